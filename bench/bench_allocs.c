@@ -127,11 +127,76 @@ static const char* LARGE_INPUT =
   "</body>\n"
   "</html>\n";
 
+// Broken off mid-tag so that lexing falls back to asking Prism where each ERB tag ends.
+static const char* RECOVERY_INPUT =
+  "<ul>\n"
+  "  <li><% if item.visible? ></li>\n"
+  "  <li><%= link_to item.name, item_path(item) ></li>\n"
+  "  <li><% items.each do |entry| %><%= entry.title %><% end %></li>\n"
+  "  <li><%= format(\"%d > %d\", a, b) </li>\n"
+  "</ul>\n";
+
 typedef struct {
   const char* name;
   const char* source;
 } test_case_T;
 
+// The analyzed-Ruby path hands every ERB tag to Prism, which allocates from the C heap rather than through an
+// hb_allocator_T, so the counts above miss it. On glibc every heap allocation made during a run is counted as well,
+// by interposing malloc. An arena-backed parse then shows the arena's own pages plus every allocation that escapes it.
+#if defined(__GLIBC__)
+#  define HEAP_COUNTING 1
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* pointer, size_t size);
+extern void __libc_free(void* pointer);
+
+static bool heap_counting = false;
+static size_t heap_allocation_count = 0;
+static size_t heap_deallocation_count = 0;
+
+void* malloc(size_t size) {
+  if (heap_counting) { heap_allocation_count++; }
+
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+  if (heap_counting) { heap_allocation_count++; }
+
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) {
+  if (heap_counting && pointer == NULL) { heap_allocation_count++; }
+
+  return __libc_realloc(pointer, size);
+}
+
+void free(void* pointer) {
+  if (heap_counting && pointer != NULL) { heap_deallocation_count++; }
+
+  __libc_free(pointer);
+}
+#else
+#  define HEAP_COUNTING 0
+
+static bool heap_counting = false;
+static size_t heap_allocation_count = 0;
+static size_t heap_deallocation_count = 0;
+#endif
+
+static void heap_counting_start(void) {
+  heap_allocation_count = 0;
+  heap_deallocation_count = 0;
+  heap_counting = true;
+}
+
+static void heap_counting_stop(void) {
+  heap_counting = false;
+}
+
 static bool no_untracked_deallocations(const char* phase, const char* name, hb_allocator_tracking_stats_T* stats) {
   if (stats->untracked_deallocation_count == 0) { return true; }
 
@@ -183,6 +248,96 @@ static bool run_parse_benchmark(const char* name, const char* source) {
   return ok;
 }
 
+typedef struct {
+  const char* label;
+  bool analyze;
+  bool action_view_helpers;
+} analyze_mode_T;
+
+static const analyze_mode_T ANALYZE_MODES[] = {
+  { "no-analyze", false, false },
+  {    "analyze",  true, false },
+  {"action-view",  true,  true },
+};
+
+static const size_t ANALYZE_MODES_COUNT = sizeof(ANALYZE_MODES) / sizeof(ANALYZE_MODES[0]);
+
+static bool run_analyze_benchmark(const char* name, const char* source) {
+  bool ok = true;
+
+  for (size_t i = 0; i < ANALYZE_MODES_COUNT; i++) {
+    parser_options_T options = HERB_DEFAULT_PARSER_OPTIONS;
+    options.analyze = ANALYZE_MODES[i].analyze;
+    options.action_view_helpers = ANALYZE_MODES[i].action_view_helpers;
+
+    hb_allocator_T allocator = hb_allocator_with_tracking();
+    AST_DOCUMENT_NODE_T* root = herb_parse(source, &options, &allocator);
+    ast_node_free((AST_NODE_T*) root, &allocator);
+
+    hb_allocator_tracking_stats_T* stats = hb_allocator_tracking_stats(&allocator);
+    size_t allocation_count = stats->allocation_count;
+    ok = no_untracked_deallocations(ANALYZE_MODES[i].label, name, stats) && ok;
+    hb_allocator_destroy(&allocator);
+
+    heap_counting_start();
+
+    if (!hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA)) {
+      heap_counting_stop();
+      return false;
+    }
+
+    root = herb_parse(source, &options, &allocator);
+    ast_node_free((AST_NODE_T*) root, &allocator);
+    hb_allocator_destroy(&allocator);
+    heap_counting_stop();
+
+    if (HEAP_COUNTING) {
+      printf("  %-11s %-9s  allocs: %-6zu  heap allocs (arena): %-6zu  heap deallocs (arena): %-6zu\n",
+        ANALYZE_MODES[i].label, name, allocation_count, heap_allocation_count, heap_deallocation_count);
+    } else {
+      printf("  %-11s %-9s  allocs: %-6zu\n", ANALYZE_MODES[i].label, name, allocation_count);
+    }
+  }
+
+  return ok;
+}
+
+static bool run_recovery_benchmark(void) {
+  hb_allocator_T allocator = hb_allocator_with_tracking();
+  hb_array_T* tokens = herb_lex(RECOVERY_INPUT, &allocator);
+
+  hb_allocator_tracking_stats_T* stats = hb_allocator_tracking_stats(&allocator);
+  size_t allocation_count = stats->allocation_count;
+  size_t token_count = tokens->size;
+
+  herb_free_tokens(&tokens, &allocator);
+
+  bool ok = no_untracked_deallocations("lex", "recovery", stats);
+
+  hb_allocator_destroy(&allocator);
+
+  heap_counting_start();
+
+  if (!hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA)) {
+    heap_counting_stop();
+    return false;
+  }
+
+  tokens = herb_lex(RECOVERY_INPUT, &allocator);
+  herb_free_tokens(&tokens, &allocator);
+  hb_allocator_destroy(&allocator);
+  heap_counting_stop();
+
+  if (HEAP_COUNTING) {
+    printf("  lex  %-10s  allocs: %-6zu  heap allocs (arena): %-6zu  heap deallocs (arena): %-6zu  tokens: %zu\n",
+      "recovery", allocation_count, heap_allocation_count, heap_deallocation_count, token_count);
+  } else {
+    printf("  lex  %-10s  allocs: %-6zu  tokens: %zu\n", "recovery", allocation_count, token_count);
+  }
+
+  return ok;
+}
+
 static bool run_source_check(
   const char* path,
   const char* label,
@@ -311,6 +466,16 @@ int main(int argc, char** argv) {
     printf("\n");
   }
 
+  printf("=== Analyzed Ruby ===\n\n");
+
+  for (size_t i = 0; i < num_cases; i++) {
+    ok = run_analyze_benchmark(cases[i].name, cases[i].source) && ok;
+  }
+
+  printf("\n[recovery] (%zu bytes input)\n", strlen(RECOVERY_INPUT));
+  ok = run_recovery_benchmark() && ok;
+  printf("\n");
+
   if (!ok) { return 1; }
 
   return 0;
@@ -0,0 +1,162 @@
+#include "../src/include/analyze/analyzed_ruby.h"
+#include "../src/include/analyze/helpers.h"
+#include "../src/include/herb.h"
+#include "../src/include/lib/hb_allocator.h"
+#include "../src/include/lib/hb_array.h"
+#include "../src/include/lib/hb_buffer.h"
+#include "../src/include/parser/parser.h"
+#include "../src/include/visitor.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Measures the per-ERB-tag cost of the Ruby analysis traversal. Every Ruby tag of the template is parsed with Prism
+// up front, then only the walk `herb_analyze_ruby` runs on each tag (search_ruby_nodes and search_unexpected_nodes)
+// is timed, so neither the Prism parse nor the whole-document analysis passes are counted.
+
+typedef struct {
+  const char* name;
+  const char* snippet;
+  size_t tags_per_snippet;
+} bench_case_T;
+
+static const bench_case_T CASES[] = {
+  { "output", "<p><%= item.name %></p>\n", 1 },
+  { "if-else", "<% if user.admin? %>\n<b>a</b>\n<% elsif user.guest? %>\n<i>g</i>\n<% else %>\nu\n<% end %>\n", 4 },
+  { "each-block", "<% @items.each do |item| %>\n<li><%= item.title %></li>\n<% end %>\n", 3 },
+  { "case-when", "<% case status %>\n<% when :active %>\nA\n<% when :archived %>\nB\n<% else %>\nC\n<% end %>\n", 5 },
+  { "begin-rescue", "<% begin %>\n<%= risky %>\n<% rescue StandardError %>\nerr\n<% ensure %>\ndone\n<% end %>\n", 5 },
+  { "tag-helper", "<%= link_to user.name, user_path(user), class: 'btn', data: { id: user.id } %>\n", 1 },
+};
+
+static const size_t CASES_COUNT = sizeof(CASES) / sizeof(CASES[0]);
+
+static const size_t SNIPPET_REPEATS = 500;
+static const size_t ITERATIONS = 20;
+
+static uint64_t monotonic_ns(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+}
+
+static uint64_t best_parse_ns(const char* source, const parser_options_T* options) {
+  uint64_t best = UINT64_MAX;
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    hb_allocator_T allocator = hb_allocator_with_malloc();
+
+    uint64_t start = monotonic_ns();
+    AST_DOCUMENT_NODE_T* root = herb_parse(source, options, &allocator);
+    uint64_t elapsed = monotonic_ns() - start;
+
+    ast_node_free((AST_NODE_T*) root, &allocator);
+    hb_allocator_destroy(&allocator);
+
+    if (elapsed < best) { best = elapsed; }
+  }
+
+  return best;
+}
+
+typedef struct {
+  hb_array_T* tags;
+  hb_allocator_T* allocator;
+} collect_tags_context_T;
+
+static bool collect_ruby_tags(const AST_NODE_T* node, void* data) {
+  collect_tags_context_T* context = (collect_tags_context_T*) data;
+
+  if (node->type == AST_ERB_CONTENT_NODE) {
+    const AST_ERB_CONTENT_NODE_T* erb_content_node = (const AST_ERB_CONTENT_NODE_T*) node;
+    hb_string_T opening = erb_content_node->tag_opening->value;
+
+    if (!hb_string_equals(opening, hb_string("<%#")) && !hb_string_equals(opening, hb_string("<%graphql"))) {
+      hb_array_append(context->tags, init_analyzed_ruby(erb_content_node->content->value, context->allocator));
+    }
+  }
+
+  return true;
+}
+
+static uint64_t best_traversal_ns(hb_array_T* tags) {
+  size_t tag_count = hb_array_size(tags);
+  analyzed_ruby_T* pristine = calloc(tag_count, sizeof(analyzed_ruby_T));
+  uint64_t best = UINT64_MAX;
+
+  for (size_t i = 0; i < tag_count; i++) { pristine[i] = *(analyzed_ruby_T*) hb_array_get(tags, i); }
+
+  for (size_t iteration = 0; iteration < ITERATIONS; iteration++) {
+    for (size_t i = 0; i < tag_count; i++) { *(analyzed_ruby_T*) hb_array_get(tags, i) = pristine[i]; }
+
+    uint64_t start = monotonic_ns();
+
+    for (size_t i = 0; i < tag_count; i++) {
+      analyzed_ruby_T* analyzed = hb_array_get(tags, i);
+
+      pm_visit_node(analyzed->root, search_ruby_nodes, analyzed);
+      search_unexpected_nodes(analyzed);
+    }
+
+    uint64_t elapsed = monotonic_ns() - start;
+
+    if (elapsed < best) { best = elapsed; }
+  }
+
+  free(pristine);
+
+  return best;
+}
+
+static void run_case(const bench_case_T* bench_case) {
+  hb_allocator_T allocator = hb_allocator_with_malloc();
+  hb_buffer_T buffer;
+  hb_buffer_init(&buffer, strlen(bench_case->snippet) * SNIPPET_REPEATS + 1, &allocator);
+
+  for (size_t i = 0; i < SNIPPET_REPEATS; i++) { hb_buffer_append(&buffer, bench_case->snippet); }
+
+  const char* source = hb_buffer_value(&buffer);
+
+  parser_options_T without_analyze = HERB_DEFAULT_PARSER_OPTIONS;
+  without_analyze.analyze = false;
+
+  parser_options_T with_analyze = HERB_DEFAULT_PARSER_OPTIONS;
+
+  uint64_t parsed = best_parse_ns(source, &with_analyze);
+
+  AST_DOCUMENT_NODE_T* root = herb_parse(source, &without_analyze, &allocator);
+  collect_tags_context_T context = { .tags = hb_array_init(bench_case->tags_per_snippet * SNIPPET_REPEATS, &allocator),
+                                     .allocator = &allocator };
+
+  herb_visit_node((AST_NODE_T*) root, collect_ruby_tags, &context);
+
+  size_t tag_count = hb_array_size(context.tags);
+  uint64_t traversal = best_traversal_ns(context.tags);
+
+  printf("  %-12s  tags: %-6zu  parse+analyze: %8.3f ms  traversal: %8.3f ms  traversal/tag: %8.1f ns\n",
+    bench_case->name, tag_count, (double) parsed / 1e6, (double) traversal / 1e6,
+    tag_count > 0 ? (double) traversal / tag_count : 0.0);
+
+  for (size_t i = 0; i < tag_count; i++) { free_analyzed_ruby(hb_array_get(context.tags, i)); }
+
+  hb_array_free(&context.tags);
+  ast_node_free((AST_NODE_T*) root, &allocator);
+  hb_buffer_free(&buffer);
+  hb_allocator_destroy(&allocator);
+}
+
+int main(void) {
+  printf("=== Analyze Benchmark (best of %zu, %zu snippet repeats) ===\n\n", ITERATIONS, SNIPPET_REPEATS);
+
+  for (size_t i = 0; i < CASES_COUNT; i++) { run_case(&CASES[i]); }
+
+  printf("\n");
+
+  return 0;
+}
@@ -0,0 +1,163 @@
+#include "../src/include/diff/herb_diff.h"
+#include "../src/include/herb.h"
+#include "../src/include/lib/hb_allocator.h"
+#include "../src/include/lib/hb_buffer.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Diffs a generated `<ul>` with 10k and 100k `<li>` children against edited copies to show how the child diff
+// scales past the LCS table, and how many operations each edit produces.
+
+typedef enum {
+  EDIT_CHANGE_ONE,
+  EDIT_INSERT_BLOCK,
+  EDIT_MOVE_ONE,
+  EDIT_SWAP_HALVES,
+  EDIT_CHANGE_EVERY_TENTH,
+  EDIT_REWRITE_ALL,
+} bench_edit_T;
+
+typedef struct {
+  const char* name;
+  bench_edit_T edit;
+} bench_case_T;
+
+static const bench_case_T CASES[] = {
+  { "change-one",         EDIT_CHANGE_ONE         },
+  { "insert-block",       EDIT_INSERT_BLOCK       },
+  { "move-one",           EDIT_MOVE_ONE           },
+  { "swap-halves",        EDIT_SWAP_HALVES        },
+  { "change-every-tenth", EDIT_CHANGE_EVERY_TENTH },
+  { "rewrite-all",        EDIT_REWRITE_ALL        },
+};
+
+static const size_t CASES_COUNT = sizeof(CASES) / sizeof(CASES[0]);
+
+static const size_t CHILD_COUNTS[] = { 10000, 100000 };
+static const size_t CHILD_COUNTS_COUNT = sizeof(CHILD_COUNTS) / sizeof(CHILD_COUNTS[0]);
+
+static const size_t INSERTED_BLOCK = 100;
+
+static uint64_t monotonic_ns(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+}
+
+static void append_item(hb_buffer_T* buffer, size_t id, const char* text) {
+  char item[96];
+
+  snprintf(item, sizeof(item), "<li id=\"item-%zu\">%s %zu</li>\n", id, text, id);
+  hb_buffer_append(buffer, item);
+}
+
+static void build_old(hb_buffer_T* buffer, size_t count) {
+  hb_buffer_append(buffer, "<ul>\n");
+  for (size_t i = 0; i < count; i++) { append_item(buffer, i, "Item"); }
+  hb_buffer_append(buffer, "</ul>\n");
+}
+
+static void build_new(hb_buffer_T* buffer, size_t count, bench_edit_T edit) {
+  hb_buffer_append(buffer, "<ul>\n");
+
+  switch (edit) {
+    case EDIT_CHANGE_ONE:
+      for (size_t i = 0; i < count; i++) { append_item(buffer, i, i == count / 2 ? "Changed" : "Item"); }
+      break;
+
+    case EDIT_INSERT_BLOCK:
+      for (size_t i = 0; i < count; i++) {
+        if (i == count / 2) {
+          for (size_t j = 0; j < INSERTED_BLOCK; j++) { append_item(buffer, count + j, "New"); }
+        }
+
+        append_item(buffer, i, "Item");
+      }
+      break;
+
+    case EDIT_MOVE_ONE:
+      for (size_t i = 0; i < count; i++) {
+        if (i != 10) { append_item(buffer, i, "Item"); }
+        if (i == count - 10) { append_item(buffer, 10, "Item"); }
+      }
+      break;
+
+    case EDIT_SWAP_HALVES:
+      for (size_t i = count / 2; i < count; i++) { append_item(buffer, i, "Item"); }
+      for (size_t i = 0; i < count / 2; i++) { append_item(buffer, i, "Item"); }
+      break;
+
+    case EDIT_CHANGE_EVERY_TENTH:
+      for (size_t i = 0; i < count; i++) { append_item(buffer, i, i % 10 == 0 ? "Changed" : "Item"); }
+      break;
+
+    case EDIT_REWRITE_ALL:
+      for (size_t i = 0; i < count; i++) { append_item(buffer, i, "Rewritten"); }
+      break;
+  }
+
+  hb_buffer_append(buffer, "</ul>\n");
+}
+
+static void run_case(const bench_case_T* bench_case, size_t count) {
+  hb_allocator_T buffer_allocator = hb_allocator_with_malloc();
+  hb_buffer_T old_source;
+  hb_buffer_T new_source;
+  hb_buffer_init(&old_source, count * 48 + 64, &buffer_allocator);
+  hb_buffer_init(&new_source, (count + INSERTED_BLOCK) * 48 + 64, &buffer_allocator);
+
+  build_old(&old_source, count);
+  build_new(&new_source, count, bench_case->edit);
+
+  parser_options_T options = HERB_DEFAULT_PARSER_OPTIONS;
+  options.timeout_ms = 0;
+  options.max_errors = 0;
+
+  hb_allocator_T allocator;
+  hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA);
+
+  AST_DOCUMENT_NODE_T* old_root = herb_parse(hb_buffer_value(&old_source), &options, &allocator);
+  AST_DOCUMENT_NODE_T* new_root = herb_parse(hb_buffer_value(&new_source), &options, &allocator);
+
+  hb_allocator_T diff_allocator;
+  hb_allocator_init(&diff_allocator, HB_ALLOCATOR_ARENA);
+
+  uint64_t start = monotonic_ns();
+  herb_diff_result_T* result = herb_diff(old_root, new_root, NULL, &diff_allocator);
+  uint64_t elapsed = monotonic_ns() - start;
+
+  size_t moves = 0;
+
+  for (size_t i = 0; i < herb_diff_operation_count(result); i++) {
+    if (herb_diff_operation_at(result, i)->type == HERB_DIFF_NODE_MOVED) { moves++; }
+  }
+
+  printf("  %-18s  children: %-7zu  diff: %9.3f ms  operations: %-7zu  moves: %zu\n",
+    bench_case->name, count, (double) elapsed / 1e6, herb_diff_operation_count(result), moves);
+
+  hb_allocator_destroy(&diff_allocator);
+  ast_node_free((AST_NODE_T*) new_root, &allocator);
+  ast_node_free((AST_NODE_T*) old_root, &allocator);
+  hb_allocator_destroy(&allocator);
+  hb_buffer_free(&new_source);
+  hb_buffer_free(&old_source);
+}
+
+int main(void) {
+  printf("=== Child Diff Benchmark ===\n\n");
+
+  for (size_t i = 0; i < CHILD_COUNTS_COUNT; i++) {
+    for (size_t j = 0; j < CASES_COUNT; j++) { run_case(&CASES[j], CHILD_COUNTS[i]); }
+
+    printf("\n");
+  }
+
+  return 0;
+}
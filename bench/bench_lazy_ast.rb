@@ -0,0 +1,79 @@
+# frozen_string_literal: true
+
+# Compares Herb.parse with and without `lazy: true`: objects allocated and time per parse, for a parse that is never
+# read, one walked by a visitor that reads only tag names, and one walked by a visitor that also reads every node
+# location.
+#
+#   bundle exec ruby -Ilib bench/bench_lazy_ast.rb
+
+require_relative "../lib/herb"
+
+ITERATIONS = 50
+
+ROW = <<~ERB
+  <tr class="<%= cycle("odd", "even") %>" id="row-<%= row.id %>">
+    <td><%= link_to row.name, row_path(row) %></td>
+    <td data-value="<%= row.amount %>"><%= number_to_currency(row.amount) %></td>
+    <% if row.archived? %><td><span class="badge">Archived</span></td><% else %><td></td><% end %>
+  </tr>
+ERB
+
+SOURCE = "<table>\n<% rows.each do |row| %>\n#{ROW * 500}<% end %>\n</table>\n".freeze
+
+class TagNameVisitor < Herb::Visitor
+  attr_reader :count
+
+  def initialize
+    super
+
+    @count = 0
+  end
+
+  def visit_html_element_node(node)
+    @count += 1 if node.tag_name&.value
+    super
+  end
+end
+
+class LocationVisitor < Herb::Visitor
+  def visit_child_nodes(node)
+    node.location
+    node.errors
+    super
+  end
+end
+
+def measure
+  GC.start
+  GC.disable
+
+  allocated = GC.stat(:total_allocated_objects)
+  started = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+
+  ITERATIONS.times { yield }
+
+  elapsed = Process.clock_gettime(Process::CLOCK_MONOTONIC) - started
+  allocated = GC.stat(:total_allocated_objects) - allocated
+
+  GC.enable
+
+  [allocated / ITERATIONS, elapsed / ITERATIONS]
+end
+
+CASES = {
+  "parse only" => ->(result) { result },
+  "visit tag names" => ->(result) { result.visit(TagNameVisitor.new) },
+  "visit with locations" => ->(result) { result.visit(LocationVisitor.new) },
+}.freeze
+
+puts "=== Lazy AST Benchmark (#{SOURCE.bytesize} bytes, #{ITERATIONS} iterations) ==="
+puts
+
+CASES.each do |name, work|
+  eager_objects, eager_time = measure { work.call(Herb.parse(SOURCE)) }
+  lazy_objects, lazy_time = measure { work.call(Herb.parse(SOURCE, lazy: true)) }
+
+  puts format("  %-18s  eager: %8d objects  %8.2f ms", name, eager_objects, eager_time * 1000)
+  puts format("  %-18s  lazy:  %8d objects  %8.2f ms  (%.1fx fewer objects)",
+              "", lazy_objects, lazy_time * 1000, eager_objects.to_f / [lazy_objects, 1].max)
+end
@@ -0,0 +1,185 @@
+#include "../src/include/herb.h"
+#include "../src/include/lib/hb_allocator.h"
+#include "../src/include/lib/hb_buffer.h"
+#include "../src/include/lexer/token_list.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Compares tokens per second for herb_lex, which allocates a token_T per token and
+// collects them in an array, with herb_lex_each, which streams one reused token, and
+// herb_lex_to_token_list, which packs every token into parallel type/offset arrays.
+// Then reports the bytes each stored representation keeps alive per token.
+
+static const char* SNIPPET = "<div class=\"card\" data-id=\"<%= item.id %>\">\n"
+                             "  <h2><%= item.title %></h2>\n"
+                             "  <% if item.published? %>\n"
+                             "    <p>Published on <%= item.published_at %></p>\n"
+                             "  <% end %>\n"
+                             "  <!-- footer -->\n"
+                             "</div>\n";
+
+static const size_t SNIPPET_REPEATS = 5000;
+static const size_t ITERATIONS = 10;
+
+static uint64_t monotonic_ns(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+}
+
+static bool count_token(const token_T* token, void* data) {
+  (void) token;
+  (*(size_t*) data)++;
+
+  return true;
+}
+
+static uint64_t best_array_ns(const char* source, hb_allocator_type_T type, size_t* token_count) {
+  uint64_t best = UINT64_MAX;
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    hb_allocator_T allocator;
+    hb_allocator_init(&allocator, type);
+
+    uint64_t start = monotonic_ns();
+    hb_array_T* tokens = herb_lex(source, &allocator);
+    uint64_t elapsed = monotonic_ns() - start;
+
+    *token_count = hb_array_size(tokens);
+
+    herb_free_tokens(&tokens, &allocator);
+    hb_allocator_destroy(&allocator);
+
+    if (elapsed < best) { best = elapsed; }
+  }
+
+  return best;
+}
+
+static uint64_t best_stream_ns(const char* source, size_t* token_count) {
+  uint64_t best = UINT64_MAX;
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    hb_allocator_T allocator = hb_allocator_with_malloc();
+    size_t count = 0;
+
+    uint64_t start = monotonic_ns();
+    herb_lex_each(source, count_token, &count, &allocator);
+    uint64_t elapsed = monotonic_ns() - start;
+
+    *token_count = count;
+
+    hb_allocator_destroy(&allocator);
+
+    if (elapsed < best) { best = elapsed; }
+  }
+
+  return best;
+}
+
+static uint64_t best_token_list_ns(const char* source, size_t* token_count) {
+  uint64_t best = UINT64_MAX;
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    hb_allocator_T allocator = hb_allocator_with_malloc();
+    token_list_T tokens;
+
+    uint64_t start = monotonic_ns();
+    herb_lex_to_token_list(source, &tokens, &allocator);
+    uint64_t elapsed = monotonic_ns() - start;
+
+    *token_count = token_list_size(&tokens);
+
+    token_list_deinit(&tokens);
+    hb_allocator_destroy(&allocator);
+
+    if (elapsed < best) { best = elapsed; }
+  }
+
+  return best;
+}
+
+static size_t live_bytes(hb_allocator_T* allocator) {
+  hb_allocator_tracking_stats_T* stats = hb_allocator_tracking_stats(allocator);
+
+  return stats->bytes_allocated - stats->bytes_deallocated;
+}
+
+static void print_memory(const char* name, size_t bytes, size_t token_count) {
+  printf("  %-28s  %10zu bytes  %6.2f bytes/token\n", name, bytes, (double) bytes / (double) token_count);
+}
+
+static void report_memory(const char* source) {
+  hb_allocator_T allocator = hb_allocator_with_tracking();
+  hb_array_T* array = herb_lex(source, &allocator);
+  size_t token_count = hb_array_size(array);
+
+  print_memory("herb_lex (token_T + array)", live_bytes(&allocator), token_count);
+
+  herb_free_tokens(&array, &allocator);
+  hb_allocator_destroy(&allocator);
+
+  allocator = hb_allocator_with_tracking();
+  token_list_T tokens;
+  herb_lex_to_token_list(source, &tokens, &allocator);
+
+  print_memory("token list", live_bytes(&allocator), token_count);
+
+  token_list_location(&tokens, 0);
+  print_memory("token list + locations", live_bytes(&allocator), token_count);
+
+  token_list_deinit(&tokens);
+  hb_allocator_destroy(&allocator);
+}
+
+static void print_result(const char* name, uint64_t nanoseconds, size_t token_count) {
+  double seconds = (double) nanoseconds / 1e9;
+
+  printf("  %-16s  tokens: %-8zu  time: %8.3f ms  %8.2f M tokens/s\n",
+    name, token_count, seconds * 1e3, (double) token_count / seconds / 1e6);
+}
+
+int main(void) {
+  hb_allocator_T allocator = hb_allocator_with_malloc();
+  hb_buffer_T buffer;
+  hb_buffer_init(&buffer, strlen(SNIPPET) * SNIPPET_REPEATS + 1, &allocator);
+
+  for (size_t i = 0; i < SNIPPET_REPEATS; i++) { hb_buffer_append(&buffer, SNIPPET); }
+
+  const char* source = hb_buffer_value(&buffer);
+  size_t token_count = 0;
+
+  printf("=== Lex Benchmark (best of %zu, %zu bytes) ===\n\n", ITERATIONS, hb_buffer_length(&buffer));
+
+  // Each timing is stored before printing, because argument evaluation order would otherwise let
+  // `token_count` be read before the benchmark sets it.
+  uint64_t nanoseconds = best_array_ns(source, HB_ALLOCATOR_MALLOC, &token_count);
+  print_result("herb_lex malloc", nanoseconds, token_count);
+
+  nanoseconds = best_array_ns(source, HB_ALLOCATOR_ARENA, &token_count);
+  print_result("herb_lex arena", nanoseconds, token_count);
+
+  nanoseconds = best_stream_ns(source, &token_count);
+  print_result("herb_lex_each", nanoseconds, token_count);
+
+  nanoseconds = best_token_list_ns(source, &token_count);
+  print_result("token list", nanoseconds, token_count);
+
+  printf("\n=== Memory per stored token ===\n\n");
+
+  report_memory(source);
+
+  printf("\n");
+
+  hb_buffer_free(&buffer);
+  hb_allocator_destroy(&allocator);
+
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include "../src/include/herb.h"
+#include "../src/include/lib/hb_allocator.h"
+#include "../src/include/lib/hb_buffer.h"
+#include "../src/include/parser/parser.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Parses flat templates with 10k, 100k and 1M sibling elements to show how
+// close-tag matching scales with the number of nodes in a single children array.
+
+typedef struct {
+  const char* name;
+  const char* prefix;
+  const char* sibling;
+  const char* suffix;
+} bench_case_T;
+
+static const bench_case_T CASES[] = {
+  { "closed",     "",      "<td>x</td>", ""       },
+  { "mixed-case", "",      "<TD>x</td>", ""       },
+  { "implicit",   "<ul>",  "<li>x",      "</ul>"  },
+  { "unbalanced", "",      "<div>x",     "</div>" },
+};
+
+static const size_t CASES_COUNT = sizeof(CASES) / sizeof(CASES[0]);
+
+static const size_t SIBLING_COUNTS[] = { 10000, 100000, 1000000 };
+static const size_t SIBLING_COUNTS_COUNT = sizeof(SIBLING_COUNTS) / sizeof(SIBLING_COUNTS[0]);
+
+static uint64_t monotonic_ns(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+}
+
+static void run_case(const bench_case_T* bench_case, size_t siblings) {
+  hb_allocator_T buffer_allocator = hb_allocator_with_malloc();
+  hb_buffer_T buffer;
+  hb_buffer_init(&buffer, strlen(bench_case->sibling) * siblings + 64, &buffer_allocator);
+
+  hb_buffer_append(&buffer, bench_case->prefix);
+  for (size_t i = 0; i < siblings; i++) { hb_buffer_append(&buffer, bench_case->sibling); }
+  hb_buffer_append(&buffer, bench_case->suffix);
+
+  parser_options_T options = HERB_DEFAULT_PARSER_OPTIONS;
+  options.analyze = false;
+  options.timeout_ms = 0;
+  options.max_errors = 0;
+
+  hb_allocator_T allocator;
+  hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA);
+
+  uint64_t start = monotonic_ns();
+  AST_DOCUMENT_NODE_T* root = herb_parse(hb_buffer_value(&buffer), &options, &allocator);
+  uint64_t elapsed = monotonic_ns() - start;
+
+  printf("  %-11s  siblings: %-8zu  parse: %10.3f ms  per sibling: %8.1f ns\n",
+    bench_case->name, siblings, (double) elapsed / 1e6, (double) elapsed / (double) siblings);
+
+  ast_node_free((AST_NODE_T*) root, &allocator);
+  hb_allocator_destroy(&allocator);
+  hb_buffer_free(&buffer);
+}
+
+int main(void) {
+  printf("=== Tag Matching Benchmark ===\n\n");
+
+  for (size_t i = 0; i < CASES_COUNT; i++) {
+    for (size_t j = 0; j < SIBLING_COUNTS_COUNT; j++) { run_case(&CASES[i], SIBLING_COUNTS[j]); }
+
+    printf("\n");
+  }
+
+  return 0;
+}
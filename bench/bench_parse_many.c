@@ -0,0 +1,107 @@
+#include "../src/include/herb.h"
+#include "../src/include/lib/hb_allocator.h"
+#include "../src/include/lib/hb_buffer.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Reports how herb_parse_many scales from 1 to 64 threads on a batch of templates of mixed sizes.
+
+static const char* SNIPPET = "<div class=\"card\" data-id=\"<%= item.id %>\">\n"
+                             "  <h2><%= item.title %></h2>\n"
+                             "  <% if item.published? %>\n"
+                             "    <p>Published on <%= item.published_at %></p>\n"
+                             "  <% else %>\n"
+                             "    <%= render \"draft\", item: item %>\n"
+                             "  <% end %>\n"
+                             "</div>\n";
+
+static const size_t TEMPLATE_COUNT = 2000;
+static const size_t ITERATIONS = 3;
+static const size_t THREAD_COUNTS[] = { 1, 2, 4, 8, 16, 32, 64 };
+
+static uint64_t monotonic_ns(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+}
+
+static uint64_t best_parse_many_ns(
+  const char* const* sources,
+  herb_parse_many_result_T* results,
+  size_t thread_count,
+  uint32_t* error_count
+) {
+  uint64_t best = UINT64_MAX;
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    uint64_t start = monotonic_ns();
+    herb_parse_many(sources, TEMPLATE_COUNT, NULL, thread_count, results);
+    uint64_t elapsed = monotonic_ns() - start;
+
+    *error_count = 0;
+    for (size_t index = 0; index < TEMPLATE_COUNT; index++) { *error_count += results[index].error_count; }
+
+    herb_free_parse_many_results(results, TEMPLATE_COUNT);
+
+    if (elapsed < best) { best = elapsed; }
+  }
+
+  return best;
+}
+
+int main(void) {
+  hb_allocator_T allocator = hb_allocator_with_malloc();
+  hb_buffer_T* buffers = malloc(TEMPLATE_COUNT * sizeof(hb_buffer_T));
+  const char** sources = malloc(TEMPLATE_COUNT * sizeof(char*));
+  herb_parse_many_result_T* results = malloc(TEMPLATE_COUNT * sizeof(herb_parse_many_result_T));
+  size_t total_bytes = 0;
+
+  // Template sizes follow a skewed distribution: most are small partials, every 97th one is a large page.
+  for (size_t index = 0; index < TEMPLATE_COUNT; index++) {
+    size_t repeats = (index % 97 == 0) ? 400 : 1 + (index * 7919) % 40;
+
+    hb_buffer_init(&buffers[index], strlen(SNIPPET) * repeats + 1, &allocator);
+    for (size_t repeat = 0; repeat < repeats; repeat++) { hb_buffer_append(&buffers[index], SNIPPET); }
+
+    sources[index] = hb_buffer_value(&buffers[index]);
+    total_bytes += hb_buffer_length(&buffers[index]);
+  }
+
+  printf("=== herb_parse_many Benchmark (best of %zu, %zu templates, %zu bytes) ===\n\n",
+    ITERATIONS, TEMPLATE_COUNT, total_bytes);
+
+  uint64_t baseline = 0;
+
+  for (size_t i = 0; i < sizeof(THREAD_COUNTS) / sizeof(THREAD_COUNTS[0]); i++) {
+    size_t thread_count = THREAD_COUNTS[i];
+    uint32_t error_count = 0;
+    uint64_t nanoseconds = best_parse_many_ns(sources, results, thread_count, &error_count);
+    double seconds = (double) nanoseconds / 1e9;
+
+    if (baseline == 0) { baseline = nanoseconds; }
+
+    double speedup = (double) baseline / (double) nanoseconds;
+
+    printf("  threads: %-3zu  time: %9.3f ms  %8.1f MB/s  %9.0f templates/s  speedup: %5.2fx  efficiency: %5.1f%%"
+           "  errors: %u\n",
+      thread_count, seconds * 1e3, (double) total_bytes / seconds / 1e6, (double) TEMPLATE_COUNT / seconds, speedup,
+      speedup / (double) thread_count * 100.0, error_count);
+  }
+
+  printf("\n");
+
+  for (size_t index = 0; index < TEMPLATE_COUNT; index++) { hb_buffer_free(&buffers[index]); }
+
+  free(results);
+  free(sources);
+  free(buffers);
+  hb_allocator_destroy(&allocator);
+
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include "../src/include/herb.h"
+#include "../src/include/lib/hb_allocator.h"
+#include "../src/include/lib/hb_buffer.h"
+#include "../src/include/parser/parser.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Measures the cost of attaching Prism nodes to ERB nodes (`prism_nodes` and
+// `prism_nodes_deep`) on templates with thousands of ERB tags, relative to a
+// parse without annotation.
+
+static const char* SNIPPET = "<li><%= item.name %></li>\n"
+                             "<% if item.visible? %>\n"
+                             "  <span><%= item.label %></span>\n"
+                             "<% end %>\n";
+
+static const size_t TAGS_PER_SNIPPET = 4;
+static const size_t TAG_COUNTS[] = { 1000, 10000, 50000 };
+static const size_t TAG_COUNTS_COUNT = sizeof(TAG_COUNTS) / sizeof(TAG_COUNTS[0]);
+static const size_t ITERATIONS = 5;
+
+static uint64_t monotonic_ns(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+}
+
+static uint64_t best_parse_ns(const char* source, const parser_options_T* options) {
+  uint64_t best = UINT64_MAX;
+
+  for (size_t i = 0; i < ITERATIONS; i++) {
+    hb_allocator_T allocator;
+    hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA);
+
+    uint64_t start = monotonic_ns();
+    AST_DOCUMENT_NODE_T* root = herb_parse(source, options, &allocator);
+    uint64_t elapsed = monotonic_ns() - start;
+
+    ast_node_free((AST_NODE_T*) root, &allocator);
+    hb_allocator_destroy(&allocator);
+
+    if (elapsed < best) { best = elapsed; }
+  }
+
+  return best;
+}
+
+static void run_case(size_t tag_count) {
+  size_t repeats = tag_count / TAGS_PER_SNIPPET;
+
+  hb_allocator_T allocator = hb_allocator_with_malloc();
+  hb_buffer_T buffer;
+  hb_buffer_init(&buffer, strlen(SNIPPET) * repeats + 1, &allocator);
+
+  for (size_t i = 0; i < repeats; i++) { hb_buffer_append(&buffer, SNIPPET); }
+
+  const char* source = hb_buffer_value(&buffer);
+
+  parser_options_T plain = HERB_DEFAULT_PARSER_OPTIONS;
+
+  parser_options_T nodes = HERB_DEFAULT_PARSER_OPTIONS;
+  nodes.prism_nodes = true;
+
+  parser_options_T deep = HERB_DEFAULT_PARSER_OPTIONS;
+  deep.prism_nodes = true;
+  deep.prism_nodes_deep = true;
+
+  uint64_t baseline = best_parse_ns(source, &plain);
+  uint64_t annotated = best_parse_ns(source, &nodes);
+  uint64_t annotated_deep = best_parse_ns(source, &deep);
+
+  printf("  tags: %-6zu  parse: %9.3f ms  prism_nodes: %9.3f ms  prism_nodes_deep: %9.3f ms\n",
+    tag_count, (double) baseline / 1e6, (double) annotated / 1e6, (double) annotated_deep / 1e6);
+
+  hb_buffer_free(&buffer);
+  hb_allocator_destroy(&allocator);
+}
+
+int main(void) {
+  printf("=== Prism Annotation Benchmark (best of %zu) ===\n\n", ITERATIONS);
+
+  for (size_t i = 0; i < TAG_COUNTS_COUNT; i++) { run_case(TAG_COUNTS[i]); }
+
+  printf("\n");
+
+  return 0;
+}
@@ -1,11 +1,14 @@
 #include <ruby.h>
+#include <ruby/thread.h>
 
 #include "../../src/include/lib/hb_allocator.h"
 #include "../../src/include/lib/hb_arena_debug.h"
+#include "../../src/include/session.h"
 
 #include "error_helpers.h"
 #include "extension.h"
 #include "extension_helpers.h"
+#include "lazy_nodes.h"
 #include "nodes.h"
 
 VALUE mHerb;
@@ -17,8 +20,10 @@ VALUE cResult;
 VALUE cLexResult;
 VALUE cParseResult;
 VALUE cParserOptions;
+VALUE cSession;
 
 typedef struct {
+  const char* string;
   AST_DOCUMENT_NODE_T* root;
   VALUE source;
   const parser_options_T* parser_options;
@@ -26,16 +31,75 @@ typedef struct {
 } parse_args_T;
 
 typedef struct {
-  hb_array_T* tokens;
+  const char* string;
+  token_list_T tokens;
   VALUE source;
+  bool print_arena_stats;
   hb_allocator_T allocator;
 } lex_args_T;
 
+typedef struct {
+  const char* string;
+  const herb_extract_ruby_options_T* ruby_options;
+  hb_buffer_T output;
+  hb_allocator_T allocator;
+} extract_args_T;
+
 typedef struct {
   char* buffer_value;
   hb_allocator_T allocator;
 } buffer_args_T;
 
+// Lexing, parsing, extracting, diffing and scanning run without the GVL so other Ruby threads keep running meanwhile.
+// The C library never calls back into Ruby, but the source String may be mutated or moved by another thread while the
+// lock is released, so the work reads a copy held in its own arena and Ruby objects are only built afterwards.
+static const char* copy_source(VALUE source, hb_allocator_T* allocator) {
+  const char* string = check_string(source);
+  if (string == NULL) { return NULL; }
+
+  return hb_allocator_strndup(allocator, string, (size_t) RSTRING_LEN(source));
+}
+
+static void* parse_without_gvl(void* data) {
+  parse_args_T* args = (parse_args_T*) data;
+
+  args->root = herb_parse(args->string, args->parser_options, &args->allocator);
+
+  return NULL;
+}
+
+static void* lazy_parse_without_gvl(void* data) {
+  lazy_tree_T* tree = (lazy_tree_T*) data;
+
+  tree->root = herb_parse(tree->source, &tree->options, &tree->allocator);
+
+  return NULL;
+}
+
+static void* lex_without_gvl(void* data) {
+  lex_args_T* args = (lex_args_T*) data;
+
+  herb_lex_to_token_list(args->string, &args->tokens, &args->allocator);
+
+  return NULL;
+}
+
+static void* extract_ruby_without_gvl(void* data) {
+  extract_args_T* args = (extract_args_T*) data;
+
+  herb_extract_ruby_to_buffer_with_options(args->string, &args->output, args->ruby_options, &args->allocator);
+
+  return NULL;
+}
+
+static void* extract_html_without_gvl(void* data) {
+  extract_args_T* args = (extract_args_T*) data;
+
+  herb_extract_html_to_buffer(args->string, &args->output, &args->allocator);
+
+  return NULL;
+}
+
 static VALUE parse_convert_body(VALUE arg) {
   parse_args_T* args = (parse_args_T*) arg;
 
@@ -55,14 +119,17 @@ static VALUE parse_cleanup(VALUE arg) {
 static VALUE lex_convert_body(VALUE arg) {
   lex_args_T* args = (lex_args_T*) arg;
 
-  return create_lex_result(args->tokens, args->source);
+  VALUE result = create_lex_result(&args->tokens, args->source);
+
+  if (args->print_arena_stats) { hb_arena_print_stats((hb_arena_T*) args->allocator.context); }
+
+  return result;
 }
 
 static VALUE lex_cleanup(VALUE arg) {
   lex_args_T* args = (lex_args_T*) arg;
 
-  if (args->tokens != NULL) { herb_free_tokens(&args->tokens, &args->allocator); }
-
+  token_list_deinit(&args->tokens);
   hb_allocator_destroy(&args->allocator);
 
   return Qnil;
@@ -87,7 +154,7 @@ static VALUE Herb_lex(int argc, VALUE* argv, VALUE self) {
   VALUE source, options;
   rb_scan_args(argc, argv, "1:", &source, &options);
 
-  char* string = (char*) check_string(source);
+  check_string(source);
   bool print_arena_stats = false;
 
   if (!NIL_P(options)) {
@@ -98,107 +165,134 @@ static VALUE Herb_lex(int argc, VALUE* argv, VALUE self) {
 
   lex_args_T args = { 0 };
   args.source = source;
+  args.print_arena_stats = print_arena_stats;
 
   if (!hb_allocator_init(&args.allocator, HB_ALLOCATOR_ARENA)) { return Qnil; }
 
-  args.tokens = herb_lex(string, &args.allocator);
-
-  if (print_arena_stats) { hb_arena_print_stats((hb_arena_T*) args.allocator.context); }
+  args.string = copy_source(source, &args.allocator);
+  rb_thread_call_without_gvl(lex_without_gvl, &args, NULL, NULL);
 
   return rb_ensure(lex_convert_body, (VALUE) &args, lex_cleanup, (VALUE) &args);
 }
 
-static VALUE Herb_parse(int argc, VALUE* argv, VALUE self) {
-  VALUE source, options;
-  rb_scan_args(argc, argv, "1:", &source, &options);
+static void read_parser_options(VALUE options, parser_options_T* parser_options, bool* print_arena_stats) {
+  if (NIL_P(options)) { return; }
 
-  char* string = (char*) check_string(source);
-  bool print_arena_stats = false;
+  VALUE track_whitespace = rb_hash_lookup(options, rb_utf8_str_new_cstr("track_whitespace"));
+  if (NIL_P(track_whitespace)) { track_whitespace = rb_hash_lookup(options, ID2SYM(rb_intern("track_whitespace"))); }
+  if (!NIL_P(track_whitespace) && RTEST(track_whitespace)) { parser_options->track_whitespace = true; }
 
-  parser_options_T parser_options = HERB_DEFAULT_PARSER_OPTIONS;
+  VALUE track_locations = rb_hash_lookup(options, rb_utf8_str_new_cstr("track_locations"));
+  if (NIL_P(track_locations)) { track_locations = rb_hash_lookup(options, ID2SYM(rb_intern("track_locations"))); }
+  if (!NIL_P(track_locations) && !RTEST(track_locations)) { parser_options->track_locations = false; }
 
-  if (!NIL_P(options)) {
-    VALUE track_whitespace = rb_hash_lookup(options, rb_utf8_str_new_cstr("track_whitespace"));
-    if (NIL_P(track_whitespace)) { track_whitespace = rb_hash_lookup(options, ID2SYM(rb_intern("track_whitespace"))); }
-    if (!NIL_P(track_whitespace) && RTEST(track_whitespace)) { parser_options.track_whitespace = true; }
+  VALUE analyze = rb_hash_lookup(options, rb_utf8_str_new_cstr("analyze"));
+  if (NIL_P(analyze)) { analyze = rb_hash_lookup(options, ID2SYM(rb_intern("analyze"))); }
+  if (!NIL_P(analyze) && !RTEST(analyze)) { parser_options->analyze = false; }
 
-    VALUE track_locations = rb_hash_lookup(options, rb_utf8_str_new_cstr("track_locations"));
-    if (NIL_P(track_locations)) { track_locations = rb_hash_lookup(options, ID2SYM(rb_intern("track_locations"))); }
-    if (!NIL_P(track_locations) && !RTEST(track_locations)) { parser_options.track_locations = false; }
+  VALUE strict = rb_hash_lookup(options, rb_utf8_str_new_cstr("strict"));
+  if (NIL_P(strict)) { strict = rb_hash_lookup(options, ID2SYM(rb_intern("strict"))); }
+  if (!NIL_P(strict)) { parser_options->strict = RTEST(strict); }
 
-    VALUE analyze = rb_hash_lookup(options, rb_utf8_str_new_cstr("analyze"));
-    if (NIL_P(analyze)) { analyze = rb_hash_lookup(options, ID2SYM(rb_intern("analyze"))); }
-    if (!NIL_P(analyze) && !RTEST(analyze)) { parser_options.analyze = false; }
+  VALUE action_view_helpers = rb_hash_lookup(options, rb_utf8_str_new_cstr("action_view_helpers"));
+  if (NIL_P(action_view_helpers)) {
+    action_view_helpers = rb_hash_lookup(options, ID2SYM(rb_intern("action_view_helpers")));
+  }
+  if (!NIL_P(action_view_helpers) && RTEST(action_view_helpers)) { parser_options->action_view_helpers = true; }
 
-    VALUE strict = rb_hash_lookup(options, rb_utf8_str_new_cstr("strict"));
-    if (NIL_P(strict)) { strict = rb_hash_lookup(options, ID2SYM(rb_intern("strict"))); }
-    if (!NIL_P(strict)) { parser_options.strict = RTEST(strict); }
+  VALUE transform_conditionals = rb_hash_lookup(options, rb_utf8_str_new_cstr("transform_conditionals"));
+  if (NIL_P(transform_conditionals)) {
+    transform_conditionals = rb_hash_lookup(options, ID2SYM(rb_intern("transform_conditionals")));
+  }
+  if (!NIL_P(transform_conditionals) && RTEST(transform_conditionals)) {
+    parser_options->transform_conditionals = true;
+  }
 
-    VALUE action_view_helpers = rb_hash_lookup(options, rb_utf8_str_new_cstr("action_view_helpers"));
-    if (NIL_P(action_view_helpers)) {
-      action_view_helpers = rb_hash_lookup(options, ID2SYM(rb_intern("action_view_helpers")));
-    }
-    if (!NIL_P(action_view_helpers) && RTEST(action_view_helpers)) { parser_options.action_view_helpers = true; }
+  VALUE dot_notation_tags = rb_hash_lookup(options, rb_utf8_str_new_cstr("dot_notation_tags"));
+  if (NIL_P(dot_notation_tags)) { dot_notation_tags = rb_hash_lookup(options, ID2SYM(rb_intern("dot_notation_tags"))); }
+  if (!NIL_P(dot_notation_tags) && RTEST(dot_notation_tags)) { parser_options->dot_notation_tags = true; }
 
-    VALUE transform_conditionals = rb_hash_lookup(options, rb_utf8_str_new_cstr("transform_conditionals"));
-    if (NIL_P(transform_conditionals)) {
-      transform_conditionals = rb_hash_lookup(options, ID2SYM(rb_intern("transform_conditionals")));
-    }
-    if (!NIL_P(transform_conditionals) && RTEST(transform_conditionals)) {
-      parser_options.transform_conditionals = true;
-    }
+  VALUE render_nodes = rb_hash_lookup(options, rb_utf8_str_new_cstr("render_nodes"));
+  if (NIL_P(render_nodes)) { render_nodes = rb_hash_lookup(options, ID2SYM(rb_intern("render_nodes"))); }
+  if (!NIL_P(render_nodes) && RTEST(render_nodes)) { parser_options->render_nodes = true; }
 
-    VALUE dot_notation_tags = rb_hash_lookup(options, rb_utf8_str_new_cstr("dot_notation_tags"));
-    if (NIL_P(dot_notation_tags)) {
-      dot_notation_tags = rb_hash_lookup(options, ID2SYM(rb_intern("dot_notation_tags")));
-    }
-    if (!NIL_P(dot_notation_tags) && RTEST(dot_notation_tags)) { parser_options.dot_notation_tags = true; }
+  VALUE strict_locals = rb_hash_lookup(options, rb_utf8_str_new_cstr("strict_locals"));
+  if (NIL_P(strict_locals)) { strict_locals = rb_hash_lookup(options, ID2SYM(rb_intern("strict_locals"))); }
+  if (!NIL_P(strict_locals) && RTEST(strict_locals)) { parser_options->strict_locals = true; }
 
-    VALUE render_nodes = rb_hash_lookup(options, rb_utf8_str_new_cstr("render_nodes"));
-    if (NIL_P(render_nodes)) { render_nodes = rb_hash_lookup(options, ID2SYM(rb_intern("render_nodes"))); }
-    if (!NIL_P(render_nodes) && RTEST(render_nodes)) { parser_options.render_nodes = true; }
+  VALUE iteration_nodes = rb_hash_lookup(options, rb_utf8_str_new_cstr("iteration_nodes"));
+  if (NIL_P(iteration_nodes)) { iteration_nodes = rb_hash_lookup(options, ID2SYM(rb_intern("iteration_nodes"))); }
+  if (!NIL_P(iteration_nodes) && RTEST(iteration_nodes)) { parser_options->iteration_nodes = true; }
 
-    VALUE strict_locals = rb_hash_lookup(options, rb_utf8_str_new_cstr("strict_locals"));
-    if (NIL_P(strict_locals)) { strict_locals = rb_hash_lookup(options, ID2SYM(rb_intern("strict_locals"))); }
-    if (!NIL_P(strict_locals) && RTEST(strict_locals)) { parser_options.strict_locals = true; }
+  VALUE prism_nodes = rb_hash_lookup(options, rb_utf8_str_new_cstr("prism_nodes"));
+  if (NIL_P(prism_nodes)) { prism_nodes = rb_hash_lookup(options, ID2SYM(rb_intern("prism_nodes"))); }
+  if (!NIL_P(prism_nodes) && RTEST(prism_nodes)) { parser_options->prism_nodes = true; }
 
-    VALUE iteration_nodes = rb_hash_lookup(options, rb_utf8_str_new_cstr("iteration_nodes"));
-    if (NIL_P(iteration_nodes)) { iteration_nodes = rb_hash_lookup(options, ID2SYM(rb_intern("iteration_nodes"))); }
-    if (!NIL_P(iteration_nodes) && RTEST(iteration_nodes)) { parser_options.iteration_nodes = true; }
+  VALUE prism_nodes_deep = rb_hash_lookup(options, rb_utf8_str_new_cstr("prism_nodes_deep"));
+  if (NIL_P(prism_nodes_deep)) { prism_nodes_deep = rb_hash_lookup(options, ID2SYM(rb_intern("prism_nodes_deep"))); }
+  if (!NIL_P(prism_nodes_deep) && RTEST(prism_nodes_deep)) { parser_options->prism_nodes_deep = true; }
 
-    VALUE prism_nodes = rb_hash_lookup(options, rb_utf8_str_new_cstr("prism_nodes"));
-    if (NIL_P(prism_nodes)) { prism_nodes = rb_hash_lookup(options, ID2SYM(rb_intern("prism_nodes"))); }
-    if (!NIL_P(prism_nodes) && RTEST(prism_nodes)) { parser_options.prism_nodes = true; }
+  VALUE prism_program = rb_hash_lookup(options, rb_utf8_str_new_cstr("prism_program"));
+  if (NIL_P(prism_program)) { prism_program = rb_hash_lookup(options, ID2SYM(rb_intern("prism_program"))); }
+  if (!NIL_P(prism_program) && RTEST(prism_program)) { parser_options->prism_program = true; }
 
-    VALUE prism_nodes_deep = rb_hash_lookup(options, rb_utf8_str_new_cstr("prism_nodes_deep"));
-    if (NIL_P(prism_nodes_deep)) { prism_nodes_deep = rb_hash_lookup(options, ID2SYM(rb_intern("prism_nodes_deep"))); }
-    if (!NIL_P(prism_nodes_deep) && RTEST(prism_nodes_deep)) { parser_options.prism_nodes_deep = true; }
+  VALUE html = rb_hash_lookup(options, rb_utf8_str_new_cstr("html"));
+  if (NIL_P(html)) { html = rb_hash_lookup(options, ID2SYM(rb_intern("html"))); }
+  if (!NIL_P(html) && !RTEST(html)) { parser_options->html = false; }
 
-    VALUE prism_program = rb_hash_lookup(options, rb_utf8_str_new_cstr("prism_program"));
-    if (NIL_P(prism_program)) { prism_program = rb_hash_lookup(options, ID2SYM(rb_intern("prism_program"))); }
-    if (!NIL_P(prism_program) && RTEST(prism_program)) { parser_options.prism_program = true; }
+  VALUE arena_stats = rb_hash_lookup(options, rb_utf8_str_new_cstr("arena_stats"));
+  if (NIL_P(arena_stats)) { arena_stats = rb_hash_lookup(options, ID2SYM(rb_intern("arena_stats"))); }
+  if (!NIL_P(arena_stats) && RTEST(arena_stats)) { *print_arena_stats = true; }
 
-    VALUE html = rb_hash_lookup(options, rb_utf8_str_new_cstr("html"));
-    if (NIL_P(html)) { html = rb_hash_lookup(options, ID2SYM(rb_intern("html"))); }
-    if (!NIL_P(html) && !RTEST(html)) { parser_options.html = false; }
+  VALUE timeout = rb_hash_lookup(options, rb_utf8_str_new_cstr("timeout"));
+  if (NIL_P(timeout)) { timeout = rb_hash_lookup(options, ID2SYM(rb_intern("timeout"))); }
+  if (!NIL_P(timeout)) { parser_options->timeout_ms = (uint32_t) (NUM2DBL(timeout) * 1000); }
 
-    VALUE arena_stats = rb_hash_lookup(options, rb_utf8_str_new_cstr("arena_stats"));
-    if (NIL_P(arena_stats)) { arena_stats = rb_hash_lookup(options, ID2SYM(rb_intern("arena_stats"))); }
-    if (!NIL_P(arena_stats) && RTEST(arena_stats)) { print_arena_stats = true; }
+  VALUE max_errors_sentinel = ID2SYM(rb_intern("__not_set__"));
+  VALUE max_errors = rb_hash_lookup2(options, rb_utf8_str_new_cstr("max_errors"), max_errors_sentinel);
 
-    VALUE timeout = rb_hash_lookup(options, rb_utf8_str_new_cstr("timeout"));
-    if (NIL_P(timeout)) { timeout = rb_hash_lookup(options, ID2SYM(rb_intern("timeout"))); }
-    if (!NIL_P(timeout)) { parser_options.timeout_ms = (uint32_t) (NUM2DBL(timeout) * 1000); }
+  if (max_errors == max_errors_sentinel) {
+    max_errors = rb_hash_lookup2(options, ID2SYM(rb_intern("max_errors")), max_errors_sentinel);
+  }
 
-    VALUE max_errors_sentinel = ID2SYM(rb_intern("__not_set__"));
-    VALUE max_errors = rb_hash_lookup2(options, rb_utf8_str_new_cstr("max_errors"), max_errors_sentinel);
+  if (max_errors != max_errors_sentinel) {
+    parser_options->max_errors = NIL_P(max_errors) ? 0 : (uint32_t) NUM2UINT(max_errors);
+  }
 
-    if (max_errors == max_errors_sentinel) {
-      max_errors = rb_hash_lookup2(options, ID2SYM(rb_intern("max_errors")), max_errors_sentinel);
-    }
+  VALUE erb_recovery_limit = rb_hash_lookup(options, rb_utf8_str_new_cstr("erb_recovery_limit"));
+  if (NIL_P(erb_recovery_limit)) { erb_recovery_limit = rb_hash_lookup(options, ID2SYM(rb_intern("erb_recovery_limit"))); }
+  if (!NIL_P(erb_recovery_limit)) { parser_options->erb_recovery_limit = (uint32_t) NUM2UINT(erb_recovery_limit); }
+}
+
+static VALUE Herb_parse(int argc, VALUE* argv, VALUE self) {
+  VALUE source, options;
+  rb_scan_args(argc, argv, "1:", &source, &options);
+
+  check_string(source);
+  bool print_arena_stats = false;
+
+  parser_options_T parser_options = HERB_DEFAULT_PARSER_OPTIONS;
+
+  read_parser_options(options, &parser_options, &print_arena_stats);
+
+  if (!NIL_P(options)) {
+    VALUE lazy = rb_hash_lookup(options, rb_utf8_str_new_cstr("lazy"));
+    if (NIL_P(lazy)) { lazy = rb_hash_lookup(options, ID2SYM(rb_intern("lazy"))); }
 
-    if (max_errors != max_errors_sentinel) {
-      parser_options.max_errors = NIL_P(max_errors) ? 0 : (uint32_t) NUM2UINT(max_errors);
+    // The tree keeps the document and its arena alive, and nodes are converted the first time Ruby reads them.
+    if (!NIL_P(lazy) && RTEST(lazy)) {
+      lazy_tree_T* tree;
+      VALUE tree_value = rb_lazy_tree_new(&tree, &parser_options);
+
+      tree->source = copy_source(source, &tree->allocator);
+      rb_thread_call_without_gvl(lazy_parse_without_gvl, tree, NULL, NULL);
+
+      if (print_arena_stats) { hb_arena_print_stats((hb_arena_T*) tree->allocator.context); }
+
+      VALUE root = rb_lazy_child_node(tree_value, (AST_NODE_T*) tree->root, Qnil);
+      RB_GC_GUARD(tree_value);
+
+      return create_parse_result_with_value(root, source, &tree->options);
     }
   }
 
@@ -211,7 +305,8 @@ static VALUE Herb_parse(int argc, VALUE* argv, VALUE self) {
 
   if (!hb_allocator_init(&args.allocator, HB_ALLOCATOR_ARENA)) { return Qnil; }
 
-  args.root = herb_parse(string, &parser_options, &args.allocator);
+  args.string = copy_source(source, &args.allocator);
+  rb_thread_call_without_gvl(parse_without_gvl, &args, NULL, NULL);
 
   if (print_arena_stats) { hb_arena_print_stats((hb_arena_T*) args.allocator.context); }
 
@@ -224,11 +319,15 @@ static VALUE Herb_extract_ruby(int argc, VALUE* argv, VALUE self) {
 
   char* string = (char*) check_string(source);
 
-  hb_allocator_T allocator;
-  if (!hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA)) { return Qnil; }
+  extract_args_T extract_args = { 0 };
+  if (!hb_allocator_init(&extract_args.allocator, HB_ALLOCATOR_ARENA)) { return Qnil; }
 
-  hb_buffer_T output;
-  if (!hb_buffer_init(&output, strlen(string), &allocator)) { return Qnil; }
+  extract_args.string = copy_source(source, &extract_args.allocator);
+  if (!hb_buffer_init(&extract_args.output, strlen(string), &extract_args.allocator)) {
+    hb_allocator_destroy(&extract_args.allocator);
+
+    return Qnil;
+  }
 
   herb_extract_ruby_options_T extract_options = HERB_EXTRACT_RUBY_DEFAULT_OPTIONS;
 
@@ -248,9 +347,10 @@ static VALUE Herb_extract_ruby(int argc, VALUE* argv, VALUE self) {
     if (!NIL_P(preserve_positions_value)) { extract_options.preserve_positions = RTEST(preserve_positions_value); }
   }
 
-  herb_extract_ruby_to_buffer_with_options(string, &output, &extract_options, &allocator);
+  extract_args.ruby_options = &extract_options;
+  rb_thread_call_without_gvl(extract_ruby_without_gvl, &extract_args, NULL, NULL);
 
-  buffer_args_T args = { .buffer_value = output.value, .allocator = allocator };
+  buffer_args_T args = { .buffer_value = extract_args.output.value, .allocator = extract_args.allocator };
 
   return rb_ensure(buffer_to_string_body, (VALUE) &args, buffer_cleanup, (VALUE) &args);
 }
@@ -258,15 +358,19 @@ static VALUE Herb_extract_ruby(int argc, VALUE* argv, VALUE self) {
 static VALUE Herb_extract_html(VALUE self, VALUE source) {
   char* string = (char*) check_string(source);
 
-  hb_allocator_T allocator;
-  if (!hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA)) { return Qnil; }
+  extract_args_T extract_args = { 0 };
+  if (!hb_allocator_init(&extract_args.allocator, HB_ALLOCATOR_ARENA)) { return Qnil; }
 
-  hb_buffer_T output;
-  if (!hb_buffer_init(&output, strlen(string), &allocator)) { return Qnil; }
+  extract_args.string = copy_source(source, &extract_args.allocator);
+  if (!hb_buffer_init(&extract_args.output, strlen(string), &extract_args.allocator)) {
+    hb_allocator_destroy(&extract_args.allocator);
 
-  herb_extract_html_to_buffer(string, &output, &allocator);
+    return Qnil;
+  }
+
+  rb_thread_call_without_gvl(extract_html_without_gvl, &extract_args, NULL, NULL);
 
-  buffer_args_T args = { .buffer_value = output.value, .allocator = allocator };
+  buffer_args_T args = { .buffer_value = extract_args.output.value, .allocator = extract_args.allocator };
 
   return rb_ensure(buffer_to_string_body, (VALUE) &args, buffer_cleanup, (VALUE) &args);
 }
@@ -310,6 +414,9 @@ static VALUE Herb_arena_stats(int argc, VALUE* argv, VALUE self) {
   rb_hash_aset(hash, ID2SYM(rb_intern("total_available")), SIZET2NUM(stats.total_available));
   rb_hash_aset(hash, ID2SYM(rb_intern("allocations")), SIZET2NUM(stats.allocations));
   rb_hash_aset(hash, ID2SYM(rb_intern("fragmentation")), SIZET2NUM(stats.fragmentation));
+  rb_hash_aset(hash, ID2SYM(rb_intern("reallocations")), SIZET2NUM(stats.reallocations));
+  rb_hash_aset(hash, ID2SYM(rb_intern("in_place_reallocations")), SIZET2NUM(stats.in_place_reallocations));
+  rb_hash_aset(hash, ID2SYM(rb_intern("abandoned_bytes")), SIZET2NUM(stats.abandoned_bytes));
   rb_hash_aset(hash, ID2SYM(rb_intern("default_page_size")), SIZET2NUM(stats.default_page_size));
 
   return hash;
@@ -376,7 +483,11 @@ static VALUE Herb_leak_check(VALUE self, VALUE source) {
     if (!hb_allocator_init(&allocator, HB_ALLOCATOR_TRACKING)) { return Qnil; }
 
     hb_buffer_T output;
-    if (!hb_buffer_init(&output, strlen(string), &allocator)) { return Qnil; }
+    if (!hb_buffer_init(&output, strlen(string), &allocator)) {
+      hb_allocator_destroy(&allocator);
+
+      return Qnil;
+    }
 
     herb_extract_ruby_options_T extract_options = HERB_EXTRACT_RUBY_DEFAULT_OPTIONS;
     herb_extract_ruby_to_buffer_with_options(string, &output, &extract_options, &allocator);
@@ -393,7 +504,11 @@ static VALUE Herb_leak_check(VALUE self, VALUE source) {
     if (!hb_allocator_init(&allocator, HB_ALLOCATOR_TRACKING)) { return Qnil; }
 
     hb_buffer_T output;
-    if (!hb_buffer_init(&output, strlen(string), &allocator)) { return Qnil; }
+    if (!hb_buffer_init(&output, strlen(string), &allocator)) {
+      hb_allocator_destroy(&allocator);
+
+      return Qnil;
+    }
 
     herb_extract_html_to_buffer(string, &output, &allocator);
 
@@ -439,6 +554,10 @@ static VALUE Herb_version(VALUE self) {
 }
 
 typedef struct {
+  const char* old_string;
+  const char* new_string;
+  const parser_options_T* parser_options;
+  const herb_diff_options_T* diff_options;
   AST_DOCUMENT_NODE_T* old_root;
   AST_DOCUMENT_NODE_T* new_root;
   herb_diff_result_T* diff_result;
@@ -477,6 +596,19 @@ static VALUE rb_create_diff_operation(const herb_diff_operation_T* operation) {
   );
 }
 
+static void* diff_without_gvl(void* data) {
+  diff_args_T* args = (diff_args_T*) data;
+
+  args->old_root = herb_parse(args->old_string, args->parser_options, &args->old_allocator);
+  args->new_root = herb_parse(args->new_string, args->parser_options, &args->new_allocator);
+
+  if (args->old_root != NULL && args->new_root != NULL) {
+    args->diff_result = herb_diff(args->old_root, args->new_root, args->diff_options, &args->diff_allocator);
+  }
+
+  return NULL;
+}
+
 static VALUE diff_convert_body(VALUE arg) {
   diff_args_T* args = (diff_args_T*) arg;
   herb_diff_result_T* diff_result = args->diff_result;
@@ -513,8 +645,8 @@ static VALUE Herb_diff(int argc, VALUE* argv, VALUE self) {
   VALUE old_source, new_source, options;
   rb_scan_args(argc, argv, "2:", &old_source, &new_source, &options);
 
-  char* old_string = (char*) check_string(old_source);
-  char* new_string = (char*) check_string(new_source);
+  check_string(old_source);
+  check_string(new_source);
 
   diff_args_T args = { 0 };
 
@@ -546,8 +678,12 @@ static VALUE Herb_diff(int argc, VALUE* argv, VALUE self) {
     return Qnil;
   }
 
-  args.old_root = herb_parse(old_string, &parser_options, &args.old_allocator);
-  args.new_root = herb_parse(new_string, &parser_options, &args.new_allocator);
+  args.old_string = copy_source(old_source, &args.old_allocator);
+  args.new_string = copy_source(new_source, &args.new_allocator);
+  args.parser_options = &parser_options;
+  args.diff_options = &diff_options;
+
+  rb_thread_call_without_gvl(diff_without_gvl, &args, NULL, NULL);
 
   if (args.old_root == NULL || args.new_root == NULL) {
     diff_cleanup((VALUE) &args);
@@ -555,11 +691,221 @@ static VALUE Herb_diff(int argc, VALUE* argv, VALUE self) {
     return Qnil;
   }
 
-  args.diff_result = herb_diff(args.old_root, args.new_root, &diff_options, &args.diff_allocator);
-
   return rb_ensure(diff_convert_body, (VALUE) &args, diff_cleanup, (VALUE) &args);
 }
 
+typedef struct {
+  const char* string;
+  herb_render_scan_T scan;
+  bool scanned;
+  hb_allocator_T allocator;
+} scan_renders_args_T;
+
+static VALUE rb_string_or_nil(const char* string) {
+  return string != NULL ? rb_utf8_str_new_cstr(string) : Qnil;
+}
+
+static VALUE rb_create_render_call(const herb_render_call_T* call) {
+  VALUE cRenderCall = rb_const_get(rb_const_get(mHerb, rb_intern("RenderScan")), rb_intern("RenderCall"));
+
+  VALUE locals = rb_hash_new();
+
+  for (size_t index = 0; index < hb_array_size(call->locals); index++) {
+    const herb_render_local_T* local = hb_array_get(call->locals, index);
+    if (local->name == NULL) { continue; }
+
+    rb_hash_aset(locals, rb_utf8_str_new_cstr(local->name), rb_string_or_nil(local->value));
+  }
+
+  return rb_funcall(
+    cRenderCall,
+    rb_intern("new"),
+    9,
+    rb_string_or_nil(call->partial),
+    rb_string_or_nil(call->template_path),
+    rb_string_or_nil(call->layout),
+    rb_string_or_nil(call->collection),
+    rb_string_or_nil(call->object),
+    rb_string_or_nil(call->as_name),
+    locals,
+    call->has_block ? Qtrue : Qfalse,
+    rb_location_from_c_struct(call->location)
+  );
+}
+
+static VALUE rb_create_strict_locals(const herb_render_scan_T* scan) {
+  if (!scan->has_strict_locals) { return Qnil; }
+
+  VALUE cStrictLocal = rb_const_get(rb_const_get(mHerb, rb_intern("RenderScan")), rb_intern("StrictLocal"));
+  VALUE strict_locals = rb_ary_new_capa((long) hb_array_size(scan->strict_locals));
+
+  for (size_t index = 0; index < hb_array_size(scan->strict_locals); index++) {
+    const herb_strict_local_T* local = hb_array_get(scan->strict_locals, index);
+
+    rb_ary_push(
+      strict_locals,
+      rb_funcall(
+        cStrictLocal,
+        rb_intern("new"),
+        3,
+        rb_utf8_str_new_cstr(local->name),
+        local->required ? Qtrue : Qfalse,
+        rb_string_or_nil(local->default_value)
+      )
+    );
+  }
+
+  return strict_locals;
+}
+
+static void* scan_renders_without_gvl(void* data) {
+  scan_renders_args_T* args = (scan_renders_args_T*) data;
+
+  args->scanned = herb_scan_renders(args->string, &args->scan, &args->allocator);
+
+  return NULL;
+}
+
+static VALUE scan_renders_convert_body(VALUE arg) {
+  scan_renders_args_T* args = (scan_renders_args_T*) arg;
+  herb_render_scan_T* scan = &args->scan;
+
+  VALUE cRenderScan = rb_const_get(mHerb, rb_intern("RenderScan"));
+  VALUE render_calls = rb_ary_new_capa((long) hb_array_size(scan->render_calls));
+
+  for (size_t index = 0; index < hb_array_size(scan->render_calls); index++) {
+    rb_ary_push(render_calls, rb_create_render_call(hb_array_get(scan->render_calls, index)));
+  }
+
+  VALUE result_args[] = {
+    render_calls,
+    rb_create_strict_locals(scan),
+    scan->has_keyword_rest ? Qtrue : Qfalse,
+    scan->has_strict_locals ? rb_location_from_c_struct(scan->strict_locals_location) : Qnil,
+  };
+
+  return rb_class_new_instance(4, result_args, cRenderScan);
+}
+
+static VALUE scan_renders_cleanup(VALUE arg) {
+  scan_renders_args_T* args = (scan_renders_args_T*) arg;
+
+  hb_allocator_destroy(&args->allocator);
+
+  return Qnil;
+}
+
+static VALUE Herb_scan_renders(VALUE self, VALUE source) {
+  check_string(source);
+
+  scan_renders_args_T args = { 0 };
+  if (!hb_allocator_init(&args.allocator, HB_ALLOCATOR_ARENA)) { return Qnil; }
+
+  args.string = copy_source(source, &args.allocator);
+  rb_thread_call_without_gvl(scan_renders_without_gvl, &args, NULL, NULL);
+
+  if (!args.scanned) {
+    scan_renders_cleanup((VALUE) &args);
+
+    return Qnil;
+  }
+
+  return rb_ensure(scan_renders_convert_body, (VALUE) &args, scan_renders_cleanup, (VALUE) &args);
+}
+
+static void session_free(void* data) {
+  herb_session_deinit((herb_session_T*) data);
+  xfree(data);
+}
+
+static size_t session_memsize(const void* data) {
+  return sizeof(herb_session_T) + herb_session_stats((const herb_session_T*) data).capacity;
+}
+
+static const rb_data_type_t session_type = {
+  .wrap_struct_name = "Herb::Session",
+  .function = { .dmark = NULL, .dfree = session_free, .dsize = session_memsize },
+  .flags = RUBY_TYPED_FREE_IMMEDIATELY,
+};
+
+static herb_session_T* get_session(VALUE self) {
+  herb_session_T* session;
+  TypedData_Get_Struct(self, herb_session_T, &session_type, session);
+
+  return session;
+}
+
+static VALUE Session_alloc(VALUE klass) {
+  herb_session_T* session;
+
+  return TypedData_Make_Struct(klass, herb_session_T, &session_type, session);
+}
+
+static VALUE Session_initialize(int argc, VALUE* argv, VALUE self) {
+  VALUE options;
+  rb_scan_args(argc, argv, ":", &options);
+
+  herb_session_options_T session_options = HERB_DEFAULT_SESSION_OPTIONS;
+
+  if (!NIL_P(options)) {
+    VALUE trim_interval = rb_hash_lookup(options, ID2SYM(rb_intern("trim_interval")));
+    if (!NIL_P(trim_interval)) { session_options.trim_interval = NUM2SIZET(trim_interval); }
+
+    VALUE max_retained_bytes = rb_hash_lookup(options, ID2SYM(rb_intern("max_retained_bytes")));
+    if (!NIL_P(max_retained_bytes)) { session_options.max_retained_bytes = NUM2SIZET(max_retained_bytes); }
+  }
+
+  herb_session_T* session = get_session(self);
+  herb_session_deinit(session);
+
+  if (!herb_session_init(session, &session_options)) { rb_raise(rb_eNoMemError, "failed to allocate session arena"); }
+
+  return self;
+}
+
+static VALUE Session_parse(int argc, VALUE* argv, VALUE self) {
+  VALUE source, options;
+  rb_scan_args(argc, argv, "1:", &source, &options);
+
+  herb_session_T* session = get_session(self);
+  if (session->allocator.context == NULL) { rb_raise(rb_eRuntimeError, "session is not initialized"); }
+
+  char* string = (char*) check_string(source);
+  bool print_arena_stats = false;
+
+  parser_options_T parser_options = HERB_DEFAULT_PARSER_OPTIONS;
+  read_parser_options(options, &parser_options, &print_arena_stats);
+
+  uint32_t error_count = 0;
+  parser_options.error_count = &error_count;
+
+  AST_DOCUMENT_NODE_T* root = herb_session_parse(session, string, &parser_options);
+
+  if (print_arena_stats) { hb_arena_print_stats((hb_arena_T*) session->allocator.context); }
+
+  // The document stays in the session arena until the next parse or reset, so a conversion error needs no cleanup.
+  return create_parse_result(root, source, &parser_options);
+}
+
+static VALUE Session_reset(VALUE self) {
+  herb_session_reset(get_session(self));
+
+  return Qnil;
+}
+
+static VALUE Session_stats(VALUE self) {
+  herb_session_stats_T stats = herb_session_stats(get_session(self));
+
+  VALUE hash = rb_hash_new();
+  rb_hash_aset(hash, ID2SYM(rb_intern("parse_count")), SIZET2NUM(stats.parse_count));
+  rb_hash_aset(hash, ID2SYM(rb_intern("pages")), SIZET2NUM(stats.pages));
+  rb_hash_aset(hash, ID2SYM(rb_intern("capacity")), SIZET2NUM(stats.capacity));
+  rb_hash_aset(hash, ID2SYM(rb_intern("used")), SIZET2NUM(stats.used));
+  rb_hash_aset(hash, ID2SYM(rb_intern("high_water_mark")), SIZET2NUM(stats.high_water_mark));
+
+  return hash;
+}
+
 __attribute__((__visibility__("default"))) void Init_herb(void) {
   mHerb = rb_define_module("Herb");
   cPosition = rb_define_class_under(mHerb, "Position", rb_cObject);
@@ -570,7 +916,9 @@ __attribute__((__visibility__("default"))) void Init_herb(void) {
   cLexResult = rb_define_class_under(mHerb, "LexResult", cResult);
   cParseResult = rb_define_class_under(mHerb, "ParseResult", cResult);
   cParserOptions = rb_define_class_under(mHerb, "ParserOptions", rb_cObject);
+  cSession = rb_define_class_under(mHerb, "Session", rb_cObject);
 
+  rb_init_lazy_nodes();
   rb_init_node_classes();
   rb_init_error_classes();
 
@@ -582,4 +930,11 @@ __attribute__((__visibility__("default"))) void Init_herb(void) {
   rb_define_singleton_method(mHerb, "leak_check", Herb_leak_check, 1);
   rb_define_singleton_method(mHerb, "version", Herb_version, 0);
   rb_define_singleton_method(mHerb, "diff", Herb_diff, -1);
+  rb_define_singleton_method(mHerb, "scan_renders", Herb_scan_renders, 1);
+
+  rb_define_alloc_func(cSession, Session_alloc);
+  rb_define_method(cSession, "initialize", Session_initialize, -1);
+  rb_define_method(cSession, "parse", Session_parse, -1);
+  rb_define_method(cSession, "reset", Session_reset, 0);
+  rb_define_method(cSession, "stats", Session_stats, 0);
 }
@@ -12,5 +12,6 @@ extern VALUE cResult;
 extern VALUE cLexResult;
 extern VALUE cParseResult;
 extern VALUE cParserOptions;
+extern VALUE cSession;
 
 #endif
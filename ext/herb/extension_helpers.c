@@ -9,6 +9,7 @@
 
 #include "../../src/include/herb.h"
 #include "../../src/include/lexer/token.h"
+#include "../../src/include/lexer/token_list.h"
 #include "../../src/include/lib/hb_allocator.h"
 #include "../../src/include/lib/hb_string.h"
 #include "../../src/include/location/location.h"
@@ -88,7 +89,7 @@ VALUE rb_interned_string_from_hb_string(hb_string_T string) {
 
 static VALUE token_type_value_cache[TOKEN_EOF + 1] = { 0 };
 
-static VALUE rb_token_type_value(token_type_T type) {
+VALUE rb_token_type_value(token_type_T type) {
   if ((unsigned int) type > (unsigned int) TOKEN_EOF) {
     return rb_interned_string_from_hb_string(token_type_to_string(type));
   }
@@ -104,7 +105,7 @@ static VALUE rb_token_type_value(token_type_T type) {
   return cached;
 }
 
-VALUE rb_token_from_c_struct(token_T* token, const parser_options_T* options) {
+VALUE rb_token_from_c_struct(const token_T* token, const parser_options_T* options) {
   if (!token) { return Qnil; }
 
   init_ast_value_ivar_ids();
@@ -118,14 +119,16 @@ VALUE rb_token_from_c_struct(token_T* token, const parser_options_T* options) {
   return object;
 }
 
-VALUE create_lex_result(hb_array_T* tokens, VALUE source) {
-  VALUE value = rb_ary_new();
+VALUE create_lex_result(token_list_T* tokens, VALUE source) {
+  VALUE value = rb_ary_new_capa((long) token_list_size(tokens));
   VALUE warnings = rb_ary_new();
   VALUE errors = rb_ary_new();
 
-  for (size_t i = 0; i < hb_array_size(tokens); i++) {
-    token_T* token = hb_array_get(tokens, i);
-    if (token != NULL) { rb_ary_push(value, rb_token_from_c_struct(token, &HERB_DEFAULT_PARSER_OPTIONS)); }
+  for (size_t index = 0; index < token_list_size(tokens); index++) {
+    token_T token;
+    token_list_get(tokens, index, &token);
+
+    rb_ary_push(value, rb_token_from_c_struct(&token, &HERB_DEFAULT_PARSER_OPTIONS));
   }
 
   VALUE args[4] = { value, source, warnings, errors };
@@ -134,7 +137,10 @@ VALUE create_lex_result(hb_array_T* tokens, VALUE source) {
 }
 
 VALUE create_parse_result(AST_DOCUMENT_NODE_T* root, VALUE source, const parser_options_T* options) {
-  VALUE value = rb_node_from_c_struct((AST_NODE_T*) root, options);
+  return create_parse_result_with_value(rb_node_from_c_struct((AST_NODE_T*) root, options), source, options);
+}
+
+VALUE create_parse_result_with_value(VALUE value, VALUE source, const parser_options_T* options) {
   VALUE warnings = rb_ary_new();
   VALUE errors = rb_ary_new();
 
@@ -7,6 +7,7 @@
 
 #include "../../src/include/herb.h"
 #include "../../src/include/lexer/token.h"
+#include "../../src/include/lexer/token_list.h"
 #include "../../src/include/location/location.h"
 #include "../../src/include/location/position.h"
 #include "../../src/include/location/range.h"
@@ -18,10 +19,12 @@ VALUE rb_interned_string_from_hb_string(hb_string_T string);
 VALUE rb_position_from_c_struct(position_T position);
 VALUE rb_location_from_c_struct(location_T location);
 
-VALUE rb_token_from_c_struct(token_T* token, const parser_options_T* options);
+VALUE rb_token_from_c_struct(const token_T* token, const parser_options_T* options);
+VALUE rb_token_type_value(token_type_T type);
 VALUE rb_range_from_c_struct(range_T range);
 
-VALUE create_lex_result(hb_array_T* tokens, VALUE source);
+VALUE create_lex_result(token_list_T* tokens, VALUE source);
 VALUE create_parse_result(AST_DOCUMENT_NODE_T* root, VALUE source, const parser_options_T* options);
+VALUE create_parse_result_with_value(VALUE value, VALUE source, const parser_options_T* options);
 
 #endif
@@ -0,0 +1,220 @@
+#include <ruby.h>
+
+#include "error_helpers.h"
+#include "extension.h"
+#include "extension_helpers.h"
+#include "lazy_nodes.h"
+#include "nodes.h"
+
+#include "../../src/include/lib/hb_arena_debug.h"
+
+static VALUE mLazy;
+static VALUE mLazyNode;
+static VALUE cLazyTree;
+static VALUE cLazyToken;
+
+// Ids without an `@` are hidden from Ruby: they don't show up in #instance_variables or #inspect.
+static ID id_tree;
+static ID id_index;
+static ID id_propagated_source;
+
+static void lazy_tree_free(void* data) {
+  lazy_tree_T* tree = (lazy_tree_T*) data;
+
+  if (tree->root != NULL) { ast_node_free((AST_NODE_T*) tree->root, &tree->allocator); }
+  if (tree->allocator.context != NULL) { hb_allocator_destroy(&tree->allocator); }
+
+  xfree(tree);
+}
+
+static size_t lazy_tree_memsize(const void* data) {
+  const lazy_tree_T* tree = (const lazy_tree_T*) data;
+  if (tree->allocator.context == NULL) { return sizeof(lazy_tree_T); }
+
+  return sizeof(lazy_tree_T) + hb_arena_get_stats((const hb_arena_T*) tree->allocator.context).total_capacity;
+}
+
+static const rb_data_type_t lazy_tree_type = {
+  .wrap_struct_name = "Herb::AST::LazyTree",
+  .function = { .dmark = NULL, .dfree = lazy_tree_free, .dsize = lazy_tree_memsize },
+  .flags = RUBY_TYPED_FREE_IMMEDIATELY,
+};
+
+static lazy_tree_T* get_lazy_tree(VALUE value) {
+  lazy_tree_T* tree;
+  TypedData_Get_Struct(value, lazy_tree_T, &lazy_tree_type, tree);
+
+  return tree;
+}
+
+VALUE rb_lazy_tree_new(lazy_tree_T** tree, const parser_options_T* options) {
+  VALUE value = TypedData_Make_Struct(cLazyTree, lazy_tree_T, &lazy_tree_type, *tree);
+
+  if (!hb_allocator_init(&(*tree)->allocator, HB_ALLOCATOR_ARENA)
+      || !hb_narray_pointer_init(&(*tree)->nodes, 64, &(*tree)->allocator)
+      || !hb_narray_pointer_init(&(*tree)->tokens, 64, &(*tree)->allocator)) {
+    rb_raise(rb_eNoMemError, "failed to allocate lazy tree arena");
+  }
+
+  (*tree)->options = *options;
+  (*tree)->options.error_count = &(*tree)->error_count;
+
+  return value;
+}
+
+static void lazy_attach(VALUE object, VALUE tree, hb_narray_T* entries, void* pointer) {
+  size_t index = hb_narray_size(entries);
+  if (!hb_narray_append(entries, &pointer)) { rb_raise(rb_eNoMemError, "failed to grow lazy tree"); }
+
+  rb_ivar_set(object, id_tree, tree);
+  rb_ivar_set(object, id_index, SIZET2NUM(index));
+}
+
+static void* lazy_lookup(VALUE object, bool token, lazy_tree_T** tree) {
+  *tree = get_lazy_tree(rb_ivar_get(object, id_tree));
+
+  hb_narray_T* entries = token ? &(*tree)->tokens : &(*tree)->nodes;
+  size_t index = NUM2SIZET(rb_ivar_get(object, id_index));
+
+  if (index >= hb_narray_size(entries)) { rb_raise(rb_eIndexError, "lazy node index out of range"); }
+
+  return *(void**) hb_narray_get(entries, index);
+}
+
+VALUE rb_define_lazy_node_class(const char* name, VALUE parent) {
+  VALUE klass = rb_define_class_under(mLazy, name, parent);
+  rb_include_module(klass, mLazyNode);
+
+  return klass;
+}
+
+VALUE rb_lazy_child_node(VALUE tree, AST_NODE_T* node, VALUE source) {
+  if (node == NULL) { return Qnil; }
+
+  VALUE object = rb_lazy_node_alloc(node);
+  if (NIL_P(object)) { return Qnil; }
+
+  lazy_attach(object, tree, &get_lazy_tree(tree)->nodes, node);
+
+  if (!NIL_P(source)) {
+    rb_ivar_set(object, rb_intern("@source"), source);
+    rb_ivar_set(object, id_propagated_source, source);
+  }
+
+  return object;
+}
+
+VALUE rb_lazy_nodes_array(VALUE tree, hb_array_T* array, VALUE source) {
+  if (array == NULL) { return rb_ary_new(); }
+
+  VALUE rb_array = rb_ary_new_capa((long) hb_array_size(array));
+
+  for (size_t index = 0; index < hb_array_size(array); index++) {
+    AST_NODE_T* child = hb_array_get(array, index);
+    if (child != NULL) { rb_ary_push(rb_array, rb_lazy_child_node(tree, child, source)); }
+  }
+
+  return rb_array;
+}
+
+VALUE rb_lazy_token(VALUE tree, token_T* token) {
+  if (token == NULL) { return Qnil; }
+
+  VALUE object = rb_obj_alloc(cLazyToken);
+  rb_ivar_set(object, rb_intern("@value"), rb_string_from_hb_string(token->value));
+  rb_ivar_set(object, rb_intern("@type"), rb_token_type_value(token->type));
+  lazy_attach(object, tree, &get_lazy_tree(tree)->tokens, token);
+
+  return object;
+}
+
+// Fields and errors are loaded together on first access. @errors is set last, so its presence marks a node whose
+// fields are loaded, and a conversion that raises is retried on the next access.
+void rb_lazy_node_load(VALUE self) {
+  ID id_errors = rb_intern("@errors");
+  if (rb_ivar_defined(self, id_errors)) { return; }
+
+  lazy_tree_T* tree;
+  AST_NODE_T* node = lazy_lookup(self, false, &tree);
+
+  VALUE source = rb_ivar_get(self, id_propagated_source);
+  rb_lazy_node_load_fields(self, node, rb_ivar_get(self, id_tree), &tree->options, source);
+  rb_ivar_set(self, id_errors, rb_errors_array_from_c_array(node->errors));
+}
+
+static VALUE LazyNode_location(VALUE self) {
+  ID id_location = rb_intern("@location");
+
+  if (!rb_ivar_defined(self, id_location)) {
+    lazy_tree_T* tree;
+    AST_NODE_T* node = lazy_lookup(self, false, &tree);
+
+    rb_ivar_set(self, id_location, tree->options.track_locations ? rb_location_from_c_struct(node->location) : Qnil);
+  }
+
+  return rb_ivar_get(self, id_location);
+}
+
+static VALUE LazyNode_errors(VALUE self) {
+  rb_lazy_node_load(self);
+
+  return rb_ivar_get(self, rb_intern("@errors"));
+}
+
+// Node#source= walks the children. Until they exist, the source is kept and handed to them when they are loaded.
+static VALUE LazyNode_set_source(VALUE self, VALUE source) {
+  if (rb_ivar_defined(self, rb_intern("@errors"))) { return rb_call_super(1, &source); }
+
+  rb_ivar_set(self, rb_intern("@source"), source);
+  rb_ivar_set(self, id_propagated_source, source);
+
+  return source;
+}
+
+static VALUE LazyToken_location(VALUE self) {
+  ID id_location = rb_intern("@location");
+
+  if (!rb_ivar_defined(self, id_location)) {
+    lazy_tree_T* tree;
+    token_T* token = lazy_lookup(self, true, &tree);
+
+    rb_ivar_set(self, id_location, tree->options.track_locations ? rb_location_from_c_struct(token->location) : Qnil);
+  }
+
+  return rb_ivar_get(self, id_location);
+}
+
+static VALUE LazyToken_range(VALUE self) {
+  ID id_range = rb_intern("@range");
+
+  if (!rb_ivar_defined(self, id_range)) {
+    lazy_tree_T* tree;
+    token_T* token = lazy_lookup(self, true, &tree);
+
+    rb_ivar_set(self, id_range, tree->options.track_locations ? rb_range_from_c_struct(token->range) : Qnil);
+  }
+
+  return rb_ivar_get(self, id_range);
+}
+
+void rb_init_lazy_nodes(void) {
+  id_tree = rb_intern("__lazy_tree");
+  id_index = rb_intern("__lazy_index");
+  id_propagated_source = rb_intern("__lazy_source");
+
+  VALUE mAST = rb_define_module_under(mHerb, "AST");
+
+  cLazyTree = rb_define_class_under(mAST, "LazyTree", rb_cObject);
+  rb_undef_alloc_func(cLazyTree);
+
+  mLazy = rb_define_module_under(mAST, "Lazy");
+
+  mLazyNode = rb_define_module_under(mAST, "LazyNode");
+  rb_define_method(mLazyNode, "location", LazyNode_location, 0);
+  rb_define_method(mLazyNode, "errors", LazyNode_errors, 0);
+  rb_define_method(mLazyNode, "source=", LazyNode_set_source, 1);
+
+  cLazyToken = rb_define_class_under(mLazy, "Token", cToken);
+  rb_define_method(cLazyToken, "location", LazyToken_location, 0);
+  rb_define_method(cLazyToken, "range", LazyToken_range, 0);
+}
@@ -0,0 +1,38 @@
+#ifndef HERB_EXTENSION_LAZY_NODES_H
+#define HERB_EXTENSION_LAZY_NODES_H
+
+#include <ruby.h>
+
+#include <stdint.h>
+
+#include "../../src/include/herb.h"
+#include "../../src/include/lexer/token_struct.h"
+#include "../../src/include/lib/hb_allocator.h"
+#include "../../src/include/lib/hb_array.h"
+#include "../../src/include/lib/hb_narray.h"
+
+// A parsed document that stays in C until Ruby reads it. The tree owns the arena the document was parsed into.
+// Lazy nodes and tokens refer back to it by index into `nodes` and `tokens`, so the arena lives as long as any of
+// them does.
+typedef struct {
+  hb_allocator_T allocator;
+  const char* source;
+  AST_DOCUMENT_NODE_T* root;
+  parser_options_T options;
+  uint32_t error_count;
+  hb_narray_T nodes;
+  hb_narray_T tokens;
+} lazy_tree_T;
+
+void rb_init_lazy_nodes(void);
+
+VALUE rb_lazy_tree_new(lazy_tree_T** tree, const parser_options_T* options);
+VALUE rb_define_lazy_node_class(const char* name, VALUE parent);
+
+VALUE rb_lazy_child_node(VALUE tree, AST_NODE_T* node, VALUE source);
+VALUE rb_lazy_nodes_array(VALUE tree, hb_array_T* array, VALUE source);
+VALUE rb_lazy_token(VALUE tree, token_T* token);
+
+void rb_lazy_node_load(VALUE self);
+
+#endif
@@ -3,6 +3,8 @@ import type { SerializedLexResult } from "./lex-result.js"
 import type { ParseOptions } from "./parser-options.js"
 import type { ExtractRubyOptions } from "./extract-ruby-options.js"
 import type { DiffOptions, DiffResult } from "./diff-result.js"
+import type { RenderScanResult } from "./render-scan.js"
+import type { LibHerbSession, SessionOptions } from "./session.js"
 
 interface LibHerbBackendFunctions {
   lex: (source: string) => SerializedLexResult
@@ -14,9 +16,14 @@ interface LibHerbBackendFunctions {
   extractRuby: (source: string, options?: ExtractRubyOptions) => string
   extractHTML: (source: string) => string
 
+  scanRenders: (source: string) => RenderScanResult
+
   parseRuby: (source: string) => Uint8Array | null
+  parseBinary: (source: string, options?: ParseOptions) => Uint8Array | null
 
   version: () => string
+
+  Session: new (options?: SessionOptions) => LibHerbSession
 }
 
 export type BackendPromise = () => Promise<LibHerbBackend>
@@ -27,8 +34,11 @@ const expectedFunctions = [
   "diff",
   "extractRuby",
   "extractHTML",
+  "scanRenders",
   "parseRuby",
+  "parseBinary",
   "version",
+  "Session",
 ] as const
 
 type LibHerbBackendFunctionName = (typeof expectedFunctions)[number]
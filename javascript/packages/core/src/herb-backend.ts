@@ -6,6 +6,8 @@ import { ParseResult } from "./parse-result.js"
 import { DEFAULT_PARSER_OPTIONS } from "./parser-options.js"
 import { DEFAULT_EXTRACT_RUBY_OPTIONS } from "./extract-ruby-options.js"
 import { deserializePrismParseResult } from "./prism/index.js"
+import { deserializeBinaryAST } from "./binary-ast.js"
+import { Session } from "./session.js"
 
 import type { LibHerbBackend, BackendPromise } from "./backend.js"
 import type { ParseResultFor } from "./parse-result.js"
@@ -13,6 +15,9 @@ import type { ParseOptions } from "./parser-options.js"
 import type { ExtractRubyOptions } from "./extract-ruby-options.js"
 import type { PrismParseResult } from "./prism/index.js"
 import type { DiffOptions, DiffResult } from "./diff-result.js"
+import type { RenderScanResult } from "./render-scan.js"
+import type { SerializedDocumentNode } from "./nodes.js"
+import type { SessionOptions } from "./session.js"
 
 /**
  * The main Herb parser interface, providing methods to lex and parse input.
@@ -79,6 +84,40 @@ export abstract class HerbBackend {
     return ParseResult.from(this.backend.parse(ensureString(source), mergedOptions)) as ParseResultFor<Options>
   }
 
+  /**
+   * Parses the given source string and transfers the tree from the backend as one binary buffer.
+   * Nodes are decoded lazily when their properties are accessed.
+   * @param source - The source code to parse.
+   * @param options - Optional parsing options.
+   * @returns The lazily decoded serialized document, which can be passed to `DocumentNode.from`.
+   * @throws Error if the backend is not loaded.
+   */
+  parseBinary(source: string, options?: ParseOptions): SerializedDocumentNode {
+    this.ensureBackend()
+
+    const mergedOptions = { ...DEFAULT_PARSER_OPTIONS, ...options }
+    const bytes = this.backend.parseBinary(ensureString(source), mergedOptions)
+
+    if (!bytes) {
+      throw new Error("Failed to parse source")
+    }
+
+    return deserializeBinaryAST(bytes)
+  }
+
+  /**
+   * Creates a parse session that reuses its memory across parses.
+   * Call `dispose()` on the session once it is no longer needed.
+   * @param options - Optional session options.
+   * @returns A `Session` instance.
+   * @throws Error if the backend is not loaded.
+   */
+  createSession(options?: SessionOptions): Session {
+    this.ensureBackend()
+
+    return new Session(new this.backend.Session(options ?? {}))
+  }
+
   /**
    * Parses a file.
    * @param path - The file path to parse.
@@ -145,6 +184,19 @@ export abstract class HerbBackend {
     return this.backend.extractHTML(ensureString(source))
   }
 
+  /**
+   * Finds the render calls and the strict locals declaration of a template without parsing it into an AST.
+   * Much cheaper than `parse` when indexing many templates for the partials they render and accept.
+   * @param source - The source code to scan.
+   * @returns The render call sites, their locals, and the strict locals signature, if any.
+   * @throws Error if the backend is not loaded.
+   */
+  scanRenders(source: string): RenderScanResult {
+    this.ensureBackend()
+
+    return this.backend.scanRenders(ensureString(source))
+  }
+
   /**
    * Gets the Herb version information, including the core and backend versions.
    * @returns A version string containing backend, core, and libherb versions.
@@ -2,6 +2,7 @@ export * from "./action-view-helpers.js"
 export * from "./ruby-reference-collector.js"
 export * from "./ast-utils.js"
 export * from "./backend.js"
+export * from "./binary-ast.js"
 export * from "./config.js"
 export * from "./diagnostic.js"
 export * from "./didyoumean.js"
@@ -23,9 +24,11 @@ export * from "./parser-options.js"
 export * from "./position.js"
 export * from "./prism"
 export * from "./range.js"
+export * from "./render-scan.js"
 export * from "./result.js"
 export * from "./ruby-keywords.js"
 export * from "./semver.js"
+export * from "./session.js"
 export * from "./token-list.js"
 export * from "./token.js"
 export * from "./util.js"
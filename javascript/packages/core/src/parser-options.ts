@@ -15,9 +15,11 @@ export interface ParseOptions {
   html?: boolean
   timeout?: number
   max_errors?: number | null
+  /** Caps the bytes ERB end recovery may hand to Prism in one document. 0 (the default) is unlimited. */
+  erb_recovery_limit?: number
 }
 
-export type SerializedParserOptions = Required<ParseOptions>
+export type SerializedParserOptions = Required<Omit<ParseOptions, "erb_recovery_limit">>
 
 export const DEFAULT_PARSER_OPTIONS: SerializedParserOptions = {
   track_whitespace: false,
@@ -0,0 +1,26 @@
+import type { SerializedLocation } from "./location.js"
+
+export interface ScannedRenderCall {
+  partial: string | null
+  template: string | null
+  layout: string | null
+  collection: string | null
+  object: string | null
+  as: string | null
+  locals: Record<string, string>
+  block: boolean
+  location: SerializedLocation
+}
+
+export interface ScannedStrictLocal {
+  name: string
+  required: boolean
+  defaultSource: string | null
+}
+
+export interface RenderScanResult {
+  renderCalls: ScannedRenderCall[]
+  strictLocals: ScannedStrictLocal[] | null
+  keywordRest: boolean
+  strictLocalsLocation: SerializedLocation | null
+}
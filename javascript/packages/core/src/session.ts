@@ -0,0 +1,89 @@
+import { ensureString } from "./util.js"
+import { ParseResult } from "./parse-result.js"
+import { DEFAULT_PARSER_OPTIONS } from "./parser-options.js"
+
+import type { ParseResultFor, SerializedParseResult } from "./parse-result.js"
+import type { ParseOptions } from "./parser-options.js"
+
+export interface SessionOptions {
+  /** Every `trim_interval` parses, release arena pages above the largest recent parse. `0` disables it. */
+  trim_interval?: number
+  /** Release arena pages beyond this many bytes after every parse. `0` keeps every page. */
+  max_retained_bytes?: number
+}
+
+export interface SessionStats {
+  parse_count: number
+  pages: number
+  capacity: number
+  used: number
+  high_water_mark: number
+}
+
+/**
+ * The session object exposed by a libherb backend. WebAssembly sessions own native memory
+ * and have to be released with `delete()`.
+ */
+export interface LibHerbSession {
+  parse(source: string, options?: ParseOptions): SerializedParseResult
+  reset(): void
+  stats(): SessionStats
+  delete?(): void
+}
+
+/**
+ * A long-lived parser that keeps its arena between parses, so repeated parses
+ * reuse warm memory instead of allocating a fresh arena every time.
+ */
+export class Session {
+  private session: LibHerbSession | null
+
+  constructor(session: LibHerbSession) {
+    this.session = session
+  }
+
+  /**
+   * Parses the given source string into a `ParseResult`.
+   * @param source - The source code to parse.
+   * @param options - Optional parsing options.
+   * @returns A `ParseResult` instance.
+   * @throws Error if the session has been disposed.
+   */
+  parse<const Options extends ParseOptions>(source: string, options?: Options): ParseResultFor<Options> {
+    const mergedOptions = { ...DEFAULT_PARSER_OPTIONS, ...options }
+
+    return ParseResult.from(this.ensureSession().parse(ensureString(source), mergedOptions)) as ParseResultFor<Options>
+  }
+
+  /**
+   * Releases the last parsed document and applies the session's trimming policy.
+   * @throws Error if the session has been disposed.
+   */
+  reset(): void {
+    this.ensureSession().reset()
+  }
+
+  /**
+   * Reports how much arena memory the session holds.
+   * @throws Error if the session has been disposed.
+   */
+  stats(): SessionStats {
+    return this.ensureSession().stats()
+  }
+
+  /**
+   * Releases the session's native memory. The session cannot be used afterwards.
+   */
+  dispose(): void {
+    this.session?.delete?.()
+    this.session = null
+  }
+
+  private ensureSession(): LibHerbSession {
+    if (!this.session) {
+      throw new Error("Session has been disposed")
+    }
+
+    return this.session
+  }
+}
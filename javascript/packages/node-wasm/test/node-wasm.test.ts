@@ -71,6 +71,22 @@ describe("@herb-tools/node-wasm", () => {
     expect(html).toBe("<div>                    </div>")
   })
 
+  test("scanRenders() finds render calls and strict locals", async () => {
+    const source = '<%# locals: (title:, size: :md) %>\n<%= render "posts/card", post: @post %>'
+    const scan = Herb.scanRenders(source)
+
+    expect(scan.renderCalls).toHaveLength(1)
+    expect(scan.renderCalls[0].partial).toBe("posts/card")
+    expect(scan.renderCalls[0].locals).toEqual({ post: "@post" })
+    expect(scan.renderCalls[0].location.start).toEqual({ line: 2, column: 0 })
+
+    expect(scan.strictLocals).toEqual([
+      { name: "title", required: true, defaultSource: null },
+      { name: "size", required: false, defaultSource: ":md" },
+    ])
+    expect(scan.keywordRest).toBe(false)
+  })
+
   test("parse and transform erb if node", async () => {
     const erb = "<% if true %>true<% end %>"
     const result = Herb.parse(erb)
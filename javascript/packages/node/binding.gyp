@@ -4,10 +4,12 @@
       "target_name": "<(module_name)",
       "product_dir": "<(module_path)",
       "sources": [
+        "./extension/async_work.cpp",
         "./extension/error_helpers.cpp",
         "./extension/extension_helpers.cpp",
         "./extension/herb.cpp",
         "./extension/nodes.cpp",
+        "./extension/session_class.cpp",
 
         # Herb main source files
         "./extension/libherb/analyze/action_view/attribute_extraction_helpers.c",
@@ -50,6 +52,7 @@
         "./extension/libherb/ast/ast_node.c",
         "./extension/libherb/ast/ast_nodes.c",
         "./extension/libherb/ast/ast_pretty_print.c",
+        "./extension/libherb/ast/ast_serialize.c",
         "./extension/libherb/ast/pretty_print.c",
         "./extension/libherb/errors.c",
         "./extension/libherb/extract.c",
@@ -58,6 +61,7 @@
         "./extension/libherb/lexer/lexer_peek_helpers.c",
         "./extension/libherb/lexer/token_matchers.c",
         "./extension/libherb/lexer/token.c",
+        "./extension/libherb/lexer/token_list.c",
         "./extension/libherb/lib/hb_allocator.c",
         "./extension/libherb/lib/hb_arena_debug.c",
         "./extension/libherb/lib/hb_arena.c",
@@ -65,15 +69,21 @@
         "./extension/libherb/lib/hb_buffer.c",
         "./extension/libherb/lib/hb_narray.c",
         "./extension/libherb/lib/hb_string.c",
+        "./extension/libherb/location/line_index.c",
         "./extension/libherb/location/location.c",
         "./extension/libherb/location/position.c",
         "./extension/libherb/location/range.c",
+        "./extension/libherb/parse_many.c",
         "./extension/libherb/parser.c",
         "./extension/libherb/parser/dot_notation.c",
         "./extension/libherb/parser/match_tags.c",
         "./extension/libherb/parser/parser_helpers.c",
+        "./extension/libherb/prism/prism_context.c",
         "./extension/libherb/prism/prism_helpers.c",
         "./extension/libherb/prism/ruby_parser.c",
+        "./extension/libherb/render_scan.c",
+        "./extension/libherb/reparse.c",
+        "./extension/libherb/session.c",
         "./extension/libherb/util/html_util.c",
         "./extension/libherb/util/io.c",
         "./extension/libherb/util/ruby_util.c",
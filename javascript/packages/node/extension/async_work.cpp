@@ -0,0 +1,413 @@
+extern "C" {
+#include "../extension/libherb/include/ast/ast_nodes.h"
+#include "../extension/libherb/include/diff/herb_diff.h"
+#include "../extension/libherb/include/extract.h"
+#include "../extension/libherb/include/herb.h"
+#include "../extension/libherb/include/lib/hb_allocator.h"
+#include "../extension/libherb/include/lib/hb_array.h"
+#include "../extension/libherb/include/lib/hb_buffer.h"
+}
+
+#include "async_work.h"
+#include "extension_helpers.h"
+
+#include <node_api.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The *Async functions copy their arguments on the main thread, run libherb on the libuv threadpool into an arena
+// owned by the task, and only convert the result into JS values once the work completes on the main thread.
+
+typedef enum {
+  ASYNC_TASK_LEX,
+  ASYNC_TASK_PARSE,
+  ASYNC_TASK_EXTRACT_RUBY,
+  ASYNC_TASK_DIFF,
+} async_task_kind_T;
+
+typedef struct {
+  napi_deferred deferred;
+  napi_ref results;
+  uint32_t pending;
+  bool settled;
+} async_batch_T;
+
+typedef struct {
+  async_task_kind_T kind;
+  napi_async_work work;
+  napi_deferred deferred;
+  async_batch_T* batch;
+  uint32_t batch_index;
+
+  char* source;
+  char* new_source;
+
+  parser_options_T parser_options;
+  herb_extract_ruby_options_T extract_options;
+  herb_diff_options_T diff_options;
+  uint32_t error_count;
+
+  hb_allocator_T allocator;
+  hb_allocator_T new_allocator;
+  hb_allocator_T diff_allocator;
+  bool allocator_ready;
+  bool new_allocator_ready;
+  bool diff_allocator_ready;
+
+  hb_array_T* tokens;
+  AST_DOCUMENT_NODE_T* root;
+  AST_DOCUMENT_NODE_T* new_root;
+  hb_buffer_T output;
+  bool output_ready;
+  herb_diff_result_T* diff_result;
+
+  const char* error;
+} async_task_T;
+
+static async_task_T* CreateTask(async_task_kind_T kind, char* source) {
+  async_task_T* task = (async_task_T*) calloc(1, sizeof(async_task_T));
+  if (!task) { return nullptr; }
+
+  task->kind = kind;
+  task->source = source;
+  task->parser_options = HERB_DEFAULT_PARSER_OPTIONS;
+  task->extract_options = HERB_EXTRACT_RUBY_DEFAULT_OPTIONS;
+  task->diff_options = HERB_DEFAULT_DIFF_OPTIONS;
+
+  return task;
+}
+
+static void FreeTask(async_task_T* task) {
+  if (task->tokens) { herb_free_tokens(&task->tokens, &task->allocator); }
+  if (task->root) { ast_node_free((AST_NODE_T*) task->root, &task->allocator); }
+  if (task->new_root) { ast_node_free((AST_NODE_T*) task->new_root, &task->new_allocator); }
+  if (task->output_ready) { hb_buffer_free(&task->output); }
+
+  if (task->diff_allocator_ready) { hb_allocator_destroy(&task->diff_allocator); }
+  if (task->new_allocator_ready) { hb_allocator_destroy(&task->new_allocator); }
+  if (task->allocator_ready) { hb_allocator_destroy(&task->allocator); }
+
+  free(task->source);
+  free(task->new_source);
+  free(task);
+}
+
+// Runs on a threadpool thread, so it must not call into N-API.
+static void ExecuteTask(napi_env env, void* data) {
+  async_task_T* task = (async_task_T*) data;
+
+  if (!hb_allocator_init(&task->allocator, HB_ALLOCATOR_ARENA)) {
+    task->error = "Failed to initialize allocator";
+    return;
+  }
+
+  task->allocator_ready = true;
+
+  switch (task->kind) {
+    case ASYNC_TASK_LEX: {
+      task->tokens = herb_lex(task->source, &task->allocator);
+    } break;
+
+    case ASYNC_TASK_PARSE: {
+      task->parser_options.error_count = &task->error_count;
+      task->root = herb_parse(task->source, &task->parser_options, &task->allocator);
+    } break;
+
+    case ASYNC_TASK_EXTRACT_RUBY: {
+      if (!hb_buffer_init(&task->output, strlen(task->source), &task->allocator)) {
+        task->error = "Failed to initialize buffer";
+        return;
+      }
+
+      task->output_ready = true;
+      herb_extract_ruby_to_buffer_with_options(task->source, &task->output, &task->extract_options, &task->allocator);
+    } break;
+
+    case ASYNC_TASK_DIFF: {
+      task->new_allocator_ready = hb_allocator_init(&task->new_allocator, HB_ALLOCATOR_ARENA);
+      task->diff_allocator_ready = hb_allocator_init(&task->diff_allocator, HB_ALLOCATOR_ARENA);
+
+      if (!task->new_allocator_ready || !task->diff_allocator_ready) {
+        task->error = "Failed to initialize allocator";
+        return;
+      }
+
+      parser_options_T parser_options = HERB_DEFAULT_PARSER_OPTIONS;
+
+      task->root = herb_parse(task->source, &parser_options, &task->allocator);
+      task->new_root = herb_parse(task->new_source, &parser_options, &task->new_allocator);
+
+      if (task->root == nullptr || task->new_root == nullptr) {
+        task->error = "Failed to parse source";
+        return;
+      }
+
+      task->diff_result = herb_diff(task->root, task->new_root, &task->diff_options, &task->diff_allocator);
+    } break;
+  }
+}
+
+static napi_value CreateTaskResult(napi_env env, async_task_T* task) {
+  switch (task->kind) {
+    case ASYNC_TASK_LEX: return CreateLexResult(env, task->tokens, CreateString(env, task->source));
+    case ASYNC_TASK_PARSE: return CreateParseResult(env, task->root, CreateString(env, task->source), &task->parser_options);
+    case ASYNC_TASK_EXTRACT_RUBY: return CreateString(env, task->output.value);
+    case ASYNC_TASK_DIFF: return CreateDiffResult(env, task->diff_result);
+  }
+
+  return nullptr;
+}
+
+static void RejectDeferred(napi_env env, napi_deferred deferred, const char* message) {
+  napi_value message_value;
+  napi_value error;
+
+  napi_create_string_utf8(env, message, NAPI_AUTO_LENGTH, &message_value);
+  napi_create_error(env, nullptr, message_value, &error);
+  napi_reject_deferred(env, deferred, error);
+}
+
+static void SettleBatchTask(napi_env env, async_batch_T* batch, uint32_t index, napi_value result, const char* error) {
+  if (!batch->settled) {
+    if (error) {
+      RejectDeferred(env, batch->deferred, error);
+      batch->settled = true;
+    } else {
+      napi_value results;
+      napi_get_reference_value(env, batch->results, &results);
+      napi_set_element(env, results, index, result);
+    }
+  }
+
+  if (--batch->pending > 0) { return; }
+
+  if (!batch->settled) {
+    napi_value results;
+    napi_get_reference_value(env, batch->results, &results);
+    napi_resolve_deferred(env, batch->deferred, results);
+  }
+
+  napi_delete_reference(env, batch->results);
+  free(batch);
+}
+
+static void CompleteTask(napi_env env, napi_status status, void* data) {
+  async_task_T* task = (async_task_T*) data;
+
+  const char* error = status == napi_cancelled ? "Async work was cancelled" : task->error;
+  napi_value result = nullptr;
+
+  if (!error) {
+    result = CreateTaskResult(env, task);
+    if (!result) { error = "Failed to convert result"; }
+  }
+
+  if (task->batch) {
+    SettleBatchTask(env, task->batch, task->batch_index, result, error);
+  } else if (error) {
+    RejectDeferred(env, task->deferred, error);
+  } else {
+    napi_resolve_deferred(env, task->deferred, result);
+  }
+
+  napi_delete_async_work(env, task->work);
+  FreeTask(task);
+}
+
+static bool QueueTask(napi_env env, async_task_T* task) {
+  napi_value resource_name;
+  napi_create_string_utf8(env, "herb", NAPI_AUTO_LENGTH, &resource_name);
+
+  if (napi_create_async_work(env, nullptr, resource_name, ExecuteTask, CompleteTask, task, &task->work) != napi_ok) {
+    return false;
+  }
+
+  if (napi_queue_async_work(env, task->work) != napi_ok) {
+    napi_delete_async_work(env, task->work);
+    return false;
+  }
+
+  return true;
+}
+
+static napi_value StartTask(napi_env env, async_task_T* task) {
+  napi_value promise;
+
+  if (napi_create_promise(env, &task->deferred, &promise) != napi_ok) {
+    FreeTask(task);
+    napi_throw_error(env, nullptr, "Failed to create promise");
+    return nullptr;
+  }
+
+  if (!QueueTask(env, task)) {
+    RejectDeferred(env, task->deferred, "Failed to queue async work");
+    FreeTask(task);
+  }
+
+  return promise;
+}
+
+static napi_value StartTaskFromArguments(napi_env env, napi_callback_info info, async_task_kind_T kind) {
+  size_t argc = 2;
+  napi_value args[2];
+  napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+  if (argc < 1) {
+    napi_throw_error(env, nullptr, "Wrong number of arguments");
+    return nullptr;
+  }
+
+  char* string = CheckString(env, args[0]);
+  if (!string) { return nullptr; }
+
+  async_task_T* task = CreateTask(kind, string);
+
+  if (!task) {
+    free(string);
+    napi_throw_error(env, nullptr, "Memory allocation failed");
+    return nullptr;
+  }
+
+  if (argc >= 2 && kind == ASYNC_TASK_PARSE) { ReadParserOptions(env, args[1], &task->parser_options); }
+  if (argc >= 2 && kind == ASYNC_TASK_EXTRACT_RUBY) { ReadExtractRubyOptions(env, args[1], &task->extract_options); }
+
+  return StartTask(env, task);
+}
+
+napi_value Herb_lex_async(napi_env env, napi_callback_info info) {
+  return StartTaskFromArguments(env, info, ASYNC_TASK_LEX);
+}
+
+napi_value Herb_parse_async(napi_env env, napi_callback_info info) {
+  return StartTaskFromArguments(env, info, ASYNC_TASK_PARSE);
+}
+
+napi_value Herb_extract_ruby_async(napi_env env, napi_callback_info info) {
+  return StartTaskFromArguments(env, info, ASYNC_TASK_EXTRACT_RUBY);
+}
+
+napi_value Herb_diff_async(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value args[3];
+  napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+  if (argc < 2) {
+    napi_throw_error(env, nullptr, "Wrong number of arguments: expected 2 (old_source, new_source)");
+    return nullptr;
+  }
+
+  char* old_string = CheckString(env, args[0]);
+  if (!old_string) { return nullptr; }
+
+  char* new_string = CheckString(env, args[1]);
+  if (!new_string) { free(old_string); return nullptr; }
+
+  async_task_T* task = CreateTask(ASYNC_TASK_DIFF, old_string);
+
+  if (!task) {
+    free(old_string);
+    free(new_string);
+    napi_throw_error(env, nullptr, "Memory allocation failed");
+    return nullptr;
+  }
+
+  task->new_source = new_string;
+
+  if (argc >= 3) { ReadDiffOptions(env, args[2], &task->diff_options); }
+
+  return StartTask(env, task);
+}
+
+// Parses every source in the array as its own task, so the sources are spread across the threadpool. The promise
+// resolves with the parse results in input order, or rejects with the first error.
+napi_value Herb_parse_many_async(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value args[2];
+  napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+  if (argc < 1) {
+    napi_throw_error(env, nullptr, "Wrong number of arguments");
+    return nullptr;
+  }
+
+  bool is_array;
+  napi_is_array(env, args[0], &is_array);
+
+  if (!is_array) {
+    napi_throw_type_error(env, nullptr, "Array of strings expected");
+    return nullptr;
+  }
+
+  uint32_t count;
+  napi_get_array_length(env, args[0], &count);
+
+  parser_options_T parser_options = HERB_DEFAULT_PARSER_OPTIONS;
+  if (argc >= 2) { ReadParserOptions(env, args[1], &parser_options); }
+
+  char** strings = (char**) calloc(count > 0 ? count : 1, sizeof(char*));
+
+  if (!strings) {
+    napi_throw_error(env, nullptr, "Memory allocation failed");
+    return nullptr;
+  }
+
+  for (uint32_t index = 0; index < count; index++) {
+    napi_value element;
+    napi_get_element(env, args[0], index, &element);
+
+    strings[index] = CheckString(env, element);
+
+    if (!strings[index]) {
+      for (uint32_t previous = 0; previous < index; previous++) { free(strings[previous]); }
+      free(strings);
+      return nullptr;
+    }
+  }
+
+  async_batch_T* batch = (async_batch_T*) calloc(1, sizeof(async_batch_T));
+  napi_value promise;
+  napi_value results;
+
+  if (!batch || napi_create_promise(env, &batch->deferred, &promise) != napi_ok) {
+    for (uint32_t index = 0; index < count; index++) { free(strings[index]); }
+    free(strings);
+    free(batch);
+    napi_throw_error(env, nullptr, "Failed to create promise");
+    return nullptr;
+  }
+
+  napi_create_array_with_length(env, count, &results);
+
+  if (count == 0) {
+    napi_resolve_deferred(env, batch->deferred, results);
+    free(strings);
+    free(batch);
+    return promise;
+  }
+
+  napi_create_reference(env, results, 1, &batch->results);
+  batch->pending = count;
+
+  for (uint32_t index = 0; index < count; index++) {
+    async_task_T* task = CreateTask(ASYNC_TASK_PARSE, strings[index]);
+
+    if (!task) {
+      free(strings[index]);
+      SettleBatchTask(env, batch, index, nullptr, "Memory allocation failed");
+      continue;
+    }
+
+    task->batch = batch;
+    task->batch_index = index;
+    task->parser_options = parser_options;
+
+    if (!QueueTask(env, task)) {
+      FreeTask(task);
+      SettleBatchTask(env, batch, index, nullptr, "Failed to queue async work");
+    }
+  }
+
+  free(strings);
+
+  return promise;
+}
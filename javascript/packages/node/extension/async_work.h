@@ -0,0 +1,12 @@
+#ifndef HERB_NODE_ASYNC_WORK_H
+#define HERB_NODE_ASYNC_WORK_H
+
+#include <node_api.h>
+
+napi_value Herb_lex_async(napi_env env, napi_callback_info info);
+napi_value Herb_parse_async(napi_env env, napi_callback_info info);
+napi_value Herb_parse_many_async(napi_env env, napi_callback_info info);
+napi_value Herb_extract_ruby_async(napi_env env, napi_callback_info info);
+napi_value Herb_diff_async(napi_env env, napi_callback_info info);
+
+#endif
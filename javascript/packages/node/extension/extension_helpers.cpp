@@ -5,6 +5,8 @@
 
 extern "C" {
 #include "../extension/libherb/include/ast/ast_nodes.h"
+#include "../extension/libherb/include/diff/herb_diff.h"
+#include "../extension/libherb/include/extract.h"
 #include "../extension/libherb/include/herb.h"
 #include "../extension/libherb/include/location/location.h"
 #include "../extension/libherb/include/location/position.h"
@@ -217,3 +219,387 @@ napi_value CreateParseResult(napi_env env, AST_DOCUMENT_NODE_T* root, napi_value
 
   return result;
 }
+
+void ReadParserOptions(napi_env env, napi_value object, parser_options_T* options) {
+  napi_valuetype valuetype;
+  napi_typeof(env, object, &valuetype);
+
+  if (valuetype != napi_object) { return; }
+
+  napi_value track_whitespace_prop;
+  bool has_track_whitespace_prop;
+  napi_has_named_property(env, object, "track_whitespace", &has_track_whitespace_prop);
+
+  if (has_track_whitespace_prop) {
+    napi_get_named_property(env, object, "track_whitespace", &track_whitespace_prop);
+    bool track_whitespace_value;
+    napi_get_value_bool(env, track_whitespace_prop, &track_whitespace_value);
+
+    if (track_whitespace_value) {
+      options->track_whitespace = true;
+    }
+  }
+
+  napi_value max_errors_prop;
+  bool has_max_errors_prop;
+  napi_has_named_property(env, object, "max_errors", &has_max_errors_prop);
+
+  if (has_max_errors_prop) {
+    napi_get_named_property(env, object, "max_errors", &max_errors_prop);
+
+    napi_valuetype max_errors_type;
+    napi_typeof(env, max_errors_prop, &max_errors_type);
+
+    if (max_errors_type == napi_number) {
+      uint32_t max_errors_value;
+      napi_get_value_uint32(env, max_errors_prop, &max_errors_value);
+      options->max_errors = max_errors_value;
+    } else {
+      options->max_errors = 0;
+    }
+  }
+
+  napi_value erb_recovery_limit_prop;
+  bool has_erb_recovery_limit_prop;
+  napi_has_named_property(env, object, "erb_recovery_limit", &has_erb_recovery_limit_prop);
+
+  if (has_erb_recovery_limit_prop) {
+    napi_get_named_property(env, object, "erb_recovery_limit", &erb_recovery_limit_prop);
+
+    napi_valuetype erb_recovery_limit_type;
+    napi_typeof(env, erb_recovery_limit_prop, &erb_recovery_limit_type);
+
+    if (erb_recovery_limit_type == napi_number) {
+      uint32_t erb_recovery_limit_value;
+      napi_get_value_uint32(env, erb_recovery_limit_prop, &erb_recovery_limit_value);
+      options->erb_recovery_limit = erb_recovery_limit_value;
+    }
+  }
+
+  napi_value track_locations_prop;
+  bool has_track_locations_prop;
+  napi_has_named_property(env, object, "track_locations", &has_track_locations_prop);
+
+  if (has_track_locations_prop) {
+    napi_get_named_property(env, object, "track_locations", &track_locations_prop);
+    bool track_locations_value;
+    napi_get_value_bool(env, track_locations_prop, &track_locations_value);
+    options->track_locations = track_locations_value;
+  }
+
+  napi_value analyze_prop;
+  bool has_analyze_prop;
+  napi_has_named_property(env, object, "analyze", &has_analyze_prop);
+
+  if (has_analyze_prop) {
+    napi_get_named_property(env, object, "analyze", &analyze_prop);
+    bool analyze_value;
+    napi_get_value_bool(env, analyze_prop, &analyze_value);
+
+    if (!analyze_value) {
+      options->analyze = false;
+    }
+  }
+
+  napi_value strict_prop;
+  bool has_strict_prop;
+  napi_has_named_property(env, object, "strict", &has_strict_prop);
+
+  if (has_strict_prop) {
+    napi_get_named_property(env, object, "strict", &strict_prop);
+    bool strict_value;
+    napi_get_value_bool(env, strict_prop, &strict_value);
+    options->strict = strict_value;
+  }
+
+  napi_value action_view_helpers_prop;
+  bool has_action_view_helpers_prop;
+  napi_has_named_property(env, object, "action_view_helpers", &has_action_view_helpers_prop);
+
+  if (has_action_view_helpers_prop) {
+    napi_get_named_property(env, object, "action_view_helpers", &action_view_helpers_prop);
+    bool action_view_helpers_value;
+    napi_get_value_bool(env, action_view_helpers_prop, &action_view_helpers_value);
+    options->action_view_helpers = action_view_helpers_value;
+  }
+
+  napi_value render_nodes_prop;
+  bool has_render_nodes_prop;
+  napi_has_named_property(env, object, "render_nodes", &has_render_nodes_prop);
+
+  if (has_render_nodes_prop) {
+    napi_get_named_property(env, object, "render_nodes", &render_nodes_prop);
+    bool render_nodes_value;
+    napi_get_value_bool(env, render_nodes_prop, &render_nodes_value);
+    options->render_nodes = render_nodes_value;
+  }
+
+  napi_value iteration_nodes_prop;
+  bool has_iteration_nodes_prop;
+  napi_has_named_property(env, object, "iteration_nodes", &has_iteration_nodes_prop);
+
+  if (has_iteration_nodes_prop) {
+    napi_get_named_property(env, object, "iteration_nodes", &iteration_nodes_prop);
+    bool iteration_nodes_value;
+    napi_get_value_bool(env, iteration_nodes_prop, &iteration_nodes_value);
+    options->iteration_nodes = iteration_nodes_value;
+  }
+
+  napi_value strict_locals_prop;
+  bool has_strict_locals_prop;
+  napi_has_named_property(env, object, "strict_locals", &has_strict_locals_prop);
+
+  if (has_strict_locals_prop) {
+    napi_get_named_property(env, object, "strict_locals", &strict_locals_prop);
+    bool strict_locals_value;
+    napi_get_value_bool(env, strict_locals_prop, &strict_locals_value);
+    options->strict_locals = strict_locals_value;
+  }
+
+  napi_value prism_nodes_prop;
+  bool has_prism_nodes_prop;
+  napi_has_named_property(env, object, "prism_nodes", &has_prism_nodes_prop);
+
+  if (has_prism_nodes_prop) {
+    napi_get_named_property(env, object, "prism_nodes", &prism_nodes_prop);
+    bool prism_nodes_value;
+    napi_get_value_bool(env, prism_nodes_prop, &prism_nodes_value);
+    options->prism_nodes = prism_nodes_value;
+  }
+
+  napi_value prism_nodes_deep_prop;
+  bool has_prism_nodes_deep_prop;
+  napi_has_named_property(env, object, "prism_nodes_deep", &has_prism_nodes_deep_prop);
+
+  if (has_prism_nodes_deep_prop) {
+    napi_get_named_property(env, object, "prism_nodes_deep", &prism_nodes_deep_prop);
+    bool prism_nodes_deep_value;
+    napi_get_value_bool(env, prism_nodes_deep_prop, &prism_nodes_deep_value);
+    options->prism_nodes_deep = prism_nodes_deep_value;
+  }
+
+  napi_value prism_program_prop;
+  bool has_prism_program_prop;
+  napi_has_named_property(env, object, "prism_program", &has_prism_program_prop);
+
+  if (has_prism_program_prop) {
+    napi_get_named_property(env, object, "prism_program", &prism_program_prop);
+    bool prism_program_value;
+    napi_get_value_bool(env, prism_program_prop, &prism_program_value);
+    options->prism_program = prism_program_value;
+  }
+}
+
+void ReadExtractRubyOptions(napi_env env, napi_value object, herb_extract_ruby_options_T* options) {
+  napi_valuetype valuetype;
+  napi_typeof(env, object, &valuetype);
+
+  if (valuetype != napi_object) { return; }
+
+  napi_value prop;
+  bool has_prop;
+
+  napi_has_named_property(env, object, "semicolons", &has_prop);
+  if (has_prop) {
+    napi_get_named_property(env, object, "semicolons", &prop);
+    bool value;
+    napi_get_value_bool(env, prop, &value);
+    options->semicolons = value;
+  }
+
+  napi_has_named_property(env, object, "comments", &has_prop);
+  if (has_prop) {
+    napi_get_named_property(env, object, "comments", &prop);
+    bool value;
+    napi_get_value_bool(env, prop, &value);
+    options->comments = value;
+  }
+
+  napi_has_named_property(env, object, "preserve_positions", &has_prop);
+  if (has_prop) {
+    napi_get_named_property(env, object, "preserve_positions", &prop);
+    bool value;
+    napi_get_value_bool(env, prop, &value);
+    options->preserve_positions = value;
+  }
+}
+
+void ReadDiffOptions(napi_env env, napi_value object, herb_diff_options_T* options) {
+  napi_valuetype valuetype;
+  napi_typeof(env, object, &valuetype);
+
+  if (valuetype != napi_object) { return; }
+
+  napi_value track_whitespace_changes_prop;
+  bool has_track_whitespace_changes_prop;
+  napi_has_named_property(env, object, "track_whitespace_changes", &has_track_whitespace_changes_prop);
+
+  if (has_track_whitespace_changes_prop) {
+    napi_get_named_property(env, object, "track_whitespace_changes", &track_whitespace_changes_prop);
+    bool track_whitespace_changes_value;
+    napi_get_value_bool(env, track_whitespace_changes_prop, &track_whitespace_changes_value);
+
+    if (track_whitespace_changes_value) {
+      options->track_whitespace_changes = true;
+    }
+  }
+}
+
+napi_value CreateDiffResult(napi_env env, const herb_diff_result_T* diff_result) {
+  napi_value result;
+  napi_create_object(env, &result);
+
+  napi_value identical;
+  napi_get_boolean(env, diff_result->trees_identical, &identical);
+  napi_set_named_property(env, result, "identical", identical);
+
+  size_t operation_count = herb_diff_operation_count(diff_result);
+
+  napi_value operations;
+  napi_create_array_with_length(env, operation_count, &operations);
+
+  for (size_t index = 0; index < operation_count; index++) {
+    const herb_diff_operation_T* operation = herb_diff_operation_at(diff_result, index);
+
+    napi_value operation_object;
+    napi_value type_val;
+    napi_value path;
+
+    napi_create_object(env, &operation_object);
+    napi_create_string_utf8(env, herb_diff_operation_type_to_string(operation->type), NAPI_AUTO_LENGTH, &type_val);
+    napi_set_named_property(env, operation_object, "type", type_val);
+    napi_create_array_with_length(env, operation->path.depth, &path);
+
+    for (uint16_t path_index = 0; path_index < operation->path.depth; path_index++) {
+      napi_value path_val;
+      napi_create_uint32(env, operation->path.indices[path_index], &path_val);
+      napi_set_element(env, path, path_index, path_val);
+    }
+
+    napi_set_named_property(env, operation_object, "path", path);
+
+    if (operation->old_node != NULL) {
+      napi_set_named_property(env, operation_object, "oldNode", NodeFromCStruct(env, (AST_NODE_T*) operation->old_node, &HERB_DEFAULT_PARSER_OPTIONS));
+    } else {
+      napi_value null_val;
+      napi_get_null(env, &null_val);
+      napi_set_named_property(env, operation_object, "oldNode", null_val);
+    }
+
+    if (operation->new_node != NULL) {
+      napi_set_named_property(env, operation_object, "newNode", NodeFromCStruct(env, (AST_NODE_T*) operation->new_node, &HERB_DEFAULT_PARSER_OPTIONS));
+    } else {
+      napi_value null_val;
+      napi_get_null(env, &null_val);
+      napi_set_named_property(env, operation_object, "newNode", null_val);
+    }
+
+    napi_value old_index_val, new_index_val;
+    napi_create_uint32(env, operation->old_index, &old_index_val);
+    napi_create_uint32(env, operation->new_index, &new_index_val);
+    napi_set_named_property(env, operation_object, "oldIndex", old_index_val);
+    napi_set_named_property(env, operation_object, "newIndex", new_index_val);
+
+    napi_set_element(env, operations, (uint32_t) index, operation_object);
+  }
+
+  napi_set_named_property(env, result, "operations", operations);
+
+  return result;
+}
+
+static napi_value CreateStringOrNull(napi_env env, const char* string) {
+  if (string != NULL) { return CreateString(env, string); }
+
+  napi_value null_val;
+  napi_get_null(env, &null_val);
+
+  return null_val;
+}
+
+static napi_value CreateRenderCall(napi_env env, const herb_render_call_T* call) {
+  napi_value result;
+  napi_create_object(env, &result);
+
+  napi_set_named_property(env, result, "partial", CreateStringOrNull(env, call->partial));
+  napi_set_named_property(env, result, "template", CreateStringOrNull(env, call->template_path));
+  napi_set_named_property(env, result, "layout", CreateStringOrNull(env, call->layout));
+  napi_set_named_property(env, result, "collection", CreateStringOrNull(env, call->collection));
+  napi_set_named_property(env, result, "object", CreateStringOrNull(env, call->object));
+  napi_set_named_property(env, result, "as", CreateStringOrNull(env, call->as_name));
+
+  napi_value locals;
+  napi_create_object(env, &locals);
+
+  for (size_t index = 0; index < hb_array_size(call->locals); index++) {
+    const herb_render_local_T* local = (const herb_render_local_T*) hb_array_get(call->locals, index);
+    if (local->name == NULL) { continue; }
+
+    napi_set_named_property(env, locals, local->name, CreateStringOrNull(env, local->value));
+  }
+
+  napi_set_named_property(env, result, "locals", locals);
+
+  napi_value block;
+  napi_get_boolean(env, call->has_block, &block);
+  napi_set_named_property(env, result, "block", block);
+
+  napi_set_named_property(env, result, "location", CreateLocation(env, call->location));
+
+  return result;
+}
+
+napi_value CreateRenderScan(napi_env env, const herb_render_scan_T* scan) {
+  napi_value result;
+  napi_create_object(env, &result);
+
+  size_t call_count = hb_array_size(scan->render_calls);
+
+  napi_value render_calls;
+  napi_create_array_with_length(env, call_count, &render_calls);
+
+  for (size_t index = 0; index < call_count; index++) {
+    const herb_render_call_T* call = (const herb_render_call_T*) hb_array_get(scan->render_calls, index);
+    napi_set_element(env, render_calls, (uint32_t) index, CreateRenderCall(env, call));
+  }
+
+  napi_set_named_property(env, result, "renderCalls", render_calls);
+
+  napi_value null_val;
+  napi_get_null(env, &null_val);
+
+  if (scan->has_strict_locals) {
+    size_t local_count = hb_array_size(scan->strict_locals);
+
+    napi_value strict_locals;
+    napi_create_array_with_length(env, local_count, &strict_locals);
+
+    for (size_t index = 0; index < local_count; index++) {
+      const herb_strict_local_T* local = (const herb_strict_local_T*) hb_array_get(scan->strict_locals, index);
+
+      napi_value local_object;
+      napi_create_object(env, &local_object);
+
+      napi_value required;
+      napi_get_boolean(env, local->required, &required);
+
+      napi_set_named_property(env, local_object, "name", CreateString(env, local->name));
+      napi_set_named_property(env, local_object, "required", required);
+      napi_set_named_property(env, local_object, "defaultSource", CreateStringOrNull(env, local->default_value));
+
+      napi_set_element(env, strict_locals, (uint32_t) index, local_object);
+    }
+
+    napi_set_named_property(env, result, "strictLocals", strict_locals);
+    napi_set_named_property(env, result, "strictLocalsLocation", CreateLocation(env, scan->strict_locals_location));
+  } else {
+    napi_set_named_property(env, result, "strictLocals", null_val);
+    napi_set_named_property(env, result, "strictLocalsLocation", null_val);
+  }
+
+  napi_value keyword_rest;
+  napi_get_boolean(env, scan->has_keyword_rest, &keyword_rest);
+  napi_set_named_property(env, result, "keywordRest", keyword_rest);
+
+  return result;
+}
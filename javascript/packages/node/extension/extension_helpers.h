@@ -5,6 +5,8 @@
 
 extern "C" {
 #include "../extension/libherb/include/ast/ast_nodes.h"
+#include "../extension/libherb/include/diff/herb_diff.h"
+#include "../extension/libherb/include/extract.h"
 #include "../extension/libherb/include/herb.h"
 #include "../extension/libherb/include/lib/hb_array.h"
 #include "../extension/libherb/include/lib/hb_string.h"
@@ -15,6 +17,12 @@ napi_value CreateString(napi_env env, const char* str);
 napi_value CreateStringFromHbString(napi_env env, hb_string_T string);
 napi_value CreateLexResult(napi_env env, hb_array_T* tokens, napi_value source);
 napi_value CreateParseResult(napi_env env, AST_DOCUMENT_NODE_T* root, napi_value source, parser_options_T* options);
+napi_value CreateDiffResult(napi_env env, const herb_diff_result_T* diff_result);
+napi_value CreateRenderScan(napi_env env, const herb_render_scan_T* scan);
+
+void ReadParserOptions(napi_env env, napi_value object, parser_options_T* options);
+void ReadExtractRubyOptions(napi_env env, napi_value object, herb_extract_ruby_options_T* options);
+void ReadDiffOptions(napi_env env, napi_value object, herb_diff_options_T* options);
 
 napi_value CreateLocation(napi_env env, location_T location);
 napi_value CreateToken(napi_env env, token_T* token, const parser_options_T* options);
@@ -1,5 +1,6 @@
 extern "C" {
 #include "../extension/libherb/include/ast/ast_nodes.h"
+#include "../extension/libherb/include/ast/ast_serialize.h"
 #include "../extension/libherb/include/extract.h"
 #include "../extension/libherb/include/herb.h"
 #include "../extension/libherb/include/diff/herb_diff.h"
@@ -11,9 +12,11 @@ extern "C" {
 #include "../extension/libherb/include/lib/hb_buffer.h"
 }
 
+#include "async_work.h"
 #include "error_helpers.h"
 #include "extension_helpers.h"
 #include "nodes.h"
+#include "session_class.h"
 
 #include <node_api.h>
 #include <stdio.h>
@@ -64,159 +67,7 @@ napi_value Herb_parse(napi_env env, napi_callback_info info) {
   if (!string) { return nullptr; }
 
   parser_options_T parser_options = HERB_DEFAULT_PARSER_OPTIONS;
-
-  if (argc >= 2) {
-    napi_valuetype valuetype;
-    napi_typeof(env, args[1], &valuetype);
-
-    if (valuetype == napi_object) {
-      napi_value track_whitespace_prop;
-      bool has_track_whitespace_prop;
-      napi_has_named_property(env, args[1], "track_whitespace", &has_track_whitespace_prop);
-
-      if (has_track_whitespace_prop) {
-        napi_get_named_property(env, args[1], "track_whitespace", &track_whitespace_prop);
-        bool track_whitespace_value;
-        napi_get_value_bool(env, track_whitespace_prop, &track_whitespace_value);
-
-        if (track_whitespace_value) {
-          parser_options.track_whitespace = true;
-        }
-      }
-
-      napi_value max_errors_prop;
-      bool has_max_errors_prop;
-      napi_has_named_property(env, args[1], "max_errors", &has_max_errors_prop);
-
-      if (has_max_errors_prop) {
-        napi_get_named_property(env, args[1], "max_errors", &max_errors_prop);
-
-        napi_valuetype max_errors_type;
-        napi_typeof(env, max_errors_prop, &max_errors_type);
-
-        if (max_errors_type == napi_number) {
-          uint32_t max_errors_value;
-          napi_get_value_uint32(env, max_errors_prop, &max_errors_value);
-          parser_options.max_errors = max_errors_value;
-        } else {
-          parser_options.max_errors = 0;
-        }
-      }
-
-      napi_value track_locations_prop;
-      bool has_track_locations_prop;
-      napi_has_named_property(env, args[1], "track_locations", &has_track_locations_prop);
-
-      if (has_track_locations_prop) {
-        napi_get_named_property(env, args[1], "track_locations", &track_locations_prop);
-        bool track_locations_value;
-        napi_get_value_bool(env, track_locations_prop, &track_locations_value);
-        parser_options.track_locations = track_locations_value;
-      }
-
-      napi_value analyze_prop;
-      bool has_analyze_prop;
-      napi_has_named_property(env, args[1], "analyze", &has_analyze_prop);
-
-      if (has_analyze_prop) {
-        napi_get_named_property(env, args[1], "analyze", &analyze_prop);
-        bool analyze_value;
-        napi_get_value_bool(env, analyze_prop, &analyze_value);
-
-        if (!analyze_value) {
-          parser_options.analyze = false;
-        }
-      }
-
-      napi_value strict_prop;
-      bool has_strict_prop;
-      napi_has_named_property(env, args[1], "strict", &has_strict_prop);
-
-      if (has_strict_prop) {
-        napi_get_named_property(env, args[1], "strict", &strict_prop);
-        bool strict_value;
-        napi_get_value_bool(env, strict_prop, &strict_value);
-        parser_options.strict = strict_value;
-      }
-
-      napi_value action_view_helpers_prop;
-      bool has_action_view_helpers_prop;
-      napi_has_named_property(env, args[1], "action_view_helpers", &has_action_view_helpers_prop);
-
-      if (has_action_view_helpers_prop) {
-        napi_get_named_property(env, args[1], "action_view_helpers", &action_view_helpers_prop);
-        bool action_view_helpers_value;
-        napi_get_value_bool(env, action_view_helpers_prop, &action_view_helpers_value);
-        parser_options.action_view_helpers = action_view_helpers_value;
-      }
-
-      napi_value render_nodes_prop;
-      bool has_render_nodes_prop;
-      napi_has_named_property(env, args[1], "render_nodes", &has_render_nodes_prop);
-
-      if (has_render_nodes_prop) {
-        napi_get_named_property(env, args[1], "render_nodes", &render_nodes_prop);
-        bool render_nodes_value;
-        napi_get_value_bool(env, render_nodes_prop, &render_nodes_value);
-        parser_options.render_nodes = render_nodes_value;
-      }
-
-      napi_value iteration_nodes_prop;
-      bool has_iteration_nodes_prop;
-      napi_has_named_property(env, args[1], "iteration_nodes", &has_iteration_nodes_prop);
-
-      if (has_iteration_nodes_prop) {
-        napi_get_named_property(env, args[1], "iteration_nodes", &iteration_nodes_prop);
-        bool iteration_nodes_value;
-        napi_get_value_bool(env, iteration_nodes_prop, &iteration_nodes_value);
-        parser_options.iteration_nodes = iteration_nodes_value;
-      }
-
-      napi_value strict_locals_prop;
-      bool has_strict_locals_prop;
-      napi_has_named_property(env, args[1], "strict_locals", &has_strict_locals_prop);
-
-      if (has_strict_locals_prop) {
-        napi_get_named_property(env, args[1], "strict_locals", &strict_locals_prop);
-        bool strict_locals_value;
-        napi_get_value_bool(env, strict_locals_prop, &strict_locals_value);
-        parser_options.strict_locals = strict_locals_value;
-      }
-
-      napi_value prism_nodes_prop;
-      bool has_prism_nodes_prop;
-      napi_has_named_property(env, args[1], "prism_nodes", &has_prism_nodes_prop);
-
-      if (has_prism_nodes_prop) {
-        napi_get_named_property(env, args[1], "prism_nodes", &prism_nodes_prop);
-        bool prism_nodes_value;
-        napi_get_value_bool(env, prism_nodes_prop, &prism_nodes_value);
-        parser_options.prism_nodes = prism_nodes_value;
-      }
-
-      napi_value prism_nodes_deep_prop;
-      bool has_prism_nodes_deep_prop;
-      napi_has_named_property(env, args[1], "prism_nodes_deep", &has_prism_nodes_deep_prop);
-
-      if (has_prism_nodes_deep_prop) {
-        napi_get_named_property(env, args[1], "prism_nodes_deep", &prism_nodes_deep_prop);
-        bool prism_nodes_deep_value;
-        napi_get_value_bool(env, prism_nodes_deep_prop, &prism_nodes_deep_value);
-        parser_options.prism_nodes_deep = prism_nodes_deep_value;
-      }
-
-      napi_value prism_program_prop;
-      bool has_prism_program_prop;
-      napi_has_named_property(env, args[1], "prism_program", &has_prism_program_prop);
-
-      if (has_prism_program_prop) {
-        napi_get_named_property(env, args[1], "prism_program", &prism_program_prop);
-        bool prism_program_value;
-        napi_get_value_bool(env, prism_program_prop, &prism_program_value);
-        parser_options.prism_program = prism_program_value;
-      }
-    }
-  }
+  if (argc >= 2) { ReadParserOptions(env, args[1], &parser_options); }
 
   uint32_t error_count = 0;
   parser_options.error_count = &error_count;
@@ -238,6 +89,52 @@ napi_value Herb_parse(napi_env env, napi_callback_info info) {
   return result;
 }
 
+napi_value Herb_parse_binary(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value args[2];
+  napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+  if (argc < 1) {
+    napi_throw_error(env, nullptr, "Wrong number of arguments");
+    return nullptr;
+  }
+
+  char* string = CheckString(env, args[0]);
+  if (!string) { return nullptr; }
+
+  parser_options_T parser_options = HERB_DEFAULT_PARSER_OPTIONS;
+  if (argc >= 2) { ReadParserOptions(env, args[1], &parser_options); }
+
+  hb_allocator_T allocator;
+  if (!hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA)) {
+    free(string);
+    napi_throw_error(env, nullptr, "Failed to initialize allocator");
+    return nullptr;
+  }
+
+  hb_buffer_T buffer;
+  if (!hb_buffer_init(&buffer, strlen(string), &allocator)) {
+    hb_allocator_destroy(&allocator);
+    free(string);
+    napi_throw_error(env, nullptr, "Failed to initialize buffer");
+    return nullptr;
+  }
+
+  AST_DOCUMENT_NODE_T* root = herb_parse(string, &parser_options, &allocator);
+  herb_serialize(root, &buffer);
+
+  void* data;
+  napi_value result;
+  napi_create_buffer_copy(env, hb_buffer_length(&buffer), hb_buffer_value(&buffer), &data, &result);
+
+  ast_node_free((AST_NODE_T *) root, &allocator);
+  hb_buffer_free(&buffer);
+  hb_allocator_destroy(&allocator);
+  free(string);
+
+  return result;
+}
+
 napi_value Herb_extract_ruby(napi_env env, napi_callback_info info) {
   size_t argc = 2;
   napi_value args[2];
@@ -268,39 +165,7 @@ napi_value Herb_extract_ruby(napi_env env, napi_callback_info info) {
 
   herb_extract_ruby_options_T extract_options = HERB_EXTRACT_RUBY_DEFAULT_OPTIONS;
 
-  if (argc >= 2) {
-    napi_valuetype valuetype;
-    napi_typeof(env, args[1], &valuetype);
-
-    if (valuetype == napi_object) {
-      napi_value prop;
-      bool has_prop;
-
-      napi_has_named_property(env, args[1], "semicolons", &has_prop);
-      if (has_prop) {
-        napi_get_named_property(env, args[1], "semicolons", &prop);
-        bool value;
-        napi_get_value_bool(env, prop, &value);
-        extract_options.semicolons = value;
-      }
-
-      napi_has_named_property(env, args[1], "comments", &has_prop);
-      if (has_prop) {
-        napi_get_named_property(env, args[1], "comments", &prop);
-        bool value;
-        napi_get_value_bool(env, prop, &value);
-        extract_options.comments = value;
-      }
-
-      napi_has_named_property(env, args[1], "preserve_positions", &has_prop);
-      if (has_prop) {
-        napi_get_named_property(env, args[1], "preserve_positions", &prop);
-        bool value;
-        napi_get_value_bool(env, prop, &value);
-        extract_options.preserve_positions = value;
-      }
-    }
-  }
+  if (argc >= 2) { ReadExtractRubyOptions(env, args[1], &extract_options); }
 
   herb_extract_ruby_to_buffer_with_options(string, &output, &extract_options, &allocator);
 
@@ -352,6 +217,42 @@ napi_value Herb_extract_html(napi_env env, napi_callback_info info) {
   return result;
 }
 
+napi_value Herb_scan_renders(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value args[1];
+  napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+  if (argc < 1) {
+    napi_throw_error(env, nullptr, "Wrong number of arguments");
+    return nullptr;
+  }
+
+  char* string = CheckString(env, args[0]);
+  if (!string) { return nullptr; }
+
+  hb_allocator_T allocator;
+  if (!hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA)) {
+    free(string);
+    napi_throw_error(env, nullptr, "Failed to initialize allocator");
+    return nullptr;
+  }
+
+  herb_render_scan_T scan;
+
+  if (!herb_scan_renders(string, &scan, &allocator)) {
+    hb_allocator_destroy(&allocator);
+    free(string);
+    napi_throw_error(env, nullptr, "Failed to scan source");
+    return nullptr;
+  }
+
+  napi_value result = CreateRenderScan(env, &scan);
+
+  hb_allocator_destroy(&allocator);
+  free(string);
+  return result;
+}
+
 napi_value Herb_parse_ruby(napi_env env, napi_callback_info info) {
   size_t argc = 1;
   napi_value args[1];
@@ -429,26 +330,7 @@ napi_value Herb_diff(napi_env env, napi_callback_info info) {
   parser_options_T parser_options = HERB_DEFAULT_PARSER_OPTIONS;
   herb_diff_options_T diff_options = HERB_DEFAULT_DIFF_OPTIONS;
 
-  if (argc >= 3) {
-    napi_valuetype valuetype;
-    napi_typeof(env, args[2], &valuetype);
-
-    if (valuetype == napi_object) {
-      napi_value track_whitespace_changes_prop;
-      bool has_track_whitespace_changes_prop;
-      napi_has_named_property(env, args[2], "track_whitespace_changes", &has_track_whitespace_changes_prop);
-
-      if (has_track_whitespace_changes_prop) {
-        napi_get_named_property(env, args[2], "track_whitespace_changes", &track_whitespace_changes_prop);
-        bool track_whitespace_changes_value;
-        napi_get_value_bool(env, track_whitespace_changes_prop, &track_whitespace_changes_value);
-
-        if (track_whitespace_changes_value) {
-          diff_options.track_whitespace_changes = true;
-        }
-      }
-    }
-  }
+  if (argc >= 3) { ReadDiffOptions(env, args[2], &diff_options); }
 
   AST_DOCUMENT_NODE_T* old_root = herb_parse(old_string, &parser_options, &old_allocator);
   AST_DOCUMENT_NODE_T* new_root = herb_parse(new_string, &parser_options, &new_allocator);
@@ -471,64 +353,7 @@ napi_value Herb_diff(napi_env env, napi_callback_info info) {
 
   herb_diff_result_T* diff_result = herb_diff(old_root, new_root, &diff_options, &diff_allocator);
 
-  napi_value result;
-  napi_create_object(env, &result);
-
-  napi_value identical;
-  napi_get_boolean(env, diff_result->trees_identical, &identical);
-  napi_set_named_property(env, result, "identical", identical);
-
-  size_t operation_count = herb_diff_operation_count(diff_result);
-
-  napi_value operations;
-  napi_create_array_with_length(env, operation_count, &operations);
-
-  for (size_t index = 0; index < operation_count; index++) {
-    const herb_diff_operation_T* operation = herb_diff_operation_at(diff_result, index);
-
-    napi_value operation_object;
-    napi_value type_val;
-    napi_value path;
-
-    napi_create_object(env, &operation_object);
-    napi_create_string_utf8(env, herb_diff_operation_type_to_string(operation->type), NAPI_AUTO_LENGTH, &type_val);
-    napi_set_named_property(env, operation_object, "type", type_val);
-    napi_create_array_with_length(env, operation->path.depth, &path);
-
-    for (uint16_t path_index = 0; path_index < operation->path.depth; path_index++) {
-      napi_value path_val;
-      napi_create_uint32(env, operation->path.indices[path_index], &path_val);
-      napi_set_element(env, path, path_index, path_val);
-    }
-
-    napi_set_named_property(env, operation_object, "path", path);
-
-    if (operation->old_node != NULL) {
-      napi_set_named_property(env, operation_object, "oldNode", NodeFromCStruct(env, (AST_NODE_T*) operation->old_node, &HERB_DEFAULT_PARSER_OPTIONS));
-    } else {
-      napi_value null_val;
-      napi_get_null(env, &null_val);
-      napi_set_named_property(env, operation_object, "oldNode", null_val);
-    }
-
-    if (operation->new_node != NULL) {
-      napi_set_named_property(env, operation_object, "newNode", NodeFromCStruct(env, (AST_NODE_T*) operation->new_node, &HERB_DEFAULT_PARSER_OPTIONS));
-    } else {
-      napi_value null_val;
-      napi_get_null(env, &null_val);
-      napi_set_named_property(env, operation_object, "newNode", null_val);
-    }
-
-    napi_value old_index_val, new_index_val;
-    napi_create_uint32(env, operation->old_index, &old_index_val);
-    napi_create_uint32(env, operation->new_index, &new_index_val);
-    napi_set_named_property(env, operation_object, "oldIndex", old_index_val);
-    napi_set_named_property(env, operation_object, "newIndex", new_index_val);
-
-    napi_set_element(env, operations, (uint32_t) index, operation_object);
-  }
-
-  napi_set_named_property(env, result, "operations", operations);
+  napi_value result = CreateDiffResult(env, diff_result);
 
   ast_node_free((AST_NODE_T*) old_root, &old_allocator);
   ast_node_free((AST_NODE_T*) new_root, &new_allocator);
@@ -549,12 +374,20 @@ napi_value Init(napi_env env, napi_value exports) {
     { "lex", nullptr, Herb_lex, nullptr, nullptr, nullptr, napi_default, nullptr },
     { "extractRuby", nullptr, Herb_extract_ruby, nullptr, nullptr, nullptr, napi_default, nullptr },
     { "extractHTML", nullptr, Herb_extract_html, nullptr, nullptr, nullptr, napi_default, nullptr },
+    { "scanRenders", nullptr, Herb_scan_renders, nullptr, nullptr, nullptr, napi_default, nullptr },
     { "diff", nullptr, Herb_diff, nullptr, nullptr, nullptr, napi_default, nullptr },
     { "version", nullptr, Herb_version, nullptr, nullptr, nullptr, napi_default, nullptr },
     { "parseRuby", nullptr, Herb_parse_ruby, nullptr, nullptr, nullptr, napi_default, nullptr },
+    { "parseBinary", nullptr, Herb_parse_binary, nullptr, nullptr, nullptr, napi_default, nullptr },
+    { "lexAsync", nullptr, Herb_lex_async, nullptr, nullptr, nullptr, napi_default, nullptr },
+    { "parseAsync", nullptr, Herb_parse_async, nullptr, nullptr, nullptr, napi_default, nullptr },
+    { "parseManyAsync", nullptr, Herb_parse_many_async, nullptr, nullptr, nullptr, napi_default, nullptr },
+    { "extractRubyAsync", nullptr, Herb_extract_ruby_async, nullptr, nullptr, nullptr, napi_default, nullptr },
+    { "diffAsync", nullptr, Herb_diff_async, nullptr, nullptr, nullptr, napi_default, nullptr },
   };
 
   napi_define_properties(env, exports, sizeof(descriptors) / sizeof(descriptors[0]), descriptors);
+  napi_set_named_property(env, exports, "Session", DefineSessionClass(env));
 
   return exports;
 }
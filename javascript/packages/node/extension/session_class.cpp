@@ -0,0 +1,180 @@
+extern "C" {
+#include "../extension/libherb/include/ast/ast_nodes.h"
+#include "../extension/libherb/include/herb.h"
+#include "../extension/libherb/include/session.h"
+}
+
+#include "extension_helpers.h"
+#include "session_class.h"
+
+#include <node_api.h>
+#include <stdlib.h>
+
+// `Session` wraps a herb_session_T so that repeated parses reuse one arena. The parse result is converted to JS
+// values before returning, so the document only has to live until the next parse.
+
+static void Session_finalize(napi_env env, void* data, void* hint) {
+  herb_session_T* session = (herb_session_T*) data;
+
+  herb_session_deinit(session);
+  free(session);
+}
+
+static herb_session_T* UnwrapSession(napi_env env, napi_value object) {
+  herb_session_T* session = nullptr;
+
+  if (napi_unwrap(env, object, (void**) &session) != napi_ok || session == nullptr) {
+    napi_throw_type_error(env, nullptr, "Expected a Session");
+    return nullptr;
+  }
+
+  return session;
+}
+
+static void ReadSessionOptions(napi_env env, napi_value object, herb_session_options_T* options) {
+  napi_valuetype valuetype;
+  napi_typeof(env, object, &valuetype);
+
+  if (valuetype != napi_object) { return; }
+
+  napi_value prop;
+  bool has_prop;
+
+  napi_has_named_property(env, object, "trim_interval", &has_prop);
+  if (has_prop) {
+    napi_get_named_property(env, object, "trim_interval", &prop);
+    uint32_t value;
+    if (napi_get_value_uint32(env, prop, &value) == napi_ok) { options->trim_interval = value; }
+  }
+
+  napi_has_named_property(env, object, "max_retained_bytes", &has_prop);
+  if (has_prop) {
+    napi_get_named_property(env, object, "max_retained_bytes", &prop);
+    double value;
+    if (napi_get_value_double(env, prop, &value) == napi_ok && value >= 0) {
+      options->max_retained_bytes = (size_t) value;
+    }
+  }
+}
+
+static napi_value Session_constructor(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value args[1];
+  napi_value self;
+  napi_get_cb_info(env, info, &argc, args, &self, nullptr);
+
+  herb_session_options_T options = HERB_DEFAULT_SESSION_OPTIONS;
+  if (argc >= 1) { ReadSessionOptions(env, args[0], &options); }
+
+  herb_session_T* session = (herb_session_T*) malloc(sizeof(herb_session_T));
+
+  if (session == nullptr || !herb_session_init(session, &options)) {
+    free(session);
+    napi_throw_error(env, nullptr, "Failed to initialize session");
+    return nullptr;
+  }
+
+  if (napi_wrap(env, self, session, Session_finalize, nullptr, nullptr) != napi_ok) {
+    herb_session_deinit(session);
+    free(session);
+    napi_throw_error(env, nullptr, "Failed to wrap session");
+    return nullptr;
+  }
+
+  return self;
+}
+
+static napi_value Session_parse(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value args[2];
+  napi_value self;
+  napi_get_cb_info(env, info, &argc, args, &self, nullptr);
+
+  herb_session_T* session = UnwrapSession(env, self);
+  if (!session) { return nullptr; }
+
+  if (argc < 1) {
+    napi_throw_error(env, nullptr, "Wrong number of arguments");
+    return nullptr;
+  }
+
+  char* string = CheckString(env, args[0]);
+  if (!string) { return nullptr; }
+
+  parser_options_T parser_options = HERB_DEFAULT_PARSER_OPTIONS;
+  if (argc >= 2) { ReadParserOptions(env, args[1], &parser_options); }
+
+  uint32_t error_count = 0;
+  parser_options.error_count = &error_count;
+
+  AST_DOCUMENT_NODE_T* root = herb_session_parse(session, string, &parser_options);
+  napi_value result = CreateParseResult(env, root, args[0], &parser_options);
+
+  free(string);
+
+  return result;
+}
+
+static napi_value Session_reset(napi_env env, napi_callback_info info) {
+  napi_value self;
+  napi_get_cb_info(env, info, nullptr, nullptr, &self, nullptr);
+
+  herb_session_T* session = UnwrapSession(env, self);
+  if (!session) { return nullptr; }
+
+  herb_session_reset(session);
+
+  napi_value undefined;
+  napi_get_undefined(env, &undefined);
+
+  return undefined;
+}
+
+static void SetSizeProperty(napi_env env, napi_value object, const char* name, size_t value) {
+  napi_value number;
+  napi_create_double(env, (double) value, &number);
+  napi_set_named_property(env, object, name, number);
+}
+
+static napi_value Session_stats(napi_env env, napi_callback_info info) {
+  napi_value self;
+  napi_get_cb_info(env, info, nullptr, nullptr, &self, nullptr);
+
+  herb_session_T* session = UnwrapSession(env, self);
+  if (!session) { return nullptr; }
+
+  herb_session_stats_T stats = herb_session_stats(session);
+
+  napi_value result;
+  napi_create_object(env, &result);
+
+  SetSizeProperty(env, result, "parse_count", stats.parse_count);
+  SetSizeProperty(env, result, "pages", stats.pages);
+  SetSizeProperty(env, result, "capacity", stats.capacity);
+  SetSizeProperty(env, result, "used", stats.used);
+  SetSizeProperty(env, result, "high_water_mark", stats.high_water_mark);
+
+  return result;
+}
+
+napi_value DefineSessionClass(napi_env env) {
+  napi_property_descriptor properties[] = {
+    { "parse", nullptr, Session_parse, nullptr, nullptr, nullptr, napi_default, nullptr },
+    { "reset", nullptr, Session_reset, nullptr, nullptr, nullptr, napi_default, nullptr },
+    { "stats", nullptr, Session_stats, nullptr, nullptr, nullptr, napi_default, nullptr },
+  };
+
+  napi_value constructor;
+  napi_define_class(
+    env,
+    "Session",
+    NAPI_AUTO_LENGTH,
+    Session_constructor,
+    nullptr,
+    sizeof(properties) / sizeof(properties[0]),
+    properties,
+    &constructor
+  );
+
+  return constructor;
+}
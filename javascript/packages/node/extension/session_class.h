@@ -0,0 +1,8 @@
+#ifndef HERB_NODE_SESSION_CLASS_H
+#define HERB_NODE_SESSION_CLASS_H
+
+#include <node_api.h>
+
+napi_value DefineSessionClass(napi_env env);
+
+#endif
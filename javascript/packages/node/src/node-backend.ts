@@ -2,7 +2,37 @@ import { readFileSync } from "node:fs"
 
 import packageJSON from "../package.json" with { type: "json" }
 
-import { HerbBackend, LexResult, ParseResult } from "@herb-tools/core"
+import {
+  HerbBackend,
+  LexResult,
+  ParseResult,
+  DEFAULT_PARSER_OPTIONS,
+  DEFAULT_EXTRACT_RUBY_OPTIONS,
+  ensureString,
+} from "@herb-tools/core"
+
+import type {
+  DiffOptions,
+  DiffResult,
+  ExtractRubyOptions,
+  LibHerbBackend,
+  ParseOptions,
+  ParseResultFor,
+  SerializedLexResult,
+  SerializedParseResult,
+} from "@herb-tools/core"
+
+/**
+ * Functions only the native extension provides. They run libherb on the libuv threadpool
+ * and resolve once the result has been converted on the main thread.
+ */
+interface LibHerbNodeAsyncFunctions {
+  lexAsync: (source: string) => Promise<SerializedLexResult>
+  parseAsync: (source: string, options?: ParseOptions) => Promise<SerializedParseResult>
+  parseManyAsync: (sources: string[], options?: ParseOptions) => Promise<SerializedParseResult[]>
+  extractRubyAsync: (source: string, options?: ExtractRubyOptions) => Promise<string>
+  diffAsync: (oldSource: string, newSource: string, options?: DiffOptions) => Promise<DiffResult>
+}
 
 export class HerbBackendNode extends HerbBackend {
   lexFile(path: string): LexResult {
@@ -13,7 +43,82 @@ export class HerbBackendNode extends HerbBackend {
     return this.parse(readFileSync(path, "utf-8"))
   }
 
+  /**
+   * Lexes the given source string without blocking the event loop.
+   * @param source - The source code to lex.
+   * @returns A promise resolving to a `LexResult` instance.
+   * @throws Error if the backend is not loaded.
+   */
+  async lexAsync(source: string): Promise<LexResult> {
+    const backend = this.asyncBackend()
+
+    return LexResult.from(await backend.lexAsync(ensureString(source)))
+  }
+
+  /**
+   * Parses the given source string without blocking the event loop.
+   * @param source - The source code to parse.
+   * @param options - Optional parsing options.
+   * @returns A promise resolving to a `ParseResult` instance.
+   * @throws Error if the backend is not loaded.
+   */
+  async parseAsync<const Options extends ParseOptions>(source: string, options?: Options): Promise<ParseResultFor<Options>> {
+    const backend = this.asyncBackend()
+    const mergedOptions = { ...DEFAULT_PARSER_OPTIONS, ...options }
+
+    return ParseResult.from(await backend.parseAsync(ensureString(source), mergedOptions)) as ParseResultFor<Options>
+  }
+
+  /**
+   * Parses several source strings in parallel on the libuv threadpool.
+   * @param sources - The source code strings to parse.
+   * @param options - Optional parsing options, applied to every source.
+   * @returns A promise resolving to one `ParseResult` per source, in input order.
+   * @throws Error if the backend is not loaded.
+   */
+  async parseManyAsync<const Options extends ParseOptions>(sources: string[], options?: Options): Promise<ParseResultFor<Options>[]> {
+    const backend = this.asyncBackend()
+    const mergedOptions = { ...DEFAULT_PARSER_OPTIONS, ...options }
+    const results = await backend.parseManyAsync(sources.map((source) => ensureString(source)), mergedOptions)
+
+    return results.map((result) => ParseResult.from(result) as ParseResultFor<Options>)
+  }
+
+  /**
+   * Extracts embedded Ruby code from the given source without blocking the event loop.
+   * @param source - The source code to extract Ruby from.
+   * @param options - Optional extraction options.
+   * @returns A promise resolving to the extracted Ruby code.
+   * @throws Error if the backend is not loaded.
+   */
+  async extractRubyAsync(source: string, options?: ExtractRubyOptions): Promise<string> {
+    const backend = this.asyncBackend()
+    const mergedOptions = { ...DEFAULT_EXTRACT_RUBY_OPTIONS, ...options }
+
+    return backend.extractRubyAsync(ensureString(source), mergedOptions)
+  }
+
+  /**
+   * Diffs two source strings without blocking the event loop.
+   * @param oldSource - The old source code.
+   * @param newSource - The new source code.
+   * @param options - Optional diff options.
+   * @returns A promise resolving to a DiffResult containing the operations.
+   * @throws Error if the backend is not loaded.
+   */
+  async diffAsync(oldSource: string, newSource: string, options?: DiffOptions): Promise<DiffResult> {
+    const backend = this.asyncBackend()
+
+    return backend.diffAsync(ensureString(oldSource), ensureString(newSource), options)
+  }
+
   backendVersion(): string {
     return `${packageJSON.name}@${packageJSON.version}`
   }
+
+  private asyncBackend(): LibHerbBackend & LibHerbNodeAsyncFunctions {
+    this.ensureBackend()
+
+    return this.backend as LibHerbBackend & LibHerbNodeAsyncFunctions
+  }
 }
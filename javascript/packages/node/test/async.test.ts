@@ -0,0 +1,53 @@
+import { describe, test, expect, beforeAll } from "vitest"
+import { Herb } from "../src/index.js"
+
+describe("async API", () => {
+  beforeAll(async () => {
+    await Herb.load()
+  })
+
+  test("parseAsync() resolves to the same tree as parse()", async () => {
+    const source = '<div class="<%= classes %>"><% if user %><b><%= user.name %></b><% end %></div><p>'
+
+    const result = await Herb.parseAsync(source)
+
+    expect(result.value.inspect()).toEqual(Herb.parse(source).value.inspect())
+    expect(result.source).toBe(source)
+  })
+
+  test("parseManyAsync() resolves to results in input order", async () => {
+    const sources = ["<h1>One</h1>", "<h2><%= two %></h2>", "<div>", ""]
+
+    const results = await Herb.parseManyAsync(sources, { track_whitespace: true })
+
+    expect(results).toHaveLength(sources.length)
+
+    results.forEach((result, index) => {
+      expect(result.source).toBe(sources[index])
+      expect(result.value.inspect()).toEqual(Herb.parse(sources[index], { track_whitespace: true }).value.inspect())
+    })
+  })
+
+  test("lexAsync() resolves to the same tokens as lex()", async () => {
+    const source = "<div><%= title %></div>"
+
+    const result = await Herb.lexAsync(source)
+
+    expect(result.value.inspect()).toEqual(Herb.lex(source).value.inspect())
+  })
+
+  test("extractRubyAsync() passes options through", async () => {
+    expect(await Herb.extractRubyAsync("<% x = 1 %> <% y = 2 %>", { semicolons: false })).toBe("   x = 1       y = 2   ")
+  })
+
+  test("diffAsync() resolves to the same operations as diff()", async () => {
+    const oldSource = "<div><p>Hello</p></div>"
+    const newSource = "<div><p>World</p></div>"
+
+    expect(await Herb.diffAsync(oldSource, newSource)).toEqual(Herb.diff(oldSource, newSource))
+  })
+
+  test("parseManyAsync() rejects non-string sources", async () => {
+    await expect(Herb.parseManyAsync([1 as any])).rejects.toThrow()
+  })
+})
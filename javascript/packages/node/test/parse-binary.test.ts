@@ -0,0 +1,33 @@
+import { describe, test, expect, beforeAll } from "vitest"
+import { Herb, DocumentNode } from "../src/index.js"
+
+describe("parseBinary", () => {
+  beforeAll(async () => {
+    await Herb.load()
+  })
+
+  test("parseBinary() decodes to the same tree as parse()", () => {
+    const source = '<div class="<%= classes %>">\n  <% if user %><b>Hello <%= user.name %></b><% end %>\n</div>\n<p>'
+
+    const expected = Herb.parse(source).value
+    const actual = DocumentNode.from(Herb.parseBinary(source))
+
+    expect(actual.inspect()).toEqual(expected.inspect())
+    expect(actual.recursiveErrors().map((error) => error.type)).toEqual(
+      expected.recursiveErrors().map((error) => error.type),
+    )
+  })
+
+  test("parseBinary() returns nodes that decode their fields on access", () => {
+    const document = Herb.parseBinary("<h1><%= title %></h1>")
+
+    expect(document.type).toBe("AST_DOCUMENT_NODE")
+    expect(document.children).toHaveLength(1)
+
+    const element = document.children[0] as any
+
+    expect(element.type).toBe("AST_HTML_ELEMENT_NODE")
+    expect(element.tag_name.value).toBe("h1")
+    expect(element.location).toEqual({ start: { line: 1, column: 0 }, end: { line: 1, column: 21 } })
+  })
+})
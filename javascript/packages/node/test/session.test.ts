@@ -0,0 +1,58 @@
+import { describe, test, expect, beforeAll } from "vitest"
+import { Herb } from "../src/index.js"
+
+describe("Session", () => {
+  beforeAll(async () => {
+    await Herb.load()
+  })
+
+  test("parse() returns the same tree as Herb.parse()", () => {
+    const session = Herb.createSession()
+    const source = '<div class="<%= classes %>"><% if user %><b><%= user.name %></b><% end %></div><p>'
+
+    expect(session.parse(source).value.inspect()).toEqual(Herb.parse(source).value.inspect())
+    expect(session.parse(source, { track_whitespace: true }).value.inspect()).toEqual(
+      Herb.parse(source, { track_whitespace: true }).value.inspect(),
+    )
+
+    session.dispose()
+  })
+
+  test("results stay valid after the next parse", () => {
+    const session = Herb.createSession()
+
+    const first = session.parse("<h1><%= title %></h1>")
+    const second = session.parse("<div>")
+
+    expect(first.value.inspect()).toEqual(Herb.parse("<h1><%= title %></h1>").value.inspect())
+    expect(first.successful).toBe(true)
+    expect(second.failed).toBe(true)
+
+    session.dispose()
+  })
+
+  test("keeps its arena pages between parses", () => {
+    const session = Herb.createSession({ trim_interval: 0 })
+    const source = "<div><%= content %></div>\n".repeat(1000)
+
+    session.parse(source)
+    const { capacity } = session.stats()
+
+    for (let i = 0; i < 10; i++) session.parse(source)
+
+    expect(session.stats().parse_count).toBe(11)
+    expect(session.stats().capacity).toBe(capacity)
+
+    session.reset()
+    expect(session.stats().used).toBe(0)
+
+    session.dispose()
+  })
+
+  test("throws once disposed", () => {
+    const session = Herb.createSession()
+    session.dispose()
+
+    expect(() => session.parse("<div></div>")).toThrow("Session has been disposed")
+  })
+})
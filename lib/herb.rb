@@ -15,6 +15,7 @@ require_relative "herb/parser_options"
 require_relative "herb/parse_result"
 require_relative "herb/diff_operation"
 require_relative "herb/diff_result"
+require_relative "herb/render_scan"
 
 require_relative "herb/ast"
 require_relative "herb/ast/node"
@@ -6,7 +6,7 @@ module Herb
     class ERBContentNode < Node
       #: () -> Prism::node?
       def parsed_prism_node
-        erb_content = @content&.value&.strip
+        erb_content = content&.value&.strip
         return nil unless erb_content
 
         begin
@@ -11,7 +11,7 @@ require_relative "engine/slot_visitor"
 class Herb::CLI
   include Herb::Colors
 
-  attr_accessor :json, :silent, :log_file, :no_timing, :local, :escape, :no_escape, :freeze, :debug, :tool, :strict, :analyze, :track_whitespace, :track_locations, :verbose, :isolate, :arena_stats, :leak_check, :action_view_helpers, :trim, :optimize, :slots, :file_timeout
+  attr_accessor :json, :silent, :log_file, :no_timing, :local, :escape, :no_escape, :freeze, :debug, :tool, :strict, :analyze, :track_whitespace, :track_locations, :verbose, :isolate, :arena_stats, :leak_check, :action_view_helpers, :trim, :optimize, :slots, :file_timeout, :threads, :cache_directory
 
   def initialize(args)
     @args = args
@@ -159,6 +159,8 @@ class Herb::CLI
                   project.verbose = verbose || ci?
                   project.isolate = isolate
                   project.file_timeout = file_timeout if file_timeout
+                  project.threads = threads
+                  project.cache_directory = cache_directory
                   project.validate_ruby = true
                   project.arena_stats = arena_stats
                   project.leak_check = leak_check
@@ -269,6 +271,14 @@ class Herb::CLI
         self.isolate = true
       end
 
+      parser.on("--threads", "Analyze files in threads instead of worker processes (for analyze command)") do
+        self.threads = true
+      end
+
+      parser.on("--cache [DIR]", "Reuse results of unchanged files from DIR (for analyze command) (default: #{Herb::Project::DEFAULT_CACHE_DIRECTORY})") do |directory|
+        self.cache_directory = directory || Herb::Project::DEFAULT_CACHE_DIRECTORY
+      end
+
       parser.on("--timeout SECONDS", Float, "Per-file timeout for parse + compile (for analyze command) (default: #{Herb::Project::DEFAULT_FILE_TIMEOUT})") do |seconds|
         self.file_timeout = seconds
       end
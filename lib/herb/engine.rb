@@ -11,6 +11,7 @@ require_relative "engine/report/session"
 require_relative "engine/context_aware"
 require_relative "engine/diagnostics"
 require_relative "engine/compiler"
+require_relative "engine/compile_cache"
 require_relative "engine/error_formatter"
 require_relative "engine/errors"
 require_relative "engine/parse_error"
@@ -79,52 +80,33 @@ module Herb
       postamble = properties[:postamble] || "#{@bufvar}.to_s\n"
       preamble = "#{preamble}; " unless preamble.empty? || preamble.end_with?(";", " ", "\n")
 
-      @src << "# frozen_string_literal: true\n" if @freeze
-
-      parse_result = ::Herb.parse(input, **parse_options, track_whitespace: true)
-      parser_errors = parse_result.errors
+      @compile_cache = compile_cache_for(properties)
+      cache_key = @compile_cache && compile_cache_key(input, properties)
+      cached = cache_key && @compile_cache.read(cache_key)
 
-      if parser_errors.any?
-        handle_parser_errors(parser_errors, input, parse_result.value)
+      if cached
+        @src << cached
       else
-        @visitors.each do |visitor|
-          visitor.inherit_context(@context) if visitor.is_a?(ContextAware)
-
-          parse_result.value.accept(visitor)
-        end
-
-        compiler = compiler_class.new(self, properties)
+        start = @src.length
 
-        parse_result.value.accept(compiler)
-
-        static_body = buffer_required?(properties) ? nil : compile_static_body(compiler)
-
-        if static_body
-          @src << static_body
-        else
-          write_buffer_prelude(properties, preamble)
-
-          report(input)
-
-          compiler.generate_output
+        compile_template(input, properties, preamble, postamble)
 
-          @src << "\n" unless @src.end_with?("\n")
-          add_postamble(postamble)
-
-          @src << "; ensure\n  #{@bufvar} = __original_outvar\nend\n" if properties[:ensure]
-
-          insert_herb_alias!
-        end
+        @compile_cache.write(cache_key, @src[start..].to_s) if cache_key && collected_diagnostics.empty?
       end
 
-      if properties.fetch(:validate_ruby, false)
-        ensure_valid_ruby!(@src)
-      end
+      report_compile_cache(cached, cache_key) if @compile_cache
 
       @src.freeze
       freeze
     end
 
+    # Whether a compile can be replayed from `Herb::Engine::CompileCache`. A subclass whose callers
+    # read anything besides `src` off a compiled engine answers false.
+    #: () -> bool
+    def self.compile_cacheable?
+      true
+    end
+
     def self.h(value)
       value.to_s.gsub(/[&<>"']/, ESCAPE_TABLE)
     end
@@ -328,6 +310,51 @@ module Herb
 
     private
 
+    #: (String, Hash[Symbol, untyped], String, String) -> void
+    def compile_template(input, properties, preamble, postamble)
+      @src << "# frozen_string_literal: true\n" if @freeze
+
+      parse_result = ::Herb.parse(input, **parse_options, track_whitespace: true)
+      parser_errors = parse_result.errors
+
+      if parser_errors.any?
+        handle_parser_errors(parser_errors, input, parse_result.value)
+      else
+        @visitors.each do |visitor|
+          visitor.inherit_context(@context) if visitor.is_a?(ContextAware)
+
+          parse_result.value.accept(visitor)
+        end
+
+        compiler = compiler_class.new(self, properties)
+
+        parse_result.value.accept(compiler)
+
+        static_body = buffer_required?(properties) ? nil : compile_static_body(compiler)
+
+        if static_body
+          @src << static_body
+        else
+          write_buffer_prelude(properties, preamble)
+
+          report(input)
+
+          compiler.generate_output
+
+          @src << "\n" unless @src.end_with?("\n")
+          add_postamble(postamble)
+
+          @src << "; ensure\n  #{@bufvar} = __original_outvar\nend\n" if properties[:ensure]
+
+          insert_herb_alias!
+        end
+      end
+
+      if properties.fetch(:validate_ruby, false)
+        ensure_valid_ruby!(@src)
+      end
+    end
+
     #: (Hash[Symbol, untyped]) -> bool
     def buffer_required?(properties)
       return true if properties[:ensure] || properties[:preamble] || properties[:postamble] || properties[:bufval]
@@ -429,7 +456,74 @@ module Herb
     end
 
     def context_options(properties)
-      properties.except(:visitors, :src, :context)
+      properties.except(:visitors, :src, :context, :compile_cache)
+    end
+
+    #: (Hash[Symbol, untyped]) -> CompileCache?
+    def compile_cache_for(properties)
+      cache = properties.fetch(:compile_cache) { default_compile_cache }
+
+      case cache
+      when nil, false then nil
+      when CompileCache then cache
+      else CompileCache.for(File.expand_path(cache.to_s, project_path.to_s))
+      end
+    end
+
+    #: () -> String?
+    def default_compile_cache
+      directory = Herb.configuration.engine_option("compile_cache")
+
+      directory && File.expand_path(directory.to_s, Herb.configuration.project_root.to_s)
+    end
+
+    # Everything besides the visitors that decides what `src` comes out as. The properties go in
+    # whole rather than picked, so an option added later can never be left out of the key by
+    # accident. One that cannot be marshalled, a proc in `context` say, leaves the template
+    # uncached rather than keyed on something that does not describe it.
+    #: (String, Hash[Symbol, untyped]) -> String?
+    def compile_cache_key(input, properties)
+      return nil unless self.class.compile_cacheable?
+
+      visitors = @visitors.compile_cache_key
+
+      return nil unless visitors
+
+      options = properties.except(:visitors, :src, :compile_cache).sort_by { |key, _value| key.to_s }
+      engine_options = Herb.configuration.engine.except("compile_cache").sort
+
+      @compile_cache.key_for(self.class.name, input, @parser_options.sort, options, visitors, engine_options)
+    rescue TypeError
+      nil
+    end
+
+    # One measurement per template rather than a running total, since the report keeps the first
+    # it is given for each template and code. The rate over a boot is the share reading `hit`.
+    #: (String?, String?) -> void
+    def report_compile_cache(cached, cache_key)
+      @compile_cache.bypass unless cache_key
+
+      return unless @visitors.reports_compile_cache?
+
+      outcome = if cache_key
+                  cached ? :hit : :miss
+                else
+                  :bypass
+                end
+
+      Report::Session.record(
+        Herb::Diagnostic.new(
+          template: relative_file_path,
+          message: "compile cache #{outcome}",
+          severity: nil,
+          kind: :metric,
+          origin: "Herb Engine",
+          code: "compile-cache",
+          value: outcome.to_s,
+          phase: :compile,
+          data: { compile_cache: outcome }
+        )
+      )
     end
 
     #: () -> Hash[Symbol, untyped]
@@ -32,6 +32,11 @@ module Herb
         "#<#{self.class.name}>"
       end
 
+      #: () -> String
+      def compile_cache_key
+        inspect
+      end
+
       private
 
       #: (Herb::Token, Herb::Location) -> Herb::AST::HTMLCloseTagNode
@@ -0,0 +1,137 @@
+# frozen_string_literal: true
+# typed: true
+
+require "digest"
+require "fileutils"
+
+module Herb
+  class Engine
+    # Compiled `src` kept on disk between boots, so a template that has not changed since the last
+    # one is read back rather than lexed, parsed, walked by every visitor, and compiled again.
+    #
+    #     Herb::Engine.new(source, filename: path, compile_cache: "tmp/cache/herb")
+    #
+    # or for every engine at once, from `.herb.yml`:
+    #
+    #     engine:
+    #       compile_cache: tmp/cache/herb
+    #
+    # An entry is addressed by a digest of everything the compiled output follows from: the source,
+    # the Herb version, the parser options, the visitor stack, and the engine's own options. Nothing
+    # is ever invalidated, because an input that changed hashes to a different entry, and the old
+    # one is simply never read again. Clearing the directory is always safe.
+    #
+    # Entries are laid out the way bootsnap lays out its own, two hex digits of the digest as a
+    # directory and the rest as the file name, and written to a temporary file that is renamed into
+    # place, so a boot that reads while another writes sees a whole entry or none at all.
+    #
+    # Only a compile that left nothing behind but `src` can be replayed from one. A visitor says it
+    # qualifies by answering `compile_cache_key`, and a stack with any visitor that does not is
+    # compiled every time. So is a template that produced diagnostics, because reporting them is
+    # part of compiling it.
+    class CompileCache
+      FORMAT = 1 #: Integer
+
+      attr_reader :directory #: Pathname
+      attr_reader :hits #: Integer
+      attr_reader :misses #: Integer
+      attr_reader :bypasses #: Integer
+
+      @registry = {} #: Hash[String, CompileCache]
+      @registry_lock = Mutex.new
+
+      # One cache per directory for the whole process, so its counts cover every engine using it.
+      #: ((String | Pathname)) -> CompileCache
+      def self.for(directory)
+        path = File.expand_path(directory.to_s)
+
+        @registry_lock.synchronize { @registry[path] ||= new(path) }
+      end
+
+      #: ((String | Pathname)) -> void
+      def initialize(directory)
+        @directory = Pathname.new(directory)
+        @lock = Mutex.new
+
+        reset_stats!
+      end
+
+      #: (*untyped) -> String
+      def key_for(*parts)
+        Digest::SHA256.hexdigest(Marshal.dump([FORMAT, Herb::VERSION, *parts]))
+      end
+
+      #: (String) -> String?
+      def read(key)
+        src = File.binread(path_for(key)).force_encoding(Encoding::UTF_8)
+
+        @lock.synchronize { @hits += 1 }
+
+        src
+      rescue SystemCallError
+        @lock.synchronize { @misses += 1 }
+
+        nil
+      end
+
+      #: (String, String) -> void
+      def write(key, src)
+        path = path_for(key)
+        temporary = "#{path}.#{Process.pid}.#{Thread.current.object_id}.tmp"
+
+        FileUtils.mkdir_p(File.dirname(path))
+        File.binwrite(temporary, src)
+        File.rename(temporary, path)
+
+        nil
+      rescue SystemCallError
+        FileUtils.rm_f(temporary) if temporary
+
+        nil
+      end
+
+      # A compile that could not use the cache at all, as opposed to one that looked and missed.
+      #: () -> void
+      def bypass
+        @lock.synchronize { @bypasses += 1 }
+
+        nil
+      end
+
+      #: () -> Float
+      def hit_rate
+        lookups = hits + misses
+
+        lookups.zero? ? 0.0 : hits.fdiv(lookups)
+      end
+
+      #: () -> Hash[Symbol, untyped]
+      def stats
+        { hits: hits, misses: misses, bypasses: bypasses, hit_rate: hit_rate }
+      end
+
+      #: () -> void
+      def reset_stats!
+        @lock.synchronize do
+          @hits = 0
+          @misses = 0
+          @bypasses = 0
+        end
+
+        nil
+      end
+
+      #: () -> String
+      def inspect
+        "#<#{self.class.name} #{directory} hits=#{hits} misses=#{misses} bypasses=#{bypasses}>"
+      end
+
+      private
+
+      #: (String) -> String
+      def path_for(key)
+        File.join(directory.to_s, key[0, 2].to_s, key[2..].to_s)
+      end
+    end
+  end
+end
@@ -47,6 +47,10 @@ module Herb
         "#<#{self.class.name} tag_name=#{@tag_name.inspect} attributes=#{@attributes.inspect} content=#{@content.inspect}>"
       end
 
+      def compile_cache_key
+        inspect
+      end
+
       private
 
       #: () -> Herb::AST::RubyLiteralNode
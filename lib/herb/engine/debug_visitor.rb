@@ -110,6 +110,10 @@ module Herb
         "#<#{self.class.name} node=true>"
       end
 
+      def compile_cache_key
+        inspect
+      end
+
       private
 
       def filename
@@ -439,6 +439,12 @@ module Herb
         )
       end
 
+      # What callers want from this is as much the slot visitor's record of the slots as the `src`.
+      #: () -> bool
+      def self.compile_cacheable?
+        false
+      end
+
       #: () -> untyped
       def compiler_class
         Compiler
@@ -81,6 +81,11 @@ module Herb
         "#<#{self.class.name} mode=#{@mode.inspect} ignore=#{@ignore.inspect} file_path=#{context.file_path&.to_s.inspect}>"
       end
 
+      #: () -> String
+      def compile_cache_key
+        inspect
+      end
+
       private
 
       #: (Symbol) -> Symbol
@@ -48,6 +48,14 @@ module Herb
         true
       end
 
+      # Whether each compile read its `src` back from `Herb::Engine::CompileCache` or had to build
+      # it is recorded into the open report session as a measurement, so a boot wrapped in
+      # `Report::Session.capture` says which templates the cache served alongside everything else.
+      #: () -> bool
+      def self.reports_compile_cache?
+        true
+      end
+
       SESSION = "::Herb::Engine::Report::Session"
 
       ASSIGNMENT_NODES = [
@@ -95,6 +103,11 @@ module Herb
         "#<#{self.class.name}>"
       end
 
+      #: () -> String
+      def compile_cache_key
+        inspect
+      end
+
       private
 
       def frame_render(node)
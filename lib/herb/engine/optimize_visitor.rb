@@ -123,6 +123,12 @@ module Herb
         "#<#{self.class.name} verify=true>"
       end
 
+      # `verify` is the only thing besides the template that changes what this compiles to.
+      #: () -> String
+      def compile_cache_key
+        inspect
+      end
+
       private
 
       #: (String?, Herb::Location?) -> void
@@ -41,6 +41,13 @@ module Herb
       def inspect
         "#<#{self.class.name} fatal=#{fatal?}>"
       end
+
+      # A subclass configured with anything besides `fatal`, or that looks past the template it is
+      # given, has to say so here, or return nil to be run on every compile.
+      #: () -> String?
+      def compile_cache_key
+        inspect
+      end
     end
   end
 end
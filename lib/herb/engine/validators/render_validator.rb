@@ -21,6 +21,11 @@ module Herb
           super
         end
 
+        # Whether a partial exists is a question about the disk rather than the template.
+        def compile_cache_key
+          nil
+        end
+
         private
 
         def validate_partial_exists(node)
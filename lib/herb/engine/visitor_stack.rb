@@ -99,6 +99,24 @@ module Herb
         any? { |visitor| visitor.is_a?(anchor) }
       end
 
+      # What the passes contribute to a compile cache key, in order, or nil when any of them leaves
+      # something behind besides the tree it rewrote, or reads something besides the template.
+      #: () -> Array[String]?
+      def compile_cache_key
+        map { |visitor|
+          key = visitor.respond_to?(:compile_cache_key) ? visitor.compile_cache_key : nil
+
+          return nil unless key
+
+          "#{visitor.class.name} #{key}"
+        }
+      end
+
+      #: () -> bool
+      def reports_compile_cache?
+        any? { |visitor| answers?(visitor, :reports_compile_cache?) }
+      end
+
       private
 
       #: ((Integer | Module)) -> Integer
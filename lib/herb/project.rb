@@ -8,13 +8,17 @@ require "pathname"
 require "English"
 require "stringio"
 
+require_relative "project/analysis_cache"
+
 module Herb
   class Project
     include Colors
 
-    attr_accessor :project_path, :output_file, :no_log_file, :no_timing, :silent, :verbose, :isolate, :validate_ruby, :file_paths, :arena_stats, :leak_check, :file_timeout
+    attr_accessor :project_path, :output_file, :no_log_file, :no_timing, :silent, :verbose, :isolate, :validate_ruby, :file_paths, :arena_stats, :leak_check, :file_timeout,
+                  :threads, :cache_directory
 
     DEFAULT_FILE_TIMEOUT = 1 # seconds per file for parse + compile
+    DEFAULT_CACHE_DIRECTORY = "tmp/cache/herb"
 
     # Known error types that indicate issues in the user's template, not bugs in the parser.
     TEMPLATE_ERRORS = [
@@ -216,11 +220,7 @@ module Herb
           end
         end
 
-        ensure_parallel!
-
-        file_results = Parallel.map(files, in_processes: Parallel.processor_count, finish: finish_hook) do |file_path|
-          process_file(file_path)
-        end
+        file_results = analyze_files(finish_hook)
 
         unless silent
           puts "" unless verbose
@@ -333,8 +333,101 @@ module Herb
 
     private
 
-    def process_file(file_path)
-      isolate ? process_file_isolated(file_path) : process_file_direct(file_path)
+    # Reuses the cached result of every file that did not change, and analyzes the rest either in
+    # worker processes or, with `threads`, in threads of this process. Parsing releases the GVL, so
+    # threads parse in parallel without paying for a fork and for shipping each result back.
+    # Only files that crashed or timed out before are forked for crash isolation, unless `isolate`
+    # forks every one of them.
+    def analyze_files(finish_hook)
+      @analysis_cache = build_analysis_cache
+      file_results = Array.new(files.size)
+      pending = []
+
+      files.each_with_index do |file_path, index|
+        lookup = @analysis_cache&.lookup(file_path)
+
+        if lookup&.result
+          file_results[index] = lookup.result
+          finish_hook.call(file_path, index, lookup.result)
+        else
+          pending << [file_path, index, lookup&.suspect || false]
+        end
+      end
+
+      @analysis_cache&.begin!(pending.map(&:first))
+
+      processed = if threads
+                    map_in_threads(pending, finish_hook)
+                  else
+                    ensure_parallel!
+
+                    finish = ->(item, index, result) { finish_hook.call(item.first, index, result) }
+
+                    Parallel.map(pending, in_processes: Parallel.processor_count, finish: finish) do |file_path, _index, suspect|
+                      process_file(file_path, isolated: suspect)
+                    end
+                  end
+
+      pending.zip(processed) do |(_file_path, index, _suspect), result|
+        file_results[index] = result
+        @analysis_cache&.store(result)
+      end
+
+      @analysis_cache&.save
+
+      file_results
+    end
+
+    def map_in_threads(pending, finish_hook)
+      require "etc"
+      require_relative "engine/validators"
+
+      Herb.configuration
+
+      queue = Queue.new
+      pending.each_with_index { |item, position| queue << [item, position] }
+      queue.close
+
+      processed = Array.new(pending.size)
+      lock = Mutex.new
+
+      workers = Array.new([Etc.nprocessors, pending.size].min) do
+        Thread.new do
+          while (work = queue.pop)
+            (file_path, index, suspect), position = work
+            result = process_file(file_path, isolated: suspect)
+
+            lock.synchronize do
+              processed[position] = result
+              finish_hook.call(file_path, index, result)
+            end
+          end
+        end
+      end
+
+      workers.each(&:join)
+
+      processed
+    end
+
+    # Measuring a run is the point of `arena_stats` and `leak_check`, so neither reads from the cache.
+    # Nor does a run whose validators read more than the template, like the render validator looking
+    # for partials on disk, since a file's result could then change while the file did not.
+    def build_analysis_cache
+      return nil unless cache_directory
+      return nil if arena_stats || leak_check
+
+      require_relative "engine/validators"
+
+      return nil unless Herb::Engine::Validators.all.compile_cache_key
+
+      config = configuration.config_path && File.read(configuration.config_path)
+
+      AnalysisCache.new(File.expand_path(cache_directory.to_s, @project_path), [validate_ruby, config])
+    end
+
+    def process_file(file_path, isolated: false)
+      isolate || isolated ? process_file_isolated(file_path) : process_file_direct(file_path)
     end
 
     def process_file_direct(file_path)
@@ -350,7 +443,9 @@ module Herb
       end
 
       Timeout.timeout(file_timeout) do
-        parse_result = Herb.parse(file_content)
+        parse_result = Herb.parse(file_content, timeout: file_timeout)
+
+        raise Timeout::Error if parse_result.value.errors.any? { |error| error.error_name == "TimeoutError" }
 
         if parse_result.failed?
           result[:file_content] = file_content
@@ -611,6 +706,10 @@ module Herb
         puts "  #{label("Skipped")} #{dimmed("#{results.skipped.count} #{pluralize(results.skipped.count, "file")}")}"
       end
 
+      if @analysis_cache
+        puts "  #{label("Cache")} #{stat(@analysis_cache.hits, pluralize(@analysis_cache.hits, "file"), :green)} #{dimmed("reused from #{relative_path(@analysis_cache.path)}")}"
+      end
+
       if duration
         puts "  #{label("Duration")} #{cyan(format_duration(duration))}"
       end
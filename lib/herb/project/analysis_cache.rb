@@ -0,0 +1,139 @@
+# frozen_string_literal: true
+# typed: ignore
+# rbs_inline: disabled
+
+require "digest"
+require "fileutils"
+
+module Herb
+  class Project
+    # Per-file results of `herb analyze` kept on disk between runs, so a file that has not changed
+    # since the last run is reported from its previous result instead of being parsed and compiled
+    # again.
+    #
+    # A file is looked up by its mtime and size first, which costs one `stat`. When those moved but
+    # the content did not, as after a checkout or a `touch`, the SHA256 of the content still finds
+    # the entry and the new mtime is recorded for next time. Everything else the result depends on,
+    # the Herb version, the `.herb.yml`, and the options of the run, goes into the key of the cache
+    # as a whole, and a cache written under a different key is started over.
+    #
+    # The cache also remembers which files could not be analyzed safely in the same process. A
+    # file that crashed or timed out is never reused but marked as a suspect, and so is every file
+    # of a run that never got to save, since one of them took the process down. The next run forks
+    # only for those.
+    class AnalysisCache
+      FORMAT = 1
+      FILE_NAME = "analyze.cache"
+      SUSPECT_STATUSES = [:failed, :timeout].freeze
+
+      Lookup = Struct.new(:result, :suspect, keyword_init: true)
+
+      attr_reader :path, :hits, :misses
+
+      def initialize(directory, key)
+        @path = File.join(directory.to_s, FILE_NAME)
+        @key = Digest::SHA256.hexdigest(Marshal.dump([FORMAT, Herb::VERSION, *key]))
+        @hits = 0
+        @misses = 0
+
+        load
+      end
+
+      def lookup(file_path)
+        previous = @entries[file_path]
+        suspect = @pending.include?(file_path) || SUSPECT_STATUSES.include?(previous&.dig(:result, :status))
+        entry = current(previous, file_path)
+
+        if entry && !SUSPECT_STATUSES.include?(entry[:result][:status])
+          @hits += 1
+          @entries[file_path] = entry
+
+          Lookup.new(result: entry[:result], suspect: suspect)
+        else
+          @misses += 1
+
+          Lookup.new(result: nil, suspect: suspect)
+        end
+      end
+
+      # Records the files about to be analyzed, so that a run that crashes before `save` leaves
+      # them marked as suspects.
+      def begin!(file_paths)
+        @pending = Set.new(file_paths)
+
+        write
+      end
+
+      def store(result)
+        file_path = result[:file_path]
+        stat = File.stat(file_path)
+
+        @entries[file_path] = {
+          mtime: stat.mtime.to_r,
+          size: stat.size,
+          digest: Digest::SHA256.file(file_path).hexdigest,
+          result: result,
+        }
+      rescue SystemCallError
+        @entries.delete(file_path)
+      end
+
+      def save
+        @pending = Set.new
+
+        write
+      end
+
+      def hit_rate
+        lookups = hits + misses
+
+        lookups.zero? ? 0.0 : hits.fdiv(lookups)
+      end
+
+      def inspect
+        "#<#{self.class.name} #{path} entries=#{@entries.size} hits=#{hits} misses=#{misses}>"
+      end
+
+      private
+
+      def load
+        data = Marshal.load(File.binread(path)) # rubocop:disable Security/MarshalLoad
+        data = nil unless data.is_a?(Hash) && data[:key] == @key
+
+        @entries = data ? data[:entries] : {}
+        @pending = data ? data[:pending] : Set.new
+      rescue SystemCallError, ArgumentError, TypeError
+        @entries = {}
+        @pending = Set.new
+      end
+
+      # The entry for the file as it is on disk now, or nil if the file changed since it was stored.
+      def current(entry, file_path)
+        return nil unless entry
+
+        stat = File.stat(file_path)
+
+        return entry if entry[:mtime] == stat.mtime.to_r && entry[:size] == stat.size
+        return nil unless Digest::SHA256.file(file_path).hexdigest == entry[:digest]
+
+        entry.merge(mtime: stat.mtime.to_r, size: stat.size)
+      rescue SystemCallError
+        nil
+      end
+
+      def write
+        temporary = "#{path}.#{Process.pid}.tmp"
+
+        FileUtils.mkdir_p(File.dirname(path))
+        File.binwrite(temporary, Marshal.dump({ key: @key, entries: @entries, pending: @pending }))
+        File.rename(temporary, path)
+
+        nil
+      rescue SystemCallError
+        FileUtils.rm_f(temporary)
+
+        nil
+      end
+    end
+  end
+end
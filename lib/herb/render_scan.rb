@@ -0,0 +1,71 @@
+# frozen_string_literal: true
+# typed: true
+
+module Herb
+  # What `Herb.scan_renders` found in a template: its `render` call sites and its strict locals declaration, read
+  # from the ERB tags alone without building the HTML tree.
+  class RenderScan
+    RenderCall = Data.define(
+      :partial, #: String?
+      :template, #: String?
+      :layout, #: String?
+      :collection, #: String?
+      :object, #: String?
+      :as, #: String?
+      :locals, #: Hash[String, String]
+      :block, #: bool
+      :location #: Herb::Location
+    )
+
+    class RenderCall
+      #: () -> bool
+      def block?
+        block
+      end
+
+      #: () -> Array[String]
+      def local_names
+        locals.keys
+      end
+    end
+
+    StrictLocal = Data.define(
+      :name, #: String
+      :required, #: bool
+      :default_source #: String?
+    )
+
+    attr_reader :render_calls #: Array[RenderCall]
+    attr_reader :strict_locals #: Array[StrictLocal]?
+    attr_reader :strict_locals_location #: Herb::Location?
+
+    #: (Array[RenderCall], Array[StrictLocal]?, bool, Herb::Location?) -> void
+    def initialize(render_calls, strict_locals, keyword_rest, strict_locals_location)
+      @render_calls = render_calls.freeze
+      @strict_locals = strict_locals&.freeze
+      @keyword_rest = keyword_rest
+      @strict_locals_location = strict_locals_location
+      freeze
+    end
+
+    #: () -> bool
+    def strict_locals?
+      !strict_locals.nil?
+    end
+
+    #: () -> bool
+    def keyword_rest?
+      @keyword_rest
+    end
+
+    #: () -> Array[String]
+    def partials
+      render_calls.filter_map(&:partial).uniq
+    end
+
+    #: () -> String
+    def inspect
+      "#<#{self.class.name} render_calls=#{render_calls.size} strict_locals=#{strict_locals&.map(&:name).inspect}>"
+    end
+  end
+end
@@ -97,8 +97,10 @@ fn main() {
     .header(include_dir.join("analyze/analyze.h").to_str().unwrap())
     .header(include_dir.join("herb.h").to_str().unwrap())
     .header(include_dir.join("ast/ast_nodes.h").to_str().unwrap())
+    .header(include_dir.join("ast/ast_serialize.h").to_str().unwrap())
     .header(include_dir.join("errors.h").to_str().unwrap())
     .header(include_dir.join("extract.h").to_str().unwrap())
+    .header(include_dir.join("session.h").to_str().unwrap())
     .header(include_dir.join("lexer/token_struct.h").to_str().unwrap())
     .header(include_dir.join("lib/hb_allocator.h").to_str().unwrap())
     .header(include_dir.join("lib/hb_string.h").to_str().unwrap())
@@ -127,6 +129,7 @@ fn main() {
     .allowlist_type("location_T")
     .allowlist_type("herb_extract_language_T")
     .allowlist_type("herb_extract_ruby_options_T")
+    .allowlist_type("herb_session_.*")
     .allowlist_type("parser_options_T")
     .allowlist_type("prism_serialized_T")
     .allowlist_type("herb_prism_node_T")
@@ -1,3 +1,5 @@
+pub mod binary;
 pub mod nodes;
 
+pub use binary::{BinaryAst, LazyNode};
 pub use nodes::convert_document_node;
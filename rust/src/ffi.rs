@@ -1,6 +1,7 @@
 pub use crate::bindings::{
-  ast_node_free, hb_allocator_T, hb_allocator_destroy, hb_allocator_init, hb_array_get, hb_array_size, hb_buffer_free, hb_buffer_init, hb_buffer_value,
-  hb_string_T, herb_diff, herb_diff_operation_at, herb_diff_operation_count, herb_diff_operation_type_to_string, herb_diff_trees_identical, herb_extract,
-  herb_extract_ruby_to_buffer_with_options, herb_free_ruby_parse_result, herb_free_tokens, herb_lex, herb_parse, herb_parse_ruby, herb_prism_version,
-  herb_version, pm_buffer_free, pm_buffer_t, pm_prettyprint, token_type_to_string, HB_ALLOCATOR_ARENA,
+  ast_node_free, hb_allocator_T, hb_allocator_destroy, hb_allocator_init, hb_array_get, hb_array_size, hb_buffer_free, hb_buffer_init, hb_buffer_length,
+  hb_buffer_value, hb_string_T, herb_diff, herb_diff_operation_at, herb_diff_operation_count, herb_diff_operation_type_to_string, herb_diff_trees_identical,
+  herb_extract, herb_extract_ruby_to_buffer_with_options, herb_free_ruby_parse_result, herb_free_tokens, herb_lex, herb_parse, herb_parse_ruby,
+  herb_prism_version, herb_serialize, herb_session_deinit, herb_session_init, herb_session_parse, herb_session_reset, herb_session_stats, herb_version,
+  pm_buffer_free, pm_buffer_t, pm_prettyprint, token_type_to_string, HB_ALLOCATOR_ARENA,
 };
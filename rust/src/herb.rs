@@ -1,3 +1,4 @@
+use crate::ast::binary::BinaryAst;
 use crate::bindings::{hb_array_T, hb_buffer_T, token_T, AST_NODE_T};
 use crate::convert::token_from_c;
 use crate::{LexResult, ParseResult};
@@ -99,6 +100,33 @@ pub fn lex(source: &str) -> Result<LexResult, String> {
   }
 }
 
+fn c_parser_options(options: &ParserOptions, error_count: *mut u32) -> crate::bindings::parser_options_T {
+  crate::bindings::parser_options_T {
+    track_whitespace: options.track_whitespace,
+    track_locations: options.track_locations,
+    analyze: options.analyze,
+    strict: options.strict,
+    action_view_helpers: options.action_view_helpers,
+    transform_conditionals: options.transform_conditionals,
+    render_nodes: options.render_nodes,
+    strict_locals: options.strict_locals,
+    iteration_nodes: options.iteration_nodes,
+    prism_program: options.prism_program,
+    prism_nodes: options.prism_nodes,
+    prism_nodes_deep: options.prism_nodes_deep,
+    dot_notation_tags: options.dot_notation_tags,
+    html: options.html,
+    start_line: 0,
+    start_column: 0,
+    timeout_ms: options.timeout,
+    max_errors: options.max_errors.unwrap_or(0),
+    erb_recovery_limit: 0,
+    error_count,
+    deadline_ms: 0,
+    deadline: std::ptr::null_mut(),
+  }
+}
+
 pub fn parse(source: &str) -> Result<ParseResult, String> {
   parse_with_options(source, &ParserOptions::default())
 }
@@ -114,28 +142,7 @@ pub fn parse_with_options(source: &str, options: &ParserOptions) -> Result<Parse
       return Err("Failed to initialize allocator".to_string());
     }
 
-    let c_parser_options = crate::bindings::parser_options_T {
-      track_whitespace: options.track_whitespace,
-      track_locations: options.track_locations,
-      analyze: options.analyze,
-      strict: options.strict,
-      action_view_helpers: options.action_view_helpers,
-      transform_conditionals: options.transform_conditionals,
-      render_nodes: options.render_nodes,
-      strict_locals: options.strict_locals,
-      iteration_nodes: options.iteration_nodes,
-      prism_program: options.prism_program,
-      prism_nodes: options.prism_nodes,
-      prism_nodes_deep: options.prism_nodes_deep,
-      dot_notation_tags: options.dot_notation_tags,
-      html: options.html,
-      start_line: 0,
-      start_column: 0,
-      timeout_ms: options.timeout,
-      max_errors: options.max_errors.unwrap_or(0),
-      error_count: &mut error_count,
-      deadline_ms: 0,
-    };
+    let c_parser_options = c_parser_options(options, &mut error_count);
 
     let ast = crate::ffi::herb_parse(c_source.as_ptr(), &c_parser_options, &mut allocator);
 
@@ -161,6 +168,165 @@ pub fn parse_with_options(source: &str, options: &ParserOptions) -> Result<Parse
   }
 }
 
+pub fn parse_binary(source: &str) -> Result<BinaryAst, String> {
+  parse_binary_with_options(source, &ParserOptions::default())
+}
+
+/// Parses `source` and returns the AST in Herb's binary format, decoding nodes lazily instead of converting the
+/// whole tree into Rust structs up front.
+pub fn parse_binary_with_options(source: &str, options: &ParserOptions) -> Result<BinaryAst, String> {
+  unsafe {
+    let c_source = CString::new(source).map_err(|e| e.to_string())?;
+
+    let mut allocator: crate::ffi::hb_allocator_T = std::mem::zeroed();
+    let mut error_count: u32 = 0;
+
+    if !crate::ffi::hb_allocator_init(&mut allocator, crate::ffi::HB_ALLOCATOR_ARENA) {
+      return Err("Failed to initialize allocator".to_string());
+    }
+
+    let c_parser_options = c_parser_options(options, &mut error_count);
+
+    let ast = crate::ffi::herb_parse(c_source.as_ptr(), &c_parser_options, &mut allocator);
+
+    if ast.is_null() {
+      crate::ffi::hb_allocator_destroy(&mut allocator);
+      return Err("Failed to parse source".to_string());
+    }
+
+    let mut buffer: hb_buffer_T = std::mem::zeroed();
+
+    if !crate::ffi::hb_buffer_init(&mut buffer, source.len(), &mut allocator) {
+      crate::ffi::ast_node_free(ast as *mut crate::bindings::AST_NODE_T, &mut allocator);
+      crate::ffi::hb_allocator_destroy(&mut allocator);
+      return Err("Failed to initialize buffer".to_string());
+    }
+
+    crate::ffi::herb_serialize(ast, &mut buffer);
+
+    let bytes = std::slice::from_raw_parts(crate::ffi::hb_buffer_value(&buffer) as *const u8, crate::ffi::hb_buffer_length(&buffer)).to_vec();
+
+    crate::ffi::hb_buffer_free(&mut buffer);
+    crate::ffi::ast_node_free(ast as *mut crate::bindings::AST_NODE_T, &mut allocator);
+    crate::ffi::hb_allocator_destroy(&mut allocator);
+
+    BinaryAst::new(bytes, source)
+  }
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct SessionOptions {
+  /// Every `trim_interval` parses, release arena pages above the largest recent parse. `0` disables it.
+  pub trim_interval: usize,
+  /// Release arena pages beyond this many bytes after every parse. `0` keeps every page.
+  pub max_retained_bytes: usize,
+}
+
+impl Default for SessionOptions {
+  fn default() -> Self {
+    Self {
+      trim_interval: 32,
+      max_retained_bytes: 16 * 1024 * 1024,
+    }
+  }
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct SessionStats {
+  pub parse_count: usize,
+  pub pages: usize,
+  pub capacity: usize,
+  pub used: usize,
+  pub high_water_mark: usize,
+}
+
+/// A long-lived parser that keeps its arena between parses, so repeated parses reuse warm memory instead of
+/// allocating a fresh arena every time.
+pub struct Session {
+  session: crate::bindings::herb_session_T,
+}
+
+impl Session {
+  pub fn new() -> Result<Self, String> {
+    Self::with_options(&SessionOptions::default())
+  }
+
+  pub fn with_options(options: &SessionOptions) -> Result<Self, String> {
+    let c_options = crate::bindings::herb_session_options_T {
+      trim_interval: options.trim_interval,
+      max_retained_bytes: options.max_retained_bytes,
+    };
+
+    unsafe {
+      let mut session: crate::bindings::herb_session_T = std::mem::zeroed();
+
+      if !crate::ffi::herb_session_init(&mut session, &c_options) {
+        return Err("Failed to initialize session".to_string());
+      }
+
+      Ok(Self { session })
+    }
+  }
+
+  pub fn parse(&mut self, source: &str) -> Result<ParseResult, String> {
+    self.parse_with_options(source, &ParserOptions::default())
+  }
+
+  pub fn parse_with_options(&mut self, source: &str, options: &ParserOptions) -> Result<ParseResult, String> {
+    let c_source = CString::new(source).map_err(|e| e.to_string())?;
+    let mut error_count: u32 = 0;
+    let c_parser_options = c_parser_options(options, &mut error_count);
+
+    unsafe {
+      let ast = crate::ffi::herb_session_parse(&mut self.session, c_source.as_ptr(), &c_parser_options);
+
+      if ast.is_null() {
+        return Err("Failed to parse source".to_string());
+      }
+
+      let shared_source: std::sync::Arc<str> = std::sync::Arc::from(source);
+
+      let document_node =
+        crate::ast::convert_document_node(ast as *const std::ffi::c_void, &shared_source).ok_or_else(|| "Failed to convert AST".to_string())?;
+
+      Ok(ParseResult::with_error_count(
+        document_node,
+        source.to_string(),
+        Vec::new(),
+        options,
+        Some(error_count),
+      ))
+    }
+  }
+
+  /// Releases the last parsed document and applies the trimming policy.
+  pub fn reset(&mut self) {
+    unsafe {
+      crate::ffi::herb_session_reset(&mut self.session);
+    }
+  }
+
+  pub fn stats(&self) -> SessionStats {
+    let stats = unsafe { crate::ffi::herb_session_stats(&self.session) };
+
+    SessionStats {
+      parse_count: stats.parse_count,
+      pages: stats.pages,
+      capacity: stats.capacity,
+      used: stats.used,
+      high_water_mark: stats.high_water_mark,
+    }
+  }
+}
+
+impl Drop for Session {
+  fn drop(&mut self) {
+    unsafe {
+      crate::ffi::herb_session_deinit(&mut self.session);
+    }
+  }
+}
+
 pub struct RubyParseResult {
   pointer: *mut crate::bindings::herb_ruby_parse_result_T,
   _source: CString,
@@ -370,8 +536,10 @@ pub fn diff_with_options(old_source: &str, new_source: &str, options: &DiffOptio
       start_column: 0,
       timeout_ms: 1000,
       max_errors: 25,
+      erb_recovery_limit: 0,
       error_count: std::ptr::null_mut(),
       deadline_ms: 0,
+      deadline: std::ptr::null_mut(),
     };
 
     let old_root = crate::ffi::herb_parse(old_c_source.as_ptr(), &parser_options, &mut old_allocator);
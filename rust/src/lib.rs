@@ -27,11 +27,13 @@ pub use range::Range;
 pub use token::Token;
 pub use visitor::Visitor;
 
+pub use ast::{BinaryAst, LazyNode};
 pub use errors::{AnyError, ErrorNode, ErrorType};
 
 pub use herb::{
-  diff, diff_with_options, extract_html, extract_ruby, extract_ruby_with_options, herb_version, lex, parse, parse_ruby, parse_with_options, prism_version,
-  version, DiffOperation, DiffOptions, DiffResult, ExtractRubyOptions, ParserOptions, RubyParseResult,
+  diff, diff_with_options, extract_html, extract_ruby, extract_ruby_with_options, herb_version, lex, parse, parse_binary, parse_binary_with_options,
+  parse_ruby, parse_with_options, prism_version, version, DiffOperation, DiffOptions, DiffResult, ExtractRubyOptions, ParserOptions, RubyParseResult, Session,
+  SessionOptions, SessionStats,
 };
 
 pub const VERSION: &str = "0.10.3";
@@ -0,0 +1,32 @@
+mod common;
+
+use herb::nodes::Node;
+use herb::{parse, parse_binary, Location, Position};
+
+#[test]
+fn test_parse_binary_matches_parse() {
+  common::no_color();
+
+  let source = "<div class=\"<%= classes %>\">\n  <% if user %><b>Hello <%= user.name %></b><% end %>\n</div>\n<p>";
+
+  let expected = parse(source).unwrap();
+  let binary = parse_binary(source).unwrap();
+  let document = binary.document().unwrap();
+
+  assert_eq!(document.tree_inspect(), expected.value.tree_inspect());
+}
+
+#[test]
+fn test_parse_binary_lazy_node() {
+  let binary = parse_binary("<h1><%= title %></h1>").unwrap();
+  let root = binary.root();
+
+  assert_eq!(root.node_type(), "AST_DOCUMENT_NODE");
+
+  let children = root.children();
+
+  assert_eq!(children.len(), 1);
+  assert_eq!(children[0].node_type(), "AST_HTML_ELEMENT_NODE");
+  assert_eq!(children[0].location(), Location::new(Position::new(1, 0), Position::new(1, 21)));
+  assert!(children[0].errors().is_empty());
+}
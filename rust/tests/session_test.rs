@@ -0,0 +1,67 @@
+mod common;
+
+use herb::nodes::Node;
+use herb::{parse, parse_with_options, ParserOptions, Session, SessionOptions};
+
+#[test]
+fn test_session_parse_matches_parse() {
+  common::no_color();
+
+  let mut session = Session::new().unwrap();
+  let source = "<div class=\"<%= classes %>\">\n  <% if user %><b><%= user.name %></b><% end %>\n</div>\n<p>";
+
+  let first = session.parse(source).unwrap();
+  assert_eq!(first.value.tree_inspect(), parse(source).unwrap().value.tree_inspect());
+
+  let options = ParserOptions {
+    track_whitespace: true,
+    ..Default::default()
+  };
+
+  let second = session.parse_with_options(source, &options).unwrap();
+  assert_eq!(second.value.tree_inspect(), parse_with_options(source, &options).unwrap().value.tree_inspect());
+
+  // Results are converted to Rust values, so they outlive the next parse.
+  assert_eq!(first.value.tree_inspect(), parse(source).unwrap().value.tree_inspect());
+}
+
+#[test]
+fn test_session_keeps_arena_pages() {
+  let mut session = Session::with_options(&SessionOptions {
+    trim_interval: 0,
+    ..Default::default()
+  })
+  .unwrap();
+
+  let source = "<div><%= content %></div>\n".repeat(1000);
+
+  session.parse(&source).unwrap();
+  let capacity = session.stats().capacity;
+
+  for _ in 0..10 {
+    session.parse(&source).unwrap();
+  }
+
+  let stats = session.stats();
+  assert_eq!(stats.parse_count, 11);
+  assert_eq!(stats.capacity, capacity);
+
+  session.reset();
+  assert_eq!(session.stats().used, 0);
+}
+
+#[test]
+fn test_session_trims_to_max_retained_bytes() {
+  let mut session = Session::with_options(&SessionOptions {
+    max_retained_bytes: 1,
+    ..Default::default()
+  })
+  .unwrap();
+
+  session.parse(&"<div><%= content %></div>\n".repeat(5000)).unwrap();
+  let pages = session.stats().pages;
+
+  session.parse("<p></p>").unwrap();
+
+  assert!(session.stats().pages < pages);
+}
@@ -33,14 +33,14 @@ static char* extract_string_from_prism_node(pm_node_t* node, hb_allocator_T* all
 static void compute_position_pair(
   const pm_location_t* location,
   const uint8_t* source,
-  const char* original_source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   position_T* out_start,
   position_T* out_end
 ) {
-  *out_start = prism_location_to_position_with_offset(location, original_source, erb_content_offset, source);
+  *out_start = prism_location_to_position_with_offset(location, line_index, erb_content_offset, source);
   pm_location_t end_location = { .start = location->end, .end = location->end };
-  *out_end = prism_location_to_position_with_offset(&end_location, original_source, erb_content_offset, source);
+  *out_end = prism_location_to_position_with_offset(&end_location, line_index, erb_content_offset, source);
 }
 
 static void extract_key_name_location(pm_node_t* key, pm_location_t* out_name_loc) {
@@ -58,7 +58,7 @@ static void extract_key_name_location(pm_node_t* key, pm_location_t* out_name_lo
 static void compute_separator_info(
   pm_assoc_node_t* assoc,
   const uint8_t* source,
-  const char* original_source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   position_T key_end,
   const char** out_separator_string,
@@ -67,7 +67,7 @@ static void compute_separator_info(
   position_T* out_separator_end
 ) {
   *out_separator_end =
-    prism_location_to_position_with_offset(&assoc->value->location, original_source, erb_content_offset, source);
+    prism_location_to_position_with_offset(&assoc->value->location, line_index, erb_content_offset, source);
 
   if (assoc->operator_loc.start != NULL) {
     *out_separator_string = " => ";
@@ -83,7 +83,7 @@ static void compute_separator_info(
     };
 
     *out_separator_start =
-      prism_location_to_position_with_offset(&colon_loc, original_source, erb_content_offset, source);
+      prism_location_to_position_with_offset(&colon_loc, line_index, erb_content_offset, source);
   }
 }
 
@@ -113,7 +113,7 @@ static void extract_delimited_locations(
 static void compute_value_positions(
   pm_node_t* value_node,
   const uint8_t* source,
-  const char* original_source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   position_T* out_value_start,
   position_T* out_value_end,
@@ -131,17 +131,17 @@ static void compute_value_positions(
     compute_position_pair(
       &*opening_loc,
       source,
-      original_source,
+      line_index,
       erb_content_offset,
       out_value_start,
       out_content_start
     );
 
-    compute_position_pair(&*closing_loc, source, original_source, erb_content_offset, out_content_end, out_value_end);
+    compute_position_pair(&*closing_loc, source, line_index, erb_content_offset, out_content_end, out_value_end);
     *out_quoted = true;
   } else {
     const pm_location_t* fallback_loc = content_loc ? content_loc : &value_node->location;
-    compute_position_pair(fallback_loc, source, original_source, erb_content_offset, out_value_start, out_value_end);
+    compute_position_pair(fallback_loc, source, line_index, erb_content_offset, out_value_start, out_value_end);
     *out_content_start = *out_value_start;
     *out_content_end = *out_value_end;
     *out_quoted = false;
@@ -151,7 +151,7 @@ static void compute_value_positions(
 static void fill_attribute_positions(
   pm_assoc_node_t* assoc,
   const uint8_t* source,
-  const char* original_source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   attribute_positions_T* positions
 ) {
@@ -160,7 +160,7 @@ static void fill_attribute_positions(
   compute_position_pair(
     &name_loc,
     source,
-    original_source,
+    line_index,
     erb_content_offset,
     &positions->name_start,
     &positions->name_end
@@ -168,12 +168,12 @@ static void fill_attribute_positions(
 
   position_T key_end;
   pm_location_t key_end_loc = { .start = assoc->key->location.end, .end = assoc->key->location.end };
-  key_end = prism_location_to_position_with_offset(&key_end_loc, original_source, erb_content_offset, source);
+  key_end = prism_location_to_position_with_offset(&key_end_loc, line_index, erb_content_offset, source);
 
   compute_separator_info(
     assoc,
     source,
-    original_source,
+    line_index,
     erb_content_offset,
     key_end,
     &positions->separator_string,
@@ -185,7 +185,7 @@ static void fill_attribute_positions(
   compute_value_positions(
     assoc->value,
     source,
-    original_source,
+    line_index,
     erb_content_offset,
     &positions->value_start,
     &positions->value_end,
@@ -412,7 +412,7 @@ void resolve_nonce_attribute(hb_array_T* attributes, hb_allocator_T* allocator)
 AST_NODE_T* extract_html_attribute_from_assoc(
   pm_assoc_node_t* assoc,
   const uint8_t* source,
-  const char* original_source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   hb_allocator_T* allocator
 ) {
@@ -435,7 +435,7 @@ AST_NODE_T* extract_html_attribute_from_assoc(
     pm_location_t name_loc;
     extract_key_name_location(assoc->key, &name_loc);
     position_T name_start, name_end;
-    compute_position_pair(&name_loc, source, original_source, erb_content_offset, &name_start, &name_end);
+    compute_position_pair(&name_loc, source, line_index, erb_content_offset, &name_start, &name_end);
 
     char* dashed_name = convert_underscores_to_dashes(name_string);
     const char* attribute_name = dashed_name ? dashed_name : name_string;
@@ -485,7 +485,7 @@ AST_NODE_T* extract_html_attribute_from_assoc(
   }
 
   attribute_positions_T positions;
-  fill_attribute_positions(assoc, source, original_source, erb_content_offset, &positions);
+  fill_attribute_positions(assoc, source, line_index, erb_content_offset, &positions);
 
   char* dashed_name = convert_underscores_to_dashes(name_string);
   AST_NODE_T* attribute_node =
@@ -500,7 +500,7 @@ AST_NODE_T* extract_html_attribute_from_assoc(
 hb_array_T* extract_html_attributes_from_keyword_hash(
   pm_keyword_hash_node_t* kw_hash,
   const uint8_t* source,
-  const char* original_source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   hb_allocator_T* allocator
 ) {
@@ -527,7 +527,7 @@ hb_array_T* extract_html_attributes_from_keyword_hash(
           hb_buffer_append(&wrapped, ")");
 
           position_T splat_start =
-            prism_location_to_position_with_offset(&splat->base.location, original_source, erb_content_offset, source);
+            prism_location_to_position_with_offset(&splat->base.location, line_index, erb_content_offset, source);
 
           AST_RUBY_HTML_ATTRIBUTES_SPLAT_NODE_T* splat_node = ast_ruby_html_attributes_splat_node_init(
             hb_string_from_c_string(hb_buffer_value(&wrapped)),
@@ -575,7 +575,7 @@ hb_array_T* extract_html_attributes_from_keyword_hash(
 
                 position_T splat_start = prism_location_to_position_with_offset(
                   &splat->base.location,
-                  original_source,
+                  line_index,
                   erb_content_offset,
                   source
                 );
@@ -610,7 +610,7 @@ hb_array_T* extract_html_attributes_from_keyword_hash(
 
           if (attribute_key_string) {
             attribute_positions_T hash_positions;
-            fill_attribute_positions(hash_assoc, source, original_source, erb_content_offset, &hash_positions);
+            fill_attribute_positions(hash_assoc, source, line_index, erb_content_offset, &hash_positions);
 
             AST_NODE_T* attribute =
               create_attribute_from_value(attribute_key_string, hash_assoc->value, &hash_positions, allocator, true);
@@ -621,7 +621,7 @@ hb_array_T* extract_html_attributes_from_keyword_hash(
         }
       } else {
         AST_NODE_T* attribute =
-          extract_html_attribute_from_assoc(assoc, source, original_source, erb_content_offset, allocator);
+          extract_html_attribute_from_assoc(assoc, source, line_index, erb_content_offset, allocator);
 
         if (attribute) { hb_array_append(attributes, attribute); }
       }
@@ -647,7 +647,7 @@ bool has_html_attributes_in_call(pm_call_node_t* call_node) {
 hb_array_T* extract_html_attributes_from_call_node(
   pm_call_node_t* call_node,
   const uint8_t* source,
-  const char* original_source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   hb_allocator_T* allocator
 ) {
@@ -663,7 +663,7 @@ hb_array_T* extract_html_attributes_from_call_node(
     return extract_html_attributes_from_keyword_hash(
       &synthetic,
       source,
-      original_source,
+      line_index,
       erb_content_offset,
       allocator
     );
@@ -672,7 +672,7 @@ hb_array_T* extract_html_attributes_from_call_node(
   return extract_html_attributes_from_keyword_hash(
     (pm_keyword_hash_node_t*) last_argument,
     source,
-    original_source,
+    line_index,
     erb_content_offset,
     allocator
   );
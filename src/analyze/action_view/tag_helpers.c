@@ -47,19 +47,19 @@ typedef struct {
   char* content_string;
   tag_helper_info_T* info;
   const tag_helper_handler_T* matched_handler;
-  const char* original_source;
+  const line_index_T* line_index;
   size_t erb_content_offset;
 } tag_helper_parse_context_T;
 
 typedef struct {
-  tag_helper_scope_T* scope;
+  const herb_prism_context_T* program;
   hb_array_T* constants;
   size_t from;
   size_t to;
 } local_read_search_T;
 
 static void append_local_read_constant(local_read_search_T* search, pm_constant_id_t constant_id) {
-  pm_constant_t* constant = pm_constant_pool_id_to_constant(&search->scope->parser.constant_pool, constant_id);
+  pm_constant_t* constant = pm_constant_pool_id_to_constant(&search->program->parser.constant_pool, constant_id);
 
   if (!constant || constant->length == 0) { return; }
 
@@ -77,7 +77,7 @@ static void append_local_read_constant(local_read_search_T* search, pm_constant_
 
 static bool search_local_variable_reads(const pm_node_t* node, void* data) {
   local_read_search_T* search = (local_read_search_T*) data;
-  const uint8_t* base = (const uint8_t*) search->scope->buffer.value;
+  const uint8_t* base = (const uint8_t*) search->program->ruby_buf.value;
 
   size_t start = (size_t) (node->location.start - base);
   size_t end = (size_t) (node->location.end - base);
@@ -97,15 +97,15 @@ static bool build_scope_options_from_context(
   size_t from,
   size_t to
 ) {
-  if (!context || !context->tag_helper_scope || !context->tag_helper_scope->root) { return false; }
+  if (!context || !context->ruby_program || !context->ruby_program->root) { return false; }
   if (to <= from) { return false; }
 
-  local_read_search_T search = { .scope = context->tag_helper_scope,
+  local_read_search_T search = { .program = context->ruby_program,
                                  .constants = hb_array_init(4, context->allocator),
                                  .from = from,
                                  .to = to };
 
-  pm_visit_node(context->tag_helper_scope->root, search_local_variable_reads, &search);
+  pm_visit_node(context->ruby_program->root, search_local_variable_reads, &search);
 
   size_t locals_count = hb_array_size(search.constants);
   bool built = false;
@@ -132,23 +132,23 @@ static bool build_scope_options_from_context(
 }
 
 static tag_helper_parse_context_T* parse_tag_helper_content(
-  const char* content_string,
-  const char* original_source,
+  hb_string_T content,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   analyze_ruby_context_T* context,
   hb_allocator_T* allocator
 ) {
-  if (!content_string) { return NULL; }
+  if (hb_string_is_empty(content)) { return NULL; }
 
   tag_helper_parse_context_T* parse_context = hb_allocator_alloc(allocator, sizeof(tag_helper_parse_context_T));
   if (!parse_context) { return NULL; }
 
-  parse_context->content_string = hb_allocator_strdup(allocator, content_string);
+  parse_context->content_string = hb_allocator_strndup(allocator, content.data, content.length);
   parse_context->prism_source = (const uint8_t*) parse_context->content_string;
-  parse_context->original_source = original_source;
+  parse_context->line_index = line_index;
   parse_context->erb_content_offset = erb_content_offset;
 
-  size_t content_length = strlen(parse_context->content_string);
+  size_t content_length = content.length;
 
   pm_options_t options = { 0 };
   bool has_scope_options =
@@ -246,63 +246,40 @@ bool search_tag_helper_node(const pm_node_t* node, void* data) {
   return search_data->found;
 }
 
-position_T byte_offset_to_position(const char* source, size_t offset) {
+position_T byte_offset_to_position(const line_index_T* line_index, size_t offset) {
   position_T position = { .line = 1, .column = 1 };
 
-  if (!source) { return position; }
+  if (!line_index) { return position; }
 
-  for (size_t i = 0; i < offset && source[i] != '\0'; i++) {
-    if (source[i] == '\n') {
-      position.line++;
-      position.column = 1;
-    } else {
-      position.column++;
-    }
-  }
+  position = line_index_position(line_index, offset);
+  position.column++;
 
   return position;
 }
 
 position_T prism_location_to_position_with_offset(
   const pm_location_t* pm_location,
-  const char* original_source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   const uint8_t* erb_content_source
 ) {
   position_T default_position = { .line = 1, .column = 1 };
 
-  if (!pm_location || !pm_location->start || !original_source || !erb_content_source) { return default_position; }
+  if (!pm_location || !pm_location->start || !line_index || !erb_content_source) { return default_position; }
 
   size_t offset_in_erb = (size_t) (pm_location->start - erb_content_source);
   size_t total_offset = erb_content_offset + offset_in_erb;
 
-  size_t source_length = strlen(original_source);
-  if (total_offset > source_length) { return byte_offset_to_position(original_source, erb_content_offset); }
+  if (total_offset > line_index->source.length) { return byte_offset_to_position(line_index, erb_content_offset); }
 
-  return byte_offset_to_position(original_source, total_offset);
+  return byte_offset_to_position(line_index, total_offset);
 }
 
-size_t calculate_byte_offset_from_position(const char* source, position_T position) {
-  if (!source) { return 0; }
-
-  size_t offset = 0;
-  uint32_t line = 1;
-  uint32_t column = 1;
-
-  while (source[offset] != '\0') {
-    if (line == position.line && column == position.column) { return offset; }
+size_t calculate_byte_offset_from_position(const line_index_T* line_index, position_T position) {
+  if (!line_index) { return 0; }
+  if (position.column == 0) { return line_index->source.length; }
 
-    if (source[offset] == '\n') {
-      line++;
-      column = 1;
-    } else {
-      column++;
-    }
-
-    offset++;
-  }
-
-  return offset;
+  return line_index_offset(line_index, (position_T) { .line = position.line, .column = position.column - 1 });
 }
 
 static void prism_node_location_to_positions(
@@ -313,7 +290,7 @@ static void prism_node_location_to_positions(
 ) {
   *out_start = prism_location_to_position_with_offset(
     location,
-    parse_context->original_source,
+    parse_context->line_index,
     parse_context->erb_content_offset,
     parse_context->prism_source
   );
@@ -321,7 +298,7 @@ static void prism_node_location_to_positions(
   pm_location_t end_location = { .start = location->end, .end = location->end };
   *out_end = prism_location_to_position_with_offset(
     &end_location,
-    parse_context->original_source,
+    parse_context->line_index,
     parse_context->erb_content_offset,
     parse_context->prism_source
   );
@@ -529,7 +506,7 @@ static AST_NODE_T* transform_tag_helper_with_attributes(
     attributes = extract_html_attributes_from_call_node(
       parse_context->info->call_node,
       parse_context->prism_source,
-      parse_context->original_source,
+      parse_context->line_index,
       parse_context->erb_content_offset,
       allocator
     );
@@ -1079,7 +1056,7 @@ static hb_array_T* build_asset_tag_attributes(
   hb_array_T* attributes = extract_html_attributes_from_call_node(
     call_node,
     parse_context->prism_source,
-    parse_context->original_source,
+    parse_context->line_index,
     parse_context->erb_content_offset,
     allocator
   );
@@ -1302,7 +1279,7 @@ static AST_NODE_T* transform_erb_block_to_tag_helper(
     attributes = extract_html_attributes_from_call_node(
       parse_context->info->call_node,
       parse_context->prism_source,
-      parse_context->original_source,
+      parse_context->line_index,
       parse_context->erb_content_offset,
       allocator
     );
@@ -1533,7 +1510,7 @@ static AST_NODE_T* transform_link_to_helper(
     attributes = extract_html_attributes_from_call_node(
       info->call_node,
       parse_context->prism_source,
-      parse_context->original_source,
+      parse_context->line_index,
       parse_context->erb_content_offset,
       allocator
     );
@@ -1558,7 +1535,7 @@ static AST_NODE_T* transform_link_to_helper(
 
         position_T position = prism_location_to_position_with_offset(
           &second_arg->location,
-          parse_context->original_source,
+          parse_context->line_index,
           parse_context->erb_content_offset,
           parse_context->prism_source
         );
@@ -1760,22 +1737,24 @@ void transform_tag_helper_array(hb_array_T* array, analyze_ruby_context_T* conte
       token_T* block_content = block_node->content;
 
       if (block_content && !hb_string_is_empty(block_content->value)) {
-        char* block_string = hb_string_to_c_string_using_malloc(block_content->value);
         size_t erb_content_offset = 0;
 
-        if (context->source) {
-          erb_content_offset = calculate_byte_offset_from_position(context->source, block_content->location.start);
+        if (context->line_index) {
+          erb_content_offset = calculate_byte_offset_from_position(context->line_index, block_content->location.start);
         }
 
-        tag_helper_parse_context_T* parse_context =
-          parse_tag_helper_content(block_string, context->source, erb_content_offset, context, context->allocator);
+        tag_helper_parse_context_T* parse_context = parse_tag_helper_content(
+          block_content->value,
+          context->line_index,
+          erb_content_offset,
+          context,
+          context->allocator
+        );
 
         if (parse_context) {
           replacement = transform_erb_block_to_tag_helper(block_node, context, parse_context);
           free_tag_helper_parse_context(parse_context);
         }
-
-        free(block_string);
       }
     } else if (child->type == AST_ERB_CONTENT_NODE) {
       AST_ERB_CONTENT_NODE_T* erb_node = (AST_ERB_CONTENT_NODE_T*) child;
@@ -1793,15 +1772,19 @@ void transform_tag_helper_array(hb_array_T* array, analyze_ruby_context_T* conte
       token_T* erb_content = erb_node->content;
 
       if (erb_content && !hb_string_is_empty(erb_content->value)) {
-        char* erb_string = hb_string_to_c_string_using_malloc(erb_content->value);
         size_t erb_content_offset = 0;
 
-        if (context->source) {
-          erb_content_offset = calculate_byte_offset_from_position(context->source, erb_content->location.start);
+        if (context->line_index) {
+          erb_content_offset = calculate_byte_offset_from_position(context->line_index, erb_content->location.start);
         }
 
-        tag_helper_parse_context_T* parse_context =
-          parse_tag_helper_content(erb_string, context->source, erb_content_offset, context, context->allocator);
+        tag_helper_parse_context_T* parse_context = parse_tag_helper_content(
+          erb_content->value,
+          context->line_index,
+          erb_content_offset,
+          context,
+          context->allocator
+        );
 
         if (parse_context) {
           bool is_multi_source_asset_tag = (strcmp(parse_context->matched_handler->name, "javascript_include_tag") == 0
@@ -1845,7 +1828,7 @@ void transform_tag_helper_array(hb_array_T* array, analyze_ruby_context_T* conte
               attributes = extract_html_attributes_from_call_node(
                 parse_context->info->call_node,
                 parse_context->prism_source,
-                parse_context->original_source,
+                parse_context->line_index,
                 parse_context->erb_content_offset,
                 context->allocator
               );
@@ -1878,8 +1861,6 @@ void transform_tag_helper_array(hb_array_T* array, analyze_ruby_context_T* conte
 
           free_tag_helper_parse_context(parse_context);
         }
-
-        free(erb_string);
       }
     } else if (child->type == AST_HTML_ATTRIBUTE_NODE) {
       AST_HTML_ATTRIBUTE_NODE_T* attribute_node = (AST_HTML_ATTRIBUTE_NODE_T*) child;
@@ -1893,15 +1874,20 @@ void transform_tag_helper_array(hb_array_T* array, analyze_ruby_context_T* conte
           token_T* erb_content = erb_node->content;
 
           if (erb_content && !hb_string_is_empty(erb_content->value)) {
-            char* erb_string = hb_string_to_c_string_using_malloc(erb_content->value);
             size_t erb_content_offset = 0;
 
-            if (context->source) {
-              erb_content_offset = calculate_byte_offset_from_position(context->source, erb_content->location.start);
+            if (context->line_index) {
+              erb_content_offset =
+                calculate_byte_offset_from_position(context->line_index, erb_content->location.start);
             }
 
-            tag_helper_parse_context_T* parse_context =
-              parse_tag_helper_content(erb_string, context->source, erb_content_offset, context, context->allocator);
+            tag_helper_parse_context_T* parse_context = parse_tag_helper_content(
+              erb_content->value,
+              context->line_index,
+              erb_content_offset,
+              context,
+              context->allocator
+            );
 
             if (parse_context && string_equals(parse_context->matched_handler->name, "tag")
                 && parse_context->info->tag_name && string_equals(parse_context->info->tag_name, "attributes")) {
@@ -1911,7 +1897,7 @@ void transform_tag_helper_array(hb_array_T* array, analyze_ruby_context_T* conte
                 attributes = extract_html_attributes_from_call_node(
                   parse_context->info->call_node,
                   parse_context->prism_source,
-                  parse_context->original_source,
+                  parse_context->line_index,
                   parse_context->erb_content_offset,
                   context->allocator
                 );
@@ -1943,8 +1929,6 @@ void transform_tag_helper_array(hb_array_T* array, analyze_ruby_context_T* conte
             } else if (parse_context) {
               free_tag_helper_parse_context(parse_context);
             }
-
-            free(erb_string);
           }
         }
       }
@@ -1955,7 +1939,7 @@ void transform_tag_helper_array(hb_array_T* array, analyze_ruby_context_T* conte
       position_T original_end = child->location.end;
       bool has_trailing = replacement_end.line != original_end.line || replacement_end.column != original_end.column;
 
-      if (has_trailing && context->source && child->type == AST_ERB_BLOCK_NODE) {
+      if (has_trailing && context->line_index && child->type == AST_ERB_BLOCK_NODE) {
         AST_HTML_ELEMENT_NODE_T* element = (AST_HTML_ELEMENT_NODE_T*) replacement;
 
         if (replacement->type == AST_ERB_IF_NODE) {
@@ -1975,11 +1959,11 @@ void transform_tag_helper_array(hb_array_T* array, analyze_ruby_context_T* conte
         if (element->close_tag && element->close_tag->type == AST_ERB_END_NODE) {
           AST_ERB_END_NODE_T* close_erb = (AST_ERB_END_NODE_T*) element->close_tag;
           size_t trailing_start = close_erb->tag_closing->range.to;
-          size_t source_length = strlen(context->source);
+          size_t source_length = context->line_index->source.length;
           size_t trailing_end = trailing_start;
 
           while (trailing_end < source_length) {
-            position_T position = position_from_source_with_offset(context->source, trailing_end);
+            position_T position = line_index_source_position(context->line_index, trailing_end);
 
             if (position.line > original_end.line
                 || (position.line == original_end.line && position.column >= original_end.column)) {
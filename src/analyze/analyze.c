@@ -16,7 +16,6 @@
 #include "../include/ast/ast_node.h"
 #include "../include/ast/ast_nodes.h"
 #include "../include/errors.h"
-#include "../include/extract.h"
 #include "../include/lexer/token_struct.h"
 #include "../include/lib/hb_array.h"
 #include "../include/lib/hb_buffer.h"
@@ -33,34 +32,11 @@
 #include <stdlib.h>
 #include <string.h>
 
-static analyzed_ruby_T* herb_analyze_ruby(hb_string_T source) {
-  analyzed_ruby_T* analyzed = init_analyzed_ruby(source);
-
-  pm_visit_node(analyzed->root, search_if_nodes, analyzed);
-  pm_visit_node(analyzed->root, search_block_nodes, analyzed);
-  pm_visit_node(analyzed->root, search_case_nodes, analyzed);
-  pm_visit_node(analyzed->root, search_case_match_nodes, analyzed);
-  pm_visit_node(analyzed->root, search_while_nodes, analyzed);
-  pm_visit_node(analyzed->root, search_for_nodes, analyzed);
-  pm_visit_node(analyzed->root, search_until_nodes, analyzed);
-  pm_visit_node(analyzed->root, search_begin_nodes, analyzed);
-  pm_visit_node(analyzed->root, search_unless_nodes, analyzed);
-  pm_visit_node(analyzed->root, search_when_nodes, analyzed);
-  pm_visit_node(analyzed->root, search_in_nodes, analyzed);
-
-  search_unexpected_elsif_nodes(analyzed);
-  search_unexpected_else_nodes(analyzed);
-  search_unexpected_end_nodes(analyzed);
-  search_unexpected_when_nodes(analyzed);
-  search_unexpected_in_nodes(analyzed);
-
-  search_unexpected_rescue_nodes(analyzed);
-  search_unexpected_ensure_nodes(analyzed);
-  search_yield_nodes(analyzed->root, analyzed);
-  search_then_keywords(analyzed->root, analyzed);
-  search_unexpected_block_closing_nodes(analyzed);
-
-  if (!analyzed->valid) { pm_visit_node(analyzed->root, search_unclosed_control_flows, analyzed); }
+static analyzed_ruby_T* herb_analyze_ruby(hb_string_T source, hb_allocator_T* allocator) {
+  analyzed_ruby_T* analyzed = init_analyzed_ruby(source, allocator);
+
+  pm_visit_node(analyzed->root, search_ruby_nodes, analyzed);
+  search_unexpected_nodes(analyzed);
 
   return analyzed;
 }
@@ -80,8 +56,11 @@ static bool analyze_erb_content(const AST_NODE_T* node, void* data) {
 
     hb_string_T opening = erb_content_node->tag_opening->value;
 
-    if (!hb_string_equals(opening, hb_string("<%#")) && !hb_string_equals(opening, hb_string("<%graphql"))) {
-      analyzed_ruby_T* analyzed = herb_analyze_ruby(erb_content_node->content->value);
+    bool is_ruby = !hb_string_equals(opening, hb_string("<%#")) && !hb_string_equals(opening, hb_string("<%graphql"));
+
+    // Once past the deadline, the remaining tags are left unanalyzed like comments.
+    if (is_ruby && !parser_options_past_deadline(options)) {
+      analyzed_ruby_T* analyzed = herb_analyze_ruby(erb_content_node->content->value, allocator);
 
       erb_content_node->parsed = true;
       erb_content_node->valid = analyzed->valid;
@@ -760,7 +739,7 @@ static size_t process_block_structure(
   }
 
   hb_array_T* block_arguments =
-    extract_block_arguments_from_erb_node(erb_node, context->source, &block_errors, allocator);
+    extract_block_arguments_from_erb_node(erb_node, context->line_index, &block_errors, allocator);
 
   AST_ERB_BLOCK_NODE_T* block_node = ast_erb_block_node_init(
     token_copy(erb_node->tag_opening, allocator),
@@ -1020,66 +999,11 @@ hb_array_T* rewrite_node_array(AST_NODE_T* node, hb_array_T* array, analyze_ruby
   return new_array;
 }
 
-static tag_helper_scope_T* tag_helper_scope_init(const char* source, hb_allocator_T* allocator) {
-  if (!source) { return NULL; }
-
-  tag_helper_scope_T* scope = hb_allocator_alloc(allocator, sizeof(tag_helper_scope_T));
-
-  if (!scope) { return NULL; }
-
-  memset(scope, 0, sizeof(tag_helper_scope_T));
-
-  if (!hb_buffer_init(&scope->buffer, strlen(source), allocator)) {
-    hb_allocator_dealloc(allocator, scope);
-
-    return NULL;
-  }
-
-  herb_extract_ruby_options_T extract_options = {
-    .semicolons = true,
-    .comments = false,
-    .preserve_positions = true,
-  };
-
-  herb_extract_ruby_to_buffer_with_options(source, &scope->buffer, &extract_options, allocator);
-
-  if (!scope->buffer.value || scope->buffer.length == 0) {
-    hb_buffer_free(&scope->buffer);
-    hb_allocator_dealloc(allocator, scope);
-
-    return NULL;
-  }
-
-  pm_options_partial_script_set(&scope->options, true);
-  pm_parser_init(&scope->parser, (const uint8_t*) scope->buffer.value, scope->buffer.length, &scope->options);
-
-  scope->root = pm_parse(&scope->parser);
-
-  if (!scope->root) {
-    pm_parser_free(&scope->parser);
-    pm_options_free(&scope->options);
-    hb_buffer_free(&scope->buffer);
-    hb_allocator_dealloc(allocator, scope);
-
-    return NULL;
-  }
-
-  return scope;
-}
-
-static void tag_helper_scope_free(tag_helper_scope_T* scope, hb_allocator_T* allocator) {
-  if (!scope) { return; }
-
-  pm_node_destroy(&scope->parser, scope->root);
-  pm_parser_free(&scope->parser);
-  pm_options_free(&scope->options);
-  hb_buffer_free(&scope->buffer);
-  hb_allocator_dealloc(allocator, scope);
-}
-
 void herb_analyze_parse_tree(
   AST_DOCUMENT_NODE_T* document,
   const char* source,
+  const line_index_T* line_index,
+  const herb_prism_context_T* ruby_program,
   const parser_options_T* options,
   hb_allocator_T* allocator
 ) {
@@ -1090,9 +1014,10 @@ void herb_analyze_parse_tree(
     .document = document,
     .parent = NULL,
     .ruby_context_stack = hb_array_init(8, allocator),
-    .tag_helper_scope = NULL,
+    .ruby_program = ruby_program,
     .allocator = allocator,
     .source = source,
+    .line_index = line_index,
     .options = options,
   };
 
@@ -1113,12 +1038,7 @@ void herb_analyze_parse_tree(
   }
 
   if (options && options->action_view_helpers) {
-    context.tag_helper_scope = tag_helper_scope_init(source, allocator);
-
     herb_visit_node((AST_NODE_T*) document, transform_tag_helper_nodes, &context);
-
-    tag_helper_scope_free(context.tag_helper_scope, allocator);
-    context.tag_helper_scope = NULL;
   }
 
   herb_transform_conditional_elements(document, allocator);
@@ -1133,7 +1053,7 @@ void herb_analyze_parse_tree(
 
   herb_visit_node((AST_NODE_T*) document, detect_invalid_erb_structures, &invalid_context);
 
-  herb_analyze_parse_errors(document, source, options, allocator);
+  herb_analyze_parse_errors(document, source, line_index, ruby_program, options, allocator);
 
   herb_parser_match_html_tags_post_analyze(document, options, allocator);
 
@@ -102,23 +102,6 @@ bool has_error_message(analyzed_ruby_T* analyzed, const char* message) {
   return false;
 }
 
-bool search_if_nodes(const pm_node_t* node, void* data) {
-  analyzed_ruby_T* analyzed = (analyzed_ruby_T*) data;
-
-  if (node->type == PM_IF_NODE) {
-    const pm_if_node_t* if_node = (const pm_if_node_t*) node;
-
-    bool has_if_keyword = if_node->if_keyword_loc.start != NULL && if_node->if_keyword_loc.end != NULL;
-    bool has_end_keyword = if_node->end_keyword_loc.start != NULL && if_node->end_keyword_loc.end != NULL;
-
-    if (has_if_keyword && has_end_keyword) { analyzed->if_node_count++; }
-  }
-
-  pm_visit_child_nodes(node, search_if_nodes, analyzed);
-
-  return false;
-}
-
 bool is_do_block(pm_location_t opening_location) {
   size_t length = opening_location.end - opening_location.start;
 
@@ -161,257 +144,87 @@ bool has_valid_block_closing(pm_location_t opening_loc, pm_location_t closing_lo
   return false;
 }
 
-bool search_block_nodes(const pm_node_t* node, void* data) {
-  analyzed_ruby_T* analyzed = (analyzed_ruby_T*) data;
-
-  if (node->type == PM_BLOCK_NODE) {
-    pm_block_node_t* block_node = (pm_block_node_t*) node;
+static bool has_unclosed_block(pm_location_t opening_loc, pm_location_t closing_loc) {
+  bool has_opening = is_do_block(opening_loc) || is_brace_block(opening_loc);
 
-    bool has_opening = is_do_block(block_node->opening_loc) || is_brace_block(block_node->opening_loc);
-    bool is_unclosed = !has_valid_block_closing(block_node->opening_loc, block_node->closing_loc);
-
-    if (has_opening && is_unclosed) { analyzed->block_node_count++; }
-  }
-
-  if (node->type == PM_LAMBDA_NODE) {
-    pm_lambda_node_t* lambda_node = (pm_lambda_node_t*) node;
-
-    bool has_opening = is_do_block(lambda_node->opening_loc) || is_brace_block(lambda_node->opening_loc);
-    bool is_unclosed = !has_valid_block_closing(lambda_node->opening_loc, lambda_node->closing_loc);
-
-    if (has_opening && is_unclosed) { analyzed->block_node_count++; }
-  }
-
-  pm_visit_child_nodes(node, search_block_nodes, analyzed);
-
-  return false;
+  return has_opening && !has_valid_block_closing(opening_loc, closing_loc);
 }
 
-bool search_case_nodes(const pm_node_t* node, void* data) {
-  analyzed_ruby_T* analyzed = (analyzed_ruby_T*) data;
-
-  if (node->type == PM_CASE_NODE) { analyzed->case_node_count++; }
-
-  pm_visit_child_nodes(node, search_case_nodes, analyzed);
-
-  return false;
-}
-
-bool search_case_match_nodes(const pm_node_t* node, void* data) {
-  analyzed_ruby_T* analyzed = (analyzed_ruby_T*) data;
-
-  if (node->type == PM_CASE_MATCH_NODE) { analyzed->case_match_node_count++; }
-
-  pm_visit_child_nodes(node, search_case_match_nodes, analyzed);
-
-  return false;
-}
-
-bool search_while_nodes(const pm_node_t* node, void* data) {
-  analyzed_ruby_T* analyzed = (analyzed_ruby_T*) data;
-
-  if (node->type == PM_WHILE_NODE) { analyzed->while_node_count++; }
-
-  pm_visit_child_nodes(node, search_while_nodes, analyzed);
-
-  return false;
-}
-
-bool search_for_nodes(const pm_node_t* node, void* data) {
-  analyzed_ruby_T* analyzed = (analyzed_ruby_T*) data;
-
-  if (node->type == PM_FOR_NODE) { analyzed->for_node_count++; }
-
-  pm_visit_child_nodes(node, search_for_nodes, analyzed);
-
-  return false;
+static bool has_keyword(pm_location_t location) {
+  return location.start != NULL && location.end != NULL;
 }
 
-bool search_until_nodes(const pm_node_t* node, void* data) {
-  analyzed_ruby_T* analyzed = (analyzed_ruby_T*) data;
-
-  if (node->type == PM_UNTIL_NODE) { analyzed->until_node_count++; }
-
-  pm_visit_child_nodes(node, search_until_nodes, analyzed);
-
-  return false;
-}
-
-bool search_begin_nodes(const pm_node_t* node, void* data) {
-  analyzed_ruby_T* analyzed = (analyzed_ruby_T*) data;
-
-  if (node->type == PM_BEGIN_NODE) { analyzed->begin_node_count++; }
-
-  pm_visit_child_nodes(node, search_begin_nodes, analyzed);
-
-  return false;
-}
-
-bool search_unless_nodes(const pm_node_t* node, void* data) {
-  analyzed_ruby_T* analyzed = (analyzed_ruby_T*) data;
-
-  if (node->type == PM_UNLESS_NODE) {
-    const pm_unless_node_t* unless_node = (const pm_unless_node_t*) node;
-
-    bool has_if_keyword = unless_node->keyword_loc.start != NULL && unless_node->keyword_loc.end != NULL;
-    bool has_end_keyword = unless_node->end_keyword_loc.start != NULL && unless_node->end_keyword_loc.end != NULL;
-
-    if (has_if_keyword && has_end_keyword) { analyzed->unless_node_count++; }
-  }
-
-  pm_visit_child_nodes(node, search_unless_nodes, analyzed);
-
-  return false;
-}
-
-bool search_when_nodes(const pm_node_t* node, void* data) {
-  analyzed_ruby_T* analyzed = (analyzed_ruby_T*) data;
-
-  if (node->type == PM_WHEN_NODE) { analyzed->when_node_count++; }
-
-  pm_visit_child_nodes(node, search_when_nodes, analyzed);
-
-  return false;
-}
-
-bool search_in_nodes(const pm_node_t* node, void* data) {
-  analyzed_ruby_T* analyzed = (analyzed_ruby_T*) data;
+static void count_ruby_node(const pm_node_t* node, analyzed_ruby_T* analyzed) {
+  switch (node->type) {
+    case PM_IF_NODE: {
+      const pm_if_node_t* if_node = (const pm_if_node_t*) node;
 
-  if (node->type == PM_IN_NODE) { analyzed->in_node_count++; }
-  if (node->type == PM_CASE_MATCH_NODE) {
-    const pm_case_match_node_t* case_match_node = (const pm_case_match_node_t*) node;
+      if (has_keyword(if_node->if_keyword_loc) && has_keyword(if_node->end_keyword_loc)) { analyzed->if_node_count++; }
+      if (has_keyword(if_node->then_keyword_loc)) { analyzed->then_keyword_count++; }
 
-    if (case_match_node->predicate != NULL && case_match_node->predicate->type == PM_MATCH_PREDICATE_NODE) {
-      analyzed->in_node_count++;
+      break;
     }
-  }
-
-  pm_visit_child_nodes(node, search_in_nodes, analyzed);
-
-  return false;
-}
 
-bool search_unexpected_elsif_nodes(analyzed_ruby_T* analyzed) {
-  if (has_error_message(analyzed, "unexpected 'elsif', ignoring it")) {
-    analyzed->elsif_node_count++;
-    return true;
-  }
-
-  return false;
-}
+    case PM_UNLESS_NODE: {
+      const pm_unless_node_t* unless_node = (const pm_unless_node_t*) node;
 
-bool search_unexpected_else_nodes(analyzed_ruby_T* analyzed) {
-  if (has_error_message(analyzed, "unexpected 'else', ignoring it")) {
-    analyzed->else_node_count++;
-    return true;
-  }
+      if (has_keyword(unless_node->keyword_loc) && has_keyword(unless_node->end_keyword_loc)) {
+        analyzed->unless_node_count++;
+      }
 
-  return false;
-}
+      if (has_keyword(unless_node->then_keyword_loc)) { analyzed->then_keyword_count++; }
 
-bool search_unexpected_end_nodes(analyzed_ruby_T* analyzed) {
-  if (has_error_message(analyzed, "unexpected 'end', ignoring it")) {
-    if (has_error_message(analyzed, "unexpected '=', ignoring it")) {
-      // `=end`
-      return false;
+      break;
     }
 
-    analyzed->end_count++;
-    return true;
-  }
-
-  return false;
-}
-
-bool search_unexpected_block_closing_nodes(analyzed_ruby_T* analyzed) {
-  if (has_error_message(analyzed, "unexpected '}', ignoring it")) {
-    analyzed->block_closing_count++;
-    return true;
-  }
-
-  return false;
-}
-
-bool search_unexpected_when_nodes(analyzed_ruby_T* analyzed) {
-  if (has_error_message(analyzed, "unexpected 'when', ignoring it")) {
-    analyzed->when_node_count++;
-    return true;
-  }
+    case PM_WHEN_NODE: {
+      const pm_when_node_t* when_node = (const pm_when_node_t*) node;
 
-  return false;
-}
+      analyzed->when_node_count++;
 
-bool search_unexpected_in_nodes(analyzed_ruby_T* analyzed) {
-  if (has_error_message(analyzed, "unexpected 'in', ignoring it")) {
-    analyzed->in_node_count++;
-    return true;
-  }
+      if (has_keyword(when_node->then_keyword_loc)) { analyzed->then_keyword_count++; }
 
-  return false;
-}
-
-bool search_unexpected_rescue_nodes(analyzed_ruby_T* analyzed) {
-  if (has_error_message(analyzed, "unexpected 'rescue', ignoring it")) {
-    analyzed->rescue_node_count++;
-    return true;
-  }
+      break;
+    }
 
-  return false;
-}
+    case PM_BLOCK_NODE: {
+      const pm_block_node_t* block_node = (const pm_block_node_t*) node;
 
-bool search_unexpected_ensure_nodes(analyzed_ruby_T* analyzed) {
-  if (has_error_message(analyzed, "unexpected 'ensure', ignoring it")) {
-    analyzed->ensure_node_count++;
-    return true;
-  }
+      if (has_unclosed_block(block_node->opening_loc, block_node->closing_loc)) { analyzed->block_node_count++; }
 
-  return false;
-}
+      break;
+    }
 
-bool search_yield_nodes(const pm_node_t* node, void* data) {
-  analyzed_ruby_T* analyzed = (analyzed_ruby_T*) data;
+    case PM_LAMBDA_NODE: {
+      const pm_lambda_node_t* lambda_node = (const pm_lambda_node_t*) node;
 
-  if (node->type == PM_YIELD_NODE) { analyzed->yield_node_count++; }
+      if (has_unclosed_block(lambda_node->opening_loc, lambda_node->closing_loc)) { analyzed->block_node_count++; }
 
-  pm_visit_child_nodes(node, search_yield_nodes, analyzed);
+      break;
+    }
 
-  return false;
-}
+    case PM_CASE_MATCH_NODE: {
+      const pm_case_match_node_t* case_match_node = (const pm_case_match_node_t*) node;
 
-bool search_then_keywords(const pm_node_t* node, void* data) {
-  analyzed_ruby_T* analyzed = (analyzed_ruby_T*) data;
+      analyzed->case_match_node_count++;
 
-  switch (node->type) {
-    case PM_IF_NODE: {
-      const pm_if_node_t* if_node = (const pm_if_node_t*) node;
-      if (if_node->then_keyword_loc.start != NULL && if_node->then_keyword_loc.end != NULL) {
-        analyzed->then_keyword_count++;
+      if (case_match_node->predicate != NULL && case_match_node->predicate->type == PM_MATCH_PREDICATE_NODE) {
+        analyzed->in_node_count++;
       }
-      break;
-    }
 
-    case PM_UNLESS_NODE: {
-      const pm_unless_node_t* unless_node = (const pm_unless_node_t*) node;
-      if (unless_node->then_keyword_loc.start != NULL && unless_node->then_keyword_loc.end != NULL) {
-        analyzed->then_keyword_count++;
-      }
       break;
     }
 
-    case PM_WHEN_NODE: {
-      const pm_when_node_t* when_node = (const pm_when_node_t*) node;
-      if (when_node->then_keyword_loc.start != NULL && when_node->then_keyword_loc.end != NULL) {
-        analyzed->then_keyword_count++;
-      }
-      break;
-    }
+    case PM_CASE_NODE: analyzed->case_node_count++; break;
+    case PM_IN_NODE: analyzed->in_node_count++; break;
+    case PM_WHILE_NODE: analyzed->while_node_count++; break;
+    case PM_FOR_NODE: analyzed->for_node_count++; break;
+    case PM_UNTIL_NODE: analyzed->until_node_count++; break;
+    case PM_BEGIN_NODE: analyzed->begin_node_count++; break;
+    case PM_YIELD_NODE: analyzed->yield_node_count++; break;
 
     default: break;
   }
-
-  pm_visit_child_nodes(node, search_then_keywords, analyzed);
-
-  return false;
 }
 
 static bool is_postfix_conditional(const pm_statements_node_t* statements, pm_location_t keyword_location) {
@@ -420,11 +233,7 @@ static bool is_postfix_conditional(const pm_statements_node_t* statements, pm_lo
   return statements->base.location.start < keyword_location.start;
 }
 
-bool search_unclosed_control_flows(const pm_node_t* node, void* data) {
-  analyzed_ruby_T* analyzed = (analyzed_ruby_T*) data;
-
-  if (analyzed->unclosed_control_flow_count >= 2) { return false; }
-
+static void count_unclosed_control_flow(const pm_node_t* node, analyzed_ruby_T* analyzed) {
   switch (node->type) {
     case PM_IF_NODE: {
       const pm_if_node_t* if_node = (const pm_if_node_t*) node;
@@ -512,9 +321,8 @@ bool search_unclosed_control_flows(const pm_node_t* node, void* data) {
 
     case PM_BLOCK_NODE: {
       const pm_block_node_t* block_node = (const pm_block_node_t*) node;
-      bool has_opening = is_do_block(block_node->opening_loc) || is_brace_block(block_node->opening_loc);
 
-      if (has_opening && !has_valid_block_closing(block_node->opening_loc, block_node->closing_loc)) {
+      if (has_unclosed_block(block_node->opening_loc, block_node->closing_loc)) {
         analyzed->unclosed_control_flow_count++;
       }
 
@@ -523,9 +331,8 @@ bool search_unclosed_control_flows(const pm_node_t* node, void* data) {
 
     case PM_LAMBDA_NODE: {
       const pm_lambda_node_t* lambda_node = (const pm_lambda_node_t*) node;
-      bool has_opening = is_do_block(lambda_node->opening_loc) || is_brace_block(lambda_node->opening_loc);
 
-      if (has_opening && !has_valid_block_closing(lambda_node->opening_loc, lambda_node->closing_loc)) {
+      if (has_unclosed_block(lambda_node->opening_loc, lambda_node->closing_loc)) {
         analyzed->unclosed_control_flow_count++;
       }
 
@@ -534,12 +341,70 @@ bool search_unclosed_control_flows(const pm_node_t* node, void* data) {
 
     default: break;
   }
+}
+
+// Counts every construct `herb_analyze_ruby` cares about in a single walk of the Prism tree.
+bool search_ruby_nodes(const pm_node_t* node, void* data) {
+  analyzed_ruby_T* analyzed = (analyzed_ruby_T*) data;
+
+  count_ruby_node(node, analyzed);
 
-  pm_visit_child_nodes(node, search_unclosed_control_flows, analyzed);
+  // Callers only distinguish between zero, one and more than one unclosed control flow.
+  if (!analyzed->valid && analyzed->unclosed_control_flow_count < 2) { count_unclosed_control_flow(node, analyzed); }
+
+  pm_visit_child_nodes(node, search_ruby_nodes, analyzed);
 
   return false;
 }
 
+void search_unexpected_nodes(analyzed_ruby_T* analyzed) {
+  bool unexpected_elsif = false;
+  bool unexpected_else = false;
+  bool unexpected_end = false;
+  bool unexpected_equals = false;
+  bool unexpected_block_closing = false;
+  bool unexpected_when = false;
+  bool unexpected_in = false;
+  bool unexpected_rescue = false;
+  bool unexpected_ensure = false;
+
+  for (const pm_diagnostic_t* error = (const pm_diagnostic_t*) analyzed->parser.error_list.head; error != NULL;
+       error = (const pm_diagnostic_t*) error->node.next) {
+    const char* message = error->message;
+
+    if (string_equals(message, "unexpected 'elsif', ignoring it")) {
+      unexpected_elsif = true;
+    } else if (string_equals(message, "unexpected 'else', ignoring it")) {
+      unexpected_else = true;
+    } else if (string_equals(message, "unexpected 'end', ignoring it")) {
+      unexpected_end = true;
+    } else if (string_equals(message, "unexpected '=', ignoring it")) {
+      unexpected_equals = true;
+    } else if (string_equals(message, "unexpected '}', ignoring it")) {
+      unexpected_block_closing = true;
+    } else if (string_equals(message, "unexpected 'when', ignoring it")) {
+      unexpected_when = true;
+    } else if (string_equals(message, "unexpected 'in', ignoring it")) {
+      unexpected_in = true;
+    } else if (string_equals(message, "unexpected 'rescue', ignoring it")) {
+      unexpected_rescue = true;
+    } else if (string_equals(message, "unexpected 'ensure', ignoring it")) {
+      unexpected_ensure = true;
+    }
+  }
+
+  if (unexpected_elsif) { analyzed->elsif_node_count++; }
+  if (unexpected_else) { analyzed->else_node_count++; }
+  if (unexpected_when) { analyzed->when_node_count++; }
+  if (unexpected_in) { analyzed->in_node_count++; }
+  if (unexpected_rescue) { analyzed->rescue_node_count++; }
+  if (unexpected_ensure) { analyzed->ensure_node_count++; }
+  if (unexpected_block_closing) { analyzed->block_closing_count++; }
+
+  // `=end`
+  if (unexpected_end && !unexpected_equals) { analyzed->end_count++; }
+}
+
 static pm_block_node_t* find_first_block_node(pm_node_t* node) {
   if (!node) { return NULL; }
 
@@ -570,12 +435,12 @@ static position_T prism_to_source_position(
   const uint8_t* prism_pointer,
   const uint8_t* prism_source_start,
   size_t source_base_offset,
-  const char* source
+  const line_index_T* line_index
 ) {
-  if (!source || !prism_source_start) { return (position_T) { .line = 1, .column = 0 }; }
+  if (!line_index || !prism_source_start) { return (position_T) { .line = 1, .column = 0 }; }
 
   size_t prism_offset = (size_t) (prism_pointer - prism_source_start);
-  return byte_offset_to_position(source, source_base_offset + prism_offset);
+  return byte_offset_to_position(line_index, source_base_offset + prism_offset);
 }
 
 static token_T* create_parameter_name_token(
@@ -583,11 +448,11 @@ static token_T* create_parameter_name_token(
   const char* name,
   const uint8_t* prism_source_start,
   size_t source_base_offset,
-  const char* source,
+  const line_index_T* line_index,
   hb_allocator_T* allocator
 ) {
-  position_T start = prism_to_source_position(location.start, prism_source_start, source_base_offset, source);
-  position_T end = prism_to_source_position(location.end, prism_source_start, source_base_offset, source);
+  position_T start = prism_to_source_position(location.start, prism_source_start, source_base_offset, line_index);
+  position_T end = prism_to_source_position(location.end, prism_source_start, source_base_offset, line_index);
 
   return create_synthetic_token(allocator, name, TOKEN_IDENTIFIER, start, end);
 }
@@ -621,7 +486,7 @@ static void append_required_positional(
   hb_array_T* result,
   pm_node_t* node,
   pm_parser_t* parser,
-  const char* source,
+  const line_index_T* line_index,
   size_t source_base_offset,
   const uint8_t* prism_source_start,
   hb_allocator_T* allocator
@@ -631,7 +496,7 @@ static void append_multi_target_parameters(
   hb_array_T* result,
   pm_multi_target_node_t* multi_target,
   pm_parser_t* parser,
-  const char* source,
+  const line_index_T* line_index,
   size_t source_base_offset,
   const uint8_t* prism_source_start,
   hb_allocator_T* allocator
@@ -641,7 +506,7 @@ static void append_multi_target_parameters(
       result,
       multi_target->lefts.nodes[index],
       parser,
-      source,
+      line_index,
       source_base_offset,
       prism_source_start,
       allocator
@@ -661,12 +526,19 @@ static void append_multi_target_parameters(
 
         append_parameter(
           result,
-          create_parameter_name_token(node->location, name, prism_source_start, source_base_offset, source, allocator),
+          create_parameter_name_token(
+            node->location,
+            name,
+            prism_source_start,
+            source_base_offset,
+            line_index,
+            allocator
+          ),
           NULL,
           "rest",
           false,
-          prism_to_source_position(node->location.start, prism_source_start, source_base_offset, source),
-          prism_to_source_position(node->location.end, prism_source_start, source_base_offset, source),
+          prism_to_source_position(node->location.start, prism_source_start, source_base_offset, line_index),
+          prism_to_source_position(node->location.end, prism_source_start, source_base_offset, line_index),
           allocator
         );
 
@@ -680,7 +552,7 @@ static void append_multi_target_parameters(
       result,
       multi_target->rights.nodes[index],
       parser,
-      source,
+      line_index,
       source_base_offset,
       prism_source_start,
       allocator
@@ -692,7 +564,7 @@ static void append_required_positional(
   hb_array_T* result,
   pm_node_t* node,
   pm_parser_t* parser,
-  const char* source,
+  const line_index_T* line_index,
   size_t source_base_offset,
   const uint8_t* prism_source_start,
   hb_allocator_T* allocator
@@ -702,7 +574,7 @@ static void append_required_positional(
       result,
       (pm_multi_target_node_t*) node,
       parser,
-      source,
+      line_index,
       source_base_offset,
       prism_source_start,
       allocator
@@ -721,12 +593,12 @@ static void append_required_positional(
 
   append_parameter(
     result,
-    create_parameter_name_token(node->location, name, prism_source_start, source_base_offset, source, allocator),
+    create_parameter_name_token(node->location, name, prism_source_start, source_base_offset, line_index, allocator),
     NULL,
     "positional",
     true,
-    prism_to_source_position(node->location.start, prism_source_start, source_base_offset, source),
-    prism_to_source_position(node->location.end, prism_source_start, source_base_offset, source),
+    prism_to_source_position(node->location.start, prism_source_start, source_base_offset, line_index),
+    prism_to_source_position(node->location.end, prism_source_start, source_base_offset, line_index),
     allocator
   );
 
@@ -736,7 +608,7 @@ static void append_required_positional(
 hb_array_T* extract_parameters_from_prism(
   pm_parameters_node_t* parameters,
   pm_parser_t* parser,
-  const char* source,
+  const line_index_T* line_index,
   size_t source_base_offset,
   const uint8_t* prism_source_start,
   hb_allocator_T* allocator
@@ -756,7 +628,7 @@ hb_array_T* extract_parameters_from_prism(
       result,
       parameters->requireds.nodes[index],
       parser,
-      source,
+      line_index,
       source_base_offset,
       prism_source_start,
       allocator
@@ -772,8 +644,9 @@ hb_array_T* extract_parameters_from_prism(
     size_t name_length = (size_t) (optional->name_loc.end - optional->name_loc.start);
     char* name = hb_allocator_strndup(allocator, (const char*) optional->name_loc.start, name_length);
 
-    position_T start = prism_to_source_position(node->location.start, prism_source_start, source_base_offset, source);
-    position_T end = prism_to_source_position(node->location.end, prism_source_start, source_base_offset, source);
+    position_T start =
+      prism_to_source_position(node->location.start, prism_source_start, source_base_offset, line_index);
+    position_T end = prism_to_source_position(node->location.end, prism_source_start, source_base_offset, line_index);
 
     AST_RUBY_LITERAL_NODE_T* default_value = NULL;
 
@@ -781,9 +654,9 @@ hb_array_T* extract_parameters_from_prism(
       size_t value_length = (size_t) (optional->value->location.end - optional->value->location.start);
       char* value_string = hb_allocator_strndup(allocator, (const char*) optional->value->location.start, value_length);
       position_T value_start =
-        prism_to_source_position(optional->value->location.start, prism_source_start, source_base_offset, source);
+        prism_to_source_position(optional->value->location.start, prism_source_start, source_base_offset, line_index);
       position_T value_end =
-        prism_to_source_position(optional->value->location.end, prism_source_start, source_base_offset, source);
+        prism_to_source_position(optional->value->location.end, prism_source_start, source_base_offset, line_index);
 
       default_value = ast_ruby_literal_node_init(
         hb_string_from_c_string(value_string),
@@ -797,7 +670,14 @@ hb_array_T* extract_parameters_from_prism(
 
     append_parameter(
       result,
-      create_parameter_name_token(optional->name_loc, name, prism_source_start, source_base_offset, source, allocator),
+      create_parameter_name_token(
+        optional->name_loc,
+        name,
+        prism_source_start,
+        source_base_offset,
+        line_index,
+        allocator
+      ),
       default_value,
       "positional",
       false,
@@ -818,13 +698,20 @@ hb_array_T* extract_parameters_from_prism(
       char* name = hb_allocator_strndup(allocator, (const char*) rest->name_loc.start, name_length);
 
       position_T start =
-        prism_to_source_position(parameters->rest->location.start, prism_source_start, source_base_offset, source);
+        prism_to_source_position(parameters->rest->location.start, prism_source_start, source_base_offset, line_index);
       position_T end =
-        prism_to_source_position(parameters->rest->location.end, prism_source_start, source_base_offset, source);
+        prism_to_source_position(parameters->rest->location.end, prism_source_start, source_base_offset, line_index);
 
       append_parameter(
         result,
-        create_parameter_name_token(rest->name_loc, name, prism_source_start, source_base_offset, source, allocator),
+        create_parameter_name_token(
+          rest->name_loc,
+          name,
+          prism_source_start,
+          source_base_offset,
+          line_index,
+          allocator
+        ),
         NULL,
         "rest",
         false,
@@ -841,8 +728,8 @@ hb_array_T* extract_parameters_from_prism(
         NULL,
         "rest",
         false,
-        prism_to_source_position(parameters->rest->location.start, prism_source_start, source_base_offset, source),
-        prism_to_source_position(parameters->rest->location.end, prism_source_start, source_base_offset, source),
+        prism_to_source_position(parameters->rest->location.start, prism_source_start, source_base_offset, line_index),
+        prism_to_source_position(parameters->rest->location.end, prism_source_start, source_base_offset, line_index),
         allocator
       );
     }
@@ -854,7 +741,7 @@ hb_array_T* extract_parameters_from_prism(
       result,
       parameters->posts.nodes[index],
       parser,
-      source,
+      line_index,
       source_base_offset,
       prism_source_start,
       allocator
@@ -886,14 +773,14 @@ hb_array_T* extract_parameters_from_prism(
           optional_keyword->value->location.start,
           prism_source_start,
           source_base_offset,
-          source
+          line_index
         );
 
         position_T value_end = prism_to_source_position(
           optional_keyword->value->location.end,
           prism_source_start,
           source_base_offset,
-          source
+          line_index
         );
 
         default_value = ast_ruby_literal_node_init(
@@ -915,12 +802,13 @@ hb_array_T* extract_parameters_from_prism(
     char* name = hb_allocator_strndup(allocator, (const char*) name_location.start, name_length);
 
     position_T start =
-      prism_to_source_position(keyword->location.start, prism_source_start, source_base_offset, source);
-    position_T end = prism_to_source_position(keyword->location.end, prism_source_start, source_base_offset, source);
+      prism_to_source_position(keyword->location.start, prism_source_start, source_base_offset, line_index);
+    position_T end =
+      prism_to_source_position(keyword->location.end, prism_source_start, source_base_offset, line_index);
 
     append_parameter(
       result,
-      create_parameter_name_token(name_location, name, prism_source_start, source_base_offset, source, allocator),
+      create_parameter_name_token(name_location, name, prism_source_start, source_base_offset, line_index, allocator),
       default_value,
       "keyword",
       is_required,
@@ -940,11 +828,15 @@ hb_array_T* extract_parameters_from_prism(
       parameters->keyword_rest->location.start,
       prism_source_start,
       source_base_offset,
-      source
+      line_index
     );
 
-    position_T end =
-      prism_to_source_position(parameters->keyword_rest->location.end, prism_source_start, source_base_offset, source);
+    position_T end = prism_to_source_position(
+      parameters->keyword_rest->location.end,
+      prism_source_start,
+      source_base_offset,
+      line_index
+    );
 
     if (keyword_rest->name) {
       size_t name_length = (size_t) (keyword_rest->name_loc.end - keyword_rest->name_loc.start);
@@ -957,7 +849,7 @@ hb_array_T* extract_parameters_from_prism(
           name,
           prism_source_start,
           source_base_offset,
-          source,
+          line_index,
           allocator
         ),
         NULL,
@@ -984,9 +876,9 @@ hb_array_T* extract_parameters_from_prism(
       char* name = hb_allocator_strndup(allocator, (const char*) block_param->name_loc.start, name_length);
 
       position_T start =
-        prism_to_source_position(block_param->base.location.start, prism_source_start, source_base_offset, source);
+        prism_to_source_position(block_param->base.location.start, prism_source_start, source_base_offset, line_index);
       position_T end =
-        prism_to_source_position(block_param->base.location.end, prism_source_start, source_base_offset, source);
+        prism_to_source_position(block_param->base.location.end, prism_source_start, source_base_offset, line_index);
 
       append_parameter(
         result,
@@ -995,7 +887,7 @@ hb_array_T* extract_parameters_from_prism(
           name,
           prism_source_start,
           source_base_offset,
-          source,
+          line_index,
           allocator
         ),
         NULL,
@@ -1014,8 +906,8 @@ hb_array_T* extract_parameters_from_prism(
         NULL,
         "block",
         false,
-        prism_to_source_position(block_param->base.location.start, prism_source_start, source_base_offset, source),
-        prism_to_source_position(block_param->base.location.end, prism_source_start, source_base_offset, source),
+        prism_to_source_position(block_param->base.location.start, prism_source_start, source_base_offset, line_index),
+        prism_to_source_position(block_param->base.location.end, prism_source_start, source_base_offset, line_index),
         allocator
       );
     }
@@ -1026,7 +918,7 @@ hb_array_T* extract_parameters_from_prism(
 
 hb_array_T* extract_block_arguments_from_erb_node(
   const AST_ERB_CONTENT_NODE_T* erb_node,
-  const char* source,
+  const line_index_T* line_index,
   hb_array_T** errors,
   hb_allocator_T* allocator
 ) {
@@ -1041,8 +933,8 @@ hb_array_T* extract_block_arguments_from_erb_node(
   pm_block_parameters_node_t* block_parameters = (pm_block_parameters_node_t*) block_node->parameters;
   size_t erb_content_offset = 0;
 
-  if (source && erb_node->content) {
-    erb_content_offset = calculate_byte_offset_from_position(source, erb_node->content->location.start);
+  if (line_index && erb_node->content) {
+    erb_content_offset = calculate_byte_offset_from_position(line_index, erb_node->content->location.start);
   }
 
   const uint8_t* prism_source_start = (const uint8_t*) parser->start;
@@ -1057,8 +949,8 @@ hb_array_T* extract_block_arguments_from_erb_node(
       size_t error_start_offset = (size_t) (error->location.start - prism_source_start);
       size_t error_end_offset = (size_t) (error->location.end - prism_source_start);
 
-      position_T error_start = byte_offset_to_position(source, erb_content_offset + error_start_offset);
-      position_T error_end = byte_offset_to_position(source, erb_content_offset + error_end_offset);
+      position_T error_start = byte_offset_to_position(line_index, erb_content_offset + error_start_offset);
+      position_T error_end = byte_offset_to_position(line_index, erb_content_offset + error_end_offset);
 
       RUBY_PARSE_ERROR_T* parse_error =
         ruby_parse_error_from_prism_error_with_positions(error, error_start, error_end, allocator);
@@ -1070,7 +962,7 @@ hb_array_T* extract_block_arguments_from_erb_node(
   return extract_parameters_from_prism(
     block_parameters->parameters,
     parser,
-    source,
+    line_index,
     erb_content_offset,
     prism_source_start,
     allocator
@@ -1,14 +1,17 @@
 #include "../include/analyze/analyzed_ruby.h"
+#include "../include/lib/hb_allocator.h"
 #include "../include/lib/hb_string.h"
 
 #include <prism.h>
 #include <string.h>
 
-analyzed_ruby_T* init_analyzed_ruby(hb_string_T source) {
-  analyzed_ruby_T* analyzed = malloc(sizeof(analyzed_ruby_T));
+analyzed_ruby_T* init_analyzed_ruby(hb_string_T source, hb_allocator_T* allocator) {
+  analyzed_ruby_T* analyzed = hb_allocator_alloc(allocator, sizeof(analyzed_ruby_T));
 
   if (!analyzed) { return NULL; }
 
+  analyzed->allocator = allocator;
+
   pm_parser_init(&analyzed->parser, (const uint8_t*) source.data, source.length, NULL);
 
   analyzed->root = pm_parse(&analyzed->parser);
@@ -45,7 +48,7 @@ void free_analyzed_ruby(analyzed_ruby_T* analyzed) {
 
   pm_parser_free(&analyzed->parser);
 
-  free(analyzed);
+  hb_allocator_dealloc(analyzed->allocator, analyzed);
 }
 
 hb_string_T erb_keyword_from_analyzed_ruby(const analyzed_ruby_T* analyzed) {
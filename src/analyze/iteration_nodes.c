@@ -15,13 +15,13 @@
 static token_T* create_token_from_prism_location(
   pm_location_t location,
   token_type_T type,
-  const char* source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   const uint8_t* erb_content_source,
   hb_allocator_T* allocator
 ) {
   if (location.start == NULL || location.end == NULL) { return NULL; }
-  if (!source || !erb_content_source) { return NULL; }
+  if (!line_index || !erb_content_source) { return NULL; }
 
   size_t length = (size_t) (location.end - location.start);
   char* value = hb_allocator_strndup(allocator, (const char*) location.start, length);
@@ -29,8 +29,8 @@ static token_T* create_token_from_prism_location(
   size_t total_start = erb_content_offset + (size_t) (location.start - erb_content_source);
   size_t total_end = erb_content_offset + (size_t) (location.end - erb_content_source);
 
-  position_T start = byte_offset_to_position(source, total_start);
-  position_T end = byte_offset_to_position(source, total_end);
+  position_T start = byte_offset_to_position(line_index, total_start);
+  position_T end = byte_offset_to_position(line_index, total_end);
 
   token_T* token = create_synthetic_token(allocator, value, type, start, end);
 
@@ -46,7 +46,7 @@ static token_T* create_token_from_prism_location(
  */
 static hb_array_T* extract_call_arguments(
   const pm_call_node_t* call,
-  const char* source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   const uint8_t* erb_content_source,
   hb_allocator_T* allocator
@@ -65,12 +65,12 @@ static hb_array_T* extract_call_arguments(
     position_T start = { .line = 1, .column = 1 };
     position_T end = { .line = 1, .column = 1 };
 
-    if (source && erb_content_source) {
+    if (line_index && erb_content_source) {
       size_t total_start = erb_content_offset + (size_t) (argument->location.start - erb_content_source);
       size_t total_end = erb_content_offset + (size_t) (argument->location.end - erb_content_source);
 
-      start = byte_offset_to_position(source, total_start);
-      end = byte_offset_to_position(source, total_end);
+      start = byte_offset_to_position(line_index, total_start);
+      end = byte_offset_to_position(line_index, total_end);
     }
 
     AST_RUBY_LITERAL_NODE_T* literal =
@@ -188,8 +188,8 @@ static AST_ERB_ITERATION_BLOCK_NODE_T* try_transform_block_node(
 
   size_t erb_content_offset = 0;
 
-  if (context->source) {
-    erb_content_offset = calculate_byte_offset_from_position(context->source, block_node->content->location.start);
+  if (context->line_index) {
+    erb_content_offset = calculate_byte_offset_from_position(context->line_index, block_node->content->location.start);
   }
 
   const uint8_t* erb_content_source = (const uint8_t*) parser.start;
@@ -197,7 +197,7 @@ static AST_ERB_ITERATION_BLOCK_NODE_T* try_transform_block_node(
   token_T* receiver = create_token_from_prism_location(
     iteration_call->receiver->location,
     TOKEN_ERB_CONTENT,
-    context->source,
+    context->line_index,
     erb_content_offset,
     erb_content_source,
     allocator
@@ -206,7 +206,7 @@ static AST_ERB_ITERATION_BLOCK_NODE_T* try_transform_block_node(
   token_T* call_operator = create_token_from_prism_location(
     iteration_call->call_operator_loc,
     TOKEN_IDENTIFIER,
-    context->source,
+    context->line_index,
     erb_content_offset,
     erb_content_source,
     allocator
@@ -215,21 +215,21 @@ static AST_ERB_ITERATION_BLOCK_NODE_T* try_transform_block_node(
   token_T* message = create_token_from_prism_location(
     iteration_call->message_loc,
     TOKEN_IDENTIFIER,
-    context->source,
+    context->line_index,
     erb_content_offset,
     erb_content_source,
     allocator
   );
 
   hb_array_T* arguments =
-    extract_call_arguments(iteration_call, context->source, erb_content_offset, erb_content_source, allocator);
+    extract_call_arguments(iteration_call, context->line_index, erb_content_offset, erb_content_source, allocator);
 
   pm_block_node_t* block = (pm_block_node_t*) iteration_call->block;
 
   token_T* block_opening = create_token_from_prism_location(
     block->opening_loc,
     TOKEN_IDENTIFIER,
-    context->source,
+    context->line_index,
     erb_content_offset,
     erb_content_source,
     allocator
@@ -1,12 +1,14 @@
 #include "../include/analyze/analyze.h"
+#include "../include/analyze/analyzed_ruby.h"
 #include "../include/ast/ast_node.h"
 #include "../include/ast/ast_nodes.h"
 #include "../include/errors.h"
-#include "../include/extract.h"
 #include "../include/lib/hb_allocator.h"
+#include "../include/lib/hb_narray.h"
 #include "../include/lib/hb_string.h"
 #include "../include/lib/string.h"
 #include "../include/prism/prism_helpers.h"
+#include "../include/visitor.h"
 
 #include <prism.h>
 #include <stdlib.h>
@@ -43,12 +45,45 @@ static bool should_skip_forwarding_error(
   return has_anonymous_keyword_rest;
 }
 
+// Diagnostics Prism only reports for a complete program, which a `partial_script` parse never produces.
+static bool is_partial_script_diagnostic(const pm_diagnostic_t* error) {
+  switch (error->diag_id) {
+    case PM_ERR_INVALID_BLOCK_EXIT:
+    case PM_ERR_INVALID_YIELD: return true;
+    default: return false;
+  }
+}
+
+// Reuses the diagnostics of the analyzer's parse when there is one. That parse runs without `partial_script`,
+// so the diagnostics it adds for a top-level `yield`, `break`, `next`, or `redo` are skipped to match the
+// fallback parse below.
 static void parse_erb_content_errors(AST_NODE_T* erb_node, const char* source, hb_allocator_T* allocator) {
   if (!erb_node || erb_node->type != AST_ERB_CONTENT_NODE) { return; }
   AST_ERB_CONTENT_NODE_T* content_node = (AST_ERB_CONTENT_NODE_T*) erb_node;
 
   if (!content_node->content || hb_string_is_empty(content_node->content->value)) { return; }
 
+  analyzed_ruby_T* analyzed = content_node->analyzed_ruby;
+
+  if (analyzed && analyzed->parsed) {
+    for (const pm_diagnostic_t* error = (const pm_diagnostic_t*) analyzed->parser.error_list.head; error != NULL;
+         error = (const pm_diagnostic_t*) error->node.next) {
+      if (is_partial_script_diagnostic(error)) { continue; }
+
+      RUBY_PARSE_ERROR_T* parse_error = ruby_parse_error_from_prism_error_with_positions(
+        error,
+        erb_node->location.start,
+        erb_node->location.end,
+        allocator
+      );
+
+      hb_array_append_lazy(&erb_node->errors, parse_error, allocator);
+      break;
+    }
+
+    return;
+  }
+
   char* content = hb_string_to_c_string_using_malloc(content_node->content->value);
   if (!content) { return; }
 
@@ -77,35 +112,128 @@ static void parse_erb_content_errors(AST_NODE_T* erb_node, const char* source, h
   free(content);
 }
 
+typedef struct {
+  size_t from;
+  size_t to;
+  AST_NODE_T* node;
+} erb_content_span_T;
+
+// Byte spans of every ERB content tag in document order, built on the first error that needs one so that each
+// `unexpected ';'` lookup is a binary search instead of a walk over the whole tree.
+typedef struct {
+  hb_narray_T spans;
+  bool built;
+} erb_content_index_T;
+
+static bool collect_erb_content_spans_visitor(const AST_NODE_T* node, void* data) {
+  if (node->type != AST_ERB_CONTENT_NODE) { return true; }
+
+  const AST_ERB_CONTENT_NODE_T* content_node = (const AST_ERB_CONTENT_NODE_T*) node;
+  if (!content_node->tag_opening) { return false; }
+
+  const token_T* last = content_node->tag_closing ? content_node->tag_closing : content_node->content;
+  if (!last) { last = content_node->tag_opening; }
+
+  erb_content_span_T span = {
+    .from = content_node->tag_opening->range.from,
+    .to = last->range.to,
+    .node = (AST_NODE_T*) node,
+  };
+
+  hb_narray_push((hb_narray_T*) data, &span);
+
+  return false;
+}
+
+static int compare_erb_content_spans(const void* left, const void* right) {
+  size_t left_from = ((const erb_content_span_T*) left)->from;
+  size_t right_from = ((const erb_content_span_T*) right)->from;
+
+  return (left_from > right_from) - (left_from < right_from);
+}
+
+static void erb_content_index_build(
+  erb_content_index_T* index,
+  AST_DOCUMENT_NODE_T* document,
+  hb_allocator_T* allocator
+) {
+  index->built = true;
+
+  if (!hb_narray_init(&index->spans, sizeof(erb_content_span_T), 16, allocator)) { return; }
+
+  herb_visit_node((AST_NODE_T*) document, collect_erb_content_spans_visitor, &index->spans);
+
+  size_t size = hb_narray_size(&index->spans);
+
+  for (size_t i = 1; i < size; i++) {
+    const erb_content_span_T* previous = hb_narray_get(&index->spans, i - 1);
+    const erb_content_span_T* current = hb_narray_get(&index->spans, i);
+
+    if (previous->from > current->from) {
+      qsort(index->spans.items, size, sizeof(erb_content_span_T), compare_erb_content_spans);
+      break;
+    }
+  }
+}
+
+static AST_NODE_T* erb_content_index_find(
+  erb_content_index_T* index,
+  AST_DOCUMENT_NODE_T* document,
+  size_t offset,
+  hb_allocator_T* allocator
+) {
+  if (!index->built) { erb_content_index_build(index, document, allocator); }
+
+  size_t low = 0;
+  size_t high = hb_narray_size(&index->spans);
+
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    const erb_content_span_T* span = hb_narray_get(&index->spans, middle);
+
+    if (span->from <= offset) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  if (low == 0) { return NULL; }
+
+  const erb_content_span_T* span = hb_narray_get(&index->spans, low - 1);
+
+  return offset <= span->to ? span->node : NULL;
+}
+
 void herb_analyze_parse_errors(
   AST_DOCUMENT_NODE_T* document,
   const char* source,
+  const line_index_T* line_index,
+  const herb_prism_context_T* ruby_program,
   const parser_options_T* parser_options,
   hb_allocator_T* allocator
 ) {
-  char* extracted_ruby = herb_extract_ruby_with_semicolons(source, allocator);
-
-  if (!extracted_ruby) { return; }
+  if (!ruby_program) { return; }
 
   bool strict_locals_enabled = parser_options && parser_options->strict_locals;
   bool has_anonymous_keyword_rest = strict_locals_enabled && document_has_anonymous_keyword_rest(document);
 
-  pm_parser_t parser;
-  pm_options_t options = { 0, .partial_script = true };
-  pm_parser_init(&parser, (const uint8_t*) extracted_ruby, strlen(extracted_ruby), &options);
+  const pm_parser_t* parser = &ruby_program->parser;
+  const char* extracted_ruby = ruby_program->ruby_buf.value;
+  size_t extracted_length = ruby_program->ruby_buf.length;
 
-  pm_node_t* root = pm_parse(&parser);
+  erb_content_index_T erb_index = { .built = false };
 
-  for (const pm_diagnostic_t* error = (const pm_diagnostic_t*) parser.error_list.head; error != NULL;
+  for (const pm_diagnostic_t* error = (const pm_diagnostic_t*) parser->error_list.head; error != NULL;
        error = (const pm_diagnostic_t*) error->node.next) {
     if (should_skip_forwarding_error(error, strict_locals_enabled, has_anonymous_keyword_rest)) { continue; }
 
-    size_t error_offset = (size_t) (error->location.start - parser.start);
+    size_t error_offset = (size_t) (error->location.start - parser->start);
 
     if (strstr(error->message, "unexpected ';'") != NULL) {
-      if (error_offset < strlen(extracted_ruby) && extracted_ruby[error_offset] == ';') {
-        if (error_offset >= strlen(source) || source[error_offset] != ';') {
-          AST_NODE_T* erb_node = find_erb_content_at_offset(document, source, error_offset);
+      if (error_offset < extracted_length && extracted_ruby[error_offset] == ';') {
+        if (error_offset >= line_index->source.length || source[error_offset] != ';') {
+          AST_NODE_T* erb_node = erb_content_index_find(&erb_index, document, error_offset, allocator);
 
           if (erb_node) { parse_erb_content_errors(erb_node, source, allocator); }
 
@@ -115,12 +243,9 @@ void herb_analyze_parse_errors(
     }
 
     RUBY_PARSE_ERROR_T* parse_error =
-      ruby_parse_error_from_prism_error(error, (AST_NODE_T*) document, source, &parser, allocator);
+      ruby_parse_error_from_prism_error(error, (AST_NODE_T*) document, source, parser, allocator);
     hb_array_append_lazy(&document->base.errors, parse_error, allocator);
   }
 
-  pm_node_destroy(&parser, root);
-  pm_parser_free(&parser);
-  pm_options_free(&options);
-  hb_allocator_dealloc(allocator, extracted_ruby);
+  if (erb_index.built) { hb_narray_deinit(&erb_index.spans); }
 }
@@ -1,7 +1,6 @@
 #include "../include/analyze/prism_annotate.h"
 #include "../include/ast/ast_node.h"
 #include "../include/ast/ast_nodes.h"
-#include "../include/extract.h"
 #include "../include/lib/hb_allocator.h"
 #include "../include/lib/hb_buffer.h"
 #include "../include/lib/hb_narray.h"
@@ -19,9 +18,13 @@ typedef struct {
 
 typedef struct {
   pm_parser_t* parser;
-  pm_parser_t* structural_parser;
-  hb_narray_T* node_list;
-  hb_narray_T* structural_node_list;
+  hb_narray_T* nodes;
+  bool sorted;
+} prism_node_index_T;
+
+typedef struct {
+  prism_node_index_T* index;
+  prism_node_index_T* structural_index;
   bool prism_nodes_deep;
 } prism_annotate_context_T;
 
@@ -201,28 +204,69 @@ static void set_prism_node(AST_NODE_T* node, herb_prism_node_T prism_ref) {
   }
 }
 
-static herb_prism_node_T find_prism_node_for_herb_node(
-  pm_parser_t* parser,
-  hb_narray_T* node_list,
-  const AST_NODE_T* node
-) {
+static size_t prism_node_start(const prism_node_index_T* index, size_t position) {
+  const pm_node_t* prism_node = *(pm_node_t**) hb_narray_get(index->nodes, position);
+
+  return (size_t) (prism_node->location.start - index->parser->start);
+}
+
+// collect_prism_nodes walks the program in pre-order, so node start offsets come out non-decreasing and the first
+// node starting inside a content range can be found with a binary search. The linear scan stays as a fallback in
+// case a Prism node type ever reports a start before its parent's.
+static void prism_node_index_init(prism_node_index_T* index, pm_parser_t* parser, hb_narray_T* nodes) {
+  index->parser = parser;
+  index->nodes = nodes;
+  index->sorted = true;
+
+  for (size_t i = 1; i < hb_narray_size(nodes); i++) {
+    if (prism_node_start(index, i - 1) > prism_node_start(index, i)) {
+      index->sorted = false;
+      break;
+    }
+  }
+}
+
+static size_t prism_node_index_first_in_range(const prism_node_index_T* index, size_t from, size_t to) {
+  size_t size = hb_narray_size(index->nodes);
+
+  if (!index->sorted) {
+    for (size_t i = 0; i < size; i++) {
+      size_t start = prism_node_start(index, i);
+      if (start >= from && start < to) { return i; }
+    }
+
+    return size;
+  }
+
+  size_t low = 0;
+  size_t high = size;
+
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+
+    if (prism_node_start(index, middle) < from) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  if (low < size && prism_node_start(index, low) < to) { return low; }
+
+  return size;
+}
+
+static herb_prism_node_T find_prism_node_for_herb_node(const prism_node_index_T* index, const AST_NODE_T* node) {
   herb_prism_node_T result = HERB_PRISM_NODE_EMPTY;
 
   token_T* content = get_content_token(node);
   if (!content || hb_string_is_empty(content->value)) { return result; }
 
-  uint32_t content_from = content->range.from;
-  uint32_t content_to = content->range.to;
-
-  for (size_t i = 0; i < hb_narray_size(node_list); i++) {
-    pm_node_t* prism_node = *(pm_node_t**) hb_narray_get(node_list, i);
-    size_t prism_start = (size_t) (prism_node->location.start - parser->start);
+  size_t position = prism_node_index_first_in_range(index, content->range.from, content->range.to);
 
-    if (prism_start >= content_from && prism_start < content_to) {
-      result.node = prism_node;
-      result.parser = parser;
-      break;
-    }
+  if (position < hb_narray_size(index->nodes)) {
+    result.node = *(pm_node_t**) hb_narray_get(index->nodes, position);
+    result.parser = index->parser;
   }
 
   return result;
@@ -233,18 +277,13 @@ static bool annotate_visitor(const AST_NODE_T* node, void* data) {
 
   if (!get_content_token(node)) { return true; }
 
-  pm_parser_t* parser;
-  hb_narray_T* node_list;
+  const prism_node_index_T* index = context->structural_index;
 
   if (node->type == AST_ERB_CONTENT_NODE || node->type == AST_ERB_RENDER_NODE || context->prism_nodes_deep) {
-    parser = context->parser;
-    node_list = context->node_list;
-  } else {
-    parser = context->structural_parser;
-    node_list = context->structural_node_list;
+    index = context->index;
   }
 
-  herb_prism_node_T prism_ref = find_prism_node_for_herb_node(parser, node_list, node);
+  herb_prism_node_T prism_ref = find_prism_node_for_herb_node(index, node);
 
   if (prism_ref.node) { set_prism_node((AST_NODE_T*) node, prism_ref); }
 
@@ -267,65 +306,14 @@ static bool collect_content_ranges_visitor(const AST_NODE_T* node, void* data) {
 
 void herb_annotate_prism_nodes(
   AST_DOCUMENT_NODE_T* document,
-  const char* source,
+  herb_prism_context_T* context,
   bool prism_nodes,
   bool prism_nodes_deep,
-  bool prism_program,
-  hb_allocator_T* allocator
+  bool prism_program
 ) {
-  if (!document || !source) { return; }
-
-  size_t source_len = strlen(source);
-
-  herb_prism_context_T* context = hb_allocator_alloc(allocator, sizeof(herb_prism_context_T));
-  if (!context) { return; }
-
-  memset(context, 0, sizeof(herb_prism_context_T));
-
-  context->allocator = allocator;
-  context->has_structural = false;
-
-  if (!hb_buffer_init(&context->ruby_buf, source_len, allocator)) {
-    hb_allocator_dealloc(allocator, context);
-    return;
-  }
-
-  herb_extract_ruby_options_T extract_options = {
-    .semicolons = true,
-    .comments = false,
-    .preserve_positions = true,
-  };
-
-  herb_extract_ruby_to_buffer_with_options(source, &context->ruby_buf, &extract_options, allocator);
-
-  if (!context->ruby_buf.value || context->ruby_buf.length == 0) {
-    hb_buffer_free(&context->ruby_buf);
-    hb_allocator_dealloc(allocator, context);
-    return;
-  }
-
-  memset(&context->pm_opts, 0, sizeof(pm_options_t));
-  pm_options_partial_script_set(&context->pm_opts, true);
-  pm_parser_init(
-    &context->parser,
-    (const uint8_t*) context->ruby_buf.value,
-    context->ruby_buf.length,
-    &context->pm_opts
-  );
-  context->root = pm_parse(&context->parser);
-
-  if (!context->root || context->root->type != PM_PROGRAM_NODE) {
-    pm_node_destroy(&context->parser, context->root);
-    context->root = NULL;
+  if (!document || !context || !context->root || context->root->type != PM_PROGRAM_NODE) { return; }
 
-    pm_parser_free(&context->parser);
-    pm_options_free(&context->pm_opts);
-
-    hb_buffer_free(&context->ruby_buf);
-    hb_allocator_dealloc(allocator, context);
-
-    return;
-  }
+  hb_allocator_T* allocator = context->allocator;
 
   document->prism_context = context;
 
@@ -385,11 +373,18 @@ void herb_annotate_prism_nodes(
       hb_narray_deinit(&content_ranges);
     }
 
+    prism_node_index_T index;
+    prism_node_index_init(&index, &context->parser, &node_list);
+
+    prism_node_index_T structural_index = index;
+
+    if (!prism_nodes_deep) {
+      prism_node_index_init(&structural_index, &context->structural_parser, &structural_node_list);
+    }
+
     prism_annotate_context_T annotate_context = {
-      .parser = &context->parser,
-      .structural_parser = prism_nodes_deep ? &context->parser : &context->structural_parser,
-      .node_list = &node_list,
-      .structural_node_list = prism_nodes_deep ? &node_list : &structural_node_list,
+      .index = &index,
+      .structural_index = &structural_index,
       .prism_nodes_deep = prism_nodes_deep,
     };
 
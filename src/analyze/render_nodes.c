@@ -20,7 +20,7 @@ static token_T* create_token_from_prism_node(
   pm_node_t* node,
   const char* value,
   token_type_T type,
-  const char* source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   const uint8_t* erb_content_source,
   hb_allocator_T* allocator
@@ -39,7 +39,7 @@ typedef struct {
 // A superset of ALL_KNOWN_KEYS in actionview/lib/action_view/render_parser.rb,
 // which only lists the keys Rails' dependency tracker will not bail out on. The
 // rendering modes and the collection options are recognized here as well.
-static const char* render_keywords[] = {
+static const char* const render_keywords[] = {
   "partial",      "template",   "layout", "file", "inline",          "body",    "plain",    "html",     "renderable",
   "locals",       "collection", "object", "as",   "spacer_template", "formats", "variants", "handlers", "status",
   "content_type", "location",   "cached", NULL
@@ -127,7 +127,7 @@ static token_T* create_token_from_prism_node(
   pm_node_t* node,
   const char* value,
   token_type_T type,
-  const char* source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   const uint8_t* erb_content_source,
   hb_allocator_T* allocator
@@ -135,15 +135,15 @@ static token_T* create_token_from_prism_node(
   position_T start = { .line = 1, .column = 1 };
   position_T end = { .line = 1, .column = 1 };
 
-  if (node && source && erb_content_source) {
+  if (node && line_index && erb_content_source) {
     size_t start_offset_in_erb = (size_t) (node->location.start - erb_content_source);
     size_t end_offset_in_erb = (size_t) (node->location.end - erb_content_source);
 
     size_t total_start = erb_content_offset + start_offset_in_erb;
     size_t total_end = erb_content_offset + end_offset_in_erb;
 
-    start = byte_offset_to_position(source, total_start);
-    end = byte_offset_to_position(source, total_end);
+    start = byte_offset_to_position(line_index, total_start);
+    end = byte_offset_to_position(line_index, total_end);
   }
 
   return create_synthetic_token(allocator, value, type, start, end);
@@ -219,7 +219,7 @@ static pm_hash_node_t* find_locals_hash(pm_keyword_hash_node_t* keyword_hash, hb
 
 static hb_array_T* extract_locals_from_hash(
   pm_hash_node_t* hash,
-  const char* source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   const uint8_t* erb_content_source,
   hb_allocator_T* allocator
@@ -246,7 +246,7 @@ static hb_array_T* extract_locals_from_hash(
       assoc->key,
       name,
       TOKEN_IDENTIFIER,
-      source,
+      line_index,
       erb_content_offset,
       erb_content_source,
       allocator
@@ -255,11 +255,11 @@ static hb_array_T* extract_locals_from_hash(
     position_T value_start = { .line = 1, .column = 1 };
     position_T value_end = value_start;
 
-    if (assoc->value && source && erb_content_source) {
+    if (assoc->value && line_index && erb_content_source) {
       size_t start_offset = (size_t) (assoc->value->location.start - erb_content_source);
       size_t end_offset = (size_t) (assoc->value->location.end - erb_content_source);
-      value_start = byte_offset_to_position(source, erb_content_offset + start_offset);
-      value_end = byte_offset_to_position(source, erb_content_offset + end_offset);
+      value_start = byte_offset_to_position(line_index, erb_content_offset + start_offset);
+      value_end = byte_offset_to_position(line_index, erb_content_offset + end_offset);
     }
 
     AST_RUBY_LITERAL_NODE_T* value_node = ast_ruby_literal_node_init(
@@ -288,7 +288,7 @@ static hb_array_T* extract_locals_from_hash(
 static token_T* extract_keyword_token(
   pm_keyword_hash_node_t* keyword_hash,
   const char* keyword_name,
-  const char* source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   const uint8_t* erb_content_source,
   hb_allocator_T* allocator
@@ -300,7 +300,7 @@ static token_T* extract_keyword_token(
     keyword.value_node,
     keyword.value,
     TOKEN_IDENTIFIER,
-    source,
+    line_index,
     erb_content_offset,
     erb_content_source,
     allocator
@@ -323,7 +323,7 @@ static AST_ERB_RENDER_NODE_T* create_render_node_from_call(
   AST_ERB_CONTENT_NODE_T* erb_node,
   pm_call_node_t* call_node,
   pm_parser_t* parser,
-  const char* source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   const uint8_t* erb_content_source,
   render_block_fields_T* block_fields,
@@ -369,7 +369,7 @@ static AST_ERB_RENDER_NODE_T* create_render_node_from_call(
           first_argument,
           partial_string,
           TOKEN_IDENTIFIER,
-          source,
+          line_index,
           erb_content_offset,
           erb_content_source,
           allocator
@@ -385,7 +385,7 @@ static AST_ERB_RENDER_NODE_T* create_render_node_from_call(
           first_argument,
           object_string,
           TOKEN_IDENTIFIER,
-          source,
+          line_index,
           erb_content_offset,
           erb_content_source,
           allocator
@@ -403,7 +403,7 @@ static AST_ERB_RENDER_NODE_T* create_render_node_from_call(
       pm_hash_node_t* locals_hash = find_locals_hash(keyword_hash, allocator);
 
       if (locals_hash) {
-        locals = extract_locals_from_hash(locals_hash, source, erb_content_offset, erb_content_source, allocator);
+        locals = extract_locals_from_hash(locals_hash, line_index, erb_content_offset, erb_content_source, allocator);
       } else {
         locals = hb_array_init(keyword_hash->elements.size, allocator);
 
@@ -427,7 +427,7 @@ static AST_ERB_RENDER_NODE_T* create_render_node_from_call(
             assoc->key,
             name,
             TOKEN_IDENTIFIER,
-            source,
+            line_index,
             erb_content_offset,
             erb_content_source,
             allocator
@@ -436,11 +436,11 @@ static AST_ERB_RENDER_NODE_T* create_render_node_from_call(
           position_T value_start = { .line = 1, .column = 1 };
           position_T value_end = value_start;
 
-          if (assoc->value && source && erb_content_source) {
+          if (assoc->value && line_index && erb_content_source) {
             size_t start_offset = (size_t) (assoc->value->location.start - erb_content_source);
             size_t end_offset = (size_t) (assoc->value->location.end - erb_content_source);
-            value_start = byte_offset_to_position(source, erb_content_offset + start_offset);
-            value_end = byte_offset_to_position(source, erb_content_offset + end_offset);
+            value_start = byte_offset_to_position(line_index, erb_content_offset + start_offset);
+            value_end = byte_offset_to_position(line_index, erb_content_offset + end_offset);
           }
 
           AST_RUBY_LITERAL_NODE_T* value_node = ast_ruby_literal_node_init(
@@ -492,7 +492,7 @@ static AST_ERB_RENDER_NODE_T* create_render_node_from_call(
         token_T* keyword_token = extract_keyword_token(
           keyword_hash,
           keyword_fields[index].name,
-          source,
+          line_index,
           erb_content_offset,
           erb_content_source,
           allocator
@@ -509,7 +509,7 @@ static AST_ERB_RENDER_NODE_T* create_render_node_from_call(
       pm_hash_node_t* locals_hash = find_locals_hash(keyword_hash, allocator);
 
       if (locals_hash) {
-        locals = extract_locals_from_hash(locals_hash, source, erb_content_offset, erb_content_source, allocator);
+        locals = extract_locals_from_hash(locals_hash, line_index, erb_content_offset, erb_content_source, allocator);
       }
     }
   }
@@ -711,7 +711,7 @@ static AST_ERB_RENDER_NODE_T* create_render_node_from_call(
         render_block_arguments = extract_parameters_from_prism(
           block_parameters->parameters,
           parser,
-          source,
+          line_index,
           erb_content_offset,
           content_source,
           allocator
@@ -726,11 +726,11 @@ static AST_ERB_RENDER_NODE_T* create_render_node_from_call(
         position_T body_start = { .line = 1, .column = 1 };
         position_T body_end = { .line = 1, .column = 1 };
 
-        if (source && content_source) {
+        if (line_index && content_source) {
           size_t start_offset = (size_t) (inline_block->body->location.start - content_source);
           size_t end_offset = (size_t) (inline_block->body->location.end - content_source);
-          body_start = byte_offset_to_position(source, erb_content_offset + start_offset);
-          body_end = byte_offset_to_position(source, erb_content_offset + end_offset);
+          body_start = byte_offset_to_position(line_index, erb_content_offset + start_offset);
+          body_end = byte_offset_to_position(line_index, erb_content_offset + end_offset);
         }
 
         AST_RUBY_LITERAL_NODE_T* body_node = ast_ruby_literal_node_init(
@@ -799,29 +799,6 @@ static AST_ERB_RENDER_NODE_T* create_render_node_from_call(
   );
 }
 
-static size_t calculate_byte_offset_from_pos(const char* source, position_T position) {
-  if (!source) { return 0; }
-
-  size_t offset = 0;
-  uint32_t line = 1;
-  uint32_t column = 1;
-
-  while (source[offset] != '\0') {
-    if (line == position.line && column == position.column) { return offset; }
-
-    if (source[offset] == '\n') {
-      line++;
-      column = 1;
-    } else {
-      column++;
-    }
-
-    offset++;
-  }
-
-  return offset;
-}
-
 static bool is_erb_comment_tag(token_T* tag_opening) {
   if (!tag_opening || hb_string_is_empty(tag_opening->value)) { return false; }
 
@@ -842,8 +819,8 @@ static AST_ERB_RENDER_NODE_T* try_transform_content_node(
 
   size_t erb_content_offset = 0;
 
-  if (context->source && erb_node->content) {
-    erb_content_offset = calculate_byte_offset_from_pos(context->source, erb_node->content->location.start);
+  if (context->line_index && erb_node->content) {
+    erb_content_offset = calculate_byte_offset_from_position(context->line_index, erb_node->content->location.start);
   }
 
   const uint8_t* erb_content_source = (const uint8_t*) erb_node->analyzed_ruby->parser.start;
@@ -852,7 +829,7 @@ static AST_ERB_RENDER_NODE_T* try_transform_content_node(
     erb_node,
     render_call,
     &erb_node->analyzed_ruby->parser,
-    context->source,
+    context->line_index,
     erb_content_offset,
     erb_content_source,
     NULL,
@@ -896,8 +873,8 @@ static AST_ERB_RENDER_NODE_T* try_transform_block_node(
 
   size_t erb_content_offset = 0;
 
-  if (context->source && block_node->content) {
-    erb_content_offset = calculate_byte_offset_from_pos(context->source, block_node->content->location.start);
+  if (context->line_index && block_node->content) {
+    erb_content_offset = calculate_byte_offset_from_position(context->line_index, block_node->content->location.start);
   }
 
   const uint8_t* erb_content_source = (const uint8_t*) parser.start;
@@ -915,7 +892,7 @@ static AST_ERB_RENDER_NODE_T* try_transform_block_node(
     &content_view,
     render_call,
     &parser,
-    context->source,
+    context->line_index,
     erb_content_offset,
     erb_content_source,
     &block_fields,
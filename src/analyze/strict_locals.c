@@ -106,7 +106,7 @@ static pm_parameters_node_t* find_parameters_node(pm_node_t* root) {
 static hb_array_T* extract_strict_locals(
   pm_parameters_node_t* params,
   pm_parser_t* parser,
-  const char* source,
+  const line_index_T* line_index,
   size_t erb_content_byte_offset,
   const char* content_bytes,
   const char* params_open,
@@ -122,7 +122,7 @@ static hb_array_T* extract_strict_locals(
   size_t source_base_offset = erb_content_byte_offset + params_in_content - prefix_length;
 
   hb_array_T* locals =
-    extract_parameters_from_prism(params, parser, source, source_base_offset, synthetic_start, allocator);
+    extract_parameters_from_prism(params, parser, line_index, source_base_offset, synthetic_start, allocator);
 
   for (size_t index = 0; index < hb_array_size(locals); index++) {
     AST_RUBY_PARAMETER_NODE_T* local = hb_array_get(locals, index);
@@ -146,7 +146,7 @@ static hb_array_T* extract_strict_locals(
 
 static AST_ERB_STRICT_LOCALS_NODE_T* create_strict_locals_node(
   AST_ERB_CONTENT_NODE_T* erb_node,
-  const char* source,
+  const line_index_T* line_index,
   hb_allocator_T* allocator,
   const parser_options_T* parser_options
 ) {
@@ -175,10 +175,11 @@ static AST_ERB_STRICT_LOCALS_NODE_T* create_strict_locals_node(
     }
 
     char* rest = hb_allocator_strndup(allocator, after_prefix, rest_length);
-    size_t erb_content_byte_offset = calculate_byte_offset_from_position(source, erb_node->content->location.start);
+    size_t erb_content_byte_offset = calculate_byte_offset_from_position(line_index, erb_node->content->location.start);
 
-    position_T error_start = byte_offset_to_position(source, erb_content_byte_offset + after_prefix_offset);
-    position_T error_end = byte_offset_to_position(source, erb_content_byte_offset + after_prefix_offset + rest_length);
+    position_T error_start = byte_offset_to_position(line_index, erb_content_byte_offset + after_prefix_offset);
+    position_T error_end =
+      byte_offset_to_position(line_index, erb_content_byte_offset + after_prefix_offset + rest_length);
 
     append_strict_locals_missing_parenthesis_error(
       hb_string_from_c_string(rest),
@@ -227,7 +228,7 @@ static AST_ERB_STRICT_LOCALS_NODE_T* create_strict_locals_node(
   const uint8_t* synthetic_start = parser.start;
 
   pm_parameters_node_t* params_node = find_parameters_node(root);
-  size_t erb_content_byte_offset = calculate_byte_offset_from_position(source, erb_node->content->location.start);
+  size_t erb_content_byte_offset = calculate_byte_offset_from_position(line_index, erb_node->content->location.start);
   hb_array_T* errors = hb_array_init(0, allocator);
 
   size_t params_in_content = (size_t) (params_open - content_bytes);
@@ -245,8 +246,8 @@ static AST_ERB_STRICT_LOCALS_NODE_T* create_strict_locals_node(
     size_t error_content_end =
       params_in_content + (error_end_in_synthetic > prefix_length ? error_end_in_synthetic - prefix_length : 0);
 
-    position_T error_start = byte_offset_to_position(source, erb_content_byte_offset + error_content_start);
-    position_T error_end = byte_offset_to_position(source, erb_content_byte_offset + error_content_end);
+    position_T error_start = byte_offset_to_position(line_index, erb_content_byte_offset + error_content_start);
+    position_T error_end = byte_offset_to_position(line_index, erb_content_byte_offset + error_content_end);
 
     RUBY_PARSE_ERROR_T* parse_error =
       ruby_parse_error_from_prism_error_with_positions(error, error_start, error_end, allocator);
@@ -262,7 +263,7 @@ static AST_ERB_STRICT_LOCALS_NODE_T* create_strict_locals_node(
     locals = extract_strict_locals(
       params_node,
       &parser,
-      source,
+      line_index,
       erb_content_byte_offset,
       content_bytes,
       params_open,
@@ -304,7 +305,7 @@ static void transform_strict_locals_in_array(hb_array_T* array, analyze_ruby_con
     if (!is_strict_locals_node(erb_node)) { continue; }
 
     AST_ERB_STRICT_LOCALS_NODE_T* strict_locals_node =
-      create_strict_locals_node(erb_node, context->source, context->allocator, context->options);
+      create_strict_locals_node(erb_node, context->line_index, context->allocator, context->options);
 
     if (!strict_locals_node) { continue; }
 
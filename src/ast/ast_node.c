@@ -5,7 +5,6 @@
 #include "../include/lib/hb_string.h"
 #include "../include/location/position.h"
 #include "../include/util/util.h"
-#include "../include/visitor.h"
 
 #include <prism.h>
 #include <stdio.h>
@@ -50,6 +49,29 @@ AST_LITERAL_NODE_T* ast_literal_node_init_from_token(const token_T* token, hb_al
   return literal;
 }
 
+// Like ast_html_text_node_init, but `content` is referenced instead of copied. The caller guarantees that it
+// outlives the node, which holds for slices of the parsed source since tokens already point into it.
+AST_HTML_TEXT_NODE_T* ast_html_text_node_init_borrowed(
+  hb_string_T content,
+  position_T start,
+  position_T end,
+  hb_array_T* errors,
+  hb_allocator_T* allocator
+) {
+  AST_HTML_TEXT_NODE_T* text = hb_allocator_alloc(allocator, sizeof(AST_HTML_TEXT_NODE_T));
+
+  if (!text) { return NULL; }
+
+  ast_node_init(&text->base, AST_HTML_TEXT_NODE, start, end, errors, allocator);
+
+  text->content = content;
+  text->owns_content = false;
+
+  if (!hb_string_is_empty(content)) { hb_allocator_note_borrowed(allocator, content.length + 1); }
+
+  return text;
+}
+
 ast_node_type_T ast_node_type(const AST_NODE_T* node) {
   return node->type;
 }
@@ -78,30 +100,3 @@ void ast_node_set_positions_from_token(AST_NODE_T* node, const token_T* token) {
 bool ast_node_is(const AST_NODE_T* node, const ast_node_type_T type) {
   return node->type == type;
 }
-
-typedef struct {
-  position_T position;
-  AST_NODE_T* found_node;
-} find_erb_at_position_context_T;
-
-static bool find_erb_at_position_visitor(const AST_NODE_T* node, void* data) {
-  find_erb_at_position_context_T* context = (find_erb_at_position_context_T*) data;
-
-  if (node->type == AST_ERB_CONTENT_NODE) {
-    if (position_is_within_range(context->position, node->location.start, node->location.end)) {
-      context->found_node = (AST_NODE_T*) node;
-      return false;
-    }
-  }
-
-  return true;
-}
-
-AST_NODE_T* find_erb_content_at_offset(AST_DOCUMENT_NODE_T* document, const char* source, size_t offset) {
-  position_T position = position_from_source_with_offset(source, offset);
-  find_erb_at_position_context_T context = { .position = position, .found_node = NULL };
-
-  herb_visit_node((AST_NODE_T*) document, find_erb_at_position_visitor, &context);
-
-  return context.found_node;
-}
@@ -57,20 +57,31 @@ herb_diff_result_T* herb_diff(
   const herb_diff_options_T* options,
   hb_allocator_T* allocator
 ) {
-  herb_diff_result_T* result = (herb_diff_result_T*) hb_allocator_alloc(allocator, sizeof(herb_diff_result_T));
-  result->operations = hb_array_init(16, allocator);
-  result->allocator = allocator;
-  result->trees_identical = false;
-  result->options = (options != NULL) ? *options : HERB_DEFAULT_DIFF_OPTIONS;
-
   herb_hash_map_T old_hashes;
   herb_hash_map_T new_hashes;
 
   herb_hash_map_init(&old_hashes, 256, allocator);
   herb_hash_map_init(&new_hashes, 256, allocator);
 
-  herb_hash_T old_root_hash = herb_hash_tree((const AST_NODE_T*) old_document, &old_hashes);
-  herb_hash_T new_root_hash = herb_hash_tree((const AST_NODE_T*) new_document, &new_hashes);
+  return herb_diff_with_hashes(old_document, new_document, &old_hashes, &new_hashes, options, allocator);
+}
+
+herb_diff_result_T* herb_diff_with_hashes(
+  const AST_DOCUMENT_NODE_T* old_document,
+  const AST_DOCUMENT_NODE_T* new_document,
+  herb_hash_map_T* old_hashes,
+  herb_hash_map_T* new_hashes,
+  const herb_diff_options_T* options,
+  hb_allocator_T* allocator
+) {
+  herb_diff_result_T* result = (herb_diff_result_T*) hb_allocator_alloc(allocator, sizeof(herb_diff_result_T));
+  result->operations = hb_array_init(16, allocator);
+  result->allocator = allocator;
+  result->trees_identical = false;
+  result->options = (options != NULL) ? *options : HERB_DEFAULT_DIFF_OPTIONS;
+
+  herb_hash_T old_root_hash = herb_hash_tree((const AST_NODE_T*) old_document, old_hashes);
+  herb_hash_T new_root_hash = herb_hash_tree((const AST_NODE_T*) new_document, new_hashes);
 
   if (old_root_hash == new_root_hash) {
     result->trees_identical = true;
@@ -83,8 +94,8 @@ herb_diff_result_T* herb_diff(
     (const AST_NODE_T*) old_document,
     (const AST_NODE_T*) new_document,
     root_path,
-    &old_hashes,
-    &new_hashes,
+    old_hashes,
+    new_hashes,
     false,
     result
   );
@@ -2,6 +2,7 @@
 #include "../include/diff/herb_hash_index_map.h"
 #include "../include/macros.h"
 
+#include <stdint.h>
 #include <string.h>
 
 // Longest Common Subsequence (LCS) algorithm using dynamic programming.
@@ -10,6 +11,16 @@
 //   Longest Common Subsequences" (1977), Communications of the ACM, 20(5).
 // https://en.wikipedia.org/wiki/Longest_common_subsequence
 #define LCS_MAX_SIZE 256
+#define LCS_MAX_CELLS (LCS_MAX_SIZE * LCS_MAX_SIZE)
+
+// Ranges too large for the LCS table are split at anchors, children that occur exactly once on each side, taking
+// the longest run of anchors that appear in the same order on both sides. The ranges between anchors are diffed
+// recursively. This is patience diff, as described by Bram Cohen:
+// https://bramcohen.livejournal.com/73318.html
+#define ANCHOR_MAX_DEPTH 32
+
+// Wrap and unwrap detection searches every inserted subtree for every removed child.
+#define WRAP_MAX_PAIRS (LCS_MAX_SIZE * LCS_MAX_SIZE)
 
 typedef enum {
   EDIT_KEEP,
@@ -81,75 +92,351 @@ static bool nodes_match(
   return true;
 }
 
-static void diff_children_linear(
-  const hb_array_T* old_children,
-  const hb_array_T* new_children,
-  const herb_diff_path_T parent_path,
-  const herb_hash_map_T* old_hashes,
-  const herb_hash_map_T* new_hashes,
-  herb_diff_result_T* result
+typedef struct {
+  const hb_array_T* old_children;
+  const hb_array_T* new_children;
+  const herb_hash_map_T* old_hashes;
+  const herb_hash_map_T* new_hashes;
+  hb_allocator_T* allocator;
+  edit_entry_T* edit_script;
+  size_t edit_count;
+} diff_context_T;
+
+typedef herb_hash_T (*anchor_key_T)(const AST_NODE_T* node, const herb_hash_map_T* hash_map);
+
+typedef struct {
+  herb_hash_T key;
+  size_t old_count;
+  size_t new_count;
+  size_t old_index;
+  bool occupied;
+} anchor_slot_T;
+
+static void diff_range(
+  diff_context_T* context,
+  size_t old_start,
+  size_t old_end,
+  size_t new_start,
+  size_t new_end,
+  size_t depth
+);
+
+static bool children_match(const diff_context_T* context, const size_t old_index, const size_t new_index) {
+  const AST_NODE_T* old_child = (const AST_NODE_T*) hb_array_get(context->old_children, old_index);
+  const AST_NODE_T* new_child = (const AST_NODE_T*) hb_array_get(context->new_children, new_index);
+
+  return nodes_match(old_child, new_child, context->old_hashes, context->new_hashes);
+}
+
+// The edit script is built back to front, so the last edit pushed is the first one emitted.
+static void push_edit(diff_context_T* context, const edit_type_T type, const size_t old_index, const size_t new_index) {
+  edit_entry_T* entry = &context->edit_script[context->edit_count++];
+
+  entry->type = type;
+  entry->old_index = type == EDIT_INSERT ? 0 : old_index;
+  entry->new_index = type == EDIT_DELETE ? 0 : new_index;
+}
+
+static void diff_range_lcs(
+  diff_context_T* context,
+  const size_t old_start,
+  const size_t old_end,
+  const size_t new_start,
+  const size_t new_end
 ) {
-  const size_t old_size = hb_array_size(old_children);
-  const size_t new_size = hb_array_size(new_children);
+  const size_t old_size = old_end - old_start;
+  const size_t new_size = new_end - new_start;
 
-  size_t common_prefix = 0;
+  const size_t table_width = new_size + 1;
+  const size_t table_size = (old_size + 1) * table_width;
+  size_t* lcs_table = (size_t*) hb_allocator_alloc(context->allocator, table_size * sizeof(size_t));
+  memset(lcs_table, 0, table_size * sizeof(size_t));
 
-  while (common_prefix < old_size && common_prefix < new_size) {
-    const AST_NODE_T* old_child = (const AST_NODE_T*) hb_array_get(old_children, common_prefix);
-    const AST_NODE_T* new_child = (const AST_NODE_T*) hb_array_get(new_children, common_prefix);
-    herb_hash_T old_hash = herb_hash_map_get(old_hashes, old_child);
-    herb_hash_T new_hash = herb_hash_map_get(new_hashes, new_child);
+  for (size_t old_index = 1; old_index <= old_size; old_index++) {
+    for (size_t new_index = 1; new_index <= new_size; new_index++) {
+      if (children_match(context, old_start + old_index - 1, new_start + new_index - 1)) {
+        lcs_table[old_index * table_width + new_index] = lcs_table[(old_index - 1) * table_width + (new_index - 1)] + 1;
+      } else {
+        const size_t from_old = lcs_table[(old_index - 1) * table_width + new_index];
+        const size_t from_new = lcs_table[old_index * table_width + (new_index - 1)];
+        lcs_table[old_index * table_width + new_index] = MAX(from_old, from_new);
+      }
+    }
+  }
 
-    if (old_hash != new_hash) { break; }
+  size_t old_index = old_size;
+  size_t new_index = new_size;
 
-    common_prefix++;
+  while (old_index > 0 || new_index > 0) {
+    if (old_index > 0 && new_index > 0
+        && children_match(context, old_start + old_index - 1, new_start + new_index - 1)) {
+      push_edit(context, EDIT_KEEP, old_start + old_index - 1, new_start + new_index - 1);
+
+      old_index--;
+      new_index--;
+
+      continue;
+    }
+
+    if (new_index > 0
+        && (old_index == 0 || lcs_table[old_index * table_width + (new_index - 1)] >= lcs_table[(old_index - 1) * table_width + new_index])) {
+      push_edit(context, EDIT_INSERT, 0, new_start + new_index - 1);
+      new_index--;
+    } else {
+      push_edit(context, EDIT_DELETE, old_start + old_index - 1, 0);
+      old_index--;
+    }
+  }
+
+  hb_allocator_dealloc(context->allocator, lcs_table);
+}
+
+// Pairs children by position once nothing better is available, so that a rewritten range still diffs matching
+// pairs in place instead of removing and inserting every child.
+static void diff_range_positional(
+  diff_context_T* context,
+  const size_t old_start,
+  const size_t old_end,
+  const size_t new_start,
+  const size_t new_end
+) {
+  const size_t common = MIN(old_end - old_start, new_end - new_start);
+
+  for (size_t new_index = new_end; new_index > new_start + common; new_index--) {
+    push_edit(context, EDIT_INSERT, 0, new_index - 1);
+  }
+
+  for (size_t old_index = old_end; old_index > old_start + common; old_index--) {
+    push_edit(context, EDIT_DELETE, old_index - 1, 0);
+  }
+
+  for (size_t offset = common; offset > 0; offset--) {
+    const size_t old_index = old_start + offset - 1;
+    const size_t new_index = new_start + offset - 1;
+
+    if (children_match(context, old_index, new_index)) {
+      push_edit(context, EDIT_KEEP, old_index, new_index);
+    } else {
+      push_edit(context, EDIT_INSERT, 0, new_index);
+      push_edit(context, EDIT_DELETE, old_index, 0);
+    }
+  }
+}
+
+static herb_hash_T anchor_key_subtree(const AST_NODE_T* node, const herb_hash_map_T* hash_map) {
+  return herb_hash_map_get(hash_map, node);
+}
+
+static anchor_slot_T* anchor_slot_find(anchor_slot_T* slots, const size_t mask, const herb_hash_T key) {
+  size_t slot = (size_t) key & mask;
+
+  while (slots[slot].occupied && slots[slot].key != key) {
+    slot = (slot + 1) & mask;
   }
 
-  size_t common_suffix = 0;
+  return &slots[slot];
+}
 
-  while (common_suffix < (old_size - common_prefix) && common_suffix < (new_size - common_prefix)) {
-    const AST_NODE_T* old_child = (const AST_NODE_T*) hb_array_get(old_children, old_size - 1 - common_suffix);
-    const AST_NODE_T* new_child = (const AST_NODE_T*) hb_array_get(new_children, new_size - 1 - common_suffix);
+// Finds the anchors of a range and returns how many there are, in increasing order on both sides.
+static size_t find_anchors(
+  diff_context_T* context,
+  const size_t old_start,
+  const size_t old_end,
+  const size_t new_start,
+  const size_t new_end,
+  const anchor_key_T anchor_key,
+  size_t** anchors_old,
+  size_t** anchors_new
+) {
+  const size_t old_size = old_end - old_start;
+  const size_t new_size = new_end - new_start;
+
+  size_t capacity = 16;
+  while (capacity < 2 * (old_size + new_size)) {
+    capacity *= 2;
+  }
 
-    herb_hash_T old_hash = herb_hash_map_get(old_hashes, old_child);
-    herb_hash_T new_hash = herb_hash_map_get(new_hashes, new_child);
+  const size_t mask = capacity - 1;
+  anchor_slot_T* slots = (anchor_slot_T*) hb_allocator_alloc(context->allocator, capacity * sizeof(anchor_slot_T));
+  memset(slots, 0, capacity * sizeof(anchor_slot_T));
 
-    if (old_hash != new_hash) { break; }
+  for (size_t old_index = old_start; old_index < old_end; old_index++) {
+    const AST_NODE_T* old_child = (const AST_NODE_T*) hb_array_get(context->old_children, old_index);
+    herb_hash_T key = anchor_key(old_child, context->old_hashes);
+    anchor_slot_T* slot = anchor_slot_find(slots, mask, key);
 
-    common_suffix++;
+    slot->key = key;
+    slot->occupied = true;
+    slot->old_count++;
+    slot->old_index = old_index;
   }
 
-  const size_t old_middle_start = common_prefix;
-  const size_t old_middle_end = old_size - common_suffix;
-  const size_t new_middle_start = common_prefix;
-  const size_t new_middle_end = new_size - common_suffix;
-
-  for (size_t index = old_middle_start; index < old_middle_end; index++) {
-    const AST_NODE_T* old_child = (const AST_NODE_T*) hb_array_get(old_children, index);
-
-    herb_diff_emit_operation(
-      result,
-      HERB_DIFF_NODE_REMOVED,
-      herb_diff_path_append(parent_path, (uint32_t) index),
-      old_child,
-      NULL,
-      (uint32_t) index,
-      0
-    );
+  herb_hash_T* new_keys = (herb_hash_T*) hb_allocator_alloc(context->allocator, new_size * sizeof(herb_hash_T));
+
+  for (size_t new_index = new_start; new_index < new_end; new_index++) {
+    const AST_NODE_T* new_child = (const AST_NODE_T*) hb_array_get(context->new_children, new_index);
+    herb_hash_T key = anchor_key(new_child, context->new_hashes);
+    anchor_slot_T* slot = anchor_slot_find(slots, mask, key);
+
+    new_keys[new_index - new_start] = key;
+    slot->key = key;
+    slot->occupied = true;
+    slot->new_count++;
   }
 
-  for (size_t index = new_middle_start; index < new_middle_end; index++) {
-    const AST_NODE_T* new_child = (const AST_NODE_T*) hb_array_get(new_children, index);
-
-    herb_diff_emit_operation(
-      result,
-      HERB_DIFF_NODE_INSERTED,
-      herb_diff_path_append(parent_path, (uint32_t) index),
-      NULL,
-      new_child,
-      0,
-      (uint32_t) index
-    );
+  // Candidates in new order; the anchors are the longest subsequence of them that is also increasing in old order.
+  size_t* candidate_old = (size_t*) hb_allocator_alloc(context->allocator, new_size * sizeof(size_t));
+  size_t* candidate_new = (size_t*) hb_allocator_alloc(context->allocator, new_size * sizeof(size_t));
+  size_t candidate_count = 0;
+
+  for (size_t new_index = new_start; new_index < new_end; new_index++) {
+    const anchor_slot_T* slot = anchor_slot_find(slots, mask, new_keys[new_index - new_start]);
+
+    if (slot->old_count == 1 && slot->new_count == 1) {
+      candidate_old[candidate_count] = slot->old_index;
+      candidate_new[candidate_count] = new_index;
+      candidate_count++;
+    }
+  }
+
+  hb_allocator_dealloc(context->allocator, new_keys);
+  hb_allocator_dealloc(context->allocator, slots);
+
+  size_t anchor_count = 0;
+
+  if (candidate_count > 0) {
+    size_t* tails = (size_t*) hb_allocator_alloc(context->allocator, candidate_count * sizeof(size_t));
+    size_t* previous = (size_t*) hb_allocator_alloc(context->allocator, candidate_count * sizeof(size_t));
+
+    for (size_t candidate = 0; candidate < candidate_count; candidate++) {
+      size_t low = 0;
+      size_t high = anchor_count;
+
+      while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+
+        if (candidate_old[tails[middle]] < candidate_old[candidate]) {
+          low = middle + 1;
+        } else {
+          high = middle;
+        }
+      }
+
+      previous[candidate] = low > 0 ? tails[low - 1] : SIZE_MAX;
+      tails[low] = candidate;
+
+      if (low == anchor_count) { anchor_count++; }
+    }
+
+    *anchors_old = (size_t*) hb_allocator_alloc(context->allocator, anchor_count * sizeof(size_t));
+    *anchors_new = (size_t*) hb_allocator_alloc(context->allocator, anchor_count * sizeof(size_t));
+
+    size_t candidate = tails[anchor_count - 1];
+
+    for (size_t position = anchor_count; position > 0; position--) {
+      (*anchors_old)[position - 1] = candidate_old[candidate];
+      (*anchors_new)[position - 1] = candidate_new[candidate];
+      candidate = previous[candidate];
+    }
+
+    hb_allocator_dealloc(context->allocator, previous);
+    hb_allocator_dealloc(context->allocator, tails);
+  }
+
+  hb_allocator_dealloc(context->allocator, candidate_new);
+  hb_allocator_dealloc(context->allocator, candidate_old);
+
+  return anchor_count;
+}
+
+static bool diff_range_anchored(
+  diff_context_T* context,
+  const size_t old_start,
+  const size_t old_end,
+  const size_t new_start,
+  const size_t new_end,
+  const anchor_key_T anchor_key,
+  const size_t depth
+) {
+  size_t* anchors_old = NULL;
+  size_t* anchors_new = NULL;
+
+  const size_t anchor_count =
+    find_anchors(context, old_start, old_end, new_start, new_end, anchor_key, &anchors_old, &anchors_new);
+
+  if (anchor_count == 0) { return false; }
+
+  size_t old_gap_end = old_end;
+  size_t new_gap_end = new_end;
+
+  for (size_t anchor = anchor_count; anchor > 0; anchor--) {
+    const size_t old_anchor = anchors_old[anchor - 1];
+    const size_t new_anchor = anchors_new[anchor - 1];
+
+    diff_range(context, old_anchor + 1, old_gap_end, new_anchor + 1, new_gap_end, depth + 1);
+    push_edit(context, EDIT_KEEP, old_anchor, new_anchor);
+
+    old_gap_end = old_anchor;
+    new_gap_end = new_anchor;
+  }
+
+  diff_range(context, old_start, old_gap_end, new_start, new_gap_end, depth + 1);
+
+  hb_allocator_dealloc(context->allocator, anchors_new);
+  hb_allocator_dealloc(context->allocator, anchors_old);
+
+  return true;
+}
+
+static void diff_range(
+  diff_context_T* context,
+  size_t old_start,
+  size_t old_end,
+  size_t new_start,
+  size_t new_end,
+  const size_t depth
+) {
+  // Walking the LCS table back from the end matches the common suffix first, so trimming it here changes nothing
+  // for ranges that fit the table. The common prefix is only trimmed for ranges that do not.
+  while (old_end > old_start && new_end > new_start && children_match(context, old_end - 1, new_end - 1)) {
+    push_edit(context, EDIT_KEEP, old_end - 1, new_end - 1);
+
+    old_end--;
+    new_end--;
+  }
+
+  if (old_end - old_start == 0 || new_end - new_start == 0
+      || (old_end - old_start) * (new_end - new_start) <= LCS_MAX_CELLS) {
+    diff_range_lcs(context, old_start, old_end, new_start, new_end);
+    return;
+  }
+
+  size_t common_prefix = 0;
+
+  while (old_start + common_prefix < old_end && new_start + common_prefix < new_end
+         && children_match(context, old_start + common_prefix, new_start + common_prefix)) {
+    common_prefix++;
+  }
+
+  const size_t old_middle_start = old_start + common_prefix;
+  const size_t new_middle_start = new_start + common_prefix;
+  const size_t old_size = old_end - old_middle_start;
+  const size_t new_size = new_end - new_middle_start;
+
+  if (old_size == 0 || new_size == 0 || old_size * new_size <= LCS_MAX_CELLS) {
+    diff_range_lcs(context, old_middle_start, old_end, new_middle_start, new_end);
+  } else if (depth >= ANCHOR_MAX_DEPTH
+             || (!diff_range_anchored(
+                   context, old_middle_start, old_end, new_middle_start, new_end, anchor_key_subtree, depth
+                 )
+                 && !diff_range_anchored(
+                   context, old_middle_start, old_end, new_middle_start, new_end, herb_hash_node_move_identity, depth
+                 ))) {
+    diff_range_positional(context, old_middle_start, old_end, new_middle_start, new_end);
+  }
+
+  for (size_t offset = common_prefix; offset > 0; offset--) {
+    push_edit(context, EDIT_KEEP, old_start + offset - 1, new_start + offset - 1);
   }
 }
 
@@ -205,73 +492,20 @@ void herb_diff_children(
 
   if (old_size == 0 && new_size == 0) { return; }
 
-  if (old_size > LCS_MAX_SIZE || new_size > LCS_MAX_SIZE) {
-    diff_children_linear(old_children, new_children, parent_path, old_hashes, new_hashes, result);
-    return;
-  }
-
-  const size_t table_width = new_size + 1;
-  const size_t table_size = (old_size + 1) * table_width;
-  size_t* lcs_table = (size_t*) hb_allocator_alloc(result->allocator, table_size * sizeof(size_t));
-  memset(lcs_table, 0, table_size * sizeof(size_t));
-
-  for (size_t old_index = 1; old_index <= old_size; old_index++) {
-    for (size_t new_index = 1; new_index <= new_size; new_index++) {
-      const AST_NODE_T* old_child = (const AST_NODE_T*) hb_array_get(old_children, old_index - 1);
-      const AST_NODE_T* new_child = (const AST_NODE_T*) hb_array_get(new_children, new_index - 1);
-
-      if (nodes_match(old_child, new_child, old_hashes, new_hashes)) {
-        lcs_table[old_index * table_width + new_index] = lcs_table[(old_index - 1) * table_width + (new_index - 1)] + 1;
-      } else {
-        const size_t from_old = lcs_table[(old_index - 1) * table_width + new_index];
-        const size_t from_new = lcs_table[old_index * table_width + (new_index - 1)];
-        lcs_table[old_index * table_width + new_index] = MAX(from_old, from_new);
-      }
-    }
-  }
-
-  size_t edit_capacity = old_size + new_size;
-  size_t edit_count = 0;
-
-  edit_entry_T* edit_script =
-    (edit_entry_T*) hb_allocator_alloc(result->allocator, edit_capacity * sizeof(edit_entry_T));
+  diff_context_T context = {
+    .old_children = old_children,
+    .new_children = new_children,
+    .old_hashes = old_hashes,
+    .new_hashes = new_hashes,
+    .allocator = result->allocator,
+    .edit_script = (edit_entry_T*) hb_allocator_alloc(result->allocator, (old_size + new_size) * sizeof(edit_entry_T)),
+    .edit_count = 0,
+  };
 
-  size_t old_index = old_size;
-  size_t new_index = new_size;
-
-  while (old_index > 0 || new_index > 0) {
-    if (old_index > 0 && new_index > 0) {
-      const AST_NODE_T* old_child = (const AST_NODE_T*) hb_array_get(old_children, old_index - 1);
-      const AST_NODE_T* new_child = (const AST_NODE_T*) hb_array_get(new_children, new_index - 1);
-
-      if (nodes_match(old_child, new_child, old_hashes, new_hashes)) {
-        edit_script[edit_count].type = EDIT_KEEP;
-        edit_script[edit_count].old_index = old_index - 1;
-        edit_script[edit_count].new_index = new_index - 1;
-        edit_count++;
+  diff_range(&context, 0, old_size, 0, new_size, 0);
 
-        old_index--;
-        new_index--;
-
-        continue;
-      }
-    }
-
-    if (new_index > 0
-        && (old_index == 0 || lcs_table[old_index * table_width + (new_index - 1)] >= lcs_table[(old_index - 1) * table_width + new_index])) {
-      edit_script[edit_count].type = EDIT_INSERT;
-      edit_script[edit_count].old_index = 0;
-      edit_script[edit_count].new_index = new_index - 1;
-      edit_count++;
-      new_index--;
-    } else {
-      edit_script[edit_count].type = EDIT_DELETE;
-      edit_script[edit_count].old_index = old_index - 1;
-      edit_script[edit_count].new_index = 0;
-      edit_count++;
-      old_index--;
-    }
-  }
+  edit_entry_T* edit_script = context.edit_script;
+  const size_t edit_count = context.edit_count;
 
   size_t remove_count = 0;
   size_t insert_count = 0;
@@ -377,45 +611,47 @@ void herb_diff_children(
       }
     }
 
-    for (size_t remove_index = 0; remove_index < remove_count; remove_index++) {
-      if (remove_matched[remove_index]) { continue; }
+    if (remove_count * insert_count <= WRAP_MAX_PAIRS) {
+      for (size_t remove_index = 0; remove_index < remove_count; remove_index++) {
+        if (remove_matched[remove_index]) { continue; }
 
-      const edit_entry_T* remove_entry = &edit_script[remove_indices[remove_index]];
-      const AST_NODE_T* old_child = (const AST_NODE_T*) hb_array_get(old_children, remove_entry->old_index);
+        const edit_entry_T* remove_entry = &edit_script[remove_indices[remove_index]];
+        const AST_NODE_T* old_child = (const AST_NODE_T*) hb_array_get(old_children, remove_entry->old_index);
 
-      herb_hash_T old_hash = herb_hash_map_get(old_hashes, old_child);
+        herb_hash_T old_hash = herb_hash_map_get(old_hashes, old_child);
 
-      for (size_t insert_index = 0; insert_index < insert_count; insert_index++) {
-        if (insert_matched[insert_index]) { continue; }
+        for (size_t insert_index = 0; insert_index < insert_count; insert_index++) {
+          if (insert_matched[insert_index]) { continue; }
 
-        const edit_entry_T* insert_entry = &edit_script[insert_indices[insert_index]];
-        const AST_NODE_T* new_child = (const AST_NODE_T*) hb_array_get(new_children, insert_entry->new_index);
-        herb_hash_T new_hash = herb_hash_map_get(new_hashes, new_child);
+          const edit_entry_T* insert_entry = &edit_script[insert_indices[insert_index]];
+          const AST_NODE_T* new_child = (const AST_NODE_T*) hb_array_get(new_children, insert_entry->new_index);
+          herb_hash_T new_hash = herb_hash_map_get(new_hashes, new_child);
 
-        const AST_NODE_T* found_in_new = herb_diff_find_child_by_hash(new_child, old_hash, new_hashes);
+          const AST_NODE_T* found_in_new = herb_diff_find_child_by_hash(new_child, old_hash, new_hashes);
 
-        if (found_in_new != NULL) {
-          remove_matched[remove_index] = true;
-          insert_matched[insert_index] = true;
+          if (found_in_new != NULL) {
+            remove_matched[remove_index] = true;
+            insert_matched[insert_index] = true;
 
-          edit_script[remove_indices[remove_index]].type = EDIT_WRAP;
-          edit_script[remove_indices[remove_index]].new_index = insert_entry->new_index;
-          edit_script[insert_indices[insert_index]].type = EDIT_CONSUMED;
+            edit_script[remove_indices[remove_index]].type = EDIT_WRAP;
+            edit_script[remove_indices[remove_index]].new_index = insert_entry->new_index;
+            edit_script[insert_indices[insert_index]].type = EDIT_CONSUMED;
 
-          break;
-        }
+            break;
+          }
 
-        const AST_NODE_T* found_in_old = herb_diff_find_child_by_hash(old_child, new_hash, old_hashes);
+          const AST_NODE_T* found_in_old = herb_diff_find_child_by_hash(old_child, new_hash, old_hashes);
 
-        if (found_in_old != NULL) {
-          remove_matched[remove_index] = true;
-          insert_matched[insert_index] = true;
+          if (found_in_old != NULL) {
+            remove_matched[remove_index] = true;
+            insert_matched[insert_index] = true;
 
-          edit_script[remove_indices[remove_index]].type = EDIT_UNWRAP;
-          edit_script[remove_indices[remove_index]].new_index = insert_entry->new_index;
-          edit_script[insert_indices[insert_index]].type = EDIT_CONSUMED;
+            edit_script[remove_indices[remove_index]].type = EDIT_UNWRAP;
+            edit_script[remove_indices[remove_index]].new_index = insert_entry->new_index;
+            edit_script[insert_indices[insert_index]].type = EDIT_CONSUMED;
 
-          break;
+            break;
+          }
         }
       }
     }
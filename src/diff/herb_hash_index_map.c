@@ -1,13 +1,27 @@
 #include "../include/diff/herb_hash_index_map.h"
 
+#include <stdint.h>
 #include <string.h>
 
+#define HERB_HASH_INDEX_NONE SIZE_MAX
+
+static herb_hash_index_entry_T* find_entry(const herb_hash_index_map_T* map, herb_hash_T key) {
+  size_t slot = (size_t) (key % map->capacity);
+
+  while (map->entries[slot].occupied && map->entries[slot].key != key) {
+    slot = (slot + 1) % map->capacity;
+  }
+
+  return &map->entries[slot];
+}
+
 bool herb_hash_index_map_init(herb_hash_index_map_T* map, size_t count, hb_allocator_T* allocator) {
   map->capacity = count < 4 ? 8 : count * 3;
   size_t alloc_size = map->capacity * sizeof(herb_hash_index_entry_T);
   map->entries = (herb_hash_index_entry_T*) hb_allocator_alloc(allocator, alloc_size);
+  map->next = (size_t*) hb_allocator_alloc(allocator, (count > 0 ? count : 1) * sizeof(size_t));
 
-  if (map->entries == NULL) { return false; }
+  if (map->entries == NULL || map->next == NULL) { return false; }
 
   memset(map->entries, 0, alloc_size);
 
@@ -15,33 +29,40 @@ bool herb_hash_index_map_init(herb_hash_index_map_T* map, size_t count, hb_alloc
 }
 
 void herb_hash_index_map_insert(herb_hash_index_map_T* map, herb_hash_T key, size_t value) {
-  size_t slot = (size_t) (key % map->capacity);
+  herb_hash_index_entry_T* entry = find_entry(map, key);
 
-  while (map->entries[slot].occupied) {
-    slot = (slot + 1) % map->capacity;
+  map->next[value] = HERB_HASH_INDEX_NONE;
+
+  if (!entry->occupied) {
+    entry->key = key;
+    entry->head = value;
+    entry->occupied = true;
+  } else if (entry->head == HERB_HASH_INDEX_NONE) {
+    entry->head = value;
+  } else {
+    map->next[entry->tail] = value;
   }
 
-  map->entries[slot].key = key;
-  map->entries[slot].value = value;
-  map->entries[slot].occupied = true;
+  entry->tail = value;
 }
 
 bool herb_hash_index_map_find_unmatched(
-  const herb_hash_index_map_T* map,
+  herb_hash_index_map_T* map,
   herb_hash_T key,
   const bool* matched,
   size_t* out_value
 ) {
-  size_t slot = (size_t) (key % map->capacity);
+  herb_hash_index_entry_T* entry = find_entry(map, key);
 
-  while (map->entries[slot].occupied) {
-    if (map->entries[slot].key == key && !matched[map->entries[slot].value]) {
-      *out_value = map->entries[slot].value;
-      return true;
-    }
+  if (!entry->occupied) { return false; }
 
-    slot = (slot + 1) % map->capacity;
+  while (entry->head != HERB_HASH_INDEX_NONE && matched[entry->head]) {
+    entry->head = map->next[entry->head];
   }
 
-  return false;
+  if (entry->head == HERB_HASH_INDEX_NONE) { return false; }
+
+  *out_value = entry->head;
+
+  return true;
 }
@@ -1,4 +1,5 @@
 #include "include/herb.h"
+#include "include/lexer/token_list.h"
 #include "include/lib/hb_allocator.h"
 #include "include/lib/hb_array.h"
 #include "include/lib/hb_buffer.h"
@@ -13,209 +14,250 @@ const herb_extract_ruby_options_T HERB_EXTRACT_RUBY_DEFAULT_OPTIONS = { .semicol
                                                                         .comments = false,
                                                                         .preserve_positions = true };
 
-void herb_extract_ruby_to_buffer_with_options(
-  const char* source,
-  hb_buffer_T* output,
-  const herb_extract_ruby_options_T* options,
-  hb_allocator_T* allocator
-) {
-  herb_extract_ruby_options_T extract_options = options ? *options : HERB_EXTRACT_RUBY_DEFAULT_OPTIONS;
-
-  hb_array_T* tokens = herb_lex(source, allocator);
-  bool skip_erb_content = false;
-  bool is_comment_tag = false;
-  bool is_erb_comment_tag = false;
-  bool need_newline = false;
-
-  for (size_t i = 0; i < hb_array_size(tokens); i++) {
-    const token_T* token = hb_array_get(tokens, i);
-
-    switch (token->type) {
-      case TOKEN_NEWLINE: {
-        hb_buffer_append_string(output, token->value);
-        need_newline = false;
-        break;
-      }
+typedef struct {
+  herb_extract_ruby_options_T options;
+  hb_buffer_T* output;
+  bool skip_erb_content;
+  bool is_comment_tag;
+  bool is_erb_comment_tag;
+  bool need_newline;
+  bool pending_comment_marker;
+} extract_ruby_state_T;
+
+// The marker for a `<%#` tag depends on whether the comment that follows spans multiple lines, so it is
+// written once the next token is known.
+static void extract_ruby_flush_comment_marker(extract_ruby_state_T* state, const token_T* next) {
+  state->pending_comment_marker = false;
+
+  bool is_multiline = next->type == TOKEN_ERB_CONTENT && !hb_string_is_null(next->value)
+                   && memchr(next->value.data, '\n', next->value.length) != NULL;
+
+  if (is_multiline) {
+    hb_buffer_append_char(state->output, '#');
+    hb_buffer_append_whitespace(state->output, 2);
+  } else {
+    hb_buffer_append_whitespace(state->output, 2);
+    hb_buffer_append_char(state->output, '#');
+  }
+}
 
-      case TOKEN_ERB_START: {
-        is_erb_comment_tag = hb_string_equals(token->value, hb_string("<%#"));
+static bool extract_ruby_token(const token_T* token, void* data) {
+  extract_ruby_state_T* state = (extract_ruby_state_T*) data;
+  const herb_extract_ruby_options_T* options = &state->options;
+  hb_buffer_T* output = state->output;
 
-        if (is_erb_comment_tag) {
-          if (extract_options.comments) {
-            skip_erb_content = false;
-            is_comment_tag = false;
+  if (state->pending_comment_marker) { extract_ruby_flush_comment_marker(state, token); }
 
-            if (extract_options.preserve_positions) {
-              bool is_multiline = false;
+  switch (token->type) {
+    case TOKEN_NEWLINE: {
+      hb_buffer_append_string(output, token->value);
+      state->need_newline = false;
+      break;
+    }
 
-              if (i + 1 < hb_array_size(tokens)) {
-                const token_T* next = hb_array_get(tokens, i + 1);
+    case TOKEN_ERB_START: {
+      state->is_erb_comment_tag = hb_string_equals(token->value, hb_string("<%#"));
 
-                if (next->type == TOKEN_ERB_CONTENT && !hb_string_is_null(next->value)
-                    && memchr(next->value.data, '\n', next->value.length) != NULL) {
-                  is_multiline = true;
-                }
-              }
+      if (state->is_erb_comment_tag) {
+        if (options->comments) {
+          state->skip_erb_content = false;
+          state->is_comment_tag = false;
 
-              if (is_multiline) {
-                hb_buffer_append_char(output, '#');
-                hb_buffer_append_whitespace(output, 2);
-              } else {
-                hb_buffer_append_whitespace(output, 2);
-                hb_buffer_append_char(output, '#');
-              }
-            } else {
-              if (need_newline) { hb_buffer_append_char(output, '\n'); }
-              hb_buffer_append_char(output, '#');
-              need_newline = true;
-            }
+          if (options->preserve_positions) {
+            state->pending_comment_marker = true;
           } else {
-            skip_erb_content = true;
-            is_comment_tag = true;
-            if (extract_options.preserve_positions) { hb_buffer_append_whitespace(output, range_length(token->range)); }
+            if (state->need_newline) { hb_buffer_append_char(output, '\n'); }
+            hb_buffer_append_char(output, '#');
+            state->need_newline = true;
           }
-        } else if (hb_string_equals(token->value, hb_string("<%%")) || hb_string_equals(token->value, hb_string("<%%="))
-                   || hb_string_equals(token->value, hb_string("<%graphql"))) {
-          skip_erb_content = true;
-          is_comment_tag = false;
-          if (extract_options.preserve_positions) { hb_buffer_append_whitespace(output, range_length(token->range)); }
         } else {
-          skip_erb_content = false;
-          is_comment_tag = false;
-
-          if (extract_options.preserve_positions) {
-            hb_buffer_append_whitespace(output, range_length(token->range));
-          } else if (need_newline) {
-            hb_buffer_append_char(output, '\n');
-            need_newline = false;
-          }
+          state->skip_erb_content = true;
+          state->is_comment_tag = true;
+          if (options->preserve_positions) { hb_buffer_append_whitespace(output, range_length(token->range)); }
+        }
+      } else if (hb_string_equals(token->value, hb_string("<%%")) || hb_string_equals(token->value, hb_string("<%%="))
+                 || hb_string_equals(token->value, hb_string("<%graphql"))) {
+        state->skip_erb_content = true;
+        state->is_comment_tag = false;
+        if (options->preserve_positions) { hb_buffer_append_whitespace(output, range_length(token->range)); }
+      } else {
+        state->skip_erb_content = false;
+        state->is_comment_tag = false;
+
+        if (options->preserve_positions) {
+          hb_buffer_append_whitespace(output, range_length(token->range));
+        } else if (state->need_newline) {
+          hb_buffer_append_char(output, '\n');
+          state->need_newline = false;
         }
-
-        break;
       }
 
-      case TOKEN_ERB_CONTENT: {
-        if (skip_erb_content == false) {
-          bool is_inline_comment = false;
+      break;
+    }
 
-          if (!extract_options.comments && !is_comment_tag && !hb_string_is_empty(token->value)) {
-            hb_string_T trimmed = hb_string_trim_start(token->value);
+    case TOKEN_ERB_CONTENT: {
+      if (state->skip_erb_content == false) {
+        bool is_inline_comment = false;
 
-            if (!hb_string_is_empty(trimmed) && trimmed.data[0] == '#'
-                && token->location.start.line == token->location.end.line) {
-              is_comment_tag = true;
-              is_inline_comment = true;
-            }
-          }
+        if (!options->comments && !state->is_comment_tag && !hb_string_is_empty(token->value)) {
+          hb_string_T trimmed = hb_string_trim_start(token->value);
 
-          if (is_inline_comment) {
-            if (extract_options.preserve_positions) { hb_buffer_append_whitespace(output, range_length(token->range)); }
-          } else if (is_erb_comment_tag && !hb_string_is_null(token->value)) {
-            const char* content = token->value.data;
-            size_t content_remaining = token->value.length;
+          bool is_single_line = memchr(token->value.data, '\n', token->value.length) == NULL
+                             && memchr(token->value.data, '\r', token->value.length) == NULL;
 
-            while (content_remaining > 0) {
-              if (*content == '\n') {
-                hb_buffer_append_char(output, '\n');
-                content++;
-                content_remaining--;
+          if (!hb_string_is_empty(trimmed) && trimmed.data[0] == '#' && is_single_line) {
+            state->is_comment_tag = true;
+            is_inline_comment = true;
+          }
+        }
 
-                if (content_remaining > 0 && extract_options.preserve_positions && *content == ' ') {
-                  content++;
-                  content_remaining--;
-                }
+        if (is_inline_comment) {
+          if (options->preserve_positions) { hb_buffer_append_whitespace(output, range_length(token->range)); }
+        } else if (state->is_erb_comment_tag && !hb_string_is_null(token->value)) {
+          const char* content = token->value.data;
+          size_t content_remaining = token->value.length;
 
-                hb_buffer_append_char(output, '#');
-              } else {
-                hb_buffer_append_char(output, *content);
+          while (content_remaining > 0) {
+            if (*content == '\n') {
+              hb_buffer_append_char(output, '\n');
+              content++;
+              content_remaining--;
+
+              if (content_remaining > 0 && options->preserve_positions && *content == ' ') {
                 content++;
                 content_remaining--;
               }
-            }
-
-            if (!extract_options.preserve_positions) { need_newline = true; }
-          } else {
-            hb_buffer_append_string(output, token->value);
-
-            if (!extract_options.preserve_positions) { need_newline = true; }
-          }
-        } else {
-          if (is_erb_comment_tag && extract_options.preserve_positions && !hb_string_is_null(token->value)) {
-            const char* content = token->value.data;
-            size_t content_remaining = token->value.length;
-
-            while (content_remaining > 0) {
-              if (*content == '\n') {
-                hb_buffer_append_char(output, '\n');
-              } else {
-                hb_buffer_append_char(output, ' ');
-              }
 
+              hb_buffer_append_char(output, '#');
+            } else {
+              hb_buffer_append_char(output, *content);
               content++;
               content_remaining--;
             }
-          } else if (extract_options.preserve_positions) {
-            hb_buffer_append_whitespace(output, range_length(token->range));
           }
-        }
 
-        break;
-      }
+          if (!options->preserve_positions) { state->need_newline = true; }
+        } else {
+          hb_buffer_append_string(output, token->value);
 
-      case TOKEN_ERB_END: {
-        bool was_comment = is_comment_tag;
-        bool was_erb_comment = is_erb_comment_tag;
-        skip_erb_content = false;
-        is_comment_tag = false;
-        is_erb_comment_tag = false;
-
-        if (extract_options.preserve_positions) {
-          if (was_comment) {
-            hb_buffer_append_whitespace(output, range_length(token->range));
-          } else if (was_erb_comment && extract_options.comments) {
-            hb_buffer_append_whitespace(output, range_length(token->range));
-          } else if (extract_options.semicolons) {
-            size_t length = range_length(token->range);
-
-            if (length >= 2) { hb_buffer_append_char(output, ' '); }
-            if (length >= 1) { hb_buffer_append_char(output, ';'); }
-            if (length >= 2) { hb_buffer_append_whitespace(output, length - 2); }
-          } else {
-            hb_buffer_append_whitespace(output, range_length(token->range));
-          }
+          if (!options->preserve_positions) { state->need_newline = true; }
         }
+      } else {
+        if (state->is_erb_comment_tag && options->preserve_positions && !hb_string_is_null(token->value)) {
+          const char* content = token->value.data;
+          size_t content_remaining = token->value.length;
+
+          while (content_remaining > 0) {
+            if (*content == '\n') {
+              hb_buffer_append_char(output, '\n');
+            } else {
+              hb_buffer_append_char(output, ' ');
+            }
 
-        break;
+            content++;
+            content_remaining--;
+          }
+        } else if (options->preserve_positions) {
+          hb_buffer_append_whitespace(output, range_length(token->range));
+        }
       }
 
-      default: {
-        if (extract_options.preserve_positions) { hb_buffer_append_whitespace(output, range_length(token->range)); }
+      break;
+    }
+
+    case TOKEN_ERB_END: {
+      bool was_comment = state->is_comment_tag;
+      bool was_erb_comment = state->is_erb_comment_tag;
+      state->skip_erb_content = false;
+      state->is_comment_tag = false;
+      state->is_erb_comment_tag = false;
+
+      if (options->preserve_positions) {
+        if (was_comment) {
+          hb_buffer_append_whitespace(output, range_length(token->range));
+        } else if (was_erb_comment && options->comments) {
+          hb_buffer_append_whitespace(output, range_length(token->range));
+        } else if (options->semicolons) {
+          size_t length = range_length(token->range);
+
+          if (length >= 2) { hb_buffer_append_char(output, ' '); }
+          if (length >= 1) { hb_buffer_append_char(output, ';'); }
+          if (length >= 2) { hb_buffer_append_whitespace(output, length - 2); }
+        } else {
+          hb_buffer_append_whitespace(output, range_length(token->range));
+        }
       }
+
+      break;
+    }
+
+    default: {
+      if (options->preserve_positions) { hb_buffer_append_whitespace(output, range_length(token->range)); }
     }
   }
 
-  herb_free_tokens(&tokens, allocator);
+  return true;
+}
+
+void herb_extract_ruby_to_buffer_with_options(
+  const char* source,
+  hb_buffer_T* output,
+  const herb_extract_ruby_options_T* options,
+  hb_allocator_T* allocator
+) {
+  extract_ruby_state_T state = { 0 };
+  state.options = options ? *options : HERB_EXTRACT_RUBY_DEFAULT_OPTIONS;
+  state.output = output;
+
+  herb_lex_each(source, extract_ruby_token, &state, allocator);
+}
+
+// Token lists store no locations, so the callbacks above must only read a token's type, value and range.
+static void extract_each_listed_token(const token_list_T* tokens, herb_token_callback_T callback, void* data) {
+  for (size_t index = 0; index < token_list_size(tokens); index++) {
+    token_T token = { .value = token_list_value(tokens, index),
+                      .range = token_list_range(tokens, index),
+                      .type = token_list_type(tokens, index) };
+
+    if (!callback(&token, data)) { break; }
+  }
+}
+
+void herb_extract_ruby_from_token_list(
+  const token_list_T* tokens,
+  hb_buffer_T* output,
+  const herb_extract_ruby_options_T* options
+) {
+  extract_ruby_state_T state = { 0 };
+  state.options = options ? *options : HERB_EXTRACT_RUBY_DEFAULT_OPTIONS;
+  state.output = output;
+
+  extract_each_listed_token(tokens, extract_ruby_token, &state);
 }
 
 void herb_extract_ruby_to_buffer(const char* source, hb_buffer_T* output, hb_allocator_T* allocator) {
   herb_extract_ruby_to_buffer_with_options(source, output, NULL, allocator);
 }
 
-void herb_extract_html_to_buffer(const char* source, hb_buffer_T* output, hb_allocator_T* allocator) {
-  hb_array_T* tokens = herb_lex(source, allocator);
-
-  for (size_t i = 0; i < hb_array_size(tokens); i++) {
-    const token_T* token = hb_array_get(tokens, i);
+static bool extract_html_token(const token_T* token, void* data) {
+  hb_buffer_T* output = (hb_buffer_T*) data;
 
-    switch (token->type) {
-      case TOKEN_ERB_START:
-      case TOKEN_ERB_CONTENT:
-      case TOKEN_ERB_END: hb_buffer_append_whitespace(output, range_length(token->range)); break;
-      default: hb_buffer_append_string(output, token->value);
-    }
+  switch (token->type) {
+    case TOKEN_ERB_START:
+    case TOKEN_ERB_CONTENT:
+    case TOKEN_ERB_END: hb_buffer_append_whitespace(output, range_length(token->range)); break;
+    default: hb_buffer_append_string(output, token->value);
   }
 
-  herb_free_tokens(&tokens, allocator);
+  return true;
+}
+
+void herb_extract_html_to_buffer(const char* source, hb_buffer_T* output, hb_allocator_T* allocator) {
+  herb_lex_each(source, extract_html_token, output, allocator);
+}
+
+void herb_extract_html_from_token_list(const token_list_T* tokens, hb_buffer_T* output) {
+  extract_each_listed_token(tokens, extract_html_token, output);
 }
 
 char* herb_extract_ruby_with_semicolons(const char* source, hb_allocator_T* allocator) {
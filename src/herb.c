@@ -4,9 +4,12 @@
 #include "include/errors.h"
 #include "include/lexer/lexer.h"
 #include "include/lexer/token.h"
+#include "include/lexer/token_list.h"
 #include "include/lib/hb_allocator.h"
 #include "include/lib/hb_array.h"
+#include "include/location/line_index.h"
 #include "include/parser/parser.h"
+#include "include/prism/prism_context.h"
 #include "include/version.h"
 #include "include/visitor.h"
 
@@ -29,9 +32,52 @@ HERB_EXPORTED_FUNCTION hb_array_T* herb_lex(const char* source, hb_allocator_T*
 
   hb_array_append(tokens, token);
 
+  lexer_deinit(&lexer);
+
   return tokens;
 }
 
+HERB_EXPORTED_FUNCTION void herb_lex_each(
+  const char* source,
+  herb_token_callback_T callback,
+  void* data,
+  hb_allocator_T* allocator
+) {
+  if (!source) { source = ""; }
+
+  token_T token = { 0 };
+  lexer_T lexer = { 0 };
+  lexer_init(&lexer, source, allocator);
+  lexer.reusable_token = &token;
+
+  while (true) {
+    const token_T* current = lexer_next_token(&lexer);
+    if (!callback(current, data) || current->type == TOKEN_EOF) { break; }
+  }
+
+  lexer_deinit(&lexer);
+}
+
+static bool herb_append_to_token_list(const token_T* token, void* data) {
+  return token_list_append((token_list_T*) data, token);
+}
+
+HERB_EXPORTED_FUNCTION bool herb_lex_to_token_list(
+  const char* source,
+  token_list_T* tokens,
+  hb_allocator_T* allocator
+) {
+  if (!source) { source = ""; }
+
+  if (!token_list_init(tokens, hb_string(source), allocator)) { return false; }
+
+  herb_lex_each(source, herb_append_to_token_list, tokens, allocator);
+
+  size_t size = token_list_size(tokens);
+
+  return size > 0 && token_list_type(tokens, size - 1) == TOKEN_EOF;
+}
+
 static bool herb_count_node_errors(const AST_NODE_T* node, void* data) {
   if (node == NULL) { return false; }
 
@@ -59,6 +105,12 @@ HERB_EXPORTED_FUNCTION AST_DOCUMENT_NODE_T* herb_parse(
 
   parser_options_set_deadline(&parser_options);
 
+  hb_deadline_T deadline;
+  hb_deadline_init(&deadline, parser_options.deadline_ms);
+  parser_options.deadline = &deadline;
+
+  if (parser_options.timeout_ms > 0) { lexer.deadline = &deadline; }
+
   if (parser_options.start_line > 0) {
     lexer.current_line = parser_options.start_line;
     lexer.previous_line = parser_options.start_line;
@@ -69,31 +121,47 @@ HERB_EXPORTED_FUNCTION AST_DOCUMENT_NODE_T* herb_parse(
     lexer.previous_column = parser_options.start_column;
   }
 
+  lexer_set_erb_recovery_limit(&lexer, parser_options.erb_recovery_limit);
+
   herb_parser_init(&parser, &lexer, parser_options);
 
   AST_DOCUMENT_NODE_T* document = herb_parser_parse(&parser);
 
   herb_parser_deinit(&parser);
+  lexer_deinit(&lexer);
+
+  bool annotate_prism = parser_options.prism_nodes || parser_options.prism_program;
+  herb_prism_context_T* ruby_program = NULL;
 
-  if (parser_options.analyze) { herb_analyze_parse_tree(document, source, &parser_options, allocator); }
+  if (parser_options.analyze || annotate_prism) { ruby_program = herb_prism_context_init(source, allocator); }
+
+  if (parser_options.analyze) {
+    line_index_T line_index;
+
+    if (line_index_init(&line_index, lexer.source, allocator)) {
+      herb_analyze_parse_tree(document, source, &line_index, ruby_program, &parser_options, allocator);
+      line_index_deinit(&line_index);
+    }
+  }
 
   if (parser_options.error_count != NULL) {
     *parser_options.error_count = 0;
     herb_visit_node((AST_NODE_T*) document, herb_count_node_errors, parser_options.error_count);
   }
 
-  if (parser_options.prism_nodes || parser_options.prism_program) {
+  if (annotate_prism) {
     herb_annotate_prism_nodes(
       document,
-      source,
+      ruby_program,
       parser_options.prism_nodes,
       parser_options.prism_nodes_deep,
-      parser_options.prism_program,
-      allocator
+      parser_options.prism_program
     );
   }
 
-  if (parser_options_past_deadline(&parser_options)) {
+  if (document->prism_context != ruby_program) { herb_prism_context_free(ruby_program); }
+
+  if (parser_options_past_deadline_now(&parser_options)) {
     append_timeout_error(
       parser_options.timeout_ms,
       document->base.location.start,
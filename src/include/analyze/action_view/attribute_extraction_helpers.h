@@ -10,7 +10,7 @@
 AST_NODE_T* extract_html_attribute_from_assoc(
   pm_assoc_node_t* assoc,
   const uint8_t* source,
-  const char* original_source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   hb_allocator_T* allocator
 );
@@ -18,7 +18,7 @@ AST_NODE_T* extract_html_attribute_from_assoc(
 hb_array_T* extract_html_attributes_from_keyword_hash(
   pm_keyword_hash_node_t* kw_hash,
   const uint8_t* source,
-  const char* original_source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   hb_allocator_T* allocator
 );
@@ -30,7 +30,7 @@ bool has_html_attributes_in_call(pm_call_node_t* call_node);
 hb_array_T* extract_html_attributes_from_call_node(
   pm_call_node_t* call_node,
   const uint8_t* source,
-  const char* original_source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   hb_allocator_T* allocator
 );
@@ -4,6 +4,7 @@
 #include "../../lib/hb_allocator.h"
 #include "../../lib/hb_array.h"
 #include "../../lib/hb_string.h"
+#include "../../location/line_index.h"
 #include <prism.h>
 #include <stdbool.h>
 
@@ -26,7 +27,7 @@ typedef struct {
   hb_array_T* (*extract_attributes)(
     pm_call_node_t* call_node,
     const uint8_t* source,
-    const char* original_source,
+    const line_index_T* line_index,
     size_t erb_content_offset
   );
   bool (*supports_block)(void);
@@ -3,6 +3,7 @@
 
 #include "../../ast/ast_nodes.h"
 #include "../../lib/hb_array.h"
+#include "../../location/line_index.h"
 #include "../../location/position.h"
 #include "../analyze.h"
 #include "tag_helper_handler.h"
@@ -23,14 +24,14 @@ bool search_tag_helper_node(const pm_node_t* node, void* data);
 
 position_T prism_location_to_position_with_offset(
   const pm_location_t* pm_location,
-  const char* original_source,
+  const line_index_T* line_index,
   size_t erb_content_offset,
   const uint8_t* erb_content_source
 );
 
-position_T byte_offset_to_position(const char* source, size_t offset);
+position_T byte_offset_to_position(const line_index_T* line_index, size_t offset);
 
-size_t calculate_byte_offset_from_position(const char* source, position_T position);
+size_t calculate_byte_offset_from_position(const line_index_T* line_index, position_T position);
 
 void transform_tag_helper_blocks(const AST_NODE_T* node, analyze_ruby_context_T* context);
 bool transform_tag_helper_nodes(const AST_NODE_T* node, void* data);
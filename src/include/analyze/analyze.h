@@ -5,23 +5,19 @@
 #include "../lib/hb_allocator.h"
 #include "../lib/hb_array.h"
 #include "../lib/hb_buffer.h"
+#include "../location/line_index.h"
 #include "../parser/parser.h"
+#include "../prism/prism_context.h"
 #include "analyzed_ruby.h"
 
-typedef struct TAG_HELPER_SCOPE_STRUCT {
-  hb_buffer_T buffer;
-  pm_options_t options;
-  pm_parser_t parser;
-  pm_node_t* root;
-} tag_helper_scope_T;
-
 typedef struct ANALYZE_RUBY_CONTEXT_STRUCT {
   AST_DOCUMENT_NODE_T* document;
   AST_NODE_T* parent;
   hb_array_T* ruby_context_stack;
-  tag_helper_scope_T* tag_helper_scope;
+  const herb_prism_context_T* ruby_program;
   hb_allocator_T* allocator;
   const char* source;
+  const line_index_T* line_index;
   bool found_strict_locals;
   const parser_options_T* options;
 } analyze_ruby_context_T;
@@ -58,12 +54,16 @@ typedef struct {
 void herb_analyze_parse_errors(
   AST_DOCUMENT_NODE_T* document,
   const char* source,
+  const line_index_T* line_index,
+  const herb_prism_context_T* ruby_program,
   const parser_options_T* options,
   hb_allocator_T* allocator
 );
 void herb_analyze_parse_tree(
   AST_DOCUMENT_NODE_T* document,
   const char* source,
+  const line_index_T* line_index,
+  const herb_prism_context_T* ruby_program,
   const parser_options_T* options,
   hb_allocator_T* allocator
 );
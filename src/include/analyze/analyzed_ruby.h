@@ -1,12 +1,14 @@
 #ifndef HERB_ANALYZED_RUBY_H
 #define HERB_ANALYZED_RUBY_H
 
+#include "../lib/hb_allocator.h"
 #include "../lib/hb_array.h"
 #include "../lib/hb_string.h"
 
 #include <prism.h>
 
 typedef struct ANALYZED_RUBY_STRUCT {
+  hb_allocator_T* allocator;
   pm_parser_t parser;
   pm_node_t* root;
   bool valid;
@@ -33,7 +35,7 @@ typedef struct ANALYZED_RUBY_STRUCT {
   int unclosed_control_flow_count;
 } analyzed_ruby_T;
 
-analyzed_ruby_T* init_analyzed_ruby(hb_string_T source);
+analyzed_ruby_T* init_analyzed_ruby(hb_string_T source, hb_allocator_T* allocator);
 void free_analyzed_ruby(analyzed_ruby_T* analyzed);
 hb_string_T erb_keyword_from_analyzed_ruby(const analyzed_ruby_T* analyzed);
 
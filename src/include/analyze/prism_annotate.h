@@ -2,15 +2,15 @@
 #define HERB_PRISM_ANNOTATE_H
 
 #include "../ast/ast_nodes.h"
-#include "../lib/hb_allocator.h"
+#include "../prism/prism_context.h"
 
+// Hands `context` over to the document, which frees it together with the AST.
 void herb_annotate_prism_nodes(
   AST_DOCUMENT_NODE_T* document,
-  const char* source,
+  herb_prism_context_T* context,
   bool prism_nodes,
   bool prism_nodes_deep,
-  bool prism_program,
-  hb_allocator_T* allocator
+  bool prism_program
 );
 
 #endif
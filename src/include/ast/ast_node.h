@@ -4,7 +4,10 @@
 #include "../errors.h"
 #include "../lexer/token_struct.h"
 #include "../lib/hb_allocator.h"
+#include "../location/line_index.h"
 #include "../location/position.h"
+#include "../location/range.h"
+#include "../location/relocation.h"
 #include "ast_nodes.h"
 
 void ast_node_init(
@@ -17,8 +20,17 @@ void ast_node_init(
 );
 void ast_node_free(AST_NODE_T* node, hb_allocator_T* allocator);
 void ast_node_rebase_tokens(AST_NODE_T* node, const char* from, const char* to, size_t length);
+void ast_node_relocate(AST_NODE_T* node, const relocation_T* relocation);
+bool ast_node_byte_range(const AST_NODE_T* node, range_T* range);
 
 AST_LITERAL_NODE_T* ast_literal_node_init_from_token(const token_T* token, hb_allocator_T* allocator);
+AST_HTML_TEXT_NODE_T* ast_html_text_node_init_borrowed(
+  hb_string_T content,
+  position_T start,
+  position_T end,
+  hb_array_T* errors,
+  hb_allocator_T* allocator
+);
 
 size_t ast_node_sizeof(void);
 
@@ -34,6 +46,4 @@ void ast_node_set_positions_from_token(AST_NODE_T* node, const token_T* token);
 
 bool ast_node_is(const AST_NODE_T* node, ast_node_type_T type);
 
-AST_NODE_T* find_erb_content_at_offset(AST_DOCUMENT_NODE_T* document, const char* source, size_t offset);
-
 #endif
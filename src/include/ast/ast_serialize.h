@@ -0,0 +1,37 @@
+#ifndef HERB_AST_SERIALIZE_H
+#define HERB_AST_SERIALIZE_H
+
+#include "../ast/ast_nodes.h"
+#include "../lib/hb_buffer.h"
+#include "../macros.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HERB_SERIALIZE_MAGIC "HERB"
+#define HERB_SERIALIZE_VERSION 1
+
+// Writes `document` to `buffer` in Herb's binary AST format, so bindings can hand a parse result across the FFI
+// boundary as a single byte buffer and decode nodes lazily on their side.
+//
+// Integers are unsigned LEB128 varints unless noted. The layout is generated from config.yml:
+//
+//   header:   "HERB" magic, u8 format version, token type table (count, then one string per token type)
+//   node:     u8 type, u32 little endian byte length of the rest of the node, location, errors, fields
+//   error:    u8 type, u32 little endian byte length of the rest of the error, message, location, fields
+//   location: start line, start column, end line, end column
+//   string:   byte length, then the bytes
+//   token:    u8 presence, then type (index into the token type table), value, range from, range to, location
+//   fields:   nodes and location pointers are prefixed with a u8 presence flag, arrays with their count, booleans
+//             are one byte, and Prism fields are a byte length followed by the `pm_serialize` output
+//
+// The byte lengths let a reader skip any subtree without decoding it. Internal fields (`analyzed_ruby`,
+// `prism_context`) are not written, and Prism nodes are only written when Prism serialization is compiled in.
+HERB_EXPORTED_FUNCTION void herb_serialize(AST_DOCUMENT_NODE_T* document, hb_buffer_T* buffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -70,6 +70,19 @@ herb_diff_result_T* herb_diff(
   hb_allocator_T* allocator
 );
 
+// Like herb_diff, but hashes each document into a map the caller keeps. Subtrees already in a map are not hashed
+// again, so when the new document of one diff becomes the old document of the next, as in an editor session, only
+// the new document is hashed. Maps are keyed by node address and are valid for as long as their document is neither
+// freed nor modified, herb_reparse included.
+herb_diff_result_T* herb_diff_with_hashes(
+  const AST_DOCUMENT_NODE_T* old_document,
+  const AST_DOCUMENT_NODE_T* new_document,
+  herb_hash_map_T* old_hashes,
+  herb_hash_map_T* new_hashes,
+  const herb_diff_options_T* options,
+  hb_allocator_T* allocator
+);
+
 size_t herb_diff_operation_count(const herb_diff_result_T* result);
 const herb_diff_operation_T* herb_diff_operation_at(const herb_diff_result_T* result, size_t index);
 bool herb_diff_trees_identical(const herb_diff_result_T* result);
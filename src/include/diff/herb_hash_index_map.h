@@ -7,14 +7,20 @@
 #include "../lib/hb_allocator.h"
 #include "herb_hash.h"
 
+// One entry per distinct key, holding the values inserted under it as a list in insertion order. Values are
+// indices below the `count` passed to init, so the lists are threaded through one `next` array. Many children
+// share a key, such as the whitespace between elements, and both inserting and finding stay constant time per
+// value however long a key's list gets.
 typedef struct {
   herb_hash_T key;
-  size_t value;
+  size_t head;
+  size_t tail;
   bool occupied;
 } herb_hash_index_entry_T;
 
 typedef struct {
   herb_hash_index_entry_T* entries;
+  size_t* next;
   size_t capacity;
 } herb_hash_index_map_T;
 
@@ -22,8 +28,10 @@ bool herb_hash_index_map_init(herb_hash_index_map_T* map, size_t count, hb_alloc
 
 void herb_hash_index_map_insert(herb_hash_index_map_T* map, herb_hash_T key, size_t value);
 
+// Returns the first value inserted under `key` that is not yet `matched`. Values are expected to only ever become
+// matched, so those skipped here are dropped from the list.
 bool herb_hash_index_map_find_unmatched(
-  const herb_hash_index_map_T* map,
+  herb_hash_index_map_T* map,
   herb_hash_T key,
   const bool* matched,
   size_t* out_value
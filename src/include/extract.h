@@ -1,6 +1,7 @@
 #ifndef HERB_EXTRACT_H
 #define HERB_EXTRACT_H
 
+#include "lexer/token_list.h"
 #include "lib/hb_allocator.h"
 #include "lib/hb_buffer.h"
 
@@ -28,6 +29,14 @@ void herb_extract_ruby_to_buffer_with_options(
 void herb_extract_ruby_to_buffer(const char* source, hb_buffer_T* output, hb_allocator_T* allocator);
 void herb_extract_html_to_buffer(const char* source, hb_buffer_T* output, hb_allocator_T* allocator);
 
+// Extract from a token list that was already lexed, e.g. by herb_lex_to_token_list, instead of lexing `source` again.
+void herb_extract_ruby_from_token_list(
+  const token_list_T* tokens,
+  hb_buffer_T* output,
+  const herb_extract_ruby_options_T* options
+);
+void herb_extract_html_from_token_list(const token_list_T* tokens, hb_buffer_T* output);
+
 char* herb_extract_ruby_with_semicolons(const char* source, hb_allocator_T* allocator);
 
 char* herb_extract(const char* source, herb_extract_language_T language, hb_allocator_T* allocator);
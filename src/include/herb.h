@@ -4,11 +4,13 @@
 #include "ast/ast_node.h"
 #include "diff/herb_diff.h"
 #include "extract.h"
+#include "lexer/token_list.h"
 #include "lib/hb_allocator.h"
 #include "lib/hb_array.h"
 #include "lib/hb_buffer.h"
 #include "macros.h"
 #include "parser/parser.h"
+#include "render_scan.h"
 
 #include <prism.h>
 #include <stdbool.h>
@@ -20,12 +22,73 @@ extern "C" {
 
 HERB_EXPORTED_FUNCTION hb_array_T* herb_lex(const char* source, hb_allocator_T* allocator);
 
+// Called once per token, including the final TOKEN_EOF. The token is only valid for the duration of the call.
+// Returning false stops lexing.
+typedef bool (*herb_token_callback_T)(const token_T* token, void* data);
+
+HERB_EXPORTED_FUNCTION void herb_lex_each(
+  const char* source,
+  herb_token_callback_T callback,
+  void* data,
+  hb_allocator_T* allocator
+);
+
+// Lexes `source` into `tokens`, which must be released with token_list_deinit even when this returns false.
+// Values are slices of `source`, which must outlive the list.
+HERB_EXPORTED_FUNCTION bool herb_lex_to_token_list(
+  const char* source,
+  token_list_T* tokens,
+  hb_allocator_T* allocator
+);
+
 HERB_EXPORTED_FUNCTION AST_DOCUMENT_NODE_T* herb_parse(
   const char* source,
   const parser_options_T* options,
   hb_allocator_T* allocator
 );
 
+// One entry of herb_parse_many. `document` lives in `allocator`, an arena owned by this result.
+typedef struct {
+  AST_DOCUMENT_NODE_T* document;
+  hb_allocator_T allocator;
+  uint32_t error_count;
+} herb_parse_many_result_T;
+
+// Parses `sources[0..count)` on a pool of `thread_count` threads (0 uses one per online CPU) and stores the result
+// for `sources[i]` in `results[i]`. Workers claim the next unparsed source as they finish, largest sources first.
+// `options->error_count` is ignored; each result reports its own. Returns false if any arena could not be created.
+HERB_EXPORTED_FUNCTION bool herb_parse_many(
+  const char* const* sources,
+  size_t count,
+  const parser_options_T* options,
+  size_t thread_count,
+  herb_parse_many_result_T* results
+);
+
+HERB_EXPORTED_FUNCTION void herb_free_parse_many_results(herb_parse_many_result_T* results, size_t count);
+
+// An edit in byte offsets: `previous_source[start, old_end)` was replaced, and the replacement is
+// `source[start, new_end)`.
+typedef struct {
+  uint32_t start;
+  uint32_t old_end;
+  uint32_t new_end;
+} herb_edit_T;
+
+// Updates `document`, parsed from `previous_source` with the same `options` and `allocator`, to match `source`.
+// Only the top-level children around the edit are parsed again; the others are kept and relocated into `source`,
+// and `previous_source` may be freed afterwards. When the edit cannot be contained that way, for example because
+// the reparsed region has errors, `document` is freed and `source` is parsed from scratch. Either way the returned
+// document replaces `document`.
+HERB_EXPORTED_FUNCTION AST_DOCUMENT_NODE_T* herb_reparse(
+  AST_DOCUMENT_NODE_T* document,
+  const char* previous_source,
+  const char* source,
+  const herb_edit_T* edit,
+  const parser_options_T* options,
+  hb_allocator_T* allocator
+);
+
 HERB_EXPORTED_FUNCTION const char* herb_version(void);
 HERB_EXPORTED_FUNCTION const char* herb_prism_version(void);
 
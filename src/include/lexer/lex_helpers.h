@@ -10,20 +10,27 @@
 
 #include <stdlib.h>
 
-static inline void herb_lex_to_buffer(const char* source, hb_buffer_T* output, hb_allocator_T* allocator) {
-  hb_array_T* tokens = herb_lex(source, allocator);
+typedef struct {
+  hb_buffer_T* output;
+  hb_allocator_T* allocator;
+} herb_lex_to_buffer_context_T;
+
+static inline bool herb_lex_to_buffer_token(const token_T* token, void* data) {
+  herb_lex_to_buffer_context_T* context = (herb_lex_to_buffer_context_T*) data;
 
-  for (size_t i = 0; i < hb_array_size(tokens); i++) {
-    token_T* token = hb_array_get(tokens, i);
+  hb_string_T type = token_to_string(context->allocator, token);
+  hb_buffer_append_string(context->output, type);
+  hb_allocator_dealloc(context->allocator, type.data);
 
-    hb_string_T type = token_to_string(allocator, token);
-    hb_buffer_append_string(output, type);
-    hb_allocator_dealloc(allocator, type.data);
+  hb_buffer_append(context->output, "\n");
 
-    hb_buffer_append(output, "\n");
-  }
+  return true;
+}
+
+static inline void herb_lex_to_buffer(const char* source, hb_buffer_T* output, hb_allocator_T* allocator) {
+  herb_lex_to_buffer_context_T context = { .output = output, .allocator = allocator };
 
-  herb_free_tokens(&tokens, allocator);
+  herb_lex_each(source, herb_lex_to_buffer_token, &context, allocator);
 }
 
 #endif
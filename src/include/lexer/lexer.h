@@ -5,6 +5,8 @@
 #include "lexer_struct.h"
 
 void lexer_init(lexer_T* lexer, const char* source, hb_allocator_T* allocator);
+void lexer_deinit(lexer_T* lexer);
+void lexer_set_erb_recovery_limit(lexer_T* lexer, size_t limit);
 token_T* lexer_next_token(lexer_T* lexer);
 token_T* lexer_error(lexer_T* lexer, const char* message);
 
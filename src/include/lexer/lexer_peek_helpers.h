@@ -22,6 +22,7 @@ typedef struct {
   char current_character;
   lexer_state_T state;
   uint8_t malformed_erb_close_length;
+  size_t erb_recovery_budget;
 } lexer_state_snapshot_T;
 
 bool lexer_peek_for_doctype(const lexer_T* lexer, uint32_t offset);
@@ -105,7 +106,8 @@ static inline lexer_state_snapshot_T lexer_save_state(lexer_T* lexer) {
                                       .previous_column = lexer->previous_column,
                                       .current_character = lexer->current_character,
                                       .state = lexer->state,
-                                      .malformed_erb_close_length = lexer->malformed_erb_close_length };
+                                      .malformed_erb_close_length = lexer->malformed_erb_close_length,
+                                      .erb_recovery_budget = lexer->erb_recovery_budget };
   return snapshot;
 }
 
@@ -119,6 +121,7 @@ static inline void lexer_restore_state(lexer_T* lexer, lexer_state_snapshot_T sn
   lexer->current_character = snapshot.current_character;
   lexer->state = snapshot.state;
   lexer->malformed_erb_close_length = snapshot.malformed_erb_close_length;
+  lexer->erb_recovery_budget = snapshot.erb_recovery_budget;
 }
 
 #endif
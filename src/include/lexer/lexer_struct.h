@@ -2,18 +2,32 @@
 #define HERB_LEXER_STRUCT_H
 
 #include "../lib/hb_allocator.h"
+#include "../lib/hb_buffer.h"
+#include "../lib/hb_clock.h"
 #include "../lib/hb_string.h"
 
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
+#define LEXER_ERB_RECOVERY_CACHE_SIZE 64
+
 typedef enum {
   STATE_DATA,
   STATE_ERB_CONTENT,
   STATE_ERB_CLOSE,
 } lexer_state_T;
 
+// One remembered answer of ERB end recovery: whether source[start_position, end_position) parses
+// under any of the fragment wraps, and how much recovery budget finding that out cost.
+typedef struct {
+  uint32_t start_position;
+  uint32_t end_position;
+  size_t cost;
+  bool parseable;
+  bool used;
+} erb_recovery_cache_entry_T;
+
 typedef struct LEXER_STRUCT {
   hb_allocator_T* allocator;
   hb_string_T source;
@@ -32,6 +46,20 @@ typedef struct LEXER_STRUCT {
   uint32_t stall_counter;
   uint32_t last_position;
   bool stalled;
+
+  hb_buffer_T erb_recovery_buffer;
+  size_t erb_recovery_budget;
+  bool erb_recovery_limited;
+
+  // Allocated on the first recovery, like erb_recovery_buffer, so a lookahead that re-lexes an
+  // unclosed ERB tag reuses the Prism checks of the first pass instead of repeating them.
+  erb_recovery_cache_entry_T* erb_recovery_cache;
+
+  hb_deadline_T* deadline;
+
+  // When set, every token is written into this struct instead of being allocated, so a token is only
+  // valid until the next call to lexer_next_token and must not be freed.
+  struct TOKEN_STRUCT* reusable_token;
 } lexer_T;
 
 #endif
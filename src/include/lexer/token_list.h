@@ -0,0 +1,47 @@
+#ifndef HERB_TOKEN_LIST_H
+#define HERB_TOKEN_LIST_H
+
+#include "../lib/hb_allocator.h"
+#include "../lib/hb_narray.h"
+#include "../lib/hb_string.h"
+#include "../location/location.h"
+#include "../location/position.h"
+#include "../location/range.h"
+#include "token_struct.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// A lexed token stream stored as parallel arrays: a 1-byte type and the `from`/`to` source offsets of every token,
+// 9 bytes per token instead of a separately allocated token_T. Values are slices of the source, except for
+// TOKEN_ERROR, whose message is copied aside. Locations are derived on demand: the first request replays the lexer's
+// line and column counting over the tokens once and keeps the end position of each, so that every location matches
+// the one herb_lex reports.
+typedef struct TOKEN_LIST_STRUCT {
+  hb_string_T source;
+  hb_narray_T types;
+  hb_narray_T froms;
+  hb_narray_T tos;
+  hb_narray_T ends;
+  hb_narray_T errors;
+  bool has_locations;
+  hb_allocator_T* allocator;
+} token_list_T;
+
+bool token_list_init(token_list_T* list, hb_string_T source, hb_allocator_T* allocator);
+bool token_list_append(token_list_T* list, const token_T* token);
+size_t token_list_size(const token_list_T* list);
+
+token_type_T token_list_type(const token_list_T* list, size_t index);
+range_T token_list_range(const token_list_T* list, size_t index);
+hb_string_T token_list_value(const token_list_T* list, size_t index);
+location_T token_list_location(token_list_T* list, size_t index);
+
+// Fills `token` with a view of the token at `index` for code written against token_T. The value is borrowed from
+// the list and stays valid until token_list_deinit.
+void token_list_get(token_list_T* list, size_t index, token_T* token);
+
+void token_list_deinit(token_list_T* list);
+
+#endif
@@ -55,6 +55,7 @@ hb_allocator_T hb_allocator_with_arena(hb_arena_T* arena);
 hb_allocator_T hb_allocator_with_tracking(void);
 
 hb_allocator_tracking_stats_T* hb_allocator_tracking_stats(hb_allocator_T* allocator);
+void hb_allocator_note_borrowed(hb_allocator_T* allocator, size_t size);
 
 static inline void* hb_allocator_alloc(hb_allocator_T* allocator, size_t size) {
   return allocator->alloc(allocator, size);
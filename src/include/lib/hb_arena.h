@@ -18,6 +18,10 @@ typedef struct HB_ARENA_STRUCT {
   hb_arena_page_T* tail;
   size_t default_page_size;
   size_t allocation_count;
+  size_t borrowed_bytes;
+  size_t reallocation_count;
+  size_t in_place_reallocation_count;
+  size_t abandoned_bytes;
 } hb_arena_T;
 
 #define hb_arena_for_each_page(arena) for (hb_arena_page_T* page = (arena)->head; page != NULL; page = page->next)
@@ -27,10 +31,14 @@ typedef struct HB_ARENA_STRUCT {
 
 bool hb_arena_init(hb_arena_T* allocator, size_t initial_size);
 void* hb_arena_alloc(hb_arena_T* allocator, size_t size);
+void* hb_arena_realloc(hb_arena_T* allocator, void* pointer, size_t old_size, size_t new_size);
 size_t hb_arena_position(hb_arena_T* allocator);
 size_t hb_arena_capacity(hb_arena_T* allocator);
+void hb_arena_note_borrowed(hb_arena_T* allocator, size_t size);
 void hb_arena_reset(hb_arena_T* allocator);
 void hb_arena_reset_to(hb_arena_T* allocator, size_t target_position);
+void hb_arena_rewind(hb_arena_T* allocator);
+void hb_arena_trim(hb_arena_T* allocator, size_t retained_capacity);
 void hb_arena_free(hb_arena_T* allocator);
 
 #endif
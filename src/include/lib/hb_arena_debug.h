@@ -10,6 +10,10 @@ typedef struct {
   size_t total_available;
   size_t allocations;
   size_t fragmentation;
+  size_t borrowed_bytes;
+  size_t reallocations;
+  size_t in_place_reallocations;
+  size_t abandoned_bytes;
   size_t default_page_size;
 } hb_arena_stats_T;
 
@@ -1,9 +1,12 @@
 #ifndef HERB_CLOCK_H
 #define HERB_CLOCK_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <time.h>
 
+#define HB_DEADLINE_CHECK_INTERVAL 256
+
 static inline uint64_t hb_monotonic_ms(void) {
   struct timespec now;
 
@@ -12,4 +15,37 @@ static inline uint64_t hb_monotonic_ms(void) {
   return (uint64_t) now.tv_sec * 1000 + (uint64_t) now.tv_nsec / 1000000;
 }
 
+// A deadline that is cheap to poll from hot loops: `hb_deadline_passed` only reads
+// the clock once every HB_DEADLINE_CHECK_INTERVAL calls, and stays expired once it is.
+typedef struct HB_DEADLINE_STRUCT {
+  uint64_t deadline_ms;
+  uint32_t countdown;
+  bool expired;
+} hb_deadline_T;
+
+static inline void hb_deadline_init(hb_deadline_T* deadline, uint64_t deadline_ms) {
+  deadline->deadline_ms = deadline_ms;
+  deadline->countdown = 0;
+  deadline->expired = false;
+}
+
+static inline bool hb_deadline_passed_now(hb_deadline_T* deadline) {
+  if (!deadline->expired) { deadline->expired = hb_monotonic_ms() >= deadline->deadline_ms; }
+
+  return deadline->expired;
+}
+
+static inline bool hb_deadline_passed(hb_deadline_T* deadline) {
+  if (deadline->expired) { return true; }
+
+  if (deadline->countdown > 0) {
+    deadline->countdown--;
+    return false;
+  }
+
+  deadline->countdown = HB_DEADLINE_CHECK_INTERVAL;
+
+  return hb_deadline_passed_now(deadline);
+}
+
 #endif
@@ -0,0 +1,38 @@
+#ifndef HERB_LINE_INDEX_H
+#define HERB_LINE_INDEX_H
+
+#include "../lib/hb_allocator.h"
+#include "../lib/hb_narray.h"
+#include "../lib/hb_string.h"
+#include "position.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Byte offsets of every line start in a source, built once per parse so the
+// analyzer can convert between offsets and positions with a binary search.
+// Lines are terminated by '\n'; columns are counted in bytes.
+//
+// A source containing '\r' also gets the line starts that
+// `position_from_source_with_offset` sees, where '\r' ends a line too.
+typedef struct LINE_INDEX_STRUCT {
+  hb_string_T source;
+  hb_narray_T line_starts;
+  hb_narray_T source_line_starts;
+  bool has_carriage_returns;
+} line_index_T;
+
+bool line_index_init(line_index_T* index, hb_string_T source, hb_allocator_T* allocator);
+void line_index_deinit(line_index_T* index);
+
+size_t line_index_line_count(const line_index_T* index);
+uint32_t line_index_line_start(const line_index_T* index, uint32_t line);
+uint32_t line_index_line_end(const line_index_T* index, uint32_t line);
+
+position_T line_index_position(const line_index_T* index, size_t offset);
+size_t line_index_offset(const line_index_T* index, position_T position);
+
+position_T line_index_source_position(const line_index_T* index, size_t offset);
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef HERB_RELOCATION_H
+#define HERB_RELOCATION_H
+
+#include "../lexer/token_struct.h"
+#include "../lib/hb_string.h"
+#include "location.h"
+#include "position.h"
+#include "range.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Moves already parsed nodes to where their text sits in another source, so herb_reparse can keep subtrees an
+// edit did not touch. Strings pointing into [from, from + length] are moved to the same offset from `to`, byte
+// ranges move by `byte_delta`, positions on `anchor_line` move by `column_delta`, and every position then moves
+// by `line_delta`.
+typedef struct RELOCATION_STRUCT {
+  const char* from;
+  const char* to;
+  size_t length;
+  int64_t byte_delta;
+  uint32_t anchor_line;
+  int64_t column_delta;
+  int64_t line_delta;
+} relocation_T;
+
+static inline void relocation_apply_position(position_T* position, const relocation_T* relocation) {
+  if (position->line == relocation->anchor_line) {
+    position->column = (uint32_t) ((int64_t) position->column + relocation->column_delta);
+  }
+
+  position->line = (uint32_t) ((int64_t) position->line + relocation->line_delta);
+}
+
+static inline void relocation_apply_location(location_T* location, const relocation_T* relocation) {
+  relocation_apply_position(&location->start, relocation);
+  relocation_apply_position(&location->end, relocation);
+}
+
+static inline void relocation_apply_range(range_T* range, const relocation_T* relocation) {
+  range->from = (uint32_t) ((int64_t) range->from + relocation->byte_delta);
+  range->to = (uint32_t) ((int64_t) range->to + relocation->byte_delta);
+}
+
+static inline void relocation_apply_string(hb_string_T* string, const relocation_T* relocation) {
+  if (string->data == NULL) { return; }
+  if (string->data < relocation->from || string->data > relocation->from + relocation->length) { return; }
+
+  string->data = (char*) relocation->to + (string->data - relocation->from);
+}
+
+static inline void relocation_apply_token(token_T* token, const relocation_T* relocation) {
+  if (token == NULL) { return; }
+
+  if (!token->owns_value) { relocation_apply_string(&token->value, relocation); }
+  relocation_apply_range(&token->range, relocation);
+  relocation_apply_location(&token->location, relocation);
+}
+
+#endif
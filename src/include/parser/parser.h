@@ -38,8 +38,10 @@ typedef struct PARSER_OPTIONS_STRUCT {
   uint32_t start_column;
   uint32_t timeout_ms;
   uint32_t max_errors;
+  uint32_t erb_recovery_limit;
   uint32_t* error_count;
   uint64_t deadline_ms;
+  hb_deadline_T* deadline;
 } parser_options_T;
 
 typedef struct MATCH_TAGS_CONTEXT_STRUCT {
@@ -52,6 +54,14 @@ extern const parser_options_T HERB_DEFAULT_PARSER_OPTIONS;
 
 static inline bool parser_options_past_deadline(const parser_options_T* options) {
   if (options == NULL || options->timeout_ms == 0) { return false; }
+  if (options->deadline != NULL) { return hb_deadline_passed(options->deadline); }
+
+  return hb_monotonic_ms() >= options->deadline_ms;
+}
+
+static inline bool parser_options_past_deadline_now(const parser_options_T* options) {
+  if (options == NULL || options->timeout_ms == 0) { return false; }
+  if (options->deadline != NULL) { return hb_deadline_passed_now(options->deadline); }
 
   return hb_monotonic_ms() >= options->deadline_ms;
 }
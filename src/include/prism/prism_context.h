@@ -21,6 +21,11 @@ typedef struct {
   hb_allocator_T* allocator;
 } herb_prism_context_T;
 
+// Extracts the Ruby of every ERB tag in `source` (positions preserved, tags closed with semicolons) and parses it
+// as one Prism program. herb_parse builds it once and shares it between the tag helper scope, the parse error pass
+// and Prism node annotation. Returns NULL when the template contains no Ruby.
+herb_prism_context_T* herb_prism_context_init(const char* source, hb_allocator_T* allocator);
+
 static inline void herb_prism_context_free(herb_prism_context_T* context) {
   if (!context) { return; }
 
@@ -16,7 +16,7 @@ RUBY_PARSE_ERROR_T* ruby_parse_error_from_prism_error(
   const pm_diagnostic_t* error,
   const AST_NODE_T* node,
   const char* source,
-  pm_parser_t* parser,
+  const pm_parser_t* parser,
   hb_allocator_T* allocator
 );
 
@@ -1,12 +1,19 @@
 #ifndef HERB_RUBY_PARSER_H
 #define HERB_RUBY_PARSER_H
 
+#include "../lib/hb_buffer.h"
 #include "../lib/hb_string.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 
 void herb_parse_ruby_to_stdout(char* source);
 
 bool herb_ruby_fragment_is_parseable(hb_string_T source);
 
+// Same as `herb_ruby_fragment_is_parseable`, but builds the wrapped fragments in `scratch`.
+// When `budget` is non-NULL every Prism parse is charged its input length in bytes, and
+// the fragment is reported as unparseable once the budget cannot cover the next parse.
+bool herb_ruby_fragment_is_parseable_with_scratch(hb_string_T source, hb_buffer_T* scratch, size_t* budget);
+
 #endif
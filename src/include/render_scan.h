@@ -0,0 +1,50 @@
+#ifndef HERB_RENDER_SCAN_H
+#define HERB_RENDER_SCAN_H
+
+#include "lib/hb_allocator.h"
+#include "lib/hb_array.h"
+#include "location/location.h"
+#include "macros.h"
+
+#include <stdbool.h>
+
+// One `name: value` pair passed to a render call. `value` is the Ruby source of the expression.
+typedef struct {
+  char* name;
+  char* value;
+} herb_render_local_T;
+
+// A `render` call site, read the same way the analyzer builds an ERBRenderNode. String and symbol arguments are
+// unescaped; anything else is kept as Ruby source. Fields the call does not pass are NULL.
+typedef struct {
+  char* partial;
+  char* template_path;
+  char* layout;
+  char* collection;
+  char* object;
+  char* as_name;
+  hb_array_T* locals;
+  bool has_block;
+  location_T location;
+} herb_render_call_T;
+
+// One keyword of a `<%# locals: (...) %>` declaration. `default_value` is the Ruby source of the default, or NULL
+// for a required local.
+typedef struct {
+  char* name;
+  char* default_value;
+  bool required;
+} herb_strict_local_T;
+
+typedef struct {
+  hb_array_T* render_calls;
+  hb_array_T* strict_locals;
+  bool has_strict_locals;
+  bool has_keyword_rest;
+  location_T strict_locals_location;
+} herb_render_scan_T;
+
+HERB_EXPORTED_FUNCTION bool herb_scan_renders(const char* source, herb_render_scan_T* scan, hb_allocator_T* allocator);
+HERB_EXPORTED_FUNCTION void herb_render_scan_free(herb_render_scan_T* scan, hb_allocator_T* allocator);
+
+#endif
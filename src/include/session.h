@@ -0,0 +1,64 @@
+#ifndef HERB_SESSION_H
+#define HERB_SESSION_H
+
+#include "ast/ast_nodes.h"
+#include "lib/hb_allocator.h"
+#include "macros.h"
+#include "parser/parser.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  // Every `trim_interval` parses the arena is trimmed back to the largest parse seen since the previous trim.
+  // 0 disables periodic trimming.
+  size_t trim_interval;
+  // Pages beyond this capacity are released after every parse. 0 keeps every page.
+  size_t max_retained_bytes;
+} herb_session_options_T;
+
+extern const herb_session_options_T HERB_DEFAULT_SESSION_OPTIONS;
+
+// A long-lived parse context. The session owns one arena whose pages stay mapped between parses, so repeated
+// parses reuse warm memory instead of mapping a fresh arena each time. A document returned by
+// herb_session_parse is valid until the next herb_session_parse, herb_session_reset or herb_session_deinit.
+typedef struct {
+  hb_allocator_T allocator;
+  herb_session_options_T options;
+  AST_DOCUMENT_NODE_T* document;
+  size_t parse_count;
+  size_t high_water_mark;
+} herb_session_T;
+
+typedef struct {
+  size_t parse_count;
+  size_t pages;
+  size_t capacity;
+  size_t used;
+  size_t high_water_mark;
+} herb_session_stats_T;
+
+HERB_EXPORTED_FUNCTION bool herb_session_init(herb_session_T* session, const herb_session_options_T* options);
+
+// Text content in the returned document points into `source` rather than into the arena, so `source` must stay
+// alive and unchanged for as long as the document is read. It may be freed once the document is no longer used,
+// even though the session keeps the document until the next parse.
+HERB_EXPORTED_FUNCTION AST_DOCUMENT_NODE_T* herb_session_parse(
+  herb_session_T* session,
+  const char* source,
+  const parser_options_T* options
+);
+
+HERB_EXPORTED_FUNCTION void herb_session_reset(herb_session_T* session);
+HERB_EXPORTED_FUNCTION herb_session_stats_T herb_session_stats(const herb_session_T* session);
+HERB_EXPORTED_FUNCTION void herb_session_deinit(herb_session_T* session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,5 +1,6 @@
 #include "include/lexer/lexer_peek_helpers.h"
 #include "include/lexer/token.h"
+#include "include/lib/hb_buffer.h"
 #include "include/lib/hb_string.h"
 #include "include/macros.h"
 #include "include/prism/ruby_parser.h"
@@ -28,7 +29,7 @@ typedef struct {
   erb_end_candidate_kind_T kind;
 } erb_end_candidate_T;
 
-static hb_string_T erb_open_patterns[] = HB_STRING_LIST("<%==", "<%%=", "<%graphql", "<%=", "<%#", "<%-", "<%%", "<%");
+static const hb_string_T erb_open_patterns[] = HB_STRING_LIST("<%==", "<%%=", "<%graphql", "<%=", "<%#", "<%-", "<%%", "<%");
 
 static bool lexer_eof(const lexer_T* lexer) {
   return lexer->current_character == '\0' || lexer->stalled;
@@ -75,6 +76,24 @@ void lexer_init(lexer_T* lexer, const char* source, hb_allocator_T* allocator) {
   lexer->last_position = 0;
   lexer->stalled = false;
   lexer->malformed_erb_close_length = 0;
+
+  lexer->erb_recovery_buffer = (hb_buffer_T) { 0 };
+  lexer->erb_recovery_budget = 0;
+  lexer->erb_recovery_limited = false;
+  lexer->erb_recovery_cache = NULL;
+
+  lexer->deadline = NULL;
+  lexer->reusable_token = NULL;
+}
+
+void lexer_deinit(lexer_T* lexer) {
+  if (lexer->erb_recovery_buffer.value != NULL) { hb_buffer_free(&lexer->erb_recovery_buffer); }
+  if (lexer->erb_recovery_cache != NULL) { hb_allocator_dealloc(lexer->allocator, lexer->erb_recovery_cache); }
+}
+
+void lexer_set_erb_recovery_limit(lexer_T* lexer, size_t limit) {
+  lexer->erb_recovery_limited = limit > 0;
+  lexer->erb_recovery_budget = limit;
 }
 
 token_T* lexer_error(lexer_T* lexer, const char* message) {
@@ -241,6 +260,67 @@ static uint8_t lexer_erb_percent_delimiter_length(const lexer_T* lexer) {
   return 0;
 }
 
+static erb_recovery_cache_entry_T* lexer_erb_recovery_cache_slot(
+  lexer_T* lexer,
+  uint32_t start_position,
+  uint32_t end_position
+) {
+  if (lexer->erb_recovery_cache == NULL) {
+    size_t size = sizeof(erb_recovery_cache_entry_T) * LEXER_ERB_RECOVERY_CACHE_SIZE;
+
+    lexer->erb_recovery_cache = hb_allocator_alloc(lexer->allocator, size);
+    if (lexer->erb_recovery_cache == NULL) { return NULL; }
+
+    memset(lexer->erb_recovery_cache, 0, size);
+  }
+
+  size_t slot = ((size_t) start_position * 31 + end_position) & (LEXER_ERB_RECOVERY_CACHE_SIZE - 1);
+
+  return &lexer->erb_recovery_cache[slot];
+}
+
+// A cached answer is charged the budget it cost the first time, so a capped lex recovers exactly
+// as it would have without the cache, whether or not a lookahead already looked at the same tag.
+static bool lexer_erb_fragment_is_parseable(lexer_T* lexer, uint32_t start_position, uint32_t end_position) {
+  if (lexer->erb_recovery_limited && lexer->erb_recovery_budget == 0) { return false; }
+  if (lexer->deadline != NULL && hb_deadline_passed(lexer->deadline)) { return false; }
+
+  erb_recovery_cache_entry_T* entry = lexer_erb_recovery_cache_slot(lexer, start_position, end_position);
+
+  if (entry != NULL && entry->used && entry->start_position == start_position
+      && entry->end_position == end_position
+      && (!lexer->erb_recovery_limited || entry->cost <= lexer->erb_recovery_budget)) {
+    if (lexer->erb_recovery_limited) { lexer->erb_recovery_budget -= entry->cost; }
+
+    return entry->parseable;
+  }
+
+  if (lexer->erb_recovery_buffer.value == NULL
+      && !hb_buffer_init(&lexer->erb_recovery_buffer, end_position - start_position + 16, lexer->allocator)) {
+    return false;
+  }
+
+  size_t budget_before = lexer->erb_recovery_budget;
+
+  bool parseable = herb_ruby_fragment_is_parseable_with_scratch(
+    hb_string_range(lexer->source, start_position, end_position),
+    &lexer->erb_recovery_buffer,
+    lexer->erb_recovery_limited ? &lexer->erb_recovery_budget : NULL
+  );
+
+  bool exhausted = lexer->erb_recovery_limited && !parseable && lexer->erb_recovery_budget == 0;
+
+  if (entry != NULL && !exhausted) {
+    *entry = (erb_recovery_cache_entry_T) { .start_position = start_position,
+                                            .end_position = end_position,
+                                            .cost = budget_before - lexer->erb_recovery_budget,
+                                            .parseable = parseable,
+                                            .used = true };
+  }
+
+  return parseable;
+}
+
 static bool lexer_recover_erb_tag_end(
   lexer_T* lexer,
   uint32_t start_position,
@@ -255,9 +335,7 @@ static bool lexer_recover_erb_tag_end(
 
       if (candidate->kind != (erb_end_candidate_kind_T) pass) { continue; }
 
-      if (!herb_ruby_fragment_is_parseable(hb_string_range(lexer->source, start_position, candidate->position))) {
-        continue;
-      }
+      if (!lexer_erb_fragment_is_parseable(lexer, start_position, candidate->position)) { continue; }
 
       lexer->current_position = candidate->position;
       lexer->current_line = candidate->line;
@@ -14,8 +14,8 @@
 #include <string.h>
 
 token_T* token_init(hb_string_T value, const token_type_T type, lexer_T* lexer) {
-  hb_allocator_T* allocator = lexer->allocator;
-  token_T* token = hb_allocator_alloc(allocator, sizeof(token_T));
+  token_T* token = lexer->reusable_token;
+  if (!token) { token = hb_allocator_alloc(lexer->allocator, sizeof(token_T)); }
 
   if (!token) { return NULL; }
 
@@ -0,0 +1,181 @@
+#include "../include/lexer/token_list.h"
+#include "../include/lib/hb_narray.h"
+#include "../include/lib/hb_string.h"
+#include "../include/location/position.h"
+#include "../include/util/util.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+  size_t index;
+  hb_string_T message;
+} token_list_error_T;
+
+// One token per four source bytes covers text-heavy templates without growing; markup-dense ones grow once.
+static size_t token_list_initial_capacity(hb_string_T source) {
+  return source.length / 4 + 16;
+}
+
+bool token_list_init(token_list_T* list, hb_string_T source, hb_allocator_T* allocator) {
+  size_t capacity = token_list_initial_capacity(source);
+
+  list->source = hb_string_is_null(source) ? HB_STRING_EMPTY : source;
+  list->has_locations = false;
+  list->allocator = allocator;
+  list->types = (hb_narray_T) { 0 };
+  list->froms = (hb_narray_T) { 0 };
+  list->tos = (hb_narray_T) { 0 };
+  list->ends = (hb_narray_T) { 0 };
+  list->errors = (hb_narray_T) { 0 };
+
+  if (!hb_narray_init(&list->types, sizeof(uint8_t), capacity, allocator)) { return false; }
+  if (!hb_narray_init(&list->froms, sizeof(uint32_t), capacity, allocator)) { return false; }
+  if (!hb_narray_init(&list->tos, sizeof(uint32_t), capacity, allocator)) { return false; }
+
+  return true;
+}
+
+// Error tokens carry the lexer's message instead of the text they cover. They are rare, so their messages are kept
+// in a side list, created with the first one, rather than widening every token.
+static bool token_list_append_error(token_list_T* list, hb_string_T message) {
+  if (list->errors.items == NULL
+      && !hb_narray_init(&list->errors, sizeof(token_list_error_T), 4, list->allocator)) {
+    return false;
+  }
+
+  token_list_error_T error = { .index = token_list_size(list), .message = hb_string_copy(message, list->allocator) };
+
+  if (error.message.data == NULL && message.length > 0) { return false; }
+
+  return hb_narray_append(&list->errors, &error);
+}
+
+bool token_list_append(token_list_T* list, const token_T* token) {
+  assert(token->type <= UINT8_MAX);
+
+  uint8_t type = (uint8_t) token->type;
+  uint32_t from = token->range.from;
+  uint32_t to = token->range.to;
+
+  if (token->type == TOKEN_ERROR && !token_list_append_error(list, token->value)) { return false; }
+
+  return hb_narray_append(&list->types, &type) && hb_narray_append(&list->froms, &from)
+      && hb_narray_append(&list->tos, &to);
+}
+
+size_t token_list_size(const token_list_T* list) {
+  return hb_narray_size(&list->types);
+}
+
+token_type_T token_list_type(const token_list_T* list, size_t index) {
+  return (token_type_T) *(const uint8_t*) hb_narray_get(&list->types, index);
+}
+
+range_T token_list_range(const token_list_T* list, size_t index) {
+  return (range_T) { .from = *(const uint32_t*) hb_narray_get(&list->froms, index),
+                     .to = *(const uint32_t*) hb_narray_get(&list->tos, index) };
+}
+
+hb_string_T token_list_value(const token_list_T* list, size_t index) {
+  if (token_list_type(list, index) == TOKEN_ERROR) {
+    for (size_t error_index = 0; error_index < hb_narray_size(&list->errors); error_index++) {
+      const token_list_error_T* error = hb_narray_get(&list->errors, error_index);
+
+      if (error->index == index) { return error->message; }
+    }
+  }
+
+  range_T range = token_list_range(list, index);
+
+  return hb_string_range(list->source, range.from, range.to);
+}
+
+// Where the lexer stands after a token that began at `start`. Newline tokens end a line. ERB content counts bytes
+// and takes every '\r' and '\n' as a line break, while any other token moves one column per byte except the
+// single-character ones, which move one column however many bytes their UTF-8 sequence takes.
+static position_T token_list_advance(const token_list_T* list, size_t index, position_T start) {
+  token_type_T type = token_list_type(list, index);
+  range_T range = token_list_range(list, index);
+
+  if (type == TOKEN_NEWLINE) { return (position_T) { .line = start.line + 1, .column = 0 }; }
+  if (range.to == range.from) { return start; }
+  if (type == TOKEN_CHARACTER || type == TOKEN_NBSP) {
+    return (position_T) { .line = start.line, .column = start.column + 1 };
+  }
+
+  position_T position = start;
+
+  for (uint32_t offset = range.from; offset < range.to; offset++) {
+    if (!is_newline(list->source.data[offset])) {
+      position.column++;
+    } else if (type == TOKEN_ERB_CONTENT) {
+      position.line++;
+      position.column = 0;
+    }
+  }
+
+  return position;
+}
+
+static bool token_list_build_locations(token_list_T* list) {
+  size_t size = token_list_size(list);
+
+  if (!hb_narray_init(&list->ends, sizeof(position_T), size > 0 ? size : 1, list->allocator)) { return false; }
+
+  position_T position = { .line = 1, .column = 0 };
+
+  for (size_t index = 0; index < size; index++) {
+    position = token_list_advance(list, index, position);
+
+    if (!hb_narray_append(&list->ends, &position)) {
+      hb_narray_deinit(&list->ends);
+      return false;
+    }
+  }
+
+  list->has_locations = true;
+
+  return true;
+}
+
+location_T token_list_location(token_list_T* list, size_t index) {
+  location_T location = { 0 };
+
+  if (!list->has_locations && !token_list_build_locations(list)) { return location; }
+
+  location.start = index > 0 ? *(const position_T*) hb_narray_get(&list->ends, index - 1)
+                             : (position_T) { .line = 1, .column = 0 };
+  location.end = *(const position_T*) hb_narray_get(&list->ends, index);
+
+  return location;
+}
+
+void token_list_get(token_list_T* list, size_t index, token_T* token) {
+  token->type = token_list_type(list, index);
+  token->range = token_list_range(list, index);
+  token->value = token_list_value(list, index);
+  token->location = token_list_location(list, index);
+  token->owns_value = false;
+}
+
+void token_list_deinit(token_list_T* list) {
+  if (list->has_locations) { hb_narray_deinit(&list->ends); }
+
+  if (list->errors.items) {
+    for (size_t index = 0; index < hb_narray_size(&list->errors); index++) {
+      const token_list_error_T* error = hb_narray_get(&list->errors, index);
+
+      if (error->message.length > 0) { hb_allocator_dealloc(list->allocator, (void*) error->message.data); }
+    }
+
+    hb_narray_deinit(&list->errors);
+  }
+
+  if (list->tos.items) { hb_narray_deinit(&list->tos); }
+  if (list->froms.items) { hb_narray_deinit(&list->froms); }
+  if (list->types.items) { hb_narray_deinit(&list->types); }
+
+  list->has_locations = false;
+}
@@ -65,15 +65,7 @@ static void* arena_alloc(hb_allocator_T* self, size_t size) {
 }
 
 static void* arena_realloc(hb_allocator_T* self, void* pointer, size_t old_size, size_t new_size) {
-  if (!pointer) { return arena_alloc(self, new_size); }
-
-  void* new_pointer = hb_arena_alloc((hb_arena_T*) self->context, new_size);
-  if (!new_pointer) { return NULL; }
-
-  size_t copy_size = old_size < new_size ? old_size : new_size;
-  memcpy(new_pointer, pointer, copy_size);
-
-  return new_pointer;
+  return hb_arena_realloc((hb_arena_T*) self->context, pointer, old_size, new_size);
 }
 
 static void arena_dealloc(hb_allocator_T* _self, void* _pointer) {
@@ -301,6 +293,12 @@ hb_allocator_tracking_stats_T* hb_allocator_tracking_stats(hb_allocator_T* alloc
   return (hb_allocator_tracking_stats_T*) allocator->context;
 }
 
+void hb_allocator_note_borrowed(hb_allocator_T* allocator, size_t size) {
+  if (allocator->alloc != arena_alloc) { return; }
+
+  hb_arena_note_borrowed((hb_arena_T*) allocator->context, size);
+}
+
 // --- High-level API ---
 
 bool hb_allocator_init(hb_allocator_T* allocator, hb_allocator_type_T type) {
@@ -89,6 +89,10 @@ bool hb_arena_init(hb_arena_T* allocator, size_t default_page_size) {
   allocator->tail = NULL;
   allocator->default_page_size = default_page_size;
   allocator->allocation_count = 0;
+  allocator->borrowed_bytes = 0;
+  allocator->reallocation_count = 0;
+  allocator->in_place_reallocation_count = 0;
+  allocator->abandoned_bytes = 0;
 
   return hb_arena_append_page(allocator, default_page_size);
 }
@@ -120,6 +124,45 @@ void* hb_arena_alloc(hb_arena_T* allocator, size_t size) {
   return hb_arena_page_alloc(allocator->tail, required_size);
 }
 
+// Growing buffers and arrays usually reallocate the block they allocated last, so when `pointer` ends exactly at the
+// tail page's position the block is resized by moving the position instead of copying it. Other blocks shrink in
+// place and grow by copying; the bytes they leave behind are waste until the arena is reset.
+void* hb_arena_realloc(hb_arena_T* allocator, void* pointer, size_t old_size, size_t new_size) {
+  if (pointer == NULL) { return hb_arena_alloc(allocator, new_size); }
+
+  allocator->reallocation_count++;
+
+  size_t old_required_size = hb_arena_align_size(old_size, 8);
+  size_t new_required_size = hb_arena_align_size(new_size, 8);
+  hb_arena_page_T* tail = allocator->tail;
+
+  bool is_last_allocation = old_required_size > 0 && old_required_size <= tail->position
+                         && (char*) pointer == &tail->memory[tail->position - old_required_size];
+
+  if (is_last_allocation && new_required_size > 0
+      && tail->position - old_required_size + new_required_size <= tail->capacity) {
+    tail->position = tail->position - old_required_size + new_required_size;
+    allocator->in_place_reallocation_count++;
+
+    return pointer;
+  }
+
+  if (new_size > 0 && new_required_size <= old_required_size) {
+    allocator->in_place_reallocation_count++;
+    allocator->abandoned_bytes += old_required_size - new_required_size;
+
+    return pointer;
+  }
+
+  void* new_pointer = hb_arena_alloc(allocator, new_size);
+  if (new_pointer == NULL) { return NULL; }
+
+  memcpy(new_pointer, pointer, old_size < new_size ? old_size : new_size);
+  allocator->abandoned_bytes += old_required_size;
+
+  return new_pointer;
+}
+
 size_t hb_arena_position(hb_arena_T* allocator) {
   size_t total = 0;
 
@@ -140,9 +183,17 @@ size_t hb_arena_capacity(hb_arena_T* allocator) {
   return total;
 }
 
+void hb_arena_note_borrowed(hb_arena_T* allocator, size_t size) {
+  allocator->borrowed_bytes += hb_arena_align_size(size, 8);
+}
+
 void hb_arena_reset(hb_arena_T* allocator) {
   hb_arena_reset_to(allocator, 0);
   allocator->allocation_count = 0;
+  allocator->borrowed_bytes = 0;
+  allocator->reallocation_count = 0;
+  allocator->in_place_reallocation_count = 0;
+  allocator->abandoned_bytes = 0;
 }
 
 void hb_arena_reset_to(hb_arena_T* allocator, size_t target_position) {
@@ -172,6 +223,42 @@ void hb_arena_reset_to(hb_arena_T* allocator, size_t target_position) {
   }
 }
 
+// Empties every page but keeps them all mapped, so the next allocations reuse warm memory instead of the
+// munmap/mmap round trip that hb_arena_reset does when it consolidates trailing pages.
+void hb_arena_rewind(hb_arena_T* allocator) {
+  hb_arena_for_each_page(allocator) {
+    page->position = 0;
+  }
+
+  allocator->tail = allocator->head;
+  allocator->allocation_count = 0;
+  allocator->borrowed_bytes = 0;
+  allocator->reallocation_count = 0;
+  allocator->in_place_reallocation_count = 0;
+  allocator->abandoned_bytes = 0;
+}
+
+// Releases trailing pages once the pages before them hold at least `retained_capacity` bytes. The head page and
+// every page up to the current tail are always kept.
+void hb_arena_trim(hb_arena_T* allocator, size_t retained_capacity) {
+  size_t capacity = 0;
+  bool reached_tail = false;
+
+  hb_arena_for_each_page(allocator) {
+    capacity += page->capacity;
+    if (page == allocator->tail) { reached_tail = true; }
+
+    if (reached_tail && capacity >= retained_capacity) {
+      if (page->next != NULL) {
+        hb_arena_page_free(page->next);
+        page->next = NULL;
+      }
+
+      return;
+    }
+  }
+}
+
 static size_t hb_arena_page_free(hb_arena_page_T* starting_page) {
   size_t freed_capacity = 0;
 
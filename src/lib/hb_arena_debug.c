@@ -125,6 +125,10 @@ hb_arena_stats_T hb_arena_get_stats(const hb_arena_T* arena) {
 
   stats.default_page_size = arena->default_page_size;
   stats.allocations = arena->allocation_count;
+  stats.borrowed_bytes = arena->borrowed_bytes;
+  stats.reallocations = arena->reallocation_count;
+  stats.in_place_reallocations = arena->in_place_reallocation_count;
+  stats.abandoned_bytes = arena->abandoned_bytes;
 
   hb_arena_for_each_page_const(arena) {
     stats.pages++;
@@ -163,12 +167,15 @@ void hb_arena_print_stats(const hb_arena_T* allocator) {
   double fragmentation_percentage = (double) fragmentation / (double) total_capacity * 100.0;
   const char* overall_color = get_usage_color(usage_percentage);
 
-  char capacity_string[32], used_string[32], available_string[32], fragmentation_string[32], default_size_string[32];
+  char capacity_string[32], used_string[32], available_string[32], fragmentation_string[32], default_size_string[32],
+    borrowed_string[32], abandoned_string[32];
   format_bytes(total_capacity, capacity_string, sizeof(capacity_string));
   format_bytes(total_used, used_string, sizeof(used_string));
   format_bytes(total_available, available_string, sizeof(available_string));
   format_bytes(fragmentation, fragmentation_string, sizeof(fragmentation_string));
   format_bytes(allocator->default_page_size, default_size_string, sizeof(default_size_string));
+  format_bytes(stats.borrowed_bytes, borrowed_string, sizeof(borrowed_string));
+  format_bytes(stats.abandoned_bytes, abandoned_string, sizeof(abandoned_string));
 
   print_box_top();
   print_box_line_centered("ARENA MEMORY LAYOUT");
@@ -198,6 +205,19 @@ void hb_arena_print_stats(const hb_arena_T* allocator) {
 
   if (fragmentation > 0) { print_box_line("      (%.1f%% skipped in non-tail pages)", fragmentation_percentage); }
 
+  if (stats.reallocations > 0) {
+    print_box_line_with_bullet(
+      "    • Reallocations: %zu (%zu in place)",
+      stats.reallocations,
+      stats.in_place_reallocations
+    );
+    print_box_line_with_bullet("    • Waste: %s (left behind by copying reallocations)", abandoned_string);
+  }
+
+  if (stats.borrowed_bytes > 0) {
+    print_box_line_with_bullet("    • Saved: %s (borrowed from source instead of copied)", borrowed_string);
+  }
+
   print_box_separator();
 
   size_t page_number = 0;
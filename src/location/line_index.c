@@ -0,0 +1,134 @@
+#include "../include/location/line_index.h"
+#include "../include/location/position.h"
+#include "../include/util/util.h"
+
+#include <string.h>
+
+// Every '\r' and every '\n' starts a line here, so "\r\n" counts as two, as in `position_from_source_with_offset`.
+static bool source_line_starts_init(line_index_T* index, hb_allocator_T* allocator) {
+  size_t line_count = 1;
+
+  for (size_t offset = 0; offset < index->source.length; offset++) {
+    if (is_newline(index->source.data[offset])) { line_count++; }
+  }
+
+  if (!hb_narray_init(&index->source_line_starts, sizeof(uint32_t), line_count, allocator)) { return false; }
+
+  uint32_t line_start = 0;
+  hb_narray_append(&index->source_line_starts, &line_start);
+
+  for (size_t offset = 0; offset < index->source.length; offset++) {
+    if (!is_newline(index->source.data[offset])) { continue; }
+
+    line_start = (uint32_t) (offset + 1);
+    hb_narray_append(&index->source_line_starts, &line_start);
+  }
+
+  return true;
+}
+
+bool line_index_init(line_index_T* index, hb_string_T source, hb_allocator_T* allocator) {
+  index->source = hb_string_is_null(source) ? HB_STRING_EMPTY : source;
+  index->has_carriage_returns = memchr(index->source.data, '\r', index->source.length) != NULL;
+  index->line_starts = (hb_narray_T) { 0 };
+  index->source_line_starts = (hb_narray_T) { 0 };
+
+  size_t line_count = 1;
+  const char* cursor = index->source.data;
+  const char* end = index->source.data + index->source.length;
+
+  while (cursor < end && (cursor = memchr(cursor, '\n', (size_t) (end - cursor))) != NULL) {
+    line_count++;
+    cursor++;
+  }
+
+  if (!hb_narray_init(&index->line_starts, sizeof(uint32_t), line_count, allocator)) { return false; }
+
+  uint32_t line_start = 0;
+  hb_narray_append(&index->line_starts, &line_start);
+
+  cursor = index->source.data;
+
+  while (cursor < end && (cursor = memchr(cursor, '\n', (size_t) (end - cursor))) != NULL) {
+    cursor++;
+    line_start = (uint32_t) (cursor - index->source.data);
+    hb_narray_append(&index->line_starts, &line_start);
+  }
+
+  if (index->has_carriage_returns && !source_line_starts_init(index, allocator)) {
+    line_index_deinit(index);
+    return false;
+  }
+
+  return true;
+}
+
+void line_index_deinit(line_index_T* index) {
+  if (!index) { return; }
+
+  if (index->source_line_starts.items) {
+    hb_narray_deinit(&index->source_line_starts);
+    index->source_line_starts.items = NULL;
+  }
+
+  if (index->line_starts.items) {
+    hb_narray_deinit(&index->line_starts);
+    index->line_starts.items = NULL;
+  }
+}
+
+size_t line_index_line_count(const line_index_T* index) {
+  return hb_narray_size(&index->line_starts);
+}
+
+uint32_t line_index_line_start(const line_index_T* index, uint32_t line) {
+  return ((const uint32_t*) index->line_starts.items)[line - 1];
+}
+
+uint32_t line_index_line_end(const line_index_T* index, uint32_t line) {
+  if (line >= line_index_line_count(index)) { return index->source.length; }
+
+  return line_index_line_start(index, line + 1) - 1;
+}
+
+static position_T line_starts_position(const hb_narray_T* line_starts, size_t offset) {
+  const uint32_t* starts = (const uint32_t*) line_starts->items;
+  size_t low = 0;
+  size_t high = hb_narray_size(line_starts);
+
+  while (high - low > 1) {
+    size_t middle = low + (high - low) / 2;
+
+    if (starts[middle] <= offset) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+
+  return (position_T) { .line = (uint32_t) low + 1, .column = (uint32_t) (offset - starts[low]) };
+}
+
+position_T line_index_position(const line_index_T* index, size_t offset) {
+  if (offset > index->source.length) { offset = index->source.length; }
+
+  return line_starts_position(&index->line_starts, offset);
+}
+
+size_t line_index_offset(const line_index_T* index, position_T position) {
+  if (position.line == 0 || position.line > line_index_line_count(index)) { return index->source.length; }
+
+  size_t offset = (size_t) line_index_line_start(index, position.line) + position.column;
+
+  if (offset > line_index_line_end(index, position.line)) { return index->source.length; }
+
+  return offset;
+}
+
+// Matches `position_from_source_with_offset`, which also treats '\r' as a line break.
+position_T line_index_source_position(const line_index_T* index, size_t offset) {
+  if (!index->has_carriage_returns) { return line_index_position(index, offset); }
+  if (offset > index->source.length) { offset = index->source.length; }
+
+  return line_starts_position(&index->source_line_starts, offset);
+}
@@ -0,0 +1,167 @@
+#include "include/ast/ast_node.h"
+#include "include/herb.h"
+#include "include/lib/hb_allocator.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Windows and single-threaded WebAssembly builds parse the batch on the calling thread.
+#if defined(_WIN32) || (defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__))
+#  define HERB_PARSE_MANY_THREADS 0
+#else
+#  define HERB_PARSE_MANY_THREADS 1
+#  include <pthread.h>
+#  include <unistd.h>
+#endif
+
+#define HERB_PARSE_MANY_MAX_THREADS 256
+
+typedef struct {
+  size_t index;
+  size_t length;
+} parse_many_entry_T;
+
+typedef struct {
+  const char* const* sources;
+  const parser_options_T* options;
+  herb_parse_many_result_T* results;
+  const parse_many_entry_T* order;
+  size_t count;
+  size_t next;
+  bool failed;
+} parse_many_pool_T;
+
+static int compare_entries_by_length(const void* left, const void* right) {
+  const parse_many_entry_T* a = left;
+  const parse_many_entry_T* b = right;
+
+  if (a->length != b->length) { return a->length > b->length ? -1 : 1; }
+  if (a->index != b->index) { return a->index < b->index ? -1 : 1; }
+
+  return 0;
+}
+
+static size_t parse_many_claim(parse_many_pool_T* pool) {
+#if HERB_PARSE_MANY_THREADS
+  return __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED);
+#else
+  return pool->next++;
+#endif
+}
+
+static void parse_many_one(parse_many_pool_T* pool, size_t index) {
+  herb_parse_many_result_T* result = &pool->results[index];
+
+  if (!hb_allocator_init(&result->allocator, HB_ALLOCATOR_ARENA)) {
+    memset(&result->allocator, 0, sizeof(result->allocator));
+
+#if HERB_PARSE_MANY_THREADS
+    __atomic_store_n(&pool->failed, true, __ATOMIC_RELAXED);
+#else
+    pool->failed = true;
+#endif
+
+    return;
+  }
+
+  parser_options_T options = pool->options ? *pool->options : HERB_DEFAULT_PARSER_OPTIONS;
+  options.error_count = &result->error_count;
+
+  result->document = herb_parse(pool->sources[index], &options, &result->allocator);
+}
+
+static void* parse_many_worker(void* data) {
+  parse_many_pool_T* pool = data;
+
+  for (size_t position = parse_many_claim(pool); position < pool->count; position = parse_many_claim(pool)) {
+    parse_many_one(pool, pool->order ? pool->order[position].index : position);
+  }
+
+  return NULL;
+}
+
+static size_t parse_many_default_thread_count(void) {
+#if HERB_PARSE_MANY_THREADS && defined(_SC_NPROCESSORS_ONLN)
+  long processors = sysconf(_SC_NPROCESSORS_ONLN);
+  if (processors > 0) { return (size_t) processors; }
+#endif
+
+  return 1;
+}
+
+HERB_EXPORTED_FUNCTION bool herb_parse_many(
+  const char* const* sources,
+  size_t count,
+  const parser_options_T* options,
+  size_t thread_count,
+  herb_parse_many_result_T* results
+) {
+  if (results == NULL || (sources == NULL && count > 0)) { return false; }
+  if (count == 0) { return true; }
+
+  memset(results, 0, count * sizeof(herb_parse_many_result_T));
+
+  // Handing out the largest sources first keeps one big template from being picked up last and leaving every
+  // other worker idle while it finishes. Without the ordering buffer the batch is parsed in input order.
+  parse_many_entry_T* order = malloc(count * sizeof(parse_many_entry_T));
+
+  if (order != NULL) {
+    for (size_t index = 0; index < count; index++) {
+      order[index].index = index;
+      order[index].length = sources[index] ? strlen(sources[index]) : 0;
+    }
+
+    qsort(order, count, sizeof(parse_many_entry_T), compare_entries_by_length);
+  }
+
+  parse_many_pool_T pool = {
+    .sources = sources,
+    .options = options,
+    .results = results,
+    .order = order,
+    .count = count,
+    .next = 0,
+    .failed = false,
+  };
+
+  if (thread_count == 0) { thread_count = parse_many_default_thread_count(); }
+  if (thread_count > count) { thread_count = count; }
+  if (thread_count > HERB_PARSE_MANY_MAX_THREADS) { thread_count = HERB_PARSE_MANY_MAX_THREADS; }
+
+#if HERB_PARSE_MANY_THREADS
+  pthread_t threads[HERB_PARSE_MANY_MAX_THREADS];
+  size_t started = 0;
+
+  // The calling thread is one of the workers, so a failed pthread_create only means fewer helpers.
+  while (started + 1 < thread_count) {
+    if (pthread_create(&threads[started], NULL, parse_many_worker, &pool) != 0) { break; }
+    started++;
+  }
+
+  parse_many_worker(&pool);
+
+  for (size_t index = 0; index < started; index++) {
+    pthread_join(threads[index], NULL);
+  }
+#else
+  parse_many_worker(&pool);
+#endif
+
+  free(order);
+
+  return !pool.failed;
+}
+
+HERB_EXPORTED_FUNCTION void herb_free_parse_many_results(herb_parse_many_result_T* results, size_t count) {
+  if (results == NULL) { return; }
+
+  for (size_t index = 0; index < count; index++) {
+    herb_parse_many_result_T* result = &results[index];
+
+    if (result->document != NULL) { ast_node_free((AST_NODE_T*) result->document, &result->allocator); }
+    if (result->allocator.destroy != NULL) { hb_allocator_destroy(&result->allocator); }
+
+    memset(result, 0, sizeof(herb_parse_many_result_T));
+  }
+}
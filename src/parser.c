@@ -17,6 +17,7 @@
 #include "include/util/util.h"
 #include "include/visitor.h"
 
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -52,8 +53,10 @@ const parser_options_T HERB_DEFAULT_PARSER_OPTIONS = { .track_whitespace = false
                                                        .start_column = 0,
                                                        .timeout_ms = 1000,
                                                        .max_errors = 25,
+                                                       .erb_recovery_limit = 0,
                                                        .error_count = NULL,
-                                                       .deadline_ms = 0 };
+                                                       .deadline_ms = 0,
+                                                       .deadline = NULL };
 
 size_t parser_sizeof(void) {
   return sizeof(struct PARSER_STRUCT);
@@ -310,11 +313,41 @@ static AST_XML_PROCESSING_INSTRUCTION_NODE_T* parser_parse_xml_processing_instru
   return processing_instruction;
 }
 
+// A text run is made of consecutive tokens whose values normally point at adjacent bytes of the source, so the
+// run is tracked as one slice the text node can borrow. A buffer is only set up once a token breaks that chain.
+typedef struct {
+  hb_string_T slice;
+  hb_buffer_T buffer;
+  bool contiguous;
+} text_run_T;
+
+static void text_run_append(text_run_T* run, const token_T* token, hb_allocator_T* allocator) {
+  hb_string_T value = token->value;
+
+  if (run->contiguous) {
+    if (run->slice.length == 0) { run->slice.data = value.data; }
+
+    if (!token->owns_value && value.data == run->slice.data + run->slice.length) {
+      run->slice.length += value.length;
+      return;
+    }
+
+    run->contiguous = false;
+    hb_buffer_init(&run->buffer, (run->slice.length + value.length) * 2, allocator);
+    hb_buffer_append_string(&run->buffer, run->slice);
+  }
+
+  hb_buffer_append_string(&run->buffer, value);
+}
+
+static void text_run_free(text_run_T* run) {
+  if (!run->contiguous) { hb_buffer_free(&run->buffer); }
+}
+
 static AST_HTML_TEXT_NODE_T* parser_parse_text_content(parser_T* parser, hb_array_T** document_errors) {
   position_T start = parser->current_token->location.start;
 
-  hb_buffer_T content;
-  hb_buffer_init(&content, 2048, parser->allocator);
+  text_run_T run = { .slice = HB_STRING_EMPTY, .contiguous = true };
 
   while (token_is_none_of(
     parser,
@@ -327,7 +360,7 @@ static AST_HTML_TEXT_NODE_T* parser_parse_text_content(parser_T* parser, hb_arra
     TOKEN_EOF
   )) {
     if (token_is(parser, TOKEN_ERROR)) {
-      hb_buffer_free(&content);
+      text_run_free(&run);
 
       parser_append_unexpected_error_string(parser, document_errors, "Token Error", "not an error token");
 
@@ -352,11 +385,11 @@ static AST_HTML_TEXT_NODE_T* parser_parse_text_content(parser_T* parser, hb_arra
         );
 
         token_T* percent = parser_advance(parser);
-        hb_buffer_append_string(&content, percent->value);
+        text_run_append(&run, percent, parser->allocator);
         token_free(percent, parser->allocator);
 
         token_T* gt = parser_advance(parser);
-        hb_buffer_append_string(&content, gt->value);
+        text_run_append(&run, gt, parser->allocator);
         token_free(gt, parser->allocator);
 
         continue;
@@ -366,24 +399,25 @@ static AST_HTML_TEXT_NODE_T* parser_parse_text_content(parser_T* parser, hb_arra
     }
 
     token_T* token = parser_advance(parser);
-    hb_buffer_append_string(&content, token->value);
+    text_run_append(&run, token, parser->allocator);
     token_free(token, parser->allocator);
   }
 
   hb_array_T* errors = NULL;
+  position_T end = parser->current_token->location.start;
 
   AST_HTML_TEXT_NODE_T* text_node = NULL;
 
-  if (hb_buffer_length(&content) > 0) {
-    hb_string_T text_content = { .data = content.value, .length = (uint32_t) content.length };
-    text_node =
-      ast_html_text_node_init(text_content, start, parser->current_token->location.start, errors, parser->allocator);
+  if (!run.contiguous) {
+    hb_string_T text_content = { .data = run.buffer.value, .length = (uint32_t) run.buffer.length };
+    text_node = ast_html_text_node_init(text_content, start, end, errors, parser->allocator);
+  } else if (run.slice.length > 0) {
+    text_node = ast_html_text_node_init_borrowed(run.slice, start, end, errors, parser->allocator);
   } else {
-    text_node =
-      ast_html_text_node_init(HB_STRING_EMPTY, start, parser->current_token->location.start, errors, parser->allocator);
+    text_node = ast_html_text_node_init(HB_STRING_EMPTY, start, end, errors, parser->allocator);
   }
 
-  hb_buffer_free(&content);
+  text_run_free(&run);
 
   return text_node;
 }
@@ -1642,118 +1676,168 @@ static void parser_parse_in_data_state(parser_T* parser, hb_array_T* children, h
   }
 }
 
-static size_t find_matching_close_tag(
-  hb_array_T* nodes,
-  size_t start_index,
-  hb_string_T tag_name,
-  const parser_options_T* options
-) {
-  int depth = 0;
+#define NO_MATCHING_TAG ((size_t) -1)
 
-  for (size_t index = start_index + 1; index < hb_array_size(nodes); index++) {
-    if (parser_options_past_deadline(options)) { return (size_t) -1; }
+typedef struct {
+  hb_string_T name;
+  size_t open_index;
+} tag_name_slot_T;
 
-    AST_NODE_T* node = (AST_NODE_T*) hb_array_get(nodes, index);
-    if (node == NULL) { continue; }
+typedef struct {
+  tag_name_slot_T* slots;
+  size_t capacity;
+  size_t size;
+  hb_allocator_T* allocator;
+} tag_name_table_T;
 
-    if (node->type == AST_HTML_OPEN_TAG_NODE) {
-      AST_HTML_OPEN_TAG_NODE_T* open = (AST_HTML_OPEN_TAG_NODE_T*) node;
+static uint64_t tag_name_hash(hb_string_T name) {
+  uint64_t hash = 14695981039346656037ULL;
 
-      if (hb_string_equals_case_insensitive(open->tag_name->value, tag_name)) { depth++; }
-    } else if (node->type == AST_HTML_CLOSE_TAG_NODE) {
-      AST_HTML_CLOSE_TAG_NODE_T* close = (AST_HTML_CLOSE_TAG_NODE_T*) node;
-
-      if (hb_string_equals_case_insensitive(close->tag_name->value, tag_name)) {
-        if (depth == 0) { return index; }
-        depth--;
-      }
-    }
+  for (uint32_t i = 0; i < name.length; i++) {
+    hash ^= (uint64_t) tolower((unsigned char) name.data[i]);
+    hash *= 1099511628211ULL;
   }
 
-  return (size_t) -1;
+  return hash;
 }
 
-static size_t find_implicit_close_index(hb_array_T* nodes, size_t start_index, hb_string_T tag_name) {
-  if (!has_optional_end_tag(tag_name)) { return (size_t) -1; }
+static bool tag_name_table_init(tag_name_table_T* table, size_t capacity, hb_allocator_T* allocator) {
+  table->slots = hb_allocator_alloc(allocator, capacity * sizeof(tag_name_slot_T));
+  if (!table->slots) { return false; }
 
-  for (size_t index = start_index + 1; index < hb_array_size(nodes); index++) {
-    AST_NODE_T* node = (AST_NODE_T*) hb_array_get(nodes, index);
-    if (node == NULL) { continue; }
+  memset(table->slots, 0, capacity * sizeof(tag_name_slot_T));
+  table->capacity = capacity;
+  table->size = 0;
+  table->allocator = allocator;
 
-    if (node->type == AST_HTML_OPEN_TAG_NODE) {
-      AST_HTML_OPEN_TAG_NODE_T* open = (AST_HTML_OPEN_TAG_NODE_T*) node;
-      hb_string_T next_tag_name = open->tag_name->value;
+  return true;
+}
 
-      if (should_implicitly_close(tag_name, next_tag_name)) { return index; }
-    } else if (node->type == AST_HTML_CLOSE_TAG_NODE) {
-      AST_HTML_CLOSE_TAG_NODE_T* close = (AST_HTML_CLOSE_TAG_NODE_T*) node;
-      hb_string_T close_tag_name = close->tag_name->value;
+static tag_name_slot_T* tag_name_table_probe(const tag_name_table_T* table, hb_string_T name) {
+  size_t index = (size_t) tag_name_hash(name) & (table->capacity - 1);
 
-      if (parent_closes_element(tag_name, close_tag_name)) { return index; }
-    }
+  while (table->slots[index].name.data != NULL) {
+    if (hb_string_equals_case_insensitive(table->slots[index].name, name)) { return &table->slots[index]; }
+
+    index = (index + 1) & (table->capacity - 1);
   }
 
-  return hb_array_size(nodes);
+  return &table->slots[index];
 }
 
-static hb_array_T* parser_build_elements_from_tags(
-  hb_array_T* nodes,
-  hb_array_T* errors,
-  const parser_options_T* options,
-  hb_allocator_T* allocator
-);
+static bool tag_name_table_grow(tag_name_table_T* table) {
+  tag_name_table_T grown;
+  if (!tag_name_table_init(&grown, table->capacity * 2, table->allocator)) { return false; }
 
-static bool has_close_tag_for_name(hb_array_T* close_tag_names, hb_string_T tag_name) {
-  for (size_t i = 0; i < hb_array_size(close_tag_names); i++) {
-    hb_string_T* name = (hb_string_T*) hb_array_get(close_tag_names, i);
-    if (name != NULL && hb_string_equals_case_insensitive(*name, tag_name)) { return true; }
+  for (size_t i = 0; i < table->capacity; i++) {
+    if (table->slots[i].name.data == NULL) { continue; }
+
+    *tag_name_table_probe(&grown, table->slots[i].name) = table->slots[i];
   }
 
-  return false;
+  grown.size = table->size;
+  hb_allocator_dealloc(table->allocator, table->slots);
+  *table = grown;
+
+  return true;
 }
 
-static hb_array_T* collect_close_tag_names(hb_array_T* nodes, hb_allocator_T* allocator) {
-  hb_array_T* close_tag_names = hb_array_init(16, allocator);
+static tag_name_slot_T* tag_name_table_lookup(tag_name_table_T* table, hb_string_T name) {
+  tag_name_slot_T* slot = tag_name_table_probe(table, name);
+  if (slot->name.data != NULL) { return slot; }
 
-  for (size_t i = 0; i < hb_array_size(nodes); i++) {
-    AST_NODE_T* node = (AST_NODE_T*) hb_array_get(nodes, i);
-    if (node == NULL || node->type != AST_HTML_CLOSE_TAG_NODE) { continue; }
+  if ((table->size + 1) * 2 > table->capacity) {
+    if (!tag_name_table_grow(table)) { return NULL; }
+
+    slot = tag_name_table_probe(table, name);
+  }
+
+  slot->name = name;
+  slot->open_index = NO_MATCHING_TAG;
+  table->size++;
+
+  return slot;
+}
+
+// Pairs every open tag with its close tag in a single pass, keeping one stack of
+// unmatched open tags per (case-insensitive) tag name. The stacks are threaded
+// through `previous_open`, so each open tag points at the one below it.
+static size_t* match_close_tags(hb_array_T* nodes, hb_allocator_T* allocator) {
+  size_t count = hb_array_size(nodes);
+  size_t* matches = hb_allocator_alloc(allocator, count * sizeof(size_t));
+  size_t* previous_open = hb_allocator_alloc(allocator, count * sizeof(size_t));
+
+  tag_name_table_T table;
+  tag_name_table_init(&table, 16, allocator);
 
-    AST_HTML_CLOSE_TAG_NODE_T* close_tag = (AST_HTML_CLOSE_TAG_NODE_T*) node;
-    hb_string_T name = close_tag->tag_name->value;
+  for (size_t index = 0; index < count; index++) {
+    matches[index] = NO_MATCHING_TAG;
+
+    AST_NODE_T* node = (AST_NODE_T*) hb_array_get(nodes, index);
+    if (node == NULL) { continue; }
 
-    if (!has_close_tag_for_name(close_tag_names, name)) {
-      hb_string_T* stored = hb_allocator_alloc(allocator, sizeof(hb_string_T));
-      *stored = name;
-      hb_array_append(close_tag_names, stored);
+    if (node->type == AST_HTML_OPEN_TAG_NODE) {
+      AST_HTML_OPEN_TAG_NODE_T* open_tag = (AST_HTML_OPEN_TAG_NODE_T*) node;
+      tag_name_slot_T* slot = tag_name_table_lookup(&table, open_tag->tag_name->value);
+      if (slot == NULL) { continue; }
+
+      previous_open[index] = slot->open_index;
+      slot->open_index = index;
+    } else if (node->type == AST_HTML_CLOSE_TAG_NODE) {
+      AST_HTML_CLOSE_TAG_NODE_T* close_tag = (AST_HTML_CLOSE_TAG_NODE_T*) node;
+      tag_name_slot_T* slot = tag_name_table_lookup(&table, close_tag->tag_name->value);
+
+      if (slot != NULL && slot->open_index != NO_MATCHING_TAG) {
+        matches[slot->open_index] = index;
+        slot->open_index = previous_open[slot->open_index];
+      }
     }
   }
 
-  return close_tag_names;
+  hb_allocator_dealloc(allocator, table.slots);
+  hb_allocator_dealloc(allocator, previous_open);
+
+  return matches;
 }
 
-static void free_close_tag_names(hb_array_T** close_tag_names, hb_allocator_T* allocator) {
-  if (close_tag_names == NULL || *close_tag_names == NULL) { return; }
+static size_t find_implicit_close_index(hb_array_T* nodes, size_t start_index, size_t end_index, hb_string_T tag_name) {
+  if (!has_optional_end_tag(tag_name)) { return NO_MATCHING_TAG; }
+
+  for (size_t index = start_index + 1; index < end_index; index++) {
+    AST_NODE_T* node = (AST_NODE_T*) hb_array_get(nodes, index);
+    if (node == NULL) { continue; }
+
+    if (node->type == AST_HTML_OPEN_TAG_NODE) {
+      AST_HTML_OPEN_TAG_NODE_T* open = (AST_HTML_OPEN_TAG_NODE_T*) node;
+      hb_string_T next_tag_name = open->tag_name->value;
+
+      if (should_implicitly_close(tag_name, next_tag_name)) { return index; }
+    } else if (node->type == AST_HTML_CLOSE_TAG_NODE) {
+      AST_HTML_CLOSE_TAG_NODE_T* close = (AST_HTML_CLOSE_TAG_NODE_T*) node;
+      hb_string_T close_tag_name = close->tag_name->value;
 
-  for (size_t i = 0; i < hb_array_size(*close_tag_names); i++) {
-    hb_string_T* name = (hb_string_T*) hb_array_get(*close_tag_names, i);
-    if (name != NULL) { hb_allocator_dealloc(allocator, name); }
+      if (parent_closes_element(tag_name, close_tag_name)) { return index; }
+    }
   }
 
-  hb_array_free(close_tag_names);
+  return end_index;
 }
 
+// Builds elements out of `nodes[start_index, end_index)`. Close tags matched
+// outside of that range are ignored, as if the range were its own array.
 static hb_array_T* parser_build_elements_from_tags(
   hb_array_T* nodes,
+  size_t start_index,
+  size_t end_index,
+  const size_t* matches,
   hb_array_T* errors,
   const parser_options_T* options,
   hb_allocator_T* allocator
 ) {
   bool strict = options ? options->strict : false;
-  hb_array_T* result = hb_array_init(hb_array_size(nodes), allocator);
-  hb_array_T* close_tag_names = collect_close_tag_names(nodes, allocator);
+  hb_array_T* result = hb_array_init(end_index - start_index, allocator);
 
-  for (size_t index = 0; index < hb_array_size(nodes); index++) {
+  for (size_t index = start_index; index < end_index; index++) {
     if (parser_options_past_deadline(options)) { break; }
 
     AST_NODE_T* node = (AST_NODE_T*) hb_array_get(nodes, index);
@@ -1763,24 +1847,22 @@ static hb_array_T* parser_build_elements_from_tags(
       AST_HTML_OPEN_TAG_NODE_T* open_tag = (AST_HTML_OPEN_TAG_NODE_T*) node;
       hb_string_T tag_name = open_tag->tag_name->value;
 
-      size_t close_index = (size_t) -1;
+      size_t close_index = matches[index];
+      if (close_index >= end_index) { close_index = NO_MATCHING_TAG; }
 
-      if (has_close_tag_for_name(close_tag_names, tag_name)) {
-        close_index = find_matching_close_tag(nodes, index, tag_name, options);
-      }
-
-      if (close_index == (size_t) -1) {
-        size_t implicit_close_index = find_implicit_close_index(nodes, index, tag_name);
-
-        if (implicit_close_index != (size_t) -1 && implicit_close_index > index + 1) {
-          hb_array_T* body = hb_array_init(implicit_close_index - index - 1, allocator);
+      if (close_index == NO_MATCHING_TAG) {
+        size_t implicit_close_index = find_implicit_close_index(nodes, index, end_index, tag_name);
 
-          for (size_t j = index + 1; j < implicit_close_index; j++) {
-            hb_array_append(body, hb_array_get(nodes, j));
-          }
-
-          hb_array_T* processed_body = parser_build_elements_from_tags(body, errors, options, allocator);
-          hb_array_free(&body);
+        if (implicit_close_index != NO_MATCHING_TAG && implicit_close_index > index + 1) {
+          hb_array_T* processed_body = parser_build_elements_from_tags(
+            nodes,
+            index + 1,
+            implicit_close_index,
+            matches,
+            errors,
+            options,
+            allocator
+          );
 
           position_T end_position = open_tag->base.location.end;
 
@@ -1844,14 +1926,8 @@ static hb_array_T* parser_build_elements_from_tags(
       } else {
         AST_HTML_CLOSE_TAG_NODE_T* close_tag = (AST_HTML_CLOSE_TAG_NODE_T*) hb_array_get(nodes, close_index);
 
-        hb_array_T* body = hb_array_init(close_index - index - 1, allocator);
-
-        for (size_t j = index + 1; j < close_index; j++) {
-          hb_array_append(body, hb_array_get(nodes, j));
-        }
-
-        hb_array_T* processed_body = parser_build_elements_from_tags(body, errors, options, allocator);
-        hb_array_free(&body);
+        hb_array_T* processed_body =
+          parser_build_elements_from_tags(nodes, index + 1, close_index, matches, errors, options, allocator);
 
         hb_array_T* element_errors = NULL;
 
@@ -1894,8 +1970,6 @@ static hb_array_T* parser_build_elements_from_tags(
     }
   }
 
-  free_close_tag_names(&close_tag_names, allocator);
-
   return result;
 }
 
@@ -1973,7 +2047,10 @@ void match_tags_in_node_array(
 ) {
   if (nodes == NULL || hb_array_size(nodes) == 0) { return; }
 
-  hb_array_T* processed = parser_build_elements_from_tags(nodes, errors, options, allocator);
+  size_t* matches = match_close_tags(nodes, allocator);
+  hb_array_T* processed =
+    parser_build_elements_from_tags(nodes, 0, hb_array_size(nodes), matches, errors, options, allocator);
+  hb_allocator_dealloc(allocator, matches);
 
   nodes->size = 0;
 
@@ -0,0 +1,54 @@
+#include "../include/prism/prism_context.h"
+#include "../include/extract.h"
+#include "../include/lib/hb_allocator.h"
+#include "../include/lib/hb_buffer.h"
+
+#include <prism.h>
+#include <string.h>
+
+herb_prism_context_T* herb_prism_context_init(const char* source, hb_allocator_T* allocator) {
+  if (!source) { return NULL; }
+
+  herb_prism_context_T* context = hb_allocator_alloc(allocator, sizeof(herb_prism_context_T));
+  if (!context) { return NULL; }
+
+  memset(context, 0, sizeof(herb_prism_context_T));
+
+  context->allocator = allocator;
+  context->has_structural = false;
+
+  if (!hb_buffer_init(&context->ruby_buf, strlen(source), allocator)) {
+    hb_allocator_dealloc(allocator, context);
+    return NULL;
+  }
+
+  herb_extract_ruby_options_T extract_options = {
+    .semicolons = true,
+    .comments = false,
+    .preserve_positions = true,
+  };
+
+  herb_extract_ruby_to_buffer_with_options(source, &context->ruby_buf, &extract_options, allocator);
+
+  if (!context->ruby_buf.value || context->ruby_buf.length == 0) {
+    hb_buffer_free(&context->ruby_buf);
+    hb_allocator_dealloc(allocator, context);
+    return NULL;
+  }
+
+  pm_options_partial_script_set(&context->pm_opts, true);
+  pm_parser_init(
+    &context->parser,
+    (const uint8_t*) context->ruby_buf.value,
+    context->ruby_buf.length,
+    &context->pm_opts
+  );
+  context->root = pm_parse(&context->parser);
+
+  if (!context->root) {
+    herb_prism_context_free(context);
+    return NULL;
+  }
+
+  return context;
+}
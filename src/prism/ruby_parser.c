@@ -1,4 +1,6 @@
 #include "../include/prism/ruby_parser.h"
+#include "../include/lib/hb_allocator.h"
+#include "../include/lib/hb_buffer.h"
 
 #include <prism.h>
 #include <stdbool.h>
@@ -68,31 +70,57 @@ static bool ruby_source_parses(const char* source, size_t length) {
   return parses;
 }
 
-bool herb_ruby_fragment_is_parseable(hb_string_T source) {
+static bool ruby_fragment_budget_allows(size_t* budget, size_t length) {
+  if (budget == NULL) { return true; }
+
+  if (*budget < length) {
+    *budget = 0;
+    return false;
+  }
+
+  *budget -= length;
+
+  return true;
+}
+
+bool herb_ruby_fragment_is_parseable_with_scratch(hb_string_T source, hb_buffer_T* scratch, size_t* budget) {
   if (source.data == NULL) { return false; }
 
-  for (size_t index = 0; index < sizeof(RUBY_FRAGMENT_PREFIXES) / sizeof(RUBY_FRAGMENT_PREFIXES[0]); index++) {
+  if (!ruby_fragment_budget_allows(budget, source.length)) { return false; }
+  if (ruby_source_parses(source.data, source.length)) { return true; }
+
+  for (size_t index = 1; index < sizeof(RUBY_FRAGMENT_PREFIXES) / sizeof(RUBY_FRAGMENT_PREFIXES[0]); index++) {
     const char* prefix = RUBY_FRAGMENT_PREFIXES[index];
     const char* suffix = RUBY_FRAGMENT_SUFFIXES[index];
 
-    size_t prefix_length = strlen(prefix);
-    size_t suffix_length = strlen(suffix);
-    size_t length = prefix_length + source.length + suffix_length;
+    size_t length = strlen(prefix) + source.length + strlen(suffix);
 
-    char* wrapped = malloc(length + 1);
-    if (wrapped == NULL) { return false; }
+    if (!ruby_fragment_budget_allows(budget, length)) { return false; }
 
-    memcpy(wrapped, prefix, prefix_length);
-    memcpy(wrapped + prefix_length, source.data, source.length);
-    memcpy(wrapped + prefix_length + source.length, suffix, suffix_length);
-    wrapped[length] = '\0';
+    hb_buffer_clear(scratch);
+    hb_buffer_append(scratch, prefix);
+    hb_buffer_append_string(scratch, source);
+    hb_buffer_append(scratch, suffix);
 
-    bool parses = ruby_source_parses(wrapped, length);
+    if (hb_buffer_length(scratch) != length) { return false; }
 
-    free(wrapped);
-
-    if (parses) { return true; }
+    if (ruby_source_parses(hb_buffer_value(scratch), length)) { return true; }
   }
 
   return false;
 }
+
+bool herb_ruby_fragment_is_parseable(hb_string_T source) {
+  if (source.data == NULL) { return false; }
+
+  hb_allocator_T allocator = hb_allocator_with_malloc();
+  hb_buffer_T scratch;
+
+  if (!hb_buffer_init(&scratch, source.length + 16, &allocator)) { return false; }
+
+  bool parses = herb_ruby_fragment_is_parseable_with_scratch(source, &scratch, NULL);
+
+  hb_buffer_free(&scratch);
+
+  return parses;
+}
@@ -0,0 +1,439 @@
+#include "include/render_scan.h"
+#include "include/herb.h"
+#include "include/lexer/token.h"
+#include "include/lib/hb_allocator.h"
+#include "include/lib/hb_array.h"
+#include "include/lib/hb_buffer.h"
+#include "include/lib/hb_string.h"
+#include "include/util/util.h"
+
+#include <prism.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define RENDER_MARKER "render"
+#define STRICT_LOCALS_PREFIX "locals:"
+#define SYNTHETIC_PREFIX "def _"
+#define SYNTHETIC_SUFFIX "; end"
+
+// Only the tags are looked at. The lexer runs over the whole template, but nothing is parsed into HTML nodes, and
+// Prism only sees the tags that can hold a render call or a strict locals declaration, so a template that renders
+// nothing costs about as much as lexing it.
+typedef struct {
+  herb_render_scan_T* scan;
+  hb_allocator_T* allocator;
+  hb_string_T content;
+  position_T tag_start;
+  bool is_comment;
+  bool is_skipped;
+} render_scan_state_T;
+
+static bool contains_render_marker(hb_string_T content) {
+  size_t marker_length = strlen(RENDER_MARKER);
+  if (content.length < marker_length) { return false; }
+
+  const char* cursor = content.data;
+  const char* last = content.data + content.length - marker_length;
+
+  while (cursor <= last) {
+    cursor = memchr(cursor, RENDER_MARKER[0], (size_t) (last - cursor) + 1);
+    if (!cursor) { return false; }
+    if (memcmp(cursor, RENDER_MARKER, marker_length) == 0) { return true; }
+
+    cursor++;
+  }
+
+  return false;
+}
+
+static const pm_string_t* unescaped_value(pm_node_t* node) {
+  if (!node) { return NULL; }
+  if (node->type == PM_STRING_NODE) { return &((pm_string_node_t*) node)->unescaped; }
+  if (node->type == PM_SYMBOL_NODE) { return &((pm_symbol_node_t*) node)->unescaped; }
+
+  return NULL;
+}
+
+static bool key_equals(pm_node_t* key, const char* name) {
+  const pm_string_t* unescaped = unescaped_value(key);
+  if (!unescaped) { return false; }
+
+  size_t length = strlen(name);
+
+  return pm_string_length(unescaped) == length && memcmp(pm_string_source(unescaped), name, length) == 0;
+}
+
+static char* source_of(pm_node_t* node, hb_allocator_T* allocator) {
+  if (!node) { return NULL; }
+
+  size_t length = (size_t) (node->location.end - node->location.start);
+  return hb_allocator_strndup(allocator, (const char*) node->location.start, length);
+}
+
+static char* value_of(pm_node_t* node, hb_allocator_T* allocator) {
+  const pm_string_t* unescaped = unescaped_value(node);
+  if (!unescaped) { return source_of(node, allocator); }
+
+  return hb_allocator_strndup(allocator, (const char*) pm_string_source(unescaped), pm_string_length(unescaped));
+}
+
+static pm_node_t* find_keyword(pm_keyword_hash_node_t* keyword_hash, const char* name) {
+  if (!keyword_hash) { return NULL; }
+
+  for (size_t index = 0; index < keyword_hash->elements.size; index++) {
+    pm_node_t* element = keyword_hash->elements.nodes[index];
+    if (element->type != PM_ASSOC_NODE) { continue; }
+
+    pm_assoc_node_t* assoc = (pm_assoc_node_t*) element;
+    if (key_equals(assoc->key, name)) { return assoc->value; }
+  }
+
+  return NULL;
+}
+
+static bool is_render_call(pm_call_node_t* call_node, pm_parser_t* parser) {
+  if (!call_node || !call_node->name) { return false; }
+  if (call_node->receiver && call_node->receiver->type != PM_SELF_NODE) { return false; }
+
+  pm_constant_t* constant = pm_constant_pool_id_to_constant(&parser->constant_pool, call_node->name);
+
+  return constant && constant->length == strlen(RENDER_MARKER)
+      && strncmp((const char*) constant->start, RENDER_MARKER, constant->length) == 0;
+}
+
+// Like the analyzer, only a render call that is the first statement of its tag counts.
+static pm_call_node_t* find_render_call(pm_node_t* root, pm_parser_t* parser) {
+  if (!root || root->type != PM_PROGRAM_NODE) { return NULL; }
+
+  pm_program_node_t* program = (pm_program_node_t*) root;
+  if (!program->statements || program->statements->body.size == 0) { return NULL; }
+
+  pm_node_t* first = program->statements->body.nodes[0];
+  if (first->type != PM_CALL_NODE || !is_render_call((pm_call_node_t*) first, parser)) { return NULL; }
+
+  return (pm_call_node_t*) first;
+}
+
+static bool has_block(pm_call_node_t* render_call) {
+  if (render_call->block && render_call->block->type == PM_BLOCK_NODE) { return true; }
+
+  pm_arguments_node_t* arguments = render_call->arguments;
+  if (!arguments || arguments->arguments.size == 0) { return false; }
+
+  pm_node_t* first_argument = arguments->arguments.nodes[0];
+  if (first_argument->type != PM_CALL_NODE) { return false; }
+
+  pm_node_t* block = ((pm_call_node_t*) first_argument)->block;
+  return block && block->type == PM_BLOCK_NODE;
+}
+
+static void append_locals(hb_array_T* locals, pm_node_list_t* elements, hb_allocator_T* allocator) {
+  for (size_t index = 0; index < elements->size; index++) {
+    pm_node_t* element = elements->nodes[index];
+    if (element->type != PM_ASSOC_NODE) { continue; }
+
+    pm_assoc_node_t* assoc = (pm_assoc_node_t*) element;
+    herb_render_local_T* local = hb_allocator_alloc(allocator, sizeof(herb_render_local_T));
+    if (!local) { return; }
+
+    local->name = value_of(assoc->key, allocator);
+    local->value = source_of(assoc->value, allocator);
+
+    hb_array_append(locals, local);
+  }
+}
+
+// Mirrors create_render_node_from_call in analyze/render_nodes.c: with a positional partial, every keyword is a
+// local unless `locals:` is given; with the keyword form, only `locals:` holds locals.
+static herb_render_call_T* create_render_call(
+  pm_call_node_t* call_node,
+  location_T location,
+  hb_allocator_T* allocator
+) {
+  herb_render_call_T* render_call = hb_allocator_alloc(allocator, sizeof(herb_render_call_T));
+  if (!render_call) { return NULL; }
+
+  memset(render_call, 0, sizeof(herb_render_call_T));
+  render_call->location = location;
+  render_call->has_block = has_block(call_node);
+  render_call->locals = hb_array_init(0, allocator);
+
+  pm_arguments_node_t* arguments = call_node->arguments;
+  if (!arguments || arguments->arguments.size == 0) { return render_call; }
+
+  pm_node_t* first_argument = arguments->arguments.nodes[0];
+  pm_node_t* last_argument = arguments->arguments.nodes[arguments->arguments.size - 1];
+
+  pm_keyword_hash_node_t* keyword_hash =
+    last_argument->type == PM_KEYWORD_HASH_NODE ? (pm_keyword_hash_node_t*) last_argument : NULL;
+
+  bool has_positional_partial = first_argument->type == PM_STRING_NODE;
+
+  if (has_positional_partial) {
+    render_call->partial = value_of(first_argument, allocator);
+  } else if (first_argument->type != PM_KEYWORD_HASH_NODE) {
+    render_call->object = source_of(first_argument, allocator);
+  }
+
+  if (!keyword_hash) { return render_call; }
+
+  pm_node_t* locals_value = find_keyword(keyword_hash, "locals");
+  pm_hash_node_t* locals_hash =
+    locals_value && locals_value->type == PM_HASH_NODE ? (pm_hash_node_t*) locals_value : NULL;
+
+  if (has_positional_partial) {
+    append_locals(render_call->locals, locals_hash ? &locals_hash->elements : &keyword_hash->elements, allocator);
+
+    return render_call;
+  }
+
+  struct {
+    const char* name;
+    char** target;
+  } keyword_fields[] = {
+    { "partial", &render_call->partial },       { "template", &render_call->template_path },
+    { "layout", &render_call->layout },         { "collection", &render_call->collection },
+    { "object", &render_call->object },         { "as", &render_call->as_name },
+  };
+
+  for (size_t index = 0; index < sizeof(keyword_fields) / sizeof(keyword_fields[0]); index++) {
+    pm_node_t* value = find_keyword(keyword_hash, keyword_fields[index].name);
+    if (value) { *keyword_fields[index].target = value_of(value, allocator); }
+  }
+
+  if (locals_hash) { append_locals(render_call->locals, &locals_hash->elements, allocator); }
+
+  return render_call;
+}
+
+static void scan_render_call(render_scan_state_T* state, location_T location) {
+  if (!contains_render_marker(state->content)) { return; }
+
+  pm_parser_t parser;
+  pm_parser_init(&parser, (const uint8_t*) state->content.data, state->content.length, NULL);
+  pm_node_t* root = pm_parse(&parser);
+
+  pm_call_node_t* render_call = find_render_call(root, &parser);
+
+  // The opening tag of a block, `<%= render Component.new do %>`, does not parse on its own; the analyzer reads
+  // those from the ERB block node, so they are kept here despite the errors. Any other tag that fails to parse
+  // never becomes a render node.
+  if (render_call && (parser.error_list.size == 0 || has_block(render_call))) {
+    herb_render_call_T* call = create_render_call(render_call, location, state->allocator);
+    if (call) { hb_array_append(state->scan->render_calls, call); }
+  }
+
+  pm_node_destroy(&parser, root);
+  pm_parser_free(&parser);
+}
+
+static const char* skip_whitespace(const char* cursor, const char* end) {
+  while (cursor < end && is_whitespace(*cursor)) {
+    cursor++;
+  }
+
+  return cursor;
+}
+
+static const char* find_params_close(const char* params_open, const char* end) {
+  int depth = 0;
+
+  for (const char* cursor = params_open; cursor < end; cursor++) {
+    if (*cursor == '(') {
+      depth++;
+    } else if (*cursor == ')') {
+      depth--;
+      if (depth == 0) { return cursor; }
+    }
+  }
+
+  return NULL;
+}
+
+static void append_strict_locals(
+  render_scan_state_T* state,
+  pm_parameters_node_t* parameters,
+  hb_allocator_T* allocator
+) {
+  for (size_t index = 0; index < parameters->keywords.size; index++) {
+    pm_node_t* keyword = parameters->keywords.nodes[index];
+
+    pm_location_t name_location;
+    pm_node_t* default_value = NULL;
+
+    if (keyword->type == PM_REQUIRED_KEYWORD_PARAMETER_NODE) {
+      name_location = ((pm_required_keyword_parameter_node_t*) keyword)->name_loc;
+    } else if (keyword->type == PM_OPTIONAL_KEYWORD_PARAMETER_NODE) {
+      pm_optional_keyword_parameter_node_t* optional_keyword = (pm_optional_keyword_parameter_node_t*) keyword;
+      name_location = optional_keyword->name_loc;
+      default_value = optional_keyword->value;
+    } else {
+      continue;
+    }
+
+    size_t name_length = (size_t) (name_location.end - name_location.start);
+    if (name_length > 0 && name_location.start[name_length - 1] == ':') { name_length--; }
+
+    herb_strict_local_T* local = hb_allocator_alloc(allocator, sizeof(herb_strict_local_T));
+    if (!local) { return; }
+
+    local->name = hb_allocator_strndup(allocator, (const char*) name_location.start, name_length);
+    local->default_value = source_of(default_value, allocator);
+    local->required = keyword->type == PM_REQUIRED_KEYWORD_PARAMETER_NODE;
+
+    hb_array_append(state->scan->strict_locals, local);
+  }
+
+  if (parameters->keyword_rest && parameters->keyword_rest->type == PM_KEYWORD_REST_PARAMETER_NODE) {
+    state->scan->has_keyword_rest = true;
+  }
+}
+
+// `<%# locals: (title:, size: :md) %>` is read by parsing `def _(title:, size: :md); end`, the same synthetic method
+// analyze/strict_locals.c builds. A declaration that does not parse still counts as one, with no locals, as it
+// does in the AST. Only the first declaration is read, which is also the one Rails compiles.
+static void scan_strict_locals(render_scan_state_T* state, location_T location) {
+  if (state->scan->has_strict_locals) { return; }
+
+  const char* end = state->content.data + state->content.length;
+  const char* cursor = skip_whitespace(state->content.data, end);
+  size_t prefix_length = strlen(STRICT_LOCALS_PREFIX);
+
+  if ((size_t) (end - cursor) < prefix_length || strncmp(cursor, STRICT_LOCALS_PREFIX, prefix_length) != 0) {
+    return;
+  }
+
+  state->scan->has_strict_locals = true;
+  state->scan->strict_locals_location = location;
+
+  const char* params_open = skip_whitespace(cursor + prefix_length, end);
+  if (params_open == end || *params_open != '(') { return; }
+
+  const char* params_close = find_params_close(params_open, end);
+  size_t params_length = params_close ? (size_t) (params_close - params_open) + 1 : (size_t) (end - params_open);
+
+  hb_buffer_T synthetic;
+  size_t capacity = strlen(SYNTHETIC_PREFIX) + params_length + strlen(SYNTHETIC_SUFFIX) + 1;
+  if (!hb_buffer_init(&synthetic, capacity, state->allocator)) { return; }
+
+  hb_buffer_append(&synthetic, SYNTHETIC_PREFIX);
+  hb_buffer_append_with_length(&synthetic, params_open, params_length);
+  hb_buffer_append(&synthetic, SYNTHETIC_SUFFIX);
+
+  pm_parser_t parser;
+  pm_parser_init(&parser, (const uint8_t*) hb_buffer_value(&synthetic), hb_buffer_length(&synthetic), NULL);
+  pm_node_t* root = pm_parse(&parser);
+
+  bool valid = true;
+
+  for (const pm_diagnostic_t* error = (const pm_diagnostic_t*) parser.error_list.head; error != NULL;
+       error = (const pm_diagnostic_t*) error->node.next) {
+    if (error->diag_id != PM_ERR_DEF_TERM) {
+      valid = false;
+      break;
+    }
+  }
+
+  pm_program_node_t* program = root && root->type == PM_PROGRAM_NODE ? (pm_program_node_t*) root : NULL;
+  pm_node_t* first = program && program->statements && program->statements->body.size > 0
+                     ? program->statements->body.nodes[0]
+                     : NULL;
+
+  if (valid && first && first->type == PM_DEF_NODE && ((pm_def_node_t*) first)->parameters) {
+    append_strict_locals(state, ((pm_def_node_t*) first)->parameters, state->allocator);
+  }
+
+  pm_node_destroy(&parser, root);
+  pm_parser_free(&parser);
+  hb_buffer_free(&synthetic);
+}
+
+static bool scan_token(const token_T* token, void* data) {
+  render_scan_state_T* state = (render_scan_state_T*) data;
+
+  switch (token->type) {
+    case TOKEN_ERB_START: {
+      state->content = HB_STRING_NULL;
+      state->tag_start = token->location.start;
+      state->is_comment = hb_string_starts_with(token->value, hb_string("<%#"));
+      state->is_skipped = token_is_escaped_erb_tag_opening(token)
+                       || hb_string_equals(token->value, hb_string("<%graphql"));
+      break;
+    }
+
+    case TOKEN_ERB_CONTENT: {
+      state->content = token->value;
+      break;
+    }
+
+    case TOKEN_ERB_END: {
+      if (state->is_skipped || hb_string_is_null(state->content)) { break; }
+
+      location_T location = { .start = state->tag_start, .end = token->location.end };
+
+      if (state->is_comment) {
+        scan_strict_locals(state, location);
+      } else {
+        scan_render_call(state, location);
+      }
+
+      state->content = HB_STRING_NULL;
+      break;
+    }
+
+    default: break;
+  }
+
+  return true;
+}
+
+HERB_EXPORTED_FUNCTION bool herb_scan_renders(const char* source, herb_render_scan_T* scan, hb_allocator_T* allocator) {
+  memset(scan, 0, sizeof(herb_render_scan_T));
+
+  scan->render_calls = hb_array_init(0, allocator);
+  scan->strict_locals = hb_array_init(0, allocator);
+
+  if (!scan->render_calls || !scan->strict_locals) { return false; }
+
+  render_scan_state_T state = { .scan = scan, .allocator = allocator, .content = HB_STRING_NULL };
+  herb_lex_each(source, scan_token, &state, allocator);
+
+  return true;
+}
+
+HERB_EXPORTED_FUNCTION void herb_render_scan_free(herb_render_scan_T* scan, hb_allocator_T* allocator) {
+  if (!scan) { return; }
+
+  for (size_t index = 0; index < hb_array_size(scan->render_calls); index++) {
+    herb_render_call_T* call = hb_array_get(scan->render_calls, index);
+
+    for (size_t local_index = 0; local_index < hb_array_size(call->locals); local_index++) {
+      herb_render_local_T* local = hb_array_get(call->locals, local_index);
+
+      hb_allocator_dealloc(allocator, local->name);
+      hb_allocator_dealloc(allocator, local->value);
+      hb_allocator_dealloc(allocator, local);
+    }
+
+    char* fields[] = { call->partial,    call->template_path, call->layout,
+                       call->collection, call->object,        call->as_name };
+
+    for (size_t field = 0; field < sizeof(fields) / sizeof(fields[0]); field++) {
+      if (fields[field]) { hb_allocator_dealloc(allocator, fields[field]); }
+    }
+
+    hb_array_free(&call->locals);
+    hb_allocator_dealloc(allocator, call);
+  }
+
+  for (size_t index = 0; index < hb_array_size(scan->strict_locals); index++) {
+    herb_strict_local_T* local = hb_array_get(scan->strict_locals, index);
+
+    hb_allocator_dealloc(allocator, local->name);
+    if (local->default_value) { hb_allocator_dealloc(allocator, local->default_value); }
+    hb_allocator_dealloc(allocator, local);
+  }
+
+  hb_array_free(&scan->render_calls);
+  hb_array_free(&scan->strict_locals);
+}
@@ -0,0 +1,285 @@
+#include "include/ast/ast_node.h"
+#include "include/herb.h"
+#include "include/lib/hb_allocator.h"
+#include "include/lib/hb_array.h"
+#include "include/location/relocation.h"
+#include "include/visitor.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// The top-level children that surround an edit and stay untouched by it. Everything strictly between `left` and
+// `right` is reparsed; -1 means the region reaches the start or end of the document.
+typedef struct {
+  long left;
+  long right;
+  uint32_t old_from;
+  uint32_t old_to;
+} reparse_region_T;
+
+static AST_DOCUMENT_NODE_T* reparse_fully(
+  AST_DOCUMENT_NODE_T* document,
+  const char* source,
+  const parser_options_T* options,
+  hb_allocator_T* allocator
+) {
+  if (document != NULL) { ast_node_free((AST_NODE_T*) document, allocator); }
+
+  return herb_parse(source, options, allocator);
+}
+
+static bool reparse_count_errors(const AST_NODE_T* node, void* data) {
+  if (node == NULL) { return false; }
+
+  if (node->errors != NULL) { *((uint32_t*) data) += (uint32_t) hb_array_size(node->errors); }
+
+  return true;
+}
+
+// Whether the parse of `node` is independent of what follows and precedes it: the node starts with `<` and ends
+// with `>`, so neighbouring text cannot merge into it, and an element is closed by its own end tag rather than by
+// whatever comes next. Errors such as an unclosed ERB tag mean the lexer ran on into the following text, so a subtree
+// with errors is never a boundary.
+static bool reparse_is_boundary(const AST_NODE_T* node) {
+  uint32_t error_count = 0;
+  herb_visit_node(node, reparse_count_errors, &error_count);
+
+  if (error_count > 0) { return false; }
+
+  switch (node->type) {
+    case AST_HTML_TEXT_NODE:
+    case AST_WHITESPACE_NODE:
+    case AST_LITERAL_NODE: return false;
+
+    case AST_HTML_ELEMENT_NODE: {
+      const AST_HTML_ELEMENT_NODE_T* element = (const AST_HTML_ELEMENT_NODE_T*) node;
+      if (element->is_void) { return true; }
+      if (element->close_tag == NULL) { return false; }
+
+      return element->close_tag->type == AST_HTML_CLOSE_TAG_NODE || element->close_tag->type == AST_ERB_END_NODE;
+    }
+
+    default: return true;
+  }
+}
+
+static bool reparse_find_region(
+  const AST_DOCUMENT_NODE_T* document,
+  const herb_edit_T* edit,
+  uint32_t old_length,
+  reparse_region_T* region
+) {
+  region->left = -1;
+  region->right = -1;
+  region->old_from = 0;
+  region->old_to = old_length;
+
+  size_t count = hb_array_size(document->children);
+
+  for (size_t index = 0; index < count; index++) {
+    const AST_NODE_T* child = hb_array_get(document->children, index);
+    range_T range;
+
+    if (!reparse_is_boundary(child)) { continue; }
+    if (!ast_node_byte_range(child, &range)) { return false; }
+
+    if (range.to < edit->start) {
+      region->left = (long) index;
+      region->old_from = range.to;
+    } else if (range.from > edit->old_end) {
+      region->right = (long) index;
+      region->old_to = range.from;
+      break;
+    }
+  }
+
+  return region->old_from <= region->old_to;
+}
+
+// The reparsed region must not end in an element that the next untouched sibling would otherwise have closed.
+static bool reparse_fragment_is_self_contained(AST_DOCUMENT_NODE_T* fragment) {
+  uint32_t error_count = 0;
+  herb_visit_node((AST_NODE_T*) fragment, reparse_count_errors, &error_count);
+
+  if (error_count > 0) { return false; }
+
+  size_t count = hb_array_size(fragment->children);
+  if (count == 0) { return true; }
+
+  const AST_NODE_T* last = hb_array_get(fragment->children, count - 1);
+  if (last->type != AST_HTML_ELEMENT_NODE) { return true; }
+
+  return reparse_is_boundary(last);
+}
+
+HERB_EXPORTED_FUNCTION AST_DOCUMENT_NODE_T* herb_reparse(
+  AST_DOCUMENT_NODE_T* document,
+  const char* previous_source,
+  const char* source,
+  const herb_edit_T* edit,
+  const parser_options_T* options,
+  hb_allocator_T* allocator
+) {
+  if (!source) { source = ""; }
+  if (document == NULL || previous_source == NULL || edit == NULL) {
+    return reparse_fully(document, source, options, allocator);
+  }
+
+  parser_options_T parser_options = HERB_DEFAULT_PARSER_OPTIONS;
+  if (options != NULL) { parser_options = *options; }
+
+  // Prism annotations point into a program parsed from the whole previous source, and document-level errors
+  // describe the whole document; neither can be patched locally. Tag helper analysis reads the Ruby locals of the
+  // whole program, which a fragment parsed on its own cannot see. Strict locals comments are checked against every
+  // other declaration in the document, so a fragment cannot tell whether its own is a duplicate.
+  if (parser_options.prism_nodes || parser_options.prism_program || parser_options.action_view_helpers
+      || parser_options.strict_locals
+      || document->prism_context != NULL
+      || (document->base.errors != NULL && hb_array_size(document->base.errors) > 0)) {
+    return reparse_fully(document, source, options, allocator);
+  }
+
+  size_t old_length = strlen(previous_source);
+  size_t new_length = strlen(source);
+
+  bool edit_is_valid = edit->start <= edit->old_end && edit->old_end <= old_length && edit->start <= edit->new_end
+                    && edit->new_end <= new_length && old_length - edit->old_end == new_length - edit->new_end
+                    && new_length <= UINT32_MAX;
+
+  reparse_region_T region;
+
+  if (!edit_is_valid || !reparse_find_region(document, edit, (uint32_t) old_length, &region)) {
+    return reparse_fully(document, source, options, allocator);
+  }
+
+  int64_t byte_delta = (int64_t) edit->new_end - (int64_t) edit->old_end;
+  uint32_t new_from = region.old_from;
+  uint32_t new_to = (uint32_t) ((int64_t) region.old_to + byte_delta);
+  size_t fragment_length = new_to - new_from;
+
+  position_T region_start = { .line = parser_options.start_line > 0 ? parser_options.start_line : 1,
+                              .column = parser_options.start_column };
+
+  if (region.left >= 0) {
+    region_start = ((AST_NODE_T*) hb_array_get(document->children, (size_t) region.left))->location.end;
+  }
+
+  char* fragment_source = hb_allocator_strndup(allocator, source + new_from, fragment_length);
+  if (fragment_source == NULL) { return reparse_fully(document, source, options, allocator); }
+
+  uint32_t fragment_error_count = 0;
+  parser_options_T fragment_options = parser_options;
+  fragment_options.start_line = 0;
+  fragment_options.start_column = 0;
+  fragment_options.error_count = &fragment_error_count;
+
+  AST_DOCUMENT_NODE_T* fragment = herb_parse(fragment_source, &fragment_options, allocator);
+
+  if (fragment == NULL || !reparse_fragment_is_self_contained(fragment)) {
+    if (fragment != NULL) { ast_node_free((AST_NODE_T*) fragment, allocator); }
+    hb_allocator_dealloc(allocator, fragment_source);
+
+    return reparse_fully(document, source, options, allocator);
+  }
+
+  relocation_T fragment_relocation = {
+    .from = fragment_source,
+    .to = source + new_from,
+    .length = fragment_length,
+    .byte_delta = new_from,
+    .anchor_line = 1,
+    .column_delta = region_start.column,
+    .line_delta = (int64_t) region_start.line - 1,
+  };
+
+  ast_node_relocate((AST_NODE_T*) fragment, &fragment_relocation);
+  hb_allocator_dealloc(allocator, fragment_source);
+
+  position_T region_end = fragment->base.location.end;
+  hb_array_T* previous_children = document->children;
+  size_t previous_count = hb_array_size(previous_children);
+  size_t right = region.right >= 0 ? (size_t) region.right : previous_count;
+  size_t left_count = (size_t) (region.left + 1);
+
+  relocation_T suffix_relocation = {
+    .from = previous_source + region.old_to,
+    .to = source + new_to,
+    .length = old_length - region.old_to,
+    .byte_delta = byte_delta,
+  };
+
+  if (right < previous_count) {
+    position_T old_start = ((AST_NODE_T*) hb_array_get(previous_children, right))->location.start;
+
+    suffix_relocation.anchor_line = old_start.line;
+    suffix_relocation.column_delta = (int64_t) region_end.column - (int64_t) old_start.column;
+    suffix_relocation.line_delta = (int64_t) region_end.line - (int64_t) old_start.line;
+  }
+
+  // Error messages spell out positions, so errors in a subtree that moves have to come from a fresh parse.
+  if (suffix_relocation.column_delta != 0 || suffix_relocation.line_delta != 0) {
+    uint32_t suffix_error_count = 0;
+
+    for (size_t index = right; index < previous_count; index++) {
+      herb_visit_node(hb_array_get(previous_children, index), reparse_count_errors, &suffix_error_count);
+    }
+
+    if (suffix_error_count > 0) {
+      ast_node_free((AST_NODE_T*) fragment, allocator);
+      return reparse_fully(document, source, options, allocator);
+    }
+  }
+
+  hb_array_T* children =
+    hb_array_init(left_count + hb_array_size(fragment->children) + (previous_count - right), allocator);
+
+  relocation_T prefix_relocation = {
+    .from = previous_source,
+    .to = source,
+    .length = region.old_from,
+    .byte_delta = 0,
+    .anchor_line = 0,
+    .column_delta = 0,
+    .line_delta = 0,
+  };
+
+  for (size_t index = 0; index < left_count; index++) {
+    AST_NODE_T* child = hb_array_get(previous_children, index);
+    ast_node_relocate(child, &prefix_relocation);
+    hb_array_append(children, child);
+  }
+
+  for (size_t index = 0; index < hb_array_size(fragment->children); index++) {
+    hb_array_append(children, hb_array_get(fragment->children, index));
+  }
+
+  for (size_t index = left_count; index < right; index++) {
+    ast_node_free(hb_array_get(previous_children, index), allocator);
+  }
+
+  if (right < previous_count) {
+    for (size_t index = right; index < previous_count; index++) {
+      AST_NODE_T* child = hb_array_get(previous_children, index);
+      ast_node_relocate(child, &suffix_relocation);
+      hb_array_append(children, child);
+    }
+
+    relocation_apply_position(&document->base.location.end, &suffix_relocation);
+  } else {
+    document->base.location.end = region_end;
+  }
+
+  hb_array_free(&previous_children);
+  document->children = children;
+
+  hb_array_free(&fragment->children);
+  ast_node_free((AST_NODE_T*) fragment, allocator);
+
+  if (parser_options.error_count != NULL) {
+    *parser_options.error_count = 0;
+    herb_visit_node((AST_NODE_T*) document, reparse_count_errors, parser_options.error_count);
+  }
+
+  return document;
+}
@@ -0,0 +1,102 @@
+#include "include/session.h"
+#include "include/ast/ast_node.h"
+#include "include/herb.h"
+#include "include/lib/hb_allocator.h"
+#include "include/lib/hb_arena.h"
+
+#include <string.h>
+
+const herb_session_options_T HERB_DEFAULT_SESSION_OPTIONS = {
+  .trim_interval = 32,
+  .max_retained_bytes = MB(16),
+};
+
+static hb_arena_T* herb_session_arena(const herb_session_T* session) {
+  return (hb_arena_T*) session->allocator.context;
+}
+
+HERB_EXPORTED_FUNCTION bool herb_session_init(herb_session_T* session, const herb_session_options_T* options) {
+  memset(session, 0, sizeof(herb_session_T));
+
+  session->options = options ? *options : HERB_DEFAULT_SESSION_OPTIONS;
+
+  if (!hb_allocator_init(&session->allocator, HB_ALLOCATOR_ARENA)) {
+    memset(&session->allocator, 0, sizeof(hb_allocator_T));
+    return false;
+  }
+
+  return true;
+}
+
+// Releases the previous document and rewinds the arena. Pages are kept, except that the arena is trimmed to
+// `max_retained_bytes` every time and back to the recent high-water mark every `trim_interval` parses, so one
+// unusually large template does not pin its memory for the lifetime of the session.
+HERB_EXPORTED_FUNCTION void herb_session_reset(herb_session_T* session) {
+  hb_arena_T* arena = herb_session_arena(session);
+  if (arena == NULL) { return; }
+
+  if (session->document != NULL) {
+    ast_node_free((AST_NODE_T*) session->document, &session->allocator);
+    session->document = NULL;
+  }
+
+  size_t used = hb_arena_position(arena);
+  if (used > session->high_water_mark) { session->high_water_mark = used; }
+
+  hb_arena_rewind(arena);
+
+  if (session->options.max_retained_bytes > 0) { hb_arena_trim(arena, session->options.max_retained_bytes); }
+
+  if (session->options.trim_interval > 0 && session->parse_count > 0
+      && session->parse_count % session->options.trim_interval == 0) {
+    hb_arena_trim(arena, session->high_water_mark);
+    session->high_water_mark = 0;
+  }
+}
+
+HERB_EXPORTED_FUNCTION AST_DOCUMENT_NODE_T* herb_session_parse(
+  herb_session_T* session,
+  const char* source,
+  const parser_options_T* options
+) {
+  if (herb_session_arena(session) == NULL) { return NULL; }
+
+  herb_session_reset(session);
+
+  session->document = herb_parse(source, options, &session->allocator);
+  session->parse_count++;
+
+  return session->document;
+}
+
+HERB_EXPORTED_FUNCTION herb_session_stats_T herb_session_stats(const herb_session_T* session) {
+  herb_session_stats_T stats = { 0 };
+  hb_arena_T* arena = herb_session_arena(session);
+
+  stats.parse_count = session->parse_count;
+  stats.high_water_mark = session->high_water_mark;
+
+  if (arena == NULL) { return stats; }
+
+  hb_arena_for_each_page(arena) {
+    stats.pages++;
+    stats.capacity += page->capacity;
+    stats.used += page->position;
+  }
+
+  if (stats.used > stats.high_water_mark) { stats.high_water_mark = stats.used; }
+
+  return stats;
+}
+
+HERB_EXPORTED_FUNCTION void herb_session_deinit(herb_session_T* session) {
+  if (herb_session_arena(session) == NULL) { return; }
+
+  if (session->document != NULL) {
+    ast_node_free((AST_NODE_T*) session->document, &session->allocator);
+    session->document = NULL;
+  }
+
+  hb_allocator_destroy(&session->allocator);
+  memset(session, 0, sizeof(herb_session_T));
+}
@@ -10,7 +10,7 @@
 #include <string.h>
 
 // https://developer.mozilla.org/en-US/docs/Glossary/Void_element
-static hb_string_T void_tags[] = HB_STRING_LIST(
+static const hb_string_T void_tags[] = HB_STRING_LIST(
   "area",
   "base",
   "br",
@@ -28,10 +28,10 @@ static hb_string_T void_tags[] = HB_STRING_LIST(
 );
 
 // https://html.spec.whatwg.org/multipage/rendering.html#the-page
-static hb_string_T whitespace_preserving_tags[] = HB_STRING_LIST("pre", "script", "style", "textarea");
+static const hb_string_T whitespace_preserving_tags[] = HB_STRING_LIST("pre", "script", "style", "textarea");
 
 // https://html.spec.whatwg.org/multipage/common-microsyntaxes.html#boolean-attributes
-static hb_string_T boolean_attributes[] = HB_STRING_LIST(
+static const hb_string_T boolean_attributes[] = HB_STRING_LIST(
   "allowfullscreen",
   "async",
   "autofocus",
@@ -71,7 +71,7 @@ static hb_string_T boolean_attributes[] = HB_STRING_LIST(
 );
 
 // https://html.spec.whatwg.org/multipage/syntax.html#optional-tags
-static hb_string_T optional_end_tags[] = HB_STRING_LIST(
+static const hb_string_T optional_end_tags[] = HB_STRING_LIST(
   "li",
   "dt",
   "dd",
@@ -89,7 +89,7 @@ static hb_string_T optional_end_tags[] = HB_STRING_LIST(
   "colgroup"
 );
 
-static hb_string_T p_closers[] = HB_STRING_LIST(
+static const hb_string_T p_closers[] = HB_STRING_LIST(
   "address",
   "article",
   "aside",
@@ -122,7 +122,7 @@ static hb_string_T p_closers[] = HB_STRING_LIST(
   "ul"
 );
 
-static hb_string_T p_parent_closers[] = HB_STRING_LIST(
+static const hb_string_T p_parent_closers[] = HB_STRING_LIST(
   "article",
   "aside",
   "blockquote",
@@ -185,7 +185,7 @@ bool has_optional_end_tag(hb_string_T tag_name) {
   return false;
 }
 
-static bool tag_in_list(hb_string_T tag_name, hb_string_T* list, size_t count) {
+static bool tag_in_list(hb_string_T tag_name, const hb_string_T* list, size_t count) {
   for (size_t i = 0; i < count; i++) {
     if (hb_string_equals_case_insensitive(tag_name, list[i])) { return true; }
   }
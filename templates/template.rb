@@ -228,6 +228,12 @@ module Herb
       end
     end
 
+    class BorrowedStringField < StringField
+      def owner_flag
+        "owns_#{name}"
+      end
+    end
+
     class PositionField < Field
       def ruby_type
         "Herb::Position"
@@ -385,6 +391,7 @@ module Herb
         when "token"            then TokenField
         when "token_type"       then TokenTypeField
         when "string"           then StringField
+        when "borrowed_string"  then BorrowedStringField
         when "position"         then PositionField
         when "location"         then LocationField
         when "size_t"           then SizeTField
@@ -6,15 +6,18 @@ TCase *hb_arena_tests(void);
 TCase *hb_array_tests(void);
 TCase *hb_narray_tests(void);
 TCase *hb_buffer_tests(void);
+TCase *hb_clock_tests(void);
 TCase *hb_string_tests(void);
 TCase *herb_tests(void);
 TCase *html_util_tests(void);
 TCase *io_tests(void);
 TCase *lex_tests(void);
+TCase *line_index_tests(void);
 TCase *token_tests(void);
 TCase *util_tests(void);
 TCase *extract_tests(void);
 TCase *diff_tests(void);
+TCase *render_scan_tests(void);
 
 Suite *herb_suite(void) {
   Suite *suite = suite_create("Herb Suite");
@@ -24,15 +27,18 @@ Suite *herb_suite(void) {
   suite_add_tcase(suite, hb_array_tests());
   suite_add_tcase(suite, hb_narray_tests());
   suite_add_tcase(suite, hb_buffer_tests());
+  suite_add_tcase(suite, hb_clock_tests());
   suite_add_tcase(suite, hb_string_tests());
   suite_add_tcase(suite, herb_tests());
   suite_add_tcase(suite, html_util_tests());
   suite_add_tcase(suite, io_tests());
   suite_add_tcase(suite, lex_tests());
+  suite_add_tcase(suite, line_index_tests());
   suite_add_tcase(suite, token_tests());
   suite_add_tcase(suite, util_tests());
   suite_add_tcase(suite, extract_tests());
   suite_add_tcase(suite, diff_tests());
+  suite_add_tcase(suite, render_scan_tests());
 
   return suite;
 }
@@ -3,6 +3,10 @@
 #include "../../src/include/herb.h"
 #include "../../src/include/diff/herb_diff.h"
 #include "../../src/include/lib/hb_allocator.h"
+#include "../../src/include/lib/hb_buffer.h"
+
+#include <stdio.h>
+#include <string.h>
 
 static herb_diff_result_T* diff_sources(const char* old_source, const char* new_source, hb_allocator_T* allocator) {
   parser_options_T options = HERB_DEFAULT_PARSER_OPTIONS;
@@ -39,6 +43,29 @@ static herb_diff_result_T* diff_sources_tracking_whitespace(
   return herb_diff(old_document, new_document, &diff_options, allocator);
 }
 
+// Builds `<ul>` with one `<li id="item-N">Item N</li>` per entry of `items`; a negative entry is rendered as
+// `<li id="item-N">Changed</li>` for -N - 1.
+static char* large_list_source(const int* items, size_t count, hb_buffer_T* buffer) {
+  char item[64];
+
+  hb_buffer_clear(buffer);
+  hb_buffer_append(buffer, "<ul>");
+
+  for (size_t index = 0; index < count; index++) {
+    if (items[index] >= 0) {
+      snprintf(item, sizeof(item), "<li id=\"item-%d\">Item %d</li>", items[index], items[index]);
+    } else {
+      snprintf(item, sizeof(item), "<li id=\"item-%d\">Changed</li>", -items[index] - 1);
+    }
+
+    hb_buffer_append(buffer, item);
+  }
+
+  hb_buffer_append(buffer, "</ul>");
+
+  return hb_buffer_value(buffer);
+}
+
 TEST(test_diff_identical_documents)
   hb_allocator_T allocator;
   hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA);
@@ -529,6 +556,123 @@ TEST(test_diff_operation_type_to_string)
   ck_assert_str_eq(herb_diff_operation_type_to_string(HERB_DIFF_TAG_NAME_CHANGED), "tag_name_changed");
 END
 
+TEST(test_diff_large_lists_beyond_lcs_table)
+  enum { COUNT = 1000 };
+
+  hb_allocator_T allocator;
+  hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA);
+  hb_allocator_T buffer_allocator = hb_allocator_with_malloc();
+
+  hb_buffer_T old_buffer;
+  hb_buffer_T new_buffer;
+  hb_buffer_init(&old_buffer, COUNT * 40, &buffer_allocator);
+  hb_buffer_init(&new_buffer, COUNT * 40, &buffer_allocator);
+
+  int old_items[COUNT];
+  int new_items[COUNT + 1];
+
+  for (int index = 0; index < COUNT; index++) {
+    old_items[index] = index;
+  }
+
+  const char* old_source = large_list_source(old_items, COUNT, &old_buffer);
+
+  // One changed item is a single text change, not a replacement of the list.
+  memcpy(new_items, old_items, sizeof(old_items));
+  new_items[500] = -500 - 1;
+
+  herb_diff_result_T* result =
+    diff_sources(old_source, large_list_source(new_items, COUNT, &new_buffer), &allocator);
+
+  ck_assert_uint_eq(herb_diff_operation_count(result), 1);
+  ck_assert_uint_eq(herb_diff_operation_at(result, 0)->type, HERB_DIFF_TEXT_CHANGED);
+
+  // One inserted item.
+  memcpy(new_items, old_items, 500 * sizeof(int));
+  new_items[500] = COUNT;
+  memcpy(new_items + 501, old_items + 500, (COUNT - 500) * sizeof(int));
+
+  result = diff_sources(old_source, large_list_source(new_items, COUNT + 1, &new_buffer), &allocator);
+
+  ck_assert_uint_eq(herb_diff_operation_count(result), 1);
+  ck_assert_uint_eq(herb_diff_operation_at(result, 0)->type, HERB_DIFF_NODE_INSERTED);
+  ck_assert_uint_eq(herb_diff_operation_at(result, 0)->new_index, 500);
+
+  // One item moved from near the start to near the end.
+  memcpy(new_items, old_items, 100 * sizeof(int));
+  memcpy(new_items + 100, old_items + 101, 800 * sizeof(int));
+  new_items[900] = 100;
+  memcpy(new_items + 901, old_items + 901, (COUNT - 901) * sizeof(int));
+
+  result = diff_sources(old_source, large_list_source(new_items, COUNT, &new_buffer), &allocator);
+
+  ck_assert_uint_eq(herb_diff_operation_count(result), 1);
+  ck_assert_uint_eq(herb_diff_operation_at(result, 0)->type, HERB_DIFF_NODE_MOVED);
+  ck_assert_uint_eq(herb_diff_operation_at(result, 0)->old_index, 100);
+  ck_assert_uint_eq(herb_diff_operation_at(result, 0)->new_index, 900);
+
+  hb_buffer_free(&old_buffer);
+  hb_buffer_free(&new_buffer);
+  hb_allocator_destroy(&allocator);
+END
+
+TEST(test_diff_with_hashes_reuses_previous_document_hashes)
+  hb_allocator_T allocator;
+  hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA);
+
+  parser_options_T options = HERB_DEFAULT_PARSER_OPTIONS;
+  AST_DOCUMENT_NODE_T* first = herb_parse("<ul><li>One</li><li>Two</li></ul>", &options, &allocator);
+  AST_DOCUMENT_NODE_T* second = herb_parse("<ul><li>One</li><li>2</li></ul>", &options, &allocator);
+  AST_DOCUMENT_NODE_T* third = herb_parse("<ul><li>1</li><li>2</li></ul>", &options, &allocator);
+
+  herb_hash_map_T first_hashes;
+  herb_hash_map_T second_hashes;
+  herb_hash_map_T third_hashes;
+  herb_hash_map_init(&first_hashes, 16, &allocator);
+  herb_hash_map_init(&second_hashes, 16, &allocator);
+  herb_hash_map_init(&third_hashes, 16, &allocator);
+
+  herb_diff_result_T* result =
+    herb_diff_with_hashes(first, second, &first_hashes, &second_hashes, NULL, &allocator);
+
+  ck_assert_uint_eq(herb_diff_operation_count(result), 1);
+  ck_assert_uint_eq(herb_diff_operation_at(result, 0)->type, HERB_DIFF_TEXT_CHANGED);
+
+  size_t second_size = second_hashes.size;
+  herb_hash_T second_root_hash = herb_hash_map_get(&second_hashes, (const AST_NODE_T*) second);
+
+  result = herb_diff_with_hashes(second, third, &second_hashes, &third_hashes, NULL, &allocator);
+
+  ck_assert_uint_eq(second_hashes.size, second_size);
+  ck_assert(herb_hash_map_get(&second_hashes, (const AST_NODE_T*) second) == second_root_hash);
+  ck_assert_uint_eq(herb_diff_operation_count(result), 1);
+  ck_assert_uint_eq(herb_diff_operation_at(result, 0)->type, HERB_DIFF_TEXT_CHANGED);
+  ck_assert_uint_eq(herb_diff_operation_at(result, 0)->path.indices[2], 0);
+
+  ast_node_free((AST_NODE_T*) first, &allocator);
+  ast_node_free((AST_NODE_T*) second, &allocator);
+  ast_node_free((AST_NODE_T*) third, &allocator);
+  hb_allocator_destroy(&allocator);
+END
+
+TEST(test_diff_hash_bytes_covers_every_byte)
+  char text[100];
+  memset(text, 'a', sizeof(text));
+
+  herb_hash_T hash = herb_hash_bytes(HERB_HASH_INIT, text, sizeof(text));
+  ck_assert(herb_hash_bytes(HERB_HASH_INIT, text, sizeof(text)) == hash);
+
+  for (size_t index = 0; index < sizeof(text); index++) {
+    text[index] = 'b';
+    ck_assert(herb_hash_bytes(HERB_HASH_INIT, text, sizeof(text)) != hash);
+    text[index] = 'a';
+  }
+
+  for (size_t length = 0; length < sizeof(text); length++) {
+    ck_assert(herb_hash_bytes(HERB_HASH_INIT, text, length) != herb_hash_bytes(HERB_HASH_INIT, text, length + 1));
+  }
+END
+
 TCase *diff_tests(void) {
   TCase *diff = tcase_create("Diff");
 
@@ -563,6 +707,9 @@ TCase *diff_tests(void) {
   tcase_add_test(diff, test_diff_whitespace_change_detected_when_opted_in);
   tcase_add_test(diff, test_diff_significant_change_stays_text_changed_when_opted_in);
   tcase_add_test(diff, test_diff_preserving_element_stays_text_changed_when_opted_in);
+  tcase_add_test(diff, test_diff_large_lists_beyond_lcs_table);
+  tcase_add_test(diff, test_diff_with_hashes_reuses_previous_document_hashes);
+  tcase_add_test(diff, test_diff_hash_bytes_covers_every_byte);
   tcase_add_test(diff, test_diff_operation_type_to_string);
 
   return diff;
@@ -1,6 +1,8 @@
 #include "include/test.h"
 
 #include "../../src/include/extract.h"
+#include "../../src/include/herb.h"
+#include "../../src/include/lexer/token_list.h"
 #include "../../src/include/lib/hb_allocator.h"
 #include "../../src/include/lib/hb_buffer.h"
 
@@ -325,6 +327,35 @@ TEST(extract_ruby_with_options_default)
   hb_buffer_free(&output);
 END
 
+TEST(extract_from_token_list_matches_source)
+  const char* source = "<div>\n  <%# note %>\n  <% x = 1 # set %>\n  <%= x %>\n</div>";
+
+  hb_allocator_T allocator;
+  hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA);
+
+  token_list_T tokens;
+  ck_assert(herb_lex_to_token_list(source, &tokens, &allocator));
+
+  hb_buffer_T expected;
+  hb_buffer_T actual;
+  hb_buffer_init(&expected, 64, &allocator);
+  hb_buffer_init(&actual, 64, &allocator);
+
+  herb_extract_ruby_to_buffer(source, &expected, &allocator);
+  herb_extract_ruby_from_token_list(&tokens, &actual, NULL);
+  ck_assert_str_eq(hb_buffer_value(&actual), hb_buffer_value(&expected));
+
+  hb_buffer_clear(&expected);
+  hb_buffer_clear(&actual);
+
+  herb_extract_html_to_buffer(source, &expected, &allocator);
+  herb_extract_html_from_token_list(&tokens, &actual);
+  ck_assert_str_eq(hb_buffer_value(&actual), hb_buffer_value(&expected));
+
+  token_list_deinit(&tokens);
+  hb_allocator_destroy(&allocator);
+END
+
 TCase *extract_tests(void) {
   TCase *extract = tcase_create("Extract");
 
@@ -348,6 +379,7 @@ TCase *extract_tests(void) {
   tcase_add_test(extract, extract_ruby_with_options_preserve_positions_false);
   tcase_add_test(extract, extract_ruby_with_options_preserve_positions_false_and_comments_true);
   tcase_add_test(extract, extract_ruby_with_options_default);
+  tcase_add_test(extract, extract_from_token_list_matches_source);
 
   return extract;
 }
@@ -58,10 +58,57 @@ TEST(test_arena_realloc_grow)
   ck_assert_ptr_nonnull(pointer);
   memcpy(pointer, "hello, world!!!", 16);
 
+  char* other = hb_allocator_alloc(&allocator, 16);
+  memcpy(other, "other", 6);
+
   char* new_pointer = hb_allocator_realloc(&allocator, pointer, 16, 64);
   ck_assert_ptr_nonnull(new_pointer);
   ck_assert_ptr_ne(new_pointer, pointer);
   ck_assert_int_eq(memcmp(new_pointer, "hello, world!!!", 16), 0);
+  ck_assert_str_eq(other, "other");
+
+  hb_arena_T* arena = (hb_arena_T*) allocator.context;
+  ck_assert_int_eq(arena->in_place_reallocation_count, 0);
+  ck_assert_int_eq(arena->abandoned_bytes, 16);
+
+  hb_allocator_destroy(&allocator);
+END
+
+TEST(test_arena_realloc_grows_last_allocation_in_place)
+  hb_allocator_T allocator;
+  hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA);
+  hb_arena_T* arena = (hb_arena_T*) allocator.context;
+
+  char* pointer = hb_allocator_alloc(&allocator, 16);
+  memcpy(pointer, "hello, world!!!", 16);
+  size_t position = hb_arena_position(arena);
+
+  char* new_pointer = hb_allocator_realloc(&allocator, pointer, 16, 64);
+  ck_assert_ptr_eq(new_pointer, pointer);
+  ck_assert_int_eq(memcmp(new_pointer, "hello, world!!!", 16), 0);
+  ck_assert_int_eq(hb_arena_position(arena), position + 48);
+  ck_assert_int_eq(arena->in_place_reallocation_count, 1);
+  ck_assert_int_eq(arena->abandoned_bytes, 0);
+
+  char* next = hb_allocator_alloc(&allocator, 8);
+  ck_assert_ptr_eq(next, pointer + 64);
+
+  hb_allocator_destroy(&allocator);
+END
+
+TEST(test_arena_realloc_copies_when_tail_page_is_full)
+  hb_allocator_T allocator;
+  hb_allocator_init_with_size(&allocator, HB_ALLOCATOR_ARENA, 64);
+  hb_arena_T* arena = (hb_arena_T*) allocator.context;
+
+  char* pointer = hb_allocator_alloc(&allocator, 48);
+  memset(pointer, 'B', 48);
+
+  char* new_pointer = hb_allocator_realloc(&allocator, pointer, 48, 96);
+  ck_assert_ptr_ne(new_pointer, pointer);
+  ck_assert_int_eq(new_pointer[47], 'B');
+  ck_assert_int_eq(arena->in_place_reallocation_count, 0);
+  ck_assert_int_eq(arena->abandoned_bytes, 48);
 
   hb_allocator_destroy(&allocator);
 END
@@ -142,6 +189,8 @@ TCase *hb_allocator_realloc_tests(void) {
 
   tcase_add_test(allocator, test_arena_realloc_null_pointer);
   tcase_add_test(allocator, test_arena_realloc_grow);
+  tcase_add_test(allocator, test_arena_realloc_grows_last_allocation_in_place);
+  tcase_add_test(allocator, test_arena_realloc_copies_when_tail_page_is_full);
   tcase_add_test(allocator, test_arena_realloc_shrink);
   tcase_add_test(allocator, test_arena_realloc_preserves_data_across_pages);
 
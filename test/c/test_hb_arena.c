@@ -390,6 +390,73 @@ TEST(test_arena_reset_to_with_page_gap)
   hb_arena_free(&allocator);
 END
 
+TEST(test_arena_note_borrowed)
+  hb_arena_T allocator;
+  hb_arena_init(&allocator, 1024);
+
+  hb_arena_note_borrowed(&allocator, 5);
+  hb_arena_note_borrowed(&allocator, 16);
+
+  ck_assert_int_eq(allocator.borrowed_bytes, 24);
+  ck_assert_int_eq(hb_arena_position(&allocator), 0);
+
+  hb_arena_reset(&allocator);
+  ck_assert_int_eq(allocator.borrowed_bytes, 0);
+
+  hb_arena_free(&allocator);
+END
+
+// Test rewind keeps every page
+TEST(test_arena_rewind_keeps_pages)
+  hb_arena_T allocator;
+  hb_arena_init(&allocator, 64);
+
+  char *first = hb_arena_alloc(&allocator, 32);
+  hb_arena_alloc(&allocator, 64);
+  hb_arena_alloc(&allocator, 64);
+  ck_assert_int_eq(hb_arena_capacity(&allocator), 192);
+
+  hb_arena_rewind(&allocator);
+  ck_assert_int_eq(hb_arena_position(&allocator), 0);
+  ck_assert_int_eq(hb_arena_capacity(&allocator), 192);
+  ck_assert_int_eq(allocator.allocation_count, 0);
+  ck_assert_ptr_eq(allocator.tail, allocator.head);
+
+  ck_assert_ptr_eq(hb_arena_alloc(&allocator, 32), first);
+  hb_arena_alloc(&allocator, 64);
+  hb_arena_alloc(&allocator, 64);
+  ck_assert_int_eq(hb_arena_capacity(&allocator), 192);
+
+  hb_arena_free(&allocator);
+END
+
+// Test trim releases pages past the retained capacity but never pages in use
+TEST(test_arena_trim)
+  hb_arena_T allocator;
+  hb_arena_init(&allocator, 64);
+
+  for (int i = 0; i < 4; i++) { hb_arena_alloc(&allocator, 64); }
+  ck_assert_int_eq(hb_arena_capacity(&allocator), 256);
+
+  hb_arena_rewind(&allocator);
+  hb_arena_alloc(&allocator, 64);
+  hb_arena_alloc(&allocator, 64);
+
+  hb_arena_trim(&allocator, 0);
+  ck_assert_int_eq(hb_arena_capacity(&allocator), 128);
+  ck_assert_int_eq(hb_arena_position(&allocator), 128);
+
+  hb_arena_rewind(&allocator);
+  hb_arena_trim(&allocator, 100);
+  ck_assert_int_eq(hb_arena_capacity(&allocator), 128);
+
+  hb_arena_trim(&allocator, 0);
+  ck_assert_int_eq(hb_arena_capacity(&allocator), 64);
+  ck_assert_ptr_null(allocator.head->next);
+
+  hb_arena_free(&allocator);
+END
+
 TCase *hb_arena_tests(void) {
   TCase *arena = tcase_create("arena");
 
@@ -410,6 +477,9 @@ TCase *hb_arena_tests(void) {
   tcase_add_test(arena, test_arena_page_reuse_after_reset);
   tcase_add_test(arena, test_arena_page_reuse_when_next_page_is_too_small);
   tcase_add_test(arena, test_arena_reset_to_with_page_gap);
+  tcase_add_test(arena, test_arena_note_borrowed);
+  tcase_add_test(arena, test_arena_rewind_keeps_pages);
+  tcase_add_test(arena, test_arena_trim);
 
   return arena;
 }
@@ -0,0 +1,46 @@
+#include "include/test.h"
+#include "../../src/include/lib/hb_clock.h"
+
+TEST(test_hb_deadline_passed)
+  hb_deadline_T deadline;
+  hb_deadline_init(&deadline, 0);
+
+  ck_assert(hb_deadline_passed(&deadline));
+  ck_assert(hb_deadline_passed(&deadline));
+END
+
+TEST(test_hb_deadline_not_passed)
+  hb_deadline_T deadline;
+  hb_deadline_init(&deadline, hb_monotonic_ms() + 60000);
+
+  for (int i = 0; i < HB_DEADLINE_CHECK_INTERVAL * 4; i++) {
+    ck_assert(!hb_deadline_passed(&deadline));
+  }
+
+  ck_assert(!hb_deadline_passed_now(&deadline));
+END
+
+TEST(test_hb_deadline_reads_clock_every_interval)
+  hb_deadline_T deadline;
+  hb_deadline_init(&deadline, hb_monotonic_ms() + 60000);
+
+  ck_assert(!hb_deadline_passed(&deadline));
+
+  deadline.deadline_ms = 0;
+
+  for (int i = 0; i < HB_DEADLINE_CHECK_INTERVAL; i++) {
+    ck_assert(!hb_deadline_passed(&deadline));
+  }
+
+  ck_assert(hb_deadline_passed(&deadline));
+END
+
+TCase *hb_clock_tests(void) {
+  TCase *clock = tcase_create("Clock");
+
+  tcase_add_test(clock, test_hb_deadline_passed);
+  tcase_add_test(clock, test_hb_deadline_not_passed);
+  tcase_add_test(clock, test_hb_deadline_reads_clock_every_interval);
+
+  return clock;
+}
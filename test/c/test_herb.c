@@ -1,14 +1,247 @@
 #include "include/test.h"
+#include "../../src/include/ast/ast_pretty_print.h"
 #include "../../src/include/herb.h"
+#include "../../src/include/lib/hb_allocator.h"
+#include "../../src/include/session.h"
+
+#include <stdlib.h>
+#include <string.h>
 
 TEST(test_herb_version)
   ck_assert_str_eq(herb_version(), "0.10.3");
 END
 
+TEST(test_herb_parse_text_borrows_source)
+  const char* source = "Hello <b>world</b>";
+  parser_options_T options = HERB_DEFAULT_PARSER_OPTIONS;
+  hb_allocator_T allocator;
+  hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA);
+
+  AST_DOCUMENT_NODE_T* document = herb_parse(source, &options, &allocator);
+  AST_HTML_TEXT_NODE_T* text = hb_array_get(document->children, 0);
+
+  ck_assert_int_eq(text->base.type, AST_HTML_TEXT_NODE);
+  ck_assert(!text->owns_content);
+  ck_assert_ptr_eq(text->content.data, source);
+  ck_assert_int_eq(text->content.length, 6);
+
+  hb_arena_T* arena = (hb_arena_T*) allocator.context;
+  ck_assert_int_eq(arena->borrowed_bytes, 16);
+
+  hb_allocator_destroy(&allocator);
+END
+
+TEST(test_herb_parse_many_returns_results_in_order)
+  const char* sources[] = { "<h1>One</h1>", "<div>", "", "<p><%= two %></p>\n<span>Three</span>" };
+  const size_t count = sizeof(sources) / sizeof(sources[0]);
+  herb_parse_many_result_T results[4];
+
+  ck_assert(herb_parse_many(sources, count, NULL, 3, results));
+
+  for (size_t index = 0; index < count; index++) {
+    hb_allocator_T allocator;
+    hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA);
+
+    uint32_t error_count = 0;
+    parser_options_T options = HERB_DEFAULT_PARSER_OPTIONS;
+    options.error_count = &error_count;
+
+    AST_DOCUMENT_NODE_T* expected = herb_parse(sources[index], &options, &allocator);
+
+    ck_assert_ptr_nonnull(results[index].document);
+    ck_assert_int_eq(hb_array_size(results[index].document->children), hb_array_size(expected->children));
+    ck_assert_int_eq(results[index].document->base.location.end.column, expected->base.location.end.column);
+    ck_assert_int_eq(results[index].error_count, error_count);
+
+    hb_allocator_destroy(&allocator);
+  }
+
+  ck_assert_int_gt(results[1].error_count, 0);
+
+  herb_free_parse_many_results(results, count);
+
+  ck_assert_ptr_null(results[0].document);
+END
+
+TEST(test_herb_session_reuses_arena_pages)
+  herb_session_T session;
+  herb_session_options_T options = { .trim_interval = 0, .max_retained_bytes = 0 };
+  ck_assert(herb_session_init(&session, &options));
+
+  AST_DOCUMENT_NODE_T* first = herb_session_parse(&session, "<div><%= title %></div>", NULL);
+  ck_assert_ptr_nonnull(first);
+  ck_assert_int_eq(hb_array_size(first->children), 1);
+
+  herb_session_stats_T stats = herb_session_stats(&session);
+  size_t capacity = stats.capacity;
+  ck_assert_int_eq(stats.parse_count, 1);
+  ck_assert_int_gt(stats.used, 0);
+
+  for (int i = 0; i < 10; i++) {
+    AST_DOCUMENT_NODE_T* document = herb_session_parse(&session, "<div><%= title %></div>", NULL);
+    ck_assert_int_eq(hb_array_size(document->children), 1);
+  }
+
+  stats = herb_session_stats(&session);
+  ck_assert_int_eq(stats.parse_count, 11);
+  ck_assert_int_eq(stats.capacity, capacity);
+
+  herb_session_reset(&session);
+  ck_assert_ptr_null(session.document);
+  ck_assert_int_eq(herb_session_stats(&session).used, 0);
+
+  herb_session_deinit(&session);
+END
+
+static char* apply_edit(const char* source, herb_edit_T* edit, const char* replacement) {
+  size_t length = strlen(source);
+  size_t replacement_length = strlen(replacement);
+  char* result = malloc(length - (edit->old_end - edit->start) + replacement_length + 1);
+
+  memcpy(result, source, edit->start);
+  memcpy(result + edit->start, replacement, replacement_length);
+  strcpy(result + edit->start + replacement_length, source + edit->old_end);
+
+  edit->new_end = edit->start + (uint32_t) replacement_length;
+
+  return result;
+}
+
+static void pretty_print(AST_DOCUMENT_NODE_T* document, hb_buffer_T* buffer) {
+  hb_buffer_clear(buffer);
+  ast_pretty_print_node((AST_NODE_T*) document, 0, 0, buffer);
+}
+
+// Reparses `source` after replacing `[start, old_end)` with `replacement` and checks the result against a full
+// parse of the new source. Returns whether the child that was at `kept_index` was reused.
+static bool reparse_matches_full_parse_with_options(
+  const char* source,
+  uint32_t start,
+  uint32_t old_end,
+  const char* replacement,
+  size_t kept_index,
+  parser_options_T options
+) {
+  hb_allocator_T allocator;
+  hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA);
+
+  herb_edit_T edit = { .start = start, .old_end = old_end };
+
+  char* previous_source = strdup(source);
+  AST_DOCUMENT_NODE_T* document = herb_parse(previous_source, &options, &allocator);
+  AST_NODE_T* kept = hb_array_get(document->children, kept_index);
+
+  char* next_source = apply_edit(previous_source, &edit, replacement);
+  document = herb_reparse(document, previous_source, next_source, &edit, &options, &allocator);
+
+  memset(previous_source, 'x', strlen(previous_source));
+  free(previous_source);
+
+  AST_DOCUMENT_NODE_T* expected = herb_parse(next_source, &options, &allocator);
+
+  hb_buffer_T actual_output;
+  hb_buffer_T expected_output;
+  hb_buffer_init(&actual_output, 1024, &allocator);
+  hb_buffer_init(&expected_output, 1024, &allocator);
+
+  pretty_print(document, &actual_output);
+  pretty_print(expected, &expected_output);
+
+  ck_assert_str_eq(hb_buffer_value(&actual_output), hb_buffer_value(&expected_output));
+
+  bool reused = false;
+
+  for (size_t index = 0; index < hb_array_size(document->children); index++) {
+    if (hb_array_get(document->children, index) == kept) { reused = true; }
+  }
+
+  ast_node_free((AST_NODE_T*) expected, &allocator);
+  ast_node_free((AST_NODE_T*) document, &allocator);
+  hb_allocator_destroy(&allocator);
+  free(next_source);
+
+  return reused;
+}
+
+static bool reparse_matches_full_parse(
+  const char* source,
+  uint32_t start,
+  uint32_t old_end,
+  const char* replacement,
+  size_t kept_index
+) {
+  return reparse_matches_full_parse_with_options(
+    source,
+    start,
+    old_end,
+    replacement,
+    kept_index,
+    HERB_DEFAULT_PARSER_OPTIONS
+  );
+}
+
+TEST(test_herb_reparse_reuses_untouched_children)
+  const char* source = "<h1>Title</h1>\n"
+                       "<p>One <%= one %></p>\n"
+                       "<p>Two</p>\n"
+                       "<ul>\n  <li>Three</li>\n</ul>\n"
+                       "<%= render \"footer\" %>\n";
+
+  // "Two" -> "Second\nline", which moves every later child down a line.
+  ck_assert(reparse_matches_full_parse(source, 40, 43, "Second\nline", 0));
+  ck_assert(reparse_matches_full_parse(source, 40, 43, "Second\nline", 6));
+
+  // An insertion at the start, a deletion at the end, and typing inside an ERB tag.
+  ck_assert(reparse_matches_full_parse(source, 0, 0, "<hr>", 4));
+  ck_assert(reparse_matches_full_parse(source, 76, 99, "", 0));
+  ck_assert(reparse_matches_full_parse(source, 26, 29, "two + 1", 8));
+
+  // Replacing an element with text merges it with the whitespace around it.
+  ck_assert(reparse_matches_full_parse(source, 37, 47, "Two", 0));
+END
+
+TEST(test_herb_reparse_falls_back_to_full_parse)
+  const char* source = "<p>One</p>\n<div>Two</div>\n<p>Three</p>\n";
+
+  // Dropping `</div>` leaves an element that would swallow the siblings after it.
+  ck_assert(!reparse_matches_full_parse(source, 16, 25, "Two", 4));
+END
+
+TEST(test_herb_reparse_with_action_view_helpers_matches_full_parse)
+  const char* source = "<% path = root_path %>\n<p>One</p>\n<%= link_to \"Home\", path %>\n";
+
+  parser_options_T options = HERB_DEFAULT_PARSER_OPTIONS;
+  options.action_view_helpers = true;
+
+  // Tag helper analysis reads the locals of the whole program, so `path` has to be seen from the prefix.
+  ck_assert(!reparse_matches_full_parse_with_options(source, 26, 29, "Two", 0, options));
+END
+
+TEST(test_herb_reparse_with_strict_locals_matches_full_parse)
+  const char* source = "<%# locals: (title:) %>\n<p>One</p>\n<p>Two</p>\n";
+
+  parser_options_T options = HERB_DEFAULT_PARSER_OPTIONS;
+  options.strict_locals = true;
+
+  // A second declaration is only a duplicate when seen next to the first one in the prefix.
+  ck_assert(!reparse_matches_full_parse_with_options(source, 27, 30, "<%# locals: (body:) %>", 0, options));
+
+  // Removing the first declaration has to clear the duplicate error on the one after it.
+  const char* duplicated = "<%# locals: (title:) %>\n<p>One</p>\n<%# locals: (body:) %>\n";
+  ck_assert(!reparse_matches_full_parse_with_options(duplicated, 0, 23, "", 2, options));
+END
+
 TCase *herb_tests(void) {
   TCase *herb = tcase_create("Herb");
 
   tcase_add_test(herb, test_herb_version);
+  tcase_add_test(herb, test_herb_parse_text_borrows_source);
+  tcase_add_test(herb, test_herb_parse_many_returns_results_in_order);
+  tcase_add_test(herb, test_herb_session_reuses_arena_pages);
+  tcase_add_test(herb, test_herb_reparse_reuses_untouched_children);
+  tcase_add_test(herb, test_herb_reparse_falls_back_to_full_parse);
+  tcase_add_test(herb, test_herb_reparse_with_action_view_helpers_matches_full_parse);
+  tcase_add_test(herb, test_herb_reparse_with_strict_locals_matches_full_parse);
 
   return herb;
 }
@@ -1,7 +1,11 @@
 #include "include/test.h"
 #include "../../src/include/herb.h"
 #include "../../src/include/lexer/lex_helpers.h"
+#include "../../src/include/lexer/lexer.h"
+#include "../../src/include/lexer/lexer_peek_helpers.h"
+#include "../../src/include/lexer/token_list.h"
 #include "../../src/include/lib/hb_allocator.h"
+#include "../../src/include/prism/ruby_parser.h"
 
 TEST(herb_lex_to_buffer_empty_file)
   char* html = "";
@@ -38,11 +42,196 @@ TEST(herb_lex_to_buffer_basic_tag)
   hb_buffer_free(&output);
 END
 
+TEST(herb_ruby_fragment_is_parseable_with_scratch_budget)
+  hb_allocator_T allocator = hb_allocator_with_malloc();
+  hb_buffer_T scratch;
+  hb_buffer_init(&scratch, 16, &allocator);
+
+  ck_assert(herb_ruby_fragment_is_parseable_with_scratch(hb_string("if foo"), &scratch, NULL));
+  ck_assert(!herb_ruby_fragment_is_parseable_with_scratch(hb_string("foo)"), &scratch, NULL));
+
+  size_t budget = 3;
+  ck_assert(herb_ruby_fragment_is_parseable_with_scratch(hb_string("foo"), &scratch, &budget));
+  ck_assert_int_eq(budget, 0);
+
+  budget = 6;
+  ck_assert(!herb_ruby_fragment_is_parseable_with_scratch(hb_string("if foo"), &scratch, &budget));
+  ck_assert_int_eq(budget, 0);
+
+  hb_buffer_free(&scratch);
+END
+
+static void lex_to_eof(lexer_T* lexer, hb_allocator_T* allocator) {
+  token_T* token = NULL;
+
+  while ((token = lexer_next_token(lexer))->type != TOKEN_EOF) {
+    token_free(token, allocator);
+  }
+
+  token_free(token, allocator);
+}
+
+TEST(lexer_restore_state_restores_erb_recovery_budget)
+  hb_allocator_T allocator = hb_allocator_with_malloc();
+  lexer_T lexer = { 0 };
+  lexer_init(&lexer, "<p><% title ></p>\n<%= other %>", &allocator);
+  lexer_set_erb_recovery_limit(&lexer, 1000);
+
+  lexer_state_snapshot_T snapshot = lexer_save_state(&lexer);
+
+  lex_to_eof(&lexer, &allocator);
+  size_t spent = 1000 - lexer.erb_recovery_budget;
+  ck_assert_int_gt(spent, 0);
+
+  lexer_restore_state(&lexer, snapshot);
+  ck_assert_int_eq(lexer.erb_recovery_budget, 1000);
+
+  lex_to_eof(&lexer, &allocator);
+  ck_assert_int_eq(1000 - lexer.erb_recovery_budget, spent);
+
+  lexer_deinit(&lexer);
+END
+
+static hb_string_T first_erb_content(lexer_T* lexer, hb_allocator_T* allocator) {
+  token_T* token = NULL;
+
+  while ((token = lexer_next_token(lexer))->type != TOKEN_ERB_CONTENT && token->type != TOKEN_EOF) {
+    token_free(token, allocator);
+  }
+
+  hb_string_T value = token->value;
+  token_free(token, allocator);
+
+  return value;
+}
+
+TEST(lexer_erb_recovery_reuses_cached_answers)
+  hb_allocator_T allocator = hb_allocator_with_malloc();
+  lexer_T lexer = { 0 };
+  lexer_init(&lexer, "<p><% title ></p>\n<%= other %>", &allocator);
+
+  lexer_state_snapshot_T snapshot = lexer_save_state(&lexer);
+  hb_string_T recovered = first_erb_content(&lexer, &allocator);
+
+  size_t cached = 0;
+
+  for (size_t index = 0; index < LEXER_ERB_RECOVERY_CACHE_SIZE; index++) {
+    if (!lexer.erb_recovery_cache[index].used) { continue; }
+
+    lexer.erb_recovery_cache[index].parseable = !lexer.erb_recovery_cache[index].parseable;
+    cached++;
+  }
+
+  ck_assert_int_gt(cached, 0);
+
+  lexer_restore_state(&lexer, snapshot);
+  ck_assert(!hb_string_equals(first_erb_content(&lexer, &allocator), recovered));
+
+  lexer_deinit(&lexer);
+END
+
+static bool count_until_tag_end(const token_T* token, void* data) {
+  (*(size_t*) data)++;
+
+  return token->type != TOKEN_HTML_TAG_END;
+}
+
+TEST(herb_lex_each_reuses_token_and_stops_early)
+  hb_allocator_T allocator = hb_allocator_with_tracking();
+  size_t count = 0;
+
+  herb_lex_each("<div>hello</div>", count_until_tag_end, &count, &allocator);
+
+  ck_assert_int_eq(count, 3);
+  ck_assert_int_eq(hb_allocator_tracking_stats(&allocator)->allocation_count, 0);
+
+  hb_allocator_destroy(&allocator);
+END
+
+static void assert_token_list_matches_herb_lex(const char* source) {
+  hb_allocator_T allocator = hb_allocator_with_malloc();
+  hb_array_T* tokens = herb_lex(source, &allocator);
+  token_list_T list;
+
+  ck_assert(herb_lex_to_token_list(source, &list, &allocator));
+  ck_assert_int_eq(token_list_size(&list), hb_array_size(tokens));
+
+  for (size_t index = 0; index < token_list_size(&list); index++) {
+    token_T* expected = hb_array_get(tokens, index);
+    token_T actual;
+    token_list_get(&list, index, &actual);
+
+    ck_assert_int_eq(actual.type, expected->type);
+    ck_assert_int_eq(actual.range.from, expected->range.from);
+    ck_assert_int_eq(actual.range.to, expected->range.to);
+    ck_assert(hb_string_equals(actual.value, expected->value));
+    ck_assert_int_eq(actual.location.start.line, expected->location.start.line);
+    ck_assert_int_eq(actual.location.start.column, expected->location.start.column);
+    ck_assert_int_eq(actual.location.end.line, expected->location.end.line);
+    ck_assert_int_eq(actual.location.end.column, expected->location.end.column);
+  }
+
+  token_list_deinit(&list);
+  herb_free_tokens(&tokens, &allocator);
+  hb_allocator_destroy(&allocator);
+}
+
+TEST(herb_lex_to_token_list_matches_herb_lex)
+  assert_token_list_matches_herb_lex("<div class=\"a\">\n  <%= title %>\n  <% if x %>\r\n<br/><% end %>\n</div>");
+END
+
+TEST(herb_lex_to_token_list_matches_herb_lex_locations_with_non_ascii_and_crlf)
+  assert_token_list_matches_herb_lex(
+    "<p title=\"caf\xC3\xA9\">na\xC3\xAFve \xE2\x9C\x93\xC2\xA0\xF0\x9F\x98\x80</p>\r\n"
+    "<%= \"\xC3\xBC\" %>\r<% a = 1\r\n   b = 2\r %>\r\n"
+    "<span>\xE6\x97\xA5\xE6\x9C\xAC</span><% x"
+  );
+END
+
+TEST(token_list_keeps_error_token_messages)
+  hb_allocator_T allocator = hb_allocator_with_tracking();
+  token_list_T list;
+
+  ck_assert(token_list_init(&list, hb_string("<%x"), &allocator));
+
+  token_T start = { .type = TOKEN_ERB_START, .range = { .from = 0, .to = 2 } };
+  token_T error = { .type = TOKEN_ERROR, .range = { .from = 2, .to = 2 }, .value = hb_string("Unexpected ERB start") };
+  token_T end = { .type = TOKEN_EOF, .range = { .from = 3, .to = 3 } };
+
+  ck_assert(token_list_append(&list, &start));
+  ck_assert(token_list_append(&list, &error));
+  ck_assert(token_list_append(&list, &end));
+
+  token_T actual;
+  token_list_get(&list, 1, &actual);
+
+  ck_assert_int_eq(actual.type, TOKEN_ERROR);
+  ck_assert(hb_string_equals(actual.value, hb_string("Unexpected ERB start")));
+  ck_assert(hb_string_equals(token_list_value(&list, 0), hb_string("<%")));
+
+  token_list_deinit(&list);
+
+  ck_assert_int_eq(hb_allocator_tracking_stats(&allocator)->untracked_deallocation_count, 0);
+  ck_assert_int_eq(
+    hb_allocator_tracking_stats(&allocator)->allocation_count,
+    hb_allocator_tracking_stats(&allocator)->deallocation_count
+  );
+
+  hb_allocator_destroy(&allocator);
+END
+
 TCase *lex_tests(void) {
   TCase *tags = tcase_create("Lex");
 
   tcase_add_test(tags, herb_lex_to_buffer_empty_file);
   tcase_add_test(tags, herb_lex_to_buffer_basic_tag);
+  tcase_add_test(tags, herb_ruby_fragment_is_parseable_with_scratch_budget);
+  tcase_add_test(tags, lexer_restore_state_restores_erb_recovery_budget);
+  tcase_add_test(tags, lexer_erb_recovery_reuses_cached_answers);
+  tcase_add_test(tags, herb_lex_each_reuses_token_and_stops_early);
+  tcase_add_test(tags, herb_lex_to_token_list_matches_herb_lex);
+  tcase_add_test(tags, herb_lex_to_token_list_matches_herb_lex_locations_with_non_ascii_and_crlf);
+  tcase_add_test(tags, token_list_keeps_error_token_messages);
 
   return tags;
 }
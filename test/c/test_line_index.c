@@ -0,0 +1,146 @@
+#include "include/test.h"
+#include "../../src/include/lib/hb_allocator.h"
+#include "../../src/include/location/line_index.h"
+#include "../../src/include/location/position.h"
+
+TEST(test_line_index_line_starts)
+  hb_allocator_T allocator = hb_allocator_with_malloc();
+  line_index_T index;
+
+  ck_assert(line_index_init(&index, hb_string("a\nbc\n\ndef"), &allocator));
+
+  ck_assert_int_eq(line_index_line_count(&index), 4);
+  ck_assert_int_eq(line_index_line_start(&index, 1), 0);
+  ck_assert_int_eq(line_index_line_start(&index, 2), 2);
+  ck_assert_int_eq(line_index_line_start(&index, 3), 5);
+  ck_assert_int_eq(line_index_line_start(&index, 4), 6);
+
+  ck_assert_int_eq(line_index_line_end(&index, 1), 1);
+  ck_assert_int_eq(line_index_line_end(&index, 3), 5);
+  ck_assert_int_eq(line_index_line_end(&index, 4), 9);
+
+  line_index_deinit(&index);
+END
+
+TEST(test_line_index_position)
+  hb_allocator_T allocator = hb_allocator_with_malloc();
+  line_index_T index;
+
+  line_index_init(&index, hb_string("a\nbc\n\ndef"), &allocator);
+
+  position_T position = line_index_position(&index, 0);
+  ck_assert_int_eq(position.line, 1);
+  ck_assert_int_eq(position.column, 0);
+
+  position = line_index_position(&index, 1);
+  ck_assert_int_eq(position.line, 1);
+  ck_assert_int_eq(position.column, 1);
+
+  position = line_index_position(&index, 3);
+  ck_assert_int_eq(position.line, 2);
+  ck_assert_int_eq(position.column, 1);
+
+  position = line_index_position(&index, 5);
+  ck_assert_int_eq(position.line, 3);
+  ck_assert_int_eq(position.column, 0);
+
+  position = line_index_position(&index, 8);
+  ck_assert_int_eq(position.line, 4);
+  ck_assert_int_eq(position.column, 2);
+
+  position = line_index_position(&index, 100);
+  ck_assert_int_eq(position.line, 4);
+  ck_assert_int_eq(position.column, 3);
+
+  line_index_deinit(&index);
+END
+
+TEST(test_line_index_offset)
+  hb_allocator_T allocator = hb_allocator_with_malloc();
+  line_index_T index;
+
+  line_index_init(&index, hb_string("a\nbc\n\ndef"), &allocator);
+
+  ck_assert_int_eq(line_index_offset(&index, (position_T) { .line = 1, .column = 0 }), 0);
+  ck_assert_int_eq(line_index_offset(&index, (position_T) { .line = 2, .column = 1 }), 3);
+  ck_assert_int_eq(line_index_offset(&index, (position_T) { .line = 2, .column = 2 }), 4);
+  ck_assert_int_eq(line_index_offset(&index, (position_T) { .line = 4, .column = 3 }), 9);
+
+  ck_assert_int_eq(line_index_offset(&index, (position_T) { .line = 2, .column = 3 }), 9);
+  ck_assert_int_eq(line_index_offset(&index, (position_T) { .line = 0, .column = 0 }), 9);
+  ck_assert_int_eq(line_index_offset(&index, (position_T) { .line = 5, .column = 0 }), 9);
+
+  line_index_deinit(&index);
+END
+
+TEST(test_line_index_matches_linear_scan)
+  hb_allocator_T allocator = hb_allocator_with_malloc();
+  const char* sources[] = { "",
+                            "abc",
+                            "\n",
+                            "a\nb\n",
+                            "<div>\n  <%= foo %>\n</div>\n",
+                            "a\r\nb\rc\n",
+                            "\r",
+                            "\r\n\r\n",
+                            "a\r\r\nb\n\rc",
+                            "<div>\r\n  <%= foo %>\r\n</div>\r\n" };
+
+  for (size_t source_index = 0; source_index < sizeof(sources) / sizeof(sources[0]); source_index++) {
+    const char* source = sources[source_index];
+    line_index_T index;
+
+    line_index_init(&index, hb_string(source), &allocator);
+
+    for (size_t offset = 0; offset <= strlen(source); offset++) {
+      position_T expected = position_from_source_with_offset(source, offset);
+      position_T actual = line_index_source_position(&index, offset);
+
+      ck_assert_int_eq(actual.line, expected.line);
+      ck_assert_int_eq(actual.column, expected.column);
+    }
+
+    line_index_deinit(&index);
+  }
+END
+
+TEST(test_line_index_source_position_with_carriage_returns)
+  hb_allocator_T allocator = hb_allocator_with_malloc();
+  line_index_T index;
+
+  ck_assert(line_index_init(&index, hb_string("ab\r\ncd\ref"), &allocator));
+
+  position_T position = line_index_source_position(&index, 3);
+  ck_assert_int_eq(position.line, 2);
+  ck_assert_int_eq(position.column, 0);
+
+  position = line_index_source_position(&index, 5);
+  ck_assert_int_eq(position.line, 3);
+  ck_assert_int_eq(position.column, 1);
+
+  position = line_index_source_position(&index, 8);
+  ck_assert_int_eq(position.line, 4);
+  ck_assert_int_eq(position.column, 1);
+
+  position = line_index_source_position(&index, 100);
+  ck_assert_int_eq(position.line, 4);
+  ck_assert_int_eq(position.column, 2);
+
+  position = line_index_position(&index, 8);
+  ck_assert_int_eq(position.line, 2);
+  ck_assert_int_eq(position.column, 4);
+
+  line_index_deinit(&index);
+END
+
+TCase *line_index_tests(void) {
+  TCase *line_index = tcase_create("Line Index");
+
+  tcase_add_test(line_index, test_line_index_line_starts);
+  tcase_add_test(line_index, test_line_index_position);
+  tcase_add_test(line_index, test_line_index_offset);
+  tcase_add_test(line_index, test_line_index_matches_linear_scan);
+  tcase_add_test(line_index, test_line_index_source_position_with_carriage_returns);
+
+  return line_index;
+}
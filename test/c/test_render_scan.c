@@ -0,0 +1,181 @@
+#include "include/test.h"
+
+#include "../../src/include/herb.h"
+#include "../../src/include/lib/hb_allocator.h"
+#include "../../src/include/lib/hb_array.h"
+#include "../../src/include/render_scan.h"
+
+#include <string.h>
+
+static herb_render_call_T* render_call_at(herb_render_scan_T* scan, size_t index) {
+  return (herb_render_call_T*) hb_array_get(scan->render_calls, index);
+}
+
+static herb_render_local_T* local_at(herb_render_call_T* call, size_t index) {
+  return (herb_render_local_T*) hb_array_get(call->locals, index);
+}
+
+static herb_strict_local_T* strict_local_at(herb_render_scan_T* scan, size_t index) {
+  return (herb_strict_local_T*) hb_array_get(scan->strict_locals, index);
+}
+
+TEST(render_scan_positional_partial_with_locals)
+  const char* source = "<div>\n  <%= render \"shared/card\", title: @post.title, size: :md %>\n</div>";
+
+  hb_allocator_T allocator;
+  hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA);
+
+  herb_render_scan_T scan;
+  ck_assert(herb_scan_renders(source, &scan, &allocator));
+  ck_assert_int_eq(hb_array_size(scan.render_calls), 1);
+
+  herb_render_call_T* call = render_call_at(&scan, 0);
+  ck_assert_str_eq(call->partial, "shared/card");
+  ck_assert_ptr_null(call->template_path);
+  ck_assert(!call->has_block);
+
+  ck_assert_int_eq(hb_array_size(call->locals), 2);
+  ck_assert_str_eq(local_at(call, 0)->name, "title");
+  ck_assert_str_eq(local_at(call, 0)->value, "@post.title");
+  ck_assert_str_eq(local_at(call, 1)->name, "size");
+  ck_assert_str_eq(local_at(call, 1)->value, ":md");
+
+  ck_assert_int_eq(call->location.start.line, 2);
+  ck_assert_int_eq(call->location.start.column, 2);
+  ck_assert_int_eq(call->location.end.line, 2);
+
+  ck_assert(!scan.has_strict_locals);
+
+  hb_allocator_destroy(&allocator);
+END
+
+TEST(render_scan_keyword_form_reads_only_locals_hash)
+  const char* source =
+    "<%= render partial: \"posts/post\", collection: @posts, as: :item, locals: { compact: true } %>";
+
+  hb_allocator_T allocator;
+  hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA);
+
+  herb_render_scan_T scan;
+  herb_scan_renders(source, &scan, &allocator);
+  ck_assert_int_eq(hb_array_size(scan.render_calls), 1);
+
+  herb_render_call_T* call = render_call_at(&scan, 0);
+  ck_assert_str_eq(call->partial, "posts/post");
+  ck_assert_str_eq(call->collection, "@posts");
+  ck_assert_str_eq(call->as_name, "item");
+
+  ck_assert_int_eq(hb_array_size(call->locals), 1);
+  ck_assert_str_eq(local_at(call, 0)->name, "compact");
+  ck_assert_str_eq(local_at(call, 0)->value, "true");
+
+  hb_allocator_destroy(&allocator);
+END
+
+TEST(render_scan_object_and_block_renders)
+  const char* source = "<%= render @post %>\n<%= render CardComponent.new(title: \"Hi\") do |card| %>x<% end %>";
+
+  hb_allocator_T allocator;
+  hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA);
+
+  herb_render_scan_T scan;
+  herb_scan_renders(source, &scan, &allocator);
+  ck_assert_int_eq(hb_array_size(scan.render_calls), 2);
+
+  ck_assert_ptr_null(render_call_at(&scan, 0)->partial);
+  ck_assert_str_eq(render_call_at(&scan, 0)->object, "@post");
+  ck_assert(!render_call_at(&scan, 0)->has_block);
+
+  ck_assert_str_eq(render_call_at(&scan, 1)->object, "CardComponent.new(title: \"Hi\")");
+  ck_assert(render_call_at(&scan, 1)->has_block);
+
+  hb_allocator_destroy(&allocator);
+END
+
+TEST(render_scan_skips_comments_escapes_and_other_calls)
+  const char* source = "<%# render \"a\" %><%%= render \"b\" %><%= helper.render \"c\" %><%= rendered %>"
+                       "<%= render_component \"d\" %><script>x = \"<%= render 'e' %>\"</script>";
+
+  hb_allocator_T allocator;
+  hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA);
+
+  herb_render_scan_T scan;
+  herb_scan_renders(source, &scan, &allocator);
+
+  ck_assert_int_eq(hb_array_size(scan.render_calls), 1);
+  ck_assert_str_eq(render_call_at(&scan, 0)->partial, "e");
+
+  hb_allocator_destroy(&allocator);
+END
+
+TEST(render_scan_strict_locals)
+  const char* source = "<%# locals: (title:, size: :md, **rest) %>\n<h1><%= title %></h1>";
+
+  hb_allocator_T allocator;
+  hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA);
+
+  herb_render_scan_T scan;
+  herb_scan_renders(source, &scan, &allocator);
+
+  ck_assert(scan.has_strict_locals);
+  ck_assert(scan.has_keyword_rest);
+  ck_assert_int_eq(scan.strict_locals_location.start.line, 1);
+  ck_assert_int_eq(scan.strict_locals_location.start.column, 0);
+
+  ck_assert_int_eq(hb_array_size(scan.strict_locals), 2);
+  ck_assert_str_eq(strict_local_at(&scan, 0)->name, "title");
+  ck_assert(strict_local_at(&scan, 0)->required);
+  ck_assert_ptr_null(strict_local_at(&scan, 0)->default_value);
+  ck_assert_str_eq(strict_local_at(&scan, 1)->name, "size");
+  ck_assert(!strict_local_at(&scan, 1)->required);
+  ck_assert_str_eq(strict_local_at(&scan, 1)->default_value, ":md");
+
+  hb_allocator_destroy(&allocator);
+END
+
+TEST(render_scan_invalid_strict_locals_declare_nothing)
+  const char* source = "<%# locals: (title:, %>\n<%# locals: (other:) %>";
+
+  hb_allocator_T allocator;
+  hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA);
+
+  herb_render_scan_T scan;
+  herb_scan_renders(source, &scan, &allocator);
+
+  ck_assert(scan.has_strict_locals);
+  ck_assert(!scan.has_keyword_rest);
+  ck_assert_int_eq(hb_array_size(scan.strict_locals), 0);
+
+  hb_allocator_destroy(&allocator);
+END
+
+TEST(render_scan_frees_with_malloc_allocator)
+  const char* source = "<%# locals: (title: nil) %><%= render \"a\", locals: { b: 1 } %><%= render partial: \"c\" %>";
+
+  hb_allocator_T allocator = hb_allocator_with_tracking();
+
+  herb_render_scan_T scan;
+  herb_scan_renders(source, &scan, &allocator);
+  ck_assert_int_eq(hb_array_size(scan.render_calls), 2);
+
+  herb_render_scan_free(&scan, &allocator);
+
+  hb_allocator_tracking_stats_T* stats = hb_allocator_tracking_stats(&allocator);
+  ck_assert_int_eq(stats->bytes_allocated, stats->bytes_deallocated);
+
+  hb_allocator_destroy(&allocator);
+END
+
+TCase *render_scan_tests(void) {
+  TCase *render_scan = tcase_create("Render Scan");
+
+  tcase_add_test(render_scan, render_scan_positional_partial_with_locals);
+  tcase_add_test(render_scan, render_scan_keyword_form_reads_only_locals_hash);
+  tcase_add_test(render_scan, render_scan_object_and_block_renders);
+  tcase_add_test(render_scan, render_scan_skips_comments_escapes_and_other_calls);
+  tcase_add_test(render_scan, render_scan_strict_locals);
+  tcase_add_test(render_scan, render_scan_invalid_strict_locals_declare_nothing);
+  tcase_add_test(render_scan, render_scan_frees_with_malloc_allocator);
+
+  return render_scan;
+}
@@ -0,0 +1,174 @@
+# frozen_string_literal: true
+
+require_relative "../test_helper"
+require_relative "../../lib/herb/engine"
+require "herb/engine/instrumentation_visitor"
+require "herb/engine/optimize_visitor"
+
+require "tmpdir"
+require "fileutils"
+
+module Engine
+  class CompileCacheTest < Minitest::Spec
+    SOURCE = %(<div class="card"><%= title %></div>)
+
+    class WarningVisitor < Herb::Visitor
+      include Herb::Engine::Diagnostics
+
+      def visit_html_element_node(node)
+        warning("looked at #{node.tag_name.value}", node.location, code: "Looked")
+
+        super
+      end
+
+      def compile_cache_key
+        inspect
+      end
+    end
+
+    class ConfiguredVisitor < Herb::Visitor
+      def initialize(flag)
+        super()
+
+        @flag = flag
+      end
+
+      def compile_cache_key
+        "flag=#{@flag}"
+      end
+    end
+
+    class StatefulVisitor < Herb::Visitor
+      attr_reader :seen
+
+      def visit_html_element_node(node)
+        (@seen ||= []) << node.tag_name.value
+
+        super
+      end
+    end
+
+    before do
+      @directory = Dir.mktmpdir("herb_compile_cache")
+      @cache = Herb::Engine::CompileCache.new(@directory)
+
+      Herb::Engine::Report::Session.reset!
+    end
+
+    after do
+      FileUtils.rm_rf(@directory)
+
+      Herb::Engine::Report::Session.reset!
+    end
+
+    def compile(source = SOURCE, **)
+      Herb::Engine.new(source, compile_cache: @cache, **)
+    end
+
+    def entries
+      Dir.glob(File.join(@directory, "*", "*"))
+    end
+
+    test "a warm compile reads the src back instead of parsing" do
+      cold = compile.src
+
+      warm = Herb.stub(:parse, ->(*) { flunk "parsed on a warm compile" }) { compile.src }
+
+      assert_equal cold, warm
+      assert_equal({ hits: 1, misses: 1, bypasses: 0, hit_rate: 0.5 }, @cache.stats)
+    end
+
+    test "matches an uncached compile" do
+      compile
+
+      assert_equal Herb::Engine.new(SOURCE).src, compile.src
+      assert_equal Herb::Engine.new(SOURCE, escape: true).src, compile(escape: true).src
+    end
+
+    test "lays entries out two hex digits deep" do
+      compile
+
+      assert_equal 1, entries.size
+      assert_match(%r{/\h{2}/\h{62}\z}, entries.first)
+    end
+
+    test "keys on the source, the options, and the visitor stack" do
+      compile
+      compile("<p><%= title %></p>")
+      compile(escape: true)
+      compile(parser_options: { strict: false })
+      compile(filename: "app/views/posts/show.html.erb")
+      compile(visitors: [Herb::Engine::OptimizeVisitor.new])
+      compile(visitors: [ConfiguredVisitor.new(true)])
+      compile(visitors: [ConfiguredVisitor.new(false)])
+
+      assert_equal 8, entries.size
+      assert_equal 0, @cache.hits
+    end
+
+    test "bypasses a stack with a visitor that keeps what it saw" do
+      visitor = StatefulVisitor.new
+
+      compile(visitors: [visitor])
+      compile(visitors: [visitor])
+
+      assert_equal ["div", "div"], visitor.seen
+      assert_empty entries
+      assert_equal 2, @cache.bypasses
+    end
+
+    test "bypasses options that cannot be marshalled" do
+      compile(context: { helper: -> {} })
+
+      assert_empty entries
+      assert_equal 1, @cache.bypasses
+    end
+
+    test "does not store a compile that reported diagnostics" do
+      first = compile(visitors: [WarningVisitor.new]).src
+      second = compile(visitors: [WarningVisitor.new]).src
+
+      assert_equal first, second
+      assert_includes second, "record_compile_diagnostics"
+      assert_empty entries
+    end
+
+    test "a corrupt entry directory falls back to compiling" do
+      File.write(File.join(@directory, "ab"), "")
+
+      cache = Herb::Engine::CompileCache.new(File.join(@directory, "ab"))
+
+      assert_equal Herb::Engine.new(SOURCE).src, Herb::Engine.new(SOURCE, compile_cache: cache).src
+      assert_equal Herb::Engine.new(SOURCE).src, Herb::Engine.new(SOURCE, compile_cache: cache).src
+    end
+
+    test "a directory shares one cache across engines" do
+      Herb::Engine.new(SOURCE, compile_cache: @directory)
+      Herb::Engine.new(SOURCE, compile_cache: Pathname.new(@directory))
+
+      assert_equal 1, Herb::Engine::CompileCache.for(@directory).hits
+    end
+
+    test "instrumentation records whether each template was served from the cache" do
+      visitors = -> { [Herb::Engine::InstrumentationVisitor.new] }
+
+      session = Herb::Engine::Report::Session.capture do
+        compile(filename: "app/views/a.html.erb", visitors: visitors.call)
+        compile(filename: "app/views/b.html.erb", visitors: visitors.call)
+        compile(filename: "app/views/b.html.erb", visitors: visitors.call)
+      end
+
+      compiled = Herb::Engine::Report::Session.capture { compile(filename: "app/views/a.html.erb", visitors: visitors.call) }
+
+      assert_equal [["app/views/a.html.erb", "miss"], ["app/views/b.html.erb", "miss"]], session.diagnostics.map { |diagnostic| [diagnostic.template, diagnostic.value] }
+      assert_equal ["hit"], compiled.diagnostics.map(&:value)
+      assert_equal [:metric], compiled.diagnostics.map(&:kind).uniq
+    end
+
+    test "reports nothing without instrumentation" do
+      session = Herb::Engine::Report::Session.capture { compile }
+
+      assert_empty session.diagnostics
+    end
+  end
+end
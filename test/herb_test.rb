@@ -16,4 +16,40 @@ class HerbTest < Minitest::Spec
     assert defined?(Parallel)
     assert_equal already_loaded, bundler_inline_loaded.call
   end
+
+  test "lexes and parses from several threads at once" do
+    sources = Array.new(8) { |index| %(<div id="item-#{index}">\n  <%= items[#{index}] %>\n</div>\n) * 20 }
+    expected = sources.map { |source| [Herb.lex(source).value.map(&:inspect), Herb.parse(source).value.inspect] }
+
+    actual = sources.map { |source|
+      Thread.new { [Herb.lex(source).value.map(&:inspect), Herb.parse(source).value.inspect] }
+    }.map(&:value)
+
+    assert_equal expected, actual
+  end
+
+  test "lexes and parses a copy of a source another thread replaces meanwhile" do
+    original = %(<p class="a"><%= value %></p>\n) * 500
+    source = original.dup
+    expected_tokens = Herb.lex(original).value.map(&:inspect)
+    expected_tree = Herb.parse(original).value.inspect
+
+    running = true
+    mutator = Thread.new do
+      while running
+        source.replace(original.dup)
+        Thread.pass
+      end
+    end
+
+    begin
+      3.times do
+        assert_equal expected_tokens, Herb.lex(source).value.map(&:inspect)
+        assert_equal expected_tree, Herb.parse(source).value.inspect
+      end
+    ensure
+      running = false
+      mutator.join
+    end
+  end
 end
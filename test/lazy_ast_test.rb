@@ -0,0 +1,62 @@
+# frozen_string_literal: true
+
+require_relative "test_helper"
+
+class LazyASTTest < Minitest::Spec
+  SOURCE = %(<div class="<%= classes %>"><% if user %><b><%= user.name %></b><% end %></div><p>)
+
+  test "reads the same tree as an eager parse" do
+    [{}, { track_whitespace: true }, { track_locations: false }].each do |options|
+      eager = Herb.parse(SOURCE, **options)
+      lazy = Herb.parse(SOURCE, lazy: true, **options)
+
+      assert_equal eager.value.inspect, lazy.value.inspect
+      assert_equal eager.value.to_json, lazy.value.to_json
+      assert_equal eager.errors.to_json, lazy.errors.to_json
+    end
+  end
+
+  test "nodes are subclasses of the eager node classes" do
+    element = Herb.parse(SOURCE, lazy: true).value.children.first
+
+    assert_kind_of Herb::AST::HTMLElementNode, element
+    assert_equal "HTMLElementNode", element.node_name
+    assert_equal "AST_HTML_ELEMENT_NODE", element.type
+  end
+
+  test "loads fields only when they are read" do
+    element = Herb.parse(SOURCE, lazy: true).value.children.first
+
+    assert_equal [:@type], element.instance_variables
+
+    element.location
+    assert_equal [:@type, :@location], element.instance_variables
+
+    assert_equal "div", element.tag_name.value
+    assert_includes element.instance_variables, :@body
+  end
+
+  test "tokens load their location and range on access" do
+    tag_name = Herb.parse(SOURCE, lazy: true).value.children.first.open_tag.tag_name
+
+    assert_equal [:@value, :@type], tag_name.instance_variables
+    assert_equal [1, 4], tag_name.range.to_a
+    assert_equal "(1:1)-(1:4)", tag_name.location.tree_inspect
+  end
+
+  test "nodes outlive the result and the root" do
+    children = Herb.parse("<div><b>bold</b></div>", lazy: true).value.children
+    GC.start
+
+    assert_equal "div", children.first.tag_name.value
+    assert_equal 1, children.first.body.size
+  end
+
+  test "writable fields load the node before assigning" do
+    element = Herb.parse("<div><b>bold</b></div>", lazy: true).value.children.first
+    element.close_tag = nil
+
+    assert_nil element.close_tag
+    assert_equal 1, element.body.size
+  end
+end
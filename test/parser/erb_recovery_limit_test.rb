@@ -0,0 +1,20 @@
+# frozen_string_literal: true
+
+require_relative "../test_helper"
+
+module Parser
+  class ERBRecoveryLimitTest < Minitest::Spec
+    SOURCE = "<p><% title ></p>\n<%= other %>"
+
+    test "an unlimited recovery ends an unclosed tag where its Ruby parses" do
+      assert_equal Herb.parse(SOURCE).value.inspect, Herb.parse(SOURCE, erb_recovery_limit: 1_000_000).value.inspect
+    end
+
+    test "a spent recovery budget ends an unclosed tag at the next ERB opening" do
+      limited = Herb.parse(SOURCE, erb_recovery_limit: 1)
+
+      refute_equal Herb.parse(SOURCE).value.inspect, limited.value.inspect
+      assert_includes limited.value.inspect, " title ></p>\\n"
+    end
+  end
+end
@@ -74,4 +74,99 @@ class ProjectTest < Minitest::Spec
   test "finds no templates in an empty project" do
     assert_empty files_for(@project_path)
   end
+
+  def analyze
+    project = Herb::Project.new(@project_path)
+    project.no_log_file = true
+    project.no_timing = true
+    project.silent = true
+    project.threads = true
+    project.cache_directory = "tmp/cache/herb"
+
+    capture_io { project.analyze! }
+
+    project
+  end
+
+  def analysis_cache
+    Herb::Project::AnalysisCache.new(File.join(@project_path, "tmp/cache/herb"), [nil, nil])
+  end
+
+  test "reuses the results of unchanged files from the cache" do
+    write("app/views/posts/index.html.erb")
+    write("app/views/posts/show.html.erb", "<p><%= @post.title %></p>")
+
+    analyze
+
+    Herb.stub(:parse, ->(*) { flunk "parsed an unchanged file" }) { analyze }
+
+    assert analysis_cache.lookup(File.join(@project_path, "app/views/posts/index.html.erb")).result
+  end
+
+  test "analyzes a file again once its content changes" do
+    path = write("app/views/posts/index.html.erb")
+
+    analyze
+    write("app/views/posts/index.html.erb", "<p>changed</p>")
+
+    assert_nil analysis_cache.lookup(path).result
+
+    analyze
+
+    assert_equal :successful, analysis_cache.lookup(path).result[:status]
+  end
+
+  test "finds an entry by content after a touch" do
+    path = write("app/views/posts/index.html.erb")
+
+    analyze
+    File.utime(Time.now + 60, Time.now + 60, path)
+
+    cache = analysis_cache
+    assert cache.lookup(path).result
+    assert_equal 1, cache.hits
+  end
+
+  test "marks files that crashed, timed out, or were pending in a run that never saved as suspects" do
+    crashed = write("app/views/a.html.erb")
+    timed_out = write("app/views/b.html.erb")
+    clean = write("app/views/c.html.erb")
+    directory = File.join(@project_path, "tmp/cache/herb")
+
+    cache = Herb::Project::AnalysisCache.new(directory, [nil, nil])
+    cache.store({ file_path: crashed, status: :failed })
+    cache.store({ file_path: timed_out, status: :timeout })
+    cache.store({ file_path: clean, status: :successful })
+    cache.save
+
+    cache = Herb::Project::AnalysisCache.new(directory, [nil, nil])
+    assert_nil cache.lookup(crashed).result
+    assert cache.lookup(crashed).suspect
+    assert_nil cache.lookup(timed_out).result
+    assert cache.lookup(timed_out).suspect
+    refute cache.lookup(clean).suspect
+
+    cache.begin!([clean])
+
+    assert Herb::Project::AnalysisCache.new(directory, [nil, nil]).lookup(clean).suspect
+  end
+
+  test "does not cache results while the render validator is on" do
+    write("app/views/posts/index.html.erb", '<%= render "posts/missing" %>')
+
+    Herb.configuration.stub(:enabled_validators, { render: true }) { analyze }
+
+    refute File.exist?(File.join(@project_path, "tmp/cache/herb", Herb::Project::AnalysisCache::FILE_NAME))
+  end
+
+  test "starts the cache over when the key changes" do
+    path = write("app/views/posts/index.html.erb")
+    directory = File.join(@project_path, "tmp/cache/herb")
+
+    cache = Herb::Project::AnalysisCache.new(directory, [true, nil])
+    cache.store({ file_path: path, status: :successful })
+    cache.save
+
+    assert_nil Herb::Project::AnalysisCache.new(directory, [false, nil]).lookup(path).result
+  end
 end
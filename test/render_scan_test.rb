@@ -0,0 +1,90 @@
+# frozen_string_literal: true
+
+require_relative "test_helper"
+
+class RenderScanTest < Minitest::Spec
+  def render_nodes(source)
+    nodes = []
+
+    visitor = Class.new(Herb::Visitor) do
+      define_method(:visit_erb_render_node) do |node|
+        nodes << node
+        super(node)
+      end
+    end
+
+    Herb.parse(source, render_nodes: true).visit(visitor.new)
+
+    nodes
+  end
+
+  test "finds the same render calls as the parser" do
+    source = <<~ERB
+      <div>
+        <%= render "posts/card", post: @post, compact: true %>
+        <%= render partial: "posts/row", collection: @posts, as: :post, locals: { striped: true } %>
+        <%= render @comment %>
+        <%= render layout: "layouts/box" do %>inside<% end %>
+        <%# render "commented/out" %>
+        <%%= render "escaped" %>
+        <%= rendered_count %>
+      </div>
+    ERB
+
+    calls = Herb.scan_renders(source).render_calls
+    nodes = render_nodes(source)
+
+    assert_equal nodes.map(&:partial_path), calls.map(&:partial)
+    assert_equal nodes.map(&:layout_name), calls.map(&:layout)
+    assert_equal nodes.map(&:local_names), calls.map(&:local_names)
+    assert_equal nodes.map { |node| node.location.start.line }, calls.map { |call| call.location.start.line }
+  end
+
+  test "reads the arguments of a render call" do
+    call = Herb.scan_renders(%(<%= render partial: "posts/row", collection: @posts, as: :post, locals: { a: 1 } %>)).render_calls.first
+
+    assert_equal "posts/row", call.partial
+    assert_equal "@posts", call.collection
+    assert_equal "post", call.as
+    assert_equal({ "a" => "1" }, call.locals)
+    refute call.block?
+  end
+
+  test "marks a render call that opens a block" do
+    call = Herb.scan_renders(%(<%= render CardComponent.new do |card| %><% end %>)).render_calls.first
+
+    assert call.block?
+    assert_equal "CardComponent.new", call.object
+    assert_nil call.partial
+  end
+
+  test "reads a strict locals declaration" do
+    scan = Herb.scan_renders(%(<%# locals: (title:, size: :md, **options) %>\n<h1><%= title %></h1>))
+
+    assert scan.strict_locals?
+    assert scan.keyword_rest?
+    assert_equal [["title", true, nil], ["size", false, ":md"]], scan.strict_locals.map(&:to_a)
+    assert_equal "(1:0)-(1:44)", scan.strict_locals_location.tree_inspect
+  end
+
+  test "a template without a declaration has no strict locals" do
+    scan = Herb.scan_renders(%(<%# just a comment %><p>hi</p>))
+
+    refute scan.strict_locals?
+    assert_nil scan.strict_locals
+    assert_empty scan.render_calls
+  end
+
+  test "a declaration that does not parse declares no locals" do
+    scan = Herb.scan_renders("<%# locals: (title:, %>")
+
+    assert scan.strict_locals?
+    assert_empty scan.strict_locals
+  end
+
+  test "lists the partials a template renders once each" do
+    scan = Herb.scan_renders(%(<%= render "a" %><%= render "b" %><%= render "a" %><%= render @post %>))
+
+    assert_equal ["a", "b"], scan.partials
+  end
+end
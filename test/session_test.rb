@@ -0,0 +1,58 @@
+# frozen_string_literal: true
+
+require_relative "test_helper"
+
+class SessionTest < Minitest::Spec
+  test "parse returns the same tree as Herb.parse" do
+    session = Herb::Session.new
+    source = %(<div class="<%= classes %>"><% if user %><b><%= user.name %></b><% end %></div><p>)
+
+    assert_equal Herb.parse(source).value.inspect, session.parse(source).value.inspect
+    assert_equal Herb.parse(source, track_whitespace: true).value.inspect,
+                 session.parse(source, track_whitespace: true).value.inspect
+  end
+
+  test "results stay valid after the next parse" do
+    session = Herb::Session.new
+
+    first = session.parse("<h1><%= title %></h1>")
+    second = session.parse("<div>")
+
+    assert_equal Herb.parse("<h1><%= title %></h1>").value.inspect, first.value.inspect
+    assert_predicate first.errors, :empty?
+    refute_predicate second.errors, :empty?
+  end
+
+  test "keeps its arena pages between parses" do
+    session = Herb::Session.new(trim_interval: 0)
+    source = "<div><%= content %></div>\n" * 1000
+
+    session.parse(source)
+    capacity = session.stats[:capacity]
+
+    10.times { session.parse(source) }
+
+    stats = session.stats
+    assert_equal 11, stats[:parse_count]
+    assert_equal capacity, stats[:capacity]
+  end
+
+  test "trims back to max_retained_bytes" do
+    session = Herb::Session.new(max_retained_bytes: 1)
+
+    session.parse("<div><%= content %></div>\n" * 5000)
+    large = session.stats[:pages]
+
+    session.parse("<p></p>")
+
+    assert_operator session.stats[:pages], :<, large
+  end
+
+  test "reset releases the current document" do
+    session = Herb::Session.new
+    session.parse("<div></div>")
+    session.reset
+
+    assert_equal 0, session.stats[:used]
+  end
+end
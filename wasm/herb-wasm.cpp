@@ -12,10 +12,12 @@ extern "C" {
 #include "../src/include/lib/hb_array.h"
 #include "../src/include/ast/ast_node.h"
 #include "../src/include/ast/ast_nodes.h"
+#include "../src/include/ast/ast_serialize.h"
 #include "../src/include/ast/ast_pretty_print.h"
 #include "../src/include/lib/hb_buffer.h"
 #include "../src/include/extract.h"
 #include "../src/include/herb.h"
+#include "../src/include/session.h"
 #include "../src/include/diff/herb_diff.h"
 #include "../src/include/location/location.h"
 #include "../src/include/location/position.h"
@@ -42,7 +44,7 @@ val Herb_lex(const std::string& source) {
   return result;
 }
 
-val Herb_parse(const std::string& source, val options) {
+static parser_options_T ParserOptionsFromValue(val options) {
   parser_options_T parser_options = HERB_DEFAULT_PARSER_OPTIONS;
 
   if (!options.isUndefined() && !options.isNull() && options.typeOf().as<std::string>() == "object") {
@@ -116,8 +118,18 @@ val Herb_parse(const std::string& source, val options) {
       val max_errors_val = options["max_errors"];
       parser_options.max_errors = max_errors_val.isNull() ? 0 : (uint32_t) max_errors_val.as<int>();
     }
+
+    if (options.hasOwnProperty("erb_recovery_limit")) {
+      parser_options.erb_recovery_limit = (uint32_t) options["erb_recovery_limit"].as<int>();
+    }
   }
 
+  return parser_options;
+}
+
+val Herb_parse(const std::string& source, val options) {
+  parser_options_T parser_options = ParserOptionsFromValue(options);
+
   uint32_t error_count = 0;
   parser_options.error_count = &error_count;
 
@@ -136,6 +148,33 @@ val Herb_parse(const std::string& source, val options) {
   return result;
 }
 
+val Herb_parse_binary(const std::string& source, val options) {
+  parser_options_T parser_options = ParserOptionsFromValue(options);
+
+  hb_allocator_T allocator;
+  if (!hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA)) {
+    return val::null();
+  }
+
+  hb_buffer_T buffer;
+  if (!hb_buffer_init(&buffer, source.length(), &allocator)) {
+    hb_allocator_destroy(&allocator);
+    return val::null();
+  }
+
+  AST_DOCUMENT_NODE_T* root = herb_parse(source.c_str(), &parser_options, &allocator);
+  herb_serialize(root, &buffer);
+
+  val result = val(typed_memory_view(hb_buffer_length(&buffer), (const uint8_t*) hb_buffer_value(&buffer)));
+  result = val::global("Uint8Array").new_(result);
+
+  ast_node_free((AST_NODE_T *) root, &allocator);
+  hb_buffer_free(&buffer);
+  hb_allocator_destroy(&allocator);
+
+  return result;
+}
+
 std::string Herb_extract_ruby(const std::string& source, val options) {
   hb_allocator_T allocator;
   if (!hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA)) {
@@ -182,6 +221,78 @@ std::string Herb_extract_html(const std::string& source) {
   return result;
 }
 
+val Herb_scan_renders(const std::string& source) {
+  hb_allocator_T allocator;
+  if (!hb_allocator_init(&allocator, HB_ALLOCATOR_ARENA)) {
+    return val::null();
+  }
+
+  herb_render_scan_T scan;
+
+  if (!herb_scan_renders(source.c_str(), &scan, &allocator)) {
+    hb_allocator_destroy(&allocator);
+    return val::null();
+  }
+
+  val result = val::object();
+  val render_calls = val::array();
+
+  for (size_t index = 0; index < hb_array_size(scan.render_calls); index++) {
+    const herb_render_call_T* call = (const herb_render_call_T*) hb_array_get(scan.render_calls, index);
+
+    val call_object = val::object();
+    val locals = val::object();
+
+    for (size_t local_index = 0; local_index < hb_array_size(call->locals); local_index++) {
+      const herb_render_local_T* local = (const herb_render_local_T*) hb_array_get(call->locals, local_index);
+      if (local->name == NULL) { continue; }
+
+      locals.set(val::u8string(local->name), CreateString(local->value));
+    }
+
+    call_object.set("partial", CreateString(call->partial));
+    call_object.set("template", CreateString(call->template_path));
+    call_object.set("layout", CreateString(call->layout));
+    call_object.set("collection", CreateString(call->collection));
+    call_object.set("object", CreateString(call->object));
+    call_object.set("as", CreateString(call->as_name));
+    call_object.set("locals", locals);
+    call_object.set("block", call->has_block);
+    call_object.set("location", CreateLocation(call->location));
+
+    render_calls.call<void>("push", call_object);
+  }
+
+  result.set("renderCalls", render_calls);
+
+  if (scan.has_strict_locals) {
+    val strict_locals = val::array();
+
+    for (size_t index = 0; index < hb_array_size(scan.strict_locals); index++) {
+      const herb_strict_local_T* local = (const herb_strict_local_T*) hb_array_get(scan.strict_locals, index);
+
+      val local_object = val::object();
+      local_object.set("name", CreateString(local->name));
+      local_object.set("required", local->required);
+      local_object.set("defaultSource", CreateString(local->default_value));
+
+      strict_locals.call<void>("push", local_object);
+    }
+
+    result.set("strictLocals", strict_locals);
+    result.set("strictLocalsLocation", CreateLocation(scan.strict_locals_location));
+  } else {
+    result.set("strictLocals", val::null());
+    result.set("strictLocalsLocation", val::null());
+  }
+
+  result.set("keywordRest", scan.has_keyword_rest);
+
+  hb_allocator_destroy(&allocator);
+
+  return result;
+}
+
 val Herb_parse_ruby(const std::string& source) {
   herb_ruby_parse_result_T* parse_result = herb_parse_ruby(source.c_str(), source.length());
 
@@ -308,12 +419,81 @@ std::string Herb_version() {
   return version;
 }
 
+// Bound as `Session`. The arena is kept between parses; JS callers release it with `delete()`.
+class HerbSession {
+public:
+  explicit HerbSession(val options) {
+    herb_session_options_T session_options = HERB_DEFAULT_SESSION_OPTIONS;
+
+    if (!options.isUndefined() && !options.isNull() && options.typeOf().as<std::string>() == "object") {
+      if (options.hasOwnProperty("trim_interval")) {
+        session_options.trim_interval = options["trim_interval"].as<size_t>();
+      }
+
+      if (options.hasOwnProperty("max_retained_bytes")) {
+        session_options.max_retained_bytes = options["max_retained_bytes"].as<size_t>();
+      }
+    }
+
+    initialized = herb_session_init(&session, &session_options);
+  }
+
+  ~HerbSession() {
+    herb_session_deinit(&session);
+  }
+
+  HerbSession(const HerbSession&) = delete;
+  HerbSession& operator=(const HerbSession&) = delete;
+
+  val parse(const std::string& source, val options) {
+    if (!initialized) { return val::null(); }
+
+    parser_options_T parser_options = ParserOptionsFromValue(options);
+
+    uint32_t error_count = 0;
+    parser_options.error_count = &error_count;
+
+    AST_DOCUMENT_NODE_T* root = herb_session_parse(&session, source.c_str(), &parser_options);
+
+    return CreateParseResult(root, source, &parser_options);
+  }
+
+  void reset() {
+    herb_session_reset(&session);
+  }
+
+  val stats() const {
+    herb_session_stats_T stats = herb_session_stats(&session);
+
+    val result = val::object();
+    result.set("parse_count", stats.parse_count);
+    result.set("pages", stats.pages);
+    result.set("capacity", stats.capacity);
+    result.set("used", stats.used);
+    result.set("high_water_mark", stats.high_water_mark);
+
+    return result;
+  }
+
+private:
+  herb_session_T session;
+  bool initialized;
+};
+
 EMSCRIPTEN_BINDINGS(herb_module) {
   function("lex", &Herb_lex);
   function("parse", &Herb_parse);
   function("extractRuby", &Herb_extract_ruby);
   function("extractHTML", &Herb_extract_html);
+  function("scanRenders", &Herb_scan_renders);
   function("version", &Herb_version);
   function("parseRuby", &Herb_parse_ruby);
+  function("parseBinary", &Herb_parse_binary);
   function("diff", &Herb_diff);
+
+  class_<HerbSession>("Session")
+    .constructor<val>()
+    .function("parse", &HerbSession::parse)
+    .function("reset", &HerbSession::reset)
+    .function("stats", &HerbSession::stats);
 }